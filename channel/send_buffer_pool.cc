@@ -0,0 +1,161 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <channel/send_buffer_pool.h>
+
+#include <util/error_handling.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace channel {
+
+SendBufferPool::SendBufferPool(std::size_t max_idle) : max_idle_(max_idle)
+{
+  idle_.reserve(max_idle_);
+}
+
+SendBufferPool::~SendBufferPool()
+{
+  DEBUG_ASSUME(idle_.size() == allocated_).else_log("{} send buffers still in use", allocated_ - idle_.size());
+
+  for (auto *buffer : idle_) {
+    delete buffer;
+  }
+}
+
+SendBufferPool::Buffer *SendBufferPool::acquire()
+{
+  check_owner();
+
+  Buffer *buffer;
+
+  if (idle_.empty()) {
+    /* not value-initialized: only bytes that were written into get sent */
+    buffer = new Buffer;
+    ++allocated_;
+  } else {
+    buffer = idle_.back();
+    idle_.pop_back();
+  }
+
+  buffer->pool = this;
+  buffer->refs = 1;
+  buffer->used = 0;
+  return buffer;
+}
+
+void SendBufferPool::unref(Buffer *buffer)
+{
+  if (--buffer->refs == 0) {
+    buffer->pool->recycle(buffer);
+  }
+}
+
+void SendBufferPool::recycle(Buffer *buffer)
+{
+  check_owner();
+
+  if (idle_.size() < max_idle_) {
+    idle_.push_back(buffer);
+  } else {
+    delete buffer;
+    --allocated_;
+  }
+}
+
+void SendBufferPool::trim()
+{
+  check_owner();
+
+  for (auto *buffer : idle_) {
+    delete buffer;
+  }
+  allocated_ -= idle_.size();
+  idle_.clear();
+}
+
+void SendBufferPool::check_owner()
+{
+#ifndef NDEBUG
+  if (owner_ == std::thread::id{}) {
+    owner_ = std::this_thread::get_id();
+  }
+  DEBUG_ASSUME(owner_ == std::this_thread::get_id()).else_log("send buffer pool used from more than one thread");
+#endif // NDEBUG
+}
+
+SendQueue::~SendQueue()
+{
+  clear();
+}
+
+void SendQueue::append(u8 const *data, u32 len)
+{
+  while (len > 0) {
+    if (!tail_ || tail_->available() == 0) {
+      if (tail_) {
+        SendBufferPool::unref(tail_);
+      }
+      tail_ = pool_.acquire();
+    }
+
+    u32 const count = std::min(len, tail_->available());
+    memcpy(tail_->data + tail_->used, data, count);
+
+    if (!slices_.empty() && slices_.back().buffer == tail_) {
+      /* slices taken out of the queue are never extended */
+      slices_.back().len += count;
+    } else {
+      SendBufferPool::ref(tail_);
+      slices_.push_back({.buffer = tail_, .offset = tail_->used, .len = count});
+    }
+
+    tail_->used += count;
+    bytes_ += count;
+    data += count;
+    len -= count;
+  }
+}
+
+void SendQueue::take(std::vector<SendSlice> &out)
+{
+  out.insert(out.end(), slices_.begin(), slices_.end());
+  slices_.clear();
+  bytes_ = 0;
+}
+
+void SendQueue::clear()
+{
+  release(slices_);
+  bytes_ = 0;
+
+  if (tail_) {
+    SendBufferPool::unref(tail_);
+    tail_ = nullptr;
+  }
+}
+
+void SendQueue::release_idle_buffer()
+{
+  if (!slices_.empty()) {
+    return;
+  }
+
+  if (tail_) {
+    SendBufferPool::unref(tail_);
+    tail_ = nullptr;
+  }
+
+  pool_.trim();
+}
+
+void SendQueue::release(std::vector<SendSlice> &slices)
+{
+  for (auto const &slice : slices) {
+    SendBufferPool::unref(slice.buffer);
+  }
+  slices.clear();
+}
+
+} // namespace channel
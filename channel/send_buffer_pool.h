@@ -0,0 +1,161 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/types.h>
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace channel {
+
+/**
+ * A pool of fixed-size buffers that outgoing data is copied into until it is
+ * written to a socket.
+ *
+ * Buffers are refcounted, and go back to the pool when their last reference is
+ * dropped. At most `max_idle` free buffers are kept around, the others are
+ * freed; trim() frees the ones kept.
+ *
+ * The pool must outlive the queues and slices holding its buffers; the channel
+ * writing them owns it. It is not thread-safe: buffers must be acquired and
+ * released on the thread that first acquired one, which debug builds check.
+ */
+class SendBufferPool {
+public:
+  static constexpr u32 buffer_size = 64 * 1024;
+  static constexpr std::size_t default_max_idle = 16;
+
+  struct Buffer {
+    SendBufferPool *pool;
+    u32 refs;
+    /* number of bytes filled so far */
+    u32 used;
+    char data[buffer_size];
+
+    u32 available() const { return buffer_size - used; }
+  };
+
+  explicit SendBufferPool(std::size_t max_idle = default_max_idle);
+  ~SendBufferPool();
+
+  SendBufferPool(SendBufferPool const &) = delete;
+  SendBufferPool &operator=(SendBufferPool const &) = delete;
+
+  /**
+   * Returns an empty buffer holding one reference.
+   */
+  Buffer *acquire();
+
+  static void ref(Buffer *buffer) { ++buffer->refs; }
+
+  /**
+   * Drops a reference, returning the buffer to its pool on the last one.
+   */
+  static void unref(Buffer *buffer);
+
+  /**
+   * Number of buffers allocated by this pool, in use or idle.
+   */
+  std::size_t allocated() const { return allocated_; }
+
+  std::size_t idle() const { return idle_.size(); }
+
+  /**
+   * Frees the idle buffers.
+   */
+  void trim();
+
+private:
+  void recycle(Buffer *buffer);
+
+  /* checks that the pool is only used from one thread */
+  void check_owner();
+
+  std::size_t const max_idle_;
+  std::size_t allocated_ = 0;
+  std::vector<Buffer *> idle_;
+  /* the thread that first acquired a buffer */
+  std::thread::id owner_;
+};
+
+/**
+ * A range of bytes in a pooled buffer, holding a reference to the buffer.
+ */
+struct SendSlice {
+  SendBufferPool::Buffer *buffer;
+  u32 offset;
+  u32 len;
+
+  char *data() const { return buffer->data + offset; }
+};
+
+/**
+ * Bytes waiting to be written, as slices of pooled buffers.
+ *
+ * Appended data is copied at the end of the current buffer, so consecutive
+ * appends to the same buffer extend the same slice. Slices handed out by
+ * take() are never written to again, and can be written to the socket while
+ * more data is appended.
+ */
+class SendQueue {
+public:
+  /**
+   * Takes buffers from `pool`, which must outlive the queue.
+   */
+  explicit SendQueue(SendBufferPool &pool) : pool_(pool) {}
+
+  ~SendQueue();
+
+  SendQueue(SendQueue const &) = delete;
+  SendQueue &operator=(SendQueue const &) = delete;
+
+  /**
+   * Copies `len` bytes at the end of the queue.
+   */
+  void append(u8 const *data, u32 len);
+
+  bool empty() const { return slices_.empty(); }
+
+  /**
+   * Number of bytes queued.
+   */
+  u64 bytes() const { return bytes_; }
+
+  std::vector<SendSlice> const &slices() const { return slices_; }
+
+  /**
+   * Moves all queued slices at the end of `out`, leaving the queue empty.
+   * The caller takes over the slices' references, see release().
+   */
+  void take(std::vector<SendSlice> &out);
+
+  /**
+   * Drops the queued slices, and the buffer data is appended to.
+   */
+  void clear();
+
+  /**
+   * If nothing is queued, drops the buffer data is appended to and frees the
+   * pool's idle buffers, so an idle queue holds no send memory.
+   */
+  void release_idle_buffer();
+
+  /**
+   * Drops the references held by `slices`, and clears it.
+   */
+  static void release(std::vector<SendSlice> &slices);
+
+private:
+  SendBufferPool &pool_;
+  /* the buffer data is appended to, on which the queue holds a reference */
+  SendBufferPool::Buffer *tail_ = nullptr;
+  std::vector<SendSlice> slices_;
+  u64 bytes_ = 0;
+};
+
+} /* namespace channel */
@@ -0,0 +1,160 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <channel/send_buffer_pool.h>
+
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace channel {
+namespace {
+
+void append(SendQueue &queue, std::string_view data)
+{
+  queue.append(reinterpret_cast<u8 const *>(data.data()), data.size());
+}
+
+std::string contents(std::vector<SendSlice> const &slices)
+{
+  std::string out;
+  for (auto const &slice : slices) {
+    out.append(slice.data(), slice.len);
+  }
+  return out;
+}
+
+} // namespace
+
+TEST(send_buffer_pool, recycles_buffers)
+{
+  SendBufferPool pool(1);
+
+  auto *first = pool.acquire();
+  auto *second = pool.acquire();
+  EXPECT_EQ(2u, pool.allocated());
+
+  SendBufferPool::ref(first);
+  SendBufferPool::unref(first);
+  EXPECT_EQ(0u, pool.idle());
+
+  SendBufferPool::unref(first);
+  SendBufferPool::unref(second);
+  EXPECT_EQ(1u, pool.idle());
+  EXPECT_EQ(1u, pool.allocated());
+
+  EXPECT_EQ(first, pool.acquire());
+  EXPECT_EQ(0u, pool.idle());
+  SendBufferPool::unref(first);
+}
+
+TEST(send_queue, coalesces_appends)
+{
+  SendBufferPool pool;
+  SendQueue queue(pool);
+
+  append(queue, "hello ");
+  append(queue, "world");
+  ASSERT_EQ(1u, queue.slices().size());
+  EXPECT_EQ(11u, queue.bytes());
+  EXPECT_EQ("hello world", contents(queue.slices()));
+  EXPECT_EQ(1u, pool.allocated());
+}
+
+TEST(send_queue, taken_slices_are_not_extended)
+{
+  SendBufferPool pool;
+  SendQueue queue(pool);
+
+  append(queue, "first");
+  std::vector<SendSlice> in_flight;
+  queue.take(in_flight);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(0u, queue.bytes());
+
+  append(queue, "second");
+  ASSERT_EQ(1u, queue.slices().size());
+  EXPECT_EQ("first", contents(in_flight));
+  EXPECT_EQ("second", contents(queue.slices()));
+
+  // both slices share the queue's buffer
+  EXPECT_EQ(in_flight[0].buffer, queue.slices()[0].buffer);
+  EXPECT_EQ(1u, pool.allocated());
+
+  SendQueue::release(in_flight);
+  EXPECT_TRUE(in_flight.empty());
+}
+
+TEST(send_queue, splits_across_buffers)
+{
+  SendBufferPool pool;
+  SendQueue queue(pool);
+
+  std::string data(SendBufferPool::buffer_size * 2 + 100, 'x');
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>(i);
+  }
+
+  append(queue, data);
+  ASSERT_EQ(3u, queue.slices().size());
+  EXPECT_EQ(data.size(), queue.bytes());
+  EXPECT_EQ(data, contents(queue.slices()));
+  EXPECT_EQ(3u, pool.allocated());
+}
+
+TEST(send_queue, returns_buffers_to_pool)
+{
+  SendBufferPool pool;
+
+  {
+    SendQueue queue(pool);
+    append(queue, "data");
+
+    std::vector<SendSlice> in_flight;
+    queue.take(in_flight);
+
+    // the slice being written still holds the buffer
+    queue.release_idle_buffer();
+    EXPECT_EQ(0u, pool.idle());
+
+    SendQueue::release(in_flight);
+    EXPECT_EQ(1u, pool.idle());
+
+    append(queue, "more");
+    EXPECT_EQ(0u, pool.idle());
+  }
+
+  EXPECT_EQ(1u, pool.idle());
+  EXPECT_EQ(1u, pool.allocated());
+}
+
+TEST(send_queue, idle_queue_frees_buffers)
+{
+  SendBufferPool pool;
+  SendQueue queue(pool);
+
+  // buffers left idle by earlier writes
+  auto *first = pool.acquire();
+  auto *second = pool.acquire();
+  SendBufferPool::unref(first);
+  SendBufferPool::unref(second);
+  EXPECT_EQ(2u, pool.idle());
+
+  append(queue, "data");
+  std::vector<SendSlice> in_flight;
+  queue.take(in_flight);
+  SendQueue::release(in_flight);
+
+  // the write completed with nothing else queued
+  queue.release_idle_buffer();
+  EXPECT_EQ(0u, pool.idle());
+  EXPECT_EQ(0u, pool.allocated());
+
+  // and the queue still works afterwards
+  append(queue, "more");
+  EXPECT_EQ("more", contents(queue.slices()));
+  EXPECT_EQ(1u, pool.allocated());
+}
+
+} // namespace channel
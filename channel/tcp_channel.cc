@@ -38,9 +38,17 @@ void TCPChannel::conn_read_alloc_cb(uv_handle_t *handle, size_t suggested_size,
     return;
   }
 
+  /* only move unhandled bytes to the front when running out of room after them */
+  u8 *const rx_buffer = (u8 *)conn->rx_buffer_;
+  if (conn->rx_start_ > 0 && TCPChannel::rx_buffer_size - conn->rx_end_ < TCPChannel::rx_min_read_size) {
+    memmove(rx_buffer, rx_buffer + conn->rx_start_, conn->rx_end_ - conn->rx_start_);
+    conn->rx_end_ -= conn->rx_start_;
+    conn->rx_start_ = 0;
+  }
+
   /* assign the free buffer, reserving bytes for overflow */
-  buf->base = (char *)conn->rx_buffer_ + conn->rx_len_;
-  buf->len = TCPChannel::rx_buffer_size - conn->rx_len_;
+  buf->base = (char *)rx_buffer + conn->rx_end_;
+  buf->len = TCPChannel::rx_buffer_size - conn->rx_end_;
   conn->allocated_ = true;
 }
 
@@ -66,17 +74,20 @@ void TCPChannel::conn_read_cb(uv_stream_t *stream, ssize_t nread, const uv_buf_t
   }
 
   /* "merge" the read data into the buffer */
-  conn->rx_len_ += nread;
+  conn->rx_end_ += nread;
   conn->allocated_ = false;
 
   /* read all complete messages from buffer */
   try {
-    u32 res = conn->callbacks_->received_data((u8 *)conn->rx_buffer_, conn->rx_len_);
-
-    if (res > 0) {
-      ASSUME(res <= conn->rx_len_);
-      conn->rx_len_ -= res;
-      memmove(conn->rx_buffer_, (u8 *)conn->rx_buffer_ + res, conn->rx_len_);
+    u32 const rx_len = conn->rx_end_ - conn->rx_start_;
+    u32 res = conn->callbacks_->received_data((u8 *)conn->rx_buffer_ + conn->rx_start_, rx_len);
+
+    ASSUME(res <= rx_len);
+    if (res == rx_len) {
+      /* everything was handled, start over at the front */
+      conn->rx_start_ = conn->rx_end_ = 0;
+    } else {
+      conn->rx_start_ += res;
     }
   } catch (const std::exception &e) {
     LOG::error("TCPChannel: error handling received data: '{}'", e.what());
@@ -86,7 +97,7 @@ void TCPChannel::conn_read_cb(uv_stream_t *stream, ssize_t nread, const uv_buf_t
   }
 
   /* check that we don't exceed the buffer size */
-  if (conn->rx_len_ == TCPChannel::rx_buffer_size) {
+  if (conn->rx_end_ - conn->rx_start_ == TCPChannel::rx_buffer_size) {
     conn->connected_ = false;
     conn->callbacks_->on_error(-EOVERFLOW);
     return;
@@ -137,17 +148,30 @@ void TCPChannel::conn_write_cb(uv_write_t *req, int status)
   LOG::trace_in(channel::Component::tcp, "TCPChannel::{}()", __func__);
   auto tcp = (TCPChannel *)req->handle->data;
 
-  if (status < 0) {
+  SendQueue::release(tcp->in_flight_);
+  tcp->in_flight_bytes_ = 0;
+
+  bool const closing = uv_is_closing((uv_handle_t *)req->handle);
+
+  if (status < 0 || closing) {
+    /* whatever was queued after the failed write can't be sent either */
+    tcp->send_queue_.clear();
+
     /* no need to notify if close() was called, otherwise -- notify */
-    if (!uv_is_closing((uv_handle_t *)req->handle)) {
+    if (status < 0 && !closing) {
       LOG::trace_in(channel::Component::tcp, "TCPChannel::{}: connection not closing, calling close on handle()", __func__);
       tcp->connected_ = false;
       tcp->callbacks_->on_error(status);
     }
+    return;
   }
 
-  /* assumes req is the first field in send_buffer_t */
-  free(req);
+  if (tcp->send_queue_.empty()) {
+    tcp->send_queue_.release_idle_buffer();
+  } else {
+    /* errors are reported through on_error */
+    tcp->write_queued();
+  }
 }
 
 TCPChannel::TCPChannel(uv_loop_t &loop)
@@ -164,6 +188,7 @@ TCPChannel::~TCPChannel()
 {
   LOG::trace_in(channel::Component::tcp, "TCPChannel::{}: connection not closing, calling close on handle()", __func__);
   DEBUG_ASSUME(uv_is_closing((uv_handle_t *)&conn_));
+  SendQueue::release(in_flight_);
 }
 
 void TCPChannel::connect(Callbacks &callbacks)
@@ -249,46 +274,38 @@ void TCPChannel::close_permanently()
 std::error_code TCPChannel::send(const u8 *data, int data_len)
 {
   LOG::trace_in(channel::Component::tcp, "TCPChannel::{}(len:{})", __func__, data_len);
-  auto send_buffer = allocate_send_buffer(data_len);
-  if (!send_buffer) {
-    // TODO: gracefully handle out-of-memory errors
-    std::abort();
-    return std::make_error_code(std::errc::not_enough_memory);
-  }
-
-  memcpy(send_buffer->data, data, data_len);
-  send_buffer->len = data_len;
-
-  return send(send_buffer);
-}
+  send_queue_.append(data, data_len);
 
-struct TCPChannel::send_buffer_t *TCPChannel::allocate_send_buffer(u32 size)
-{
-  u32 mem_size = ((sizeof(struct send_buffer_t) + 7) & ~7) + size;
-  struct send_buffer_t *ret = (struct send_buffer_t *)malloc(mem_size);
-  if (ret == nullptr) {
-    LOG::critical("Failed to allocate send buffer of size {} mem_size {}", size, mem_size);
-    return nullptr;
+  /* otherwise, queued data is written when the write in flight completes */
+  if (in_flight_.empty() && !send_queue_.empty()) {
+    return write_queued();
   }
 
-  // clear memory to ensure we don't exfiltrate uninitialized data
-  memset(ret, 0, mem_size);
-
-  return ret;
+  return {};
 }
 
-std::error_code TCPChannel::send(struct send_buffer_t *send_buffer)
+std::error_code TCPChannel::write_queued()
 {
-  uv_buf_t uv_buf = {.base = (char *)send_buffer->data, .len = send_buffer->len};
+  in_flight_bytes_ = send_queue_.bytes();
+  send_queue_.take(in_flight_);
+
+  write_bufs_.clear();
+  for (auto const &slice : in_flight_) {
+    write_bufs_.push_back(uv_buf_init(slice.data(), slice.len));
+  }
 
-  if (auto const error = ::uv_write(&send_buffer->req, reinterpret_cast<uv_stream_t *>(&conn_), &uv_buf, 1, conn_write_cb)) {
+  if (auto const error = ::uv_write(
+          &write_req_, reinterpret_cast<uv_stream_t *>(&conn_), write_bufs_.data(), write_bufs_.size(), conn_write_cb)) {
     LOG::error(
         "TCPChannel::{}: failed to write {} bytes into {} channel: {}",
         __func__,
-        send_buffer->len,
+        in_flight_bytes_,
         CONNECTED_DISCONNECTED[connected_],
         uv_error_t{error});
 
+    SendQueue::release(in_flight_);
+    in_flight_bytes_ = 0;
+
     callbacks_->on_error(error);
     return {error, libuv_category()};
   }
@@ -300,9 +317,13 @@ void TCPChannel::reinit(uv_loop_t *loop)
 {
   LOG::trace_in(channel::Component::tcp, "TCPChannel::{}()", __func__);
   /* reinit RX buffers */
-  rx_len_ = 0;
+  rx_start_ = 0;
+  rx_end_ = 0;
   allocated_ = false;
 
+  /* writes in flight were cancelled when closing */
+  send_queue_.clear();
+
   /* re-init handle */
   CHECK_UV(uv_tcp_init(loop, &conn_));
   conn_.data = this;
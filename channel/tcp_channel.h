@@ -7,8 +7,10 @@
 
 #include <channel/callbacks.h>
 #include <channel/network_channel.h>
+#include <channel/send_buffer_pool.h>
 #include <platform/platform.h>
 #include <memory>
+#include <vector>
 
 #include <uv.h>
 
@@ -23,6 +25,15 @@ struct buffer_t {
 /**
  * A TCP channel
  *
+ * Sent data is copied into buffers from the channel's own pool (see
+ * SendBufferPool), so they are only used from the loop's thread. While a write
+ * is in flight, further sends are queued, and written together in a single
+ * uv_write when it completes.
+ *
+ * Received data is kept in rx_buffer_ until handled. Bytes left unhandled stay
+ * in place, and are only moved to the front of the buffer when less than
+ * rx_min_read_size bytes are left after them.
+ *
  * Errors for on_error callback:
  *   -EPROTO: handler threw exception
  *   -EOVERFLOW: overflow occupies entire buffer SERVER_CONN_BUFFER_SIZE and not
@@ -32,12 +43,10 @@ struct buffer_t {
 class TCPChannel : public NetworkChannel {
 public:
   static constexpr u32 rx_buffer_size = (64 * 1024);
-
-  struct send_buffer_t {
-    uv_write_t req; /* must be first */
-    u32 len;
-    u64 data[0];
-  };
+  static constexpr u32 rx_min_read_size = (16 * 1024);
+  /* idle send buffers kept between writes: one being written, one being filled;
+   * they are freed once there is nothing left to send */
+  static constexpr std::size_t send_pool_max_idle = 2;
 
   /**
    * c'tor -- leaves socket ready for accept()
@@ -91,17 +100,9 @@ public:
   std::error_code send(const u8 *data, int data_len) override;
 
   /**
-   * Allocates a send buffer capable of holding @size bytes.
-   *
-   * It is the responsibility of the caller to call send() with the buffer.
-   */
-  struct send_buffer_t *allocate_send_buffer(u32 size);
-
-  /**
-   * Sends the given TCPChannel::send_buffer_t allocated with
-   *   allocate_send_buffer().
+   * Number of bytes sent but not yet written to the socket.
    */
-  std::error_code send(struct send_buffer_t *send_buffer);
+  u64 pending_send_bytes() const { return send_queue_.bytes() + in_flight_bytes_; }
 
   /**
    * Returns the address (in binary format) that this channel is connected to,
@@ -121,6 +122,11 @@ private:
 
   void close_internal(const uv_close_cb close_cb);
 
+  /**
+   * Writes all queued data in one uv_write
+   */
+  std::error_code write_queued();
+
   /**
    * Inits the tcp handle (conn_) and buffers
    */
@@ -141,8 +147,19 @@ private:
 
   u64 rx_buffer_[(rx_buffer_size + 7) / 8];
 
-  /* number of bytes currently in the rx_buffer */
-  u32 rx_len_;
+  /* unhandled bytes are at [rx_start_, rx_end_) in the rx_buffer */
+  u32 rx_start_;
+  u32 rx_end_;
+
+  /* declared before the queue and the write, which hold its buffers */
+  SendBufferPool send_pool_{send_pool_max_idle};
+  /* data waiting for the write in flight to complete */
+  SendQueue send_queue_{send_pool_};
+  /* data being written, and the buffers of the write */
+  uv_write_t write_req_;
+  std::vector<SendSlice> in_flight_;
+  std::vector<uv_buf_t> write_bufs_;
+  u64 in_flight_bytes_ = 0;
 
   bool allocated_ = false;
 
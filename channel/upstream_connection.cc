@@ -11,7 +11,8 @@ namespace channel {
 UpstreamConnection::UpstreamConnection(
     std::size_t buffer_size, bool allow_compression, NetworkChannel &primary_channel, Channel *secondary_channel)
     : primary_channel_(primary_channel),
-      lz4_channel_(primary_channel_, buffer_size),
+      zstd_channel_(primary_channel_, buffer_size),
+      lz4_channel_(zstd_channel_, buffer_size),
       allow_compression_(allow_compression),
       double_write_channel_(lz4_channel_, secondary_channel ? *secondary_channel : lz4_channel_),
       buffered_writer_(secondary_channel ? static_cast<Channel &>(double_write_channel_) : lz4_channel_, buffer_size)
@@ -20,6 +21,9 @@ UpstreamConnection::UpstreamConnection(
 void UpstreamConnection::connect(Callbacks &callbacks)
 {
   buffered_writer_.reset();
+  dictionary_compression_ = false;
+  zstd_channel_.reset();
+  update_compression();
   primary_channel_.connect(callbacks);
 }
 
@@ -42,6 +46,9 @@ std::error_code UpstreamConnection::flush()
 void UpstreamConnection::close()
 {
   buffered_writer_.reset();
+  dictionary_compression_ = false;
+  zstd_channel_.reset();
+  update_compression();
   primary_channel_.close();
 }
 
@@ -51,11 +58,31 @@ void UpstreamConnection::set_compression(bool enabled)
 
   LOG::trace_in(
       Component::upstream,
-      "UpstreamConnection: {} ({}allowed) LZ4 compression",
+      "UpstreamConnection: {} ({}allowed) {} compression",
       enabled ? "enabling" : "disabling",
-      allow_compression_ ? "" : "not ");
+      allow_compression_ ? "" : "not ",
+      dictionary_compression_ ? "zstd" : "LZ4");
 
-  lz4_channel_.set_compression(enabled && allow_compression_);
+  compression_enabled_ = enabled;
+  update_compression();
+}
+
+void UpstreamConnection::enable_dictionary_compression(int level)
+{
+  buffered_writer_.flush();
+
+  LOG::trace_in(Component::upstream, "UpstreamConnection: switching to zstd compression, level {}", level);
+
+  zstd_channel_.set_level(level);
+  dictionary_compression_ = true;
+  update_compression();
+}
+
+void UpstreamConnection::update_compression()
+{
+  bool const enabled = compression_enabled_ && allow_compression_;
+  lz4_channel_.set_compression(enabled && !dictionary_compression_);
+  zstd_channel_.set_compression(enabled && dictionary_compression_);
 }
 
 BufferedWriter &UpstreamConnection::buffered_writer()
@@ -10,6 +10,7 @@
 #include <channel/double_write_channel.h>
 #include <channel/lz4_channel.h>
 #include <channel/network_channel.h>
+#include <channel/zstd_channel.h>
 #include <platform/platform.h>
 
 namespace channel {
@@ -44,6 +45,15 @@ public:
    */
   void set_compression(bool enabled);
 
+  /**
+   * Compresses with the ingest compression dictionary at the given zstd
+   * level, instead of LZ4, until the connection is closed.
+   *
+   * Data sent before this call is flushed first, so the switch happens at an
+   * LZ4 frame boundary.
+   */
+  void enable_dictionary_compression(int level);
+
   BufferedWriter &buffered_writer();
 
   in_addr_t const *connected_address() const override;
@@ -51,9 +61,14 @@ public:
   bool is_open() const override { return primary_channel_.is_open(); }
 
 private:
+  void update_compression();
+
   NetworkChannel &primary_channel_;
+  ZstdChannel zstd_channel_;
   Lz4Channel lz4_channel_;
   bool allow_compression_;
+  bool compression_enabled_ = false;
+  bool dictionary_compression_ = false;
   DoubleWriteChannel double_write_channel_;
   BufferedWriter buffered_writer_;
 };
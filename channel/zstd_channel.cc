@@ -0,0 +1,96 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "channel/zstd_channel.h"
+
+#include <util/compression_dictionary.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace channel {
+
+#define _CHECK_ZSTD_ERROR(code)                                                                                                \
+  if (ZSTD_isError(code)) {                                                                                                    \
+    throw std::runtime_error(std::string("ZstdChannel: compression failed: ") + std::string(ZSTD_getErrorName(code)));         \
+  }
+
+ZstdChannel::ZstdChannel(Channel &channel, u32 max_data_length)
+    : compression_enabled_(false), level_(DEFAULT_LEVEL), channel_(channel), max_data_length_(max_data_length)
+{}
+
+void ZstdChannel::set_compression(bool enabled)
+{
+  compression_enabled_ = enabled;
+
+  if (enabled && !zstd_ctx_) {
+    zstd_ctx_.reset(ZSTD_createCCtx());
+    if (!zstd_ctx_) {
+      throw std::runtime_error("ZstdChannel: Failed to create zstd context.");
+    }
+
+    auto const dictionary = compression_dictionary();
+    _CHECK_ZSTD_ERROR(ZSTD_CCtx_loadDictionary(zstd_ctx_.get(), dictionary.data(), dictionary.size()));
+    _CHECK_ZSTD_ERROR(ZSTD_CCtx_setParameter(zstd_ctx_.get(), ZSTD_c_windowLog, COMPRESSION_WINDOW_LOG));
+    _CHECK_ZSTD_ERROR(ZSTD_CCtx_setParameter(zstd_ctx_.get(), ZSTD_c_compressionLevel, level_));
+
+    buffer_.resize(ZSTD_compressBound(max_data_length_));
+  }
+}
+
+void ZstdChannel::set_level(int level)
+{
+  level_ = level;
+
+  if (zstd_ctx_) {
+    reset();
+    _CHECK_ZSTD_ERROR(ZSTD_CCtx_setParameter(zstd_ctx_.get(), ZSTD_c_compressionLevel, level_));
+  }
+}
+
+void ZstdChannel::reset()
+{
+  if (zstd_ctx_) {
+    // keeps the dictionary and parameters
+    _CHECK_ZSTD_ERROR(ZSTD_CCtx_reset(zstd_ctx_.get(), ZSTD_reset_session_only));
+  }
+}
+
+std::error_code ZstdChannel::send(const u8 *data, int data_len)
+{
+  if (!compression_enabled_) {
+    return channel_.send(data, data_len);
+  }
+
+  ZSTD_inBuffer input = {.src = data, .size = static_cast<size_t>(data_len), .pos = 0};
+
+  // ZSTD_e_flush makes everything sent so far decompressible, without ending
+  // the frame, so the next packet is still compressed with this one as context
+  for (;;) {
+    ZSTD_outBuffer output = {.dst = buffer_.data(), .size = buffer_.size(), .pos = 0};
+    size_t const remaining = ZSTD_compressStream2(zstd_ctx_.get(), &output, &input, ZSTD_e_flush);
+    _CHECK_ZSTD_ERROR(remaining);
+
+    if (output.pos > 0) {
+      if (auto error = channel_.send(buffer_.data(), output.pos)) {
+        return error;
+      }
+    }
+
+    if (remaining == 0) {
+      return {};
+    }
+  }
+}
+
+void ZstdChannel::close()
+{
+  channel_.close();
+}
+
+std::error_code ZstdChannel::flush()
+{
+  return channel_.flush();
+}
+
+} // namespace channel
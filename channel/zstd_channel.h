@@ -0,0 +1,68 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <channel/channel.h>
+#include <platform/types.h>
+#include <util/raii.h>
+
+#include <zstd.h>
+
+#include <vector>
+
+namespace channel {
+
+// ZstdChannel serves as an adapter between upstream data source and downstream
+// channel, like Lz4Channel.
+//
+// When the compression is disabled, the ZstdChannel will pass any incoming
+// data packets to downstream channel directly.
+//
+// When the compression is enabled, the ZstdChannel will compress the incoming
+// data packets with the ingest compression dictionary (see
+// util/compression_dictionary.h) before relaying them. Packets are compressed
+// into a single zstd frame, flushed after each packet, so that each packet is
+// compressed with the previous ones as context.
+class ZstdChannel : public Channel {
+public:
+  static constexpr int DEFAULT_LEVEL = 3;
+
+  // |channel|: the downstream channel which will actually send out the data.
+  // |max_data_length|: max number of bytes of any incoming data packet sent
+  //                    via send() function. Note that it's caller's
+  //                    responsibility to honor this constraint.
+  ZstdChannel(Channel &channel, u32 max_data_length);
+
+  std::error_code send(const u8 *data, int data_len) override;
+
+  void set_compression(bool enabled);
+
+  // Sets the compression level, see reset().
+  void set_level(int level);
+
+  // Drops the current frame: data compressed afterwards starts a new one.
+  // Meant for new connections, since a peer that received part of the current
+  // frame can't decompress what follows.
+  void reset();
+
+  void close() override;
+  std::error_code flush() override;
+
+  bool is_open() const override { return channel_.is_open(); }
+
+private:
+  bool compression_enabled_;
+  int level_;
+
+  Channel &channel_;
+  u32 const max_data_length_;
+
+  // allocated when compression is first enabled
+  std::vector<u8> buffer_;
+  pod_unique_ptr<ZSTD_CCtx, size_t, ZSTD_freeCCtx> zstd_ctx_;
+};
+
+} // namespace channel
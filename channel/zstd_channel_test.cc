@@ -0,0 +1,164 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <channel/zstd_channel.h>
+
+#include <util/compression_dictionary.h>
+#include <util/zstd_decompressor.h>
+
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace channel {
+namespace {
+
+constexpr u32 max_data_length = 16 * 1024;
+
+// Keeps everything sent through it.
+class StringChannel : public Channel {
+public:
+  std::error_code send(const u8 *data, int data_len) override
+  {
+    sent.append(reinterpret_cast<char const *>(data), data_len);
+    return {};
+  }
+
+  bool is_open() const override { return true; }
+
+  std::string sent;
+};
+
+std::size_t send(ZstdChannel &channel, StringChannel &downstream, std::string_view data)
+{
+  auto const before = downstream.sent.size();
+  EXPECT_FALSE(channel.send(reinterpret_cast<u8 const *>(data.data()), data.size()));
+  return downstream.sent.size() - before;
+}
+
+// Decompresses all of |compressed|, into an output buffer of |capacity| bytes.
+std::string decompress(std::string_view compressed, std::size_t capacity = max_data_length)
+{
+  ZstdDecompressor decompressor(capacity);
+  std::string out;
+
+  auto const *data = reinterpret_cast<u8 const *>(compressed.data());
+  std::size_t left = compressed.size();
+  bool output_full = false;
+  // a full output buffer may hold back data, which comes out of process()
+  // even without more input
+  while (left > 0 || output_full) {
+    std::size_t consumed = 0;
+    auto const error = decompressor.process(data, left, &consumed);
+    EXPECT_EQ(0u, error) << decompressor.error_name(error);
+    if (error) {
+      break;
+    }
+    if (consumed == 0 && decompressor.output_buf_size() == 0) {
+      ADD_FAILURE() << "no progress decompressing";
+      break;
+    }
+    data += consumed;
+    left -= consumed;
+    output_full = (decompressor.output_buf_size() == capacity);
+
+    out.append(reinterpret_cast<char const *>(decompressor.output_buf()), decompressor.output_buf_size());
+    decompressor.discard(decompressor.output_buf_size());
+  }
+
+  return out;
+}
+
+std::string message(int i)
+{
+  return "process_steady_state pid=" + std::to_string(1000 + i) + " comm=nginx-worker cgroup=/kubepods/burstable/pod" +
+         std::to_string(i * 7919);
+}
+
+} // namespace
+
+TEST(zstd_channel, passes_through_when_disabled)
+{
+  StringChannel downstream;
+  ZstdChannel channel(downstream, max_data_length);
+
+  send(channel, downstream, "uncompressed");
+  EXPECT_EQ("uncompressed", downstream.sent);
+}
+
+TEST(zstd_channel, round_trip)
+{
+  StringChannel downstream;
+  ZstdChannel channel(downstream, max_data_length);
+  channel.set_compression(true);
+
+  std::string expected;
+  for (int i = 0; i < 100; ++i) {
+    auto const data = message(i);
+    // each send can be decompressed as soon as it is received
+    EXPECT_LT(0u, send(channel, downstream, data));
+    EXPECT_EQ(expected + data, decompress(downstream.sent));
+    expected += data;
+  }
+
+  ASSERT_LE(ZstdDecompressor::MAGIC_SIZE, downstream.sent.size());
+  EXPECT_TRUE(ZstdDecompressor::is_frame_start(reinterpret_cast<u8 const *>(downstream.sent.data())));
+  EXPECT_EQ(compression_dictionary_id(), ZSTD_getDictID_fromFrame(downstream.sent.data(), downstream.sent.size()));
+}
+
+TEST(zstd_channel, compresses_across_sends)
+{
+  StringChannel downstream;
+  ZstdChannel channel(downstream, max_data_length);
+  channel.set_compression(true);
+
+  std::string data(1024, 'x');
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>((i * 2654435761u) >> 13);
+  }
+
+  auto const first = send(channel, downstream, data);
+  auto const second = send(channel, downstream, data);
+  EXPECT_LT(second * 4, first);
+  EXPECT_EQ(data + data, decompress(downstream.sent));
+}
+
+TEST(zstd_channel, round_trip_through_small_output_buffer)
+{
+  StringChannel downstream;
+  ZstdChannel channel(downstream, max_data_length);
+  channel.set_compression(true);
+
+  std::string expected;
+  for (int i = 0; i < 100; ++i) {
+    auto const data = message(i);
+    send(channel, downstream, data);
+    expected += data;
+  }
+
+  // compresses to a few bytes, so the input is used up long before the output
+  std::string const last(max_data_length, 'x');
+  send(channel, downstream, last);
+  expected += last;
+
+  EXPECT_EQ(expected, decompress(downstream.sent, 1024));
+}
+
+TEST(zstd_channel, reset_starts_a_new_frame)
+{
+  StringChannel downstream;
+  ZstdChannel channel(downstream, max_data_length);
+  channel.set_compression(true);
+
+  send(channel, downstream, message(1));
+  channel.set_level(1);
+  auto const offset = downstream.sent.size();
+  send(channel, downstream, message(2));
+
+  std::string_view const second = std::string_view(downstream.sent).substr(offset);
+  EXPECT_TRUE(ZstdDecompressor::is_frame_start(reinterpret_cast<u8 const *>(second.data())));
+  EXPECT_EQ(message(2), decompress(second));
+}
+
+} // namespace channel
@@ -51,6 +51,8 @@ BPFHandler::BPFHandler(
 
 BPFHandler::~BPFHandler()
 {
+  // unwinds a paced dump that hasn't finished, while everything it uses is still there
+  paced_dump_.reset();
   probe_handler_.cleanup_probes();
   probe_handler_.cleanup_tail_calls(bpf_skel_);
   buf_poller_.reset();
@@ -86,7 +88,38 @@ void BPFHandler::load_buffered_poller(
   last_lost_count_ = serv_lost_count();
 }
 
-void BPFHandler::load_probes(::ebpf_net::ingest::Writer &writer)
+void BPFHandler::load_probes(
+    ::ebpf_net::ingest::Writer &writer, bool pace_dump, std::function<void(std::exception_ptr)> done_cb)
+{
+  auto const poll = [this]() { buf_poller_->start(1, 1); };
+
+  if (!pace_dump) {
+    std::exception_ptr error;
+    try {
+      load_probes_internal(writer, poll);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    done_cb(error);
+    return;
+  }
+
+  paced_dump_ = std::make_unique<PacedDump>(
+      loop_,
+      DUMP_PACING_WORK,
+      DUMP_PACING_PAUSE,
+      poll,
+      [this, &writer, poll]() {
+        load_probes_internal(writer, [this, poll]() {
+          poll();
+          paced_dump_->checkpoint();
+        });
+      },
+      std::move(done_cb));
+  paced_dump_->start();
+}
+
+void BPFHandler::load_probes_internal(::ebpf_net::ingest::Writer &writer, std::function<void()> const &dump_periodic_cb)
 {
   probe_handler_.load_kernel_symbols();
 
@@ -94,7 +127,7 @@ void BPFHandler::load_probes(::ebpf_net::ingest::Writer &writer)
       probe_handler_,
       bpf_skel_,
       host_info_,
-      [this]() { buf_poller_->start(1, 1); },
+      dump_periodic_cb,
       [this](std::string error_loc) { check_cb(error_loc); });
 
   if (cgroup_prober.error_count() > 0) {
@@ -105,7 +138,7 @@ void BPFHandler::load_probes(::ebpf_net::ingest::Writer &writer)
   ProcessProber process_prober(
       probe_handler_,
       bpf_skel_,
-      [this]() { buf_poller_->start(1, 1); },
+      dump_periodic_cb,
       [this](std::string error_loc) { check_cb(error_loc); });
 
   NatProber nat_prober(probe_handler_, bpf_skel_, [this]() { buf_poller_->start(1, 1); });
@@ -134,10 +167,10 @@ void BPFHandler::load_probes(::ebpf_net::ingest::Writer &writer)
   probe_handler_.start_probe(bpf_skel_, dns_probe_alternatives);
 
   // Start instrumentation for sockets
-  SocketProber socket_prober(
+  socket_prober_.emplace(
       probe_handler_,
       bpf_skel_,
-      [this]() { buf_poller_->start(1, 1); },
+      dump_periodic_cb,
       [this](std::string error_loc) { check_cb(error_loc); },
       log_);
 
@@ -189,6 +222,9 @@ void BPFHandler::load_probes(::ebpf_net::ingest::Writer &writer)
   probe_handler_.register_tail_call(bpf_skel_, "tail_calls", TAIL_CALL_HANDLE_RECEIVE_UDP_SKB__2, "handle_receive_udp_skb__2");
   probe_handler_.register_tail_call(bpf_skel_, "tail_calls", TAIL_CALL_CONTINUE_TCP_SENDMSG, "continue_tcp_sendmsg");
   probe_handler_.register_tail_call(bpf_skel_, "tail_calls", TAIL_CALL_CONTINUE_TCP_RECVMSG, "continue_tcp_recvmsg");
+  if (probe_handler_.dns_parse_in_kernel()) {
+    probe_handler_.register_tail_call(bpf_skel_, "tail_calls", TAIL_CALL_PARSE_DNS, "handle_parse_dns");
+  }
 
   // udp v4 send statistics and dns requests
   ProbeAlternatives udp_v4_alternatives{
@@ -247,6 +283,31 @@ void BPFHandler::load_probes(::ebpf_net::ingest::Writer &writer)
 void BPFHandler::start_poll(u64 interval_useconds, u64 n_intervals)
 {
   buf_poller_->start(interval_useconds, n_intervals);
+
+  if (buf_poller_->resync_pending()) {
+    resync_sockets();
+  }
+}
+
+std::chrono::milliseconds BPFHandler::poll_interval() const
+{
+  return buf_poller_->poll_interval();
+}
+
+void BPFHandler::resync_sockets()
+{
+  u64 const start = monotonic();
+
+  auto periodic_cb = [this]() { buf_poller_->start(1, 1); };
+
+  u64 const rewalk_count = buf_poller_->reconcile_sockets(periodic_cb);
+  if (rewalk_count > 0) {
+    socket_prober_->probe_existing_sockets(
+        probe_handler_, bpf_skel_, periodic_cb, [this](std::string error_loc) { check_cb(error_loc); });
+    periodic_cb();
+  }
+
+  buf_poller_->resync_completed(monotonic() - start);
 }
 
 void BPFHandler::slow_poll()
@@ -9,13 +9,19 @@
 #include <platform/platform.h>
 
 #include <collector/kernel/buffered_poller.h>
+#include <collector/kernel/paced_dump.h>
 #include <collector/kernel/probe_handler.h>
+#include <collector/kernel/socket_prober.h>
 #include <generated/ebpf_net/ingest/encoder.h>
 #include <util/curl_engine.h>
 #include <util/logger.h>
 #include <uv.h>
 
+#include <chrono>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <optional>
 
 // Forward declaration for the skeleton
 struct render_bpf_bpf;
@@ -58,15 +64,33 @@ public:
 
   /**
    * Loads BPF probes. Takes writer to send out steady_state msgs
-   * where necessary.
+   * where necessary. Calls `done_cb` once the probes are loaded, with the
+   * exception thrown while loading them, if any.
+   *
+   * If `pace_dump` is true, the dump of existing cgroups, processes and
+   * sockets is slowed down, as the reducer asks during reconnect storms: it
+   * runs for DUMP_PACING_WORK at a time, then the loop runs and polls the rings
+   * for DUMP_PACING_PAUSE. `done_cb` is then called from the loop, after this
+   * function has returned.
    */
-  void load_probes(::ebpf_net::ingest::Writer &writer);
+  void load_probes(
+      ::ebpf_net::ingest::Writer &writer, bool pace_dump, std::function<void(std::exception_ptr)> done_cb);
+
+  static constexpr std::chrono::milliseconds DUMP_PACING_WORK{10};
+  static constexpr std::chrono::milliseconds DUMP_PACING_PAUSE{30};
 
   /**
-   * Calls start(interval_useconds, n_intervals) on buf_poller_
+   * Calls start(interval_useconds, n_intervals) on buf_poller_, then resyncs
+   * sockets if BPF samples were lost
    */
   void start_poll(u64 interval_useconds, u64 n_intervals);
 
+  /**
+   * Returns how long to wait until the next start_poll(), adapted to how full
+   * the perf rings have been
+   */
+  std::chrono::milliseconds poll_interval() const;
+
   /**
    * Calls less frequent cleanup operations on buf_poller_
    */
@@ -90,12 +114,26 @@ public:
 #endif
 
 private:
+  /**
+   * Loads BPF probes and dumps existing state, calling `dump_periodic_cb`
+   * every once in a while during the dump
+   */
+  void load_probes_internal(::ebpf_net::ingest::Writer &writer, std::function<void()> const &dump_periodic_cb);
+
+  /**
+   * Recovers from lost BPF samples by reconciling socket tables with BPF's,
+   * and re-walking existing sockets whose creation events were lost
+   */
+  void resync_sockets();
+
   uv_loop_t &loop_;
   ProbeHandler probe_handler_;
   struct render_bpf_bpf *bpf_skel_;
   PerfContainer perf_;
   ::ebpf_net::ingest::Encoder *encoder_;
   std::unique_ptr<BufferedPoller> buf_poller_;
+  std::optional<SocketProber> socket_prober_;
+  std::unique_ptr<PacedDump> paced_dump_;
   bool enable_http_metrics_;
   FileDescriptor &bpf_dump_file_;
   logging::Logger &log_;
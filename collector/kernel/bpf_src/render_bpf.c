@@ -7,6 +7,9 @@
 volatile const long boot_time_adjustment = 0;
 volatile const long filter_ns = 1000000000;    // Default 1 second in nanoseconds
 volatile const int enable_tcp_data_stream = 0; // Set to 1 to enable TCP data stream processing
+volatile const int use_ringbuf = 0;            // Set to 1 to send events through events_ringbuf instead of events
+volatile const int tcp_stats_in_kernel = 0;    // Set to 1 to accumulate TCP statistics in tcp_open_sockets
+volatile const int dns_parse_in_kernel = 0;    // Set to 1 to parse DNS packets into dns_record messages
 
 #include <vmlinux.h>
 
@@ -58,6 +61,26 @@ struct {
   __uint(key_size, sizeof(u32));
   __uint(value_size, sizeof(u32));
 } events SEC(".maps");
+
+// Events - single ring buffer shared by all CPUs, used instead of `events` when `use_ringbuf` is set (kernel 5.8+).
+// Userland doesn't create this map when it isn't used.
+struct {
+  __uint(type, BPF_MAP_TYPE_RINGBUF);
+  __uint(max_entries, EVENTS_RINGBUF_N_BYTES);
+} events_ringbuf SEC(".maps");
+
+// Number of events dropped because events_ringbuf was full
+u64 events_ringbuf_lost = 0;
+
+// Stats epoch for in-kernel TCP statistics: userland bumps it when it drains tcp_open_sockets, starting a new interval
+u32 tcp_stats_epoch = 1;
+
+// Flags for committing to events_ringbuf: only wake up userland once enough data is waiting, like the perf ring watermark
+static __always_inline u64 events_ringbuf_wakeup_flags(void)
+{
+  return bpf_ringbuf_query(&events_ringbuf, BPF_RB_AVAIL_DATA) >= EVENTS_RINGBUF_WAKEUP_BYTES ? BPF_RB_FORCE_WAKEUP
+                                                                                                : BPF_RB_NO_WAKEUP;
+}
 #include "ebpf_net/agent_internal/bpf.h"
 
 // Common utility functions
@@ -89,21 +112,6 @@ static inline u32 packets_in_flight_helper(struct sock *sk)
   return t.packets_out - (t.sacked_out + t.lost_out) + t.retrans_out;
 }
 
-/**
- * Tracking open sockets
- */
-struct tcp_open_socket_t {
-  u32 tgid;
-  u32 rcv_holes;
-  u64 last_output;
-  u64 bytes_received; /* last observed */
-  u32 rcv_delivered;
-  u32 padding;
-#if TCP_STATS_ON_PARENT
-  struct sock *parent; /* parent listen socket if accepted, null otherwise */
-#endif
-};
-
 struct udp_stats_t {
   u64 last_output;
   u32 laddr6[4];
@@ -544,18 +552,24 @@ static inline u32 tcp_get_delivered(struct sock *sk)
   }
 }
 
-static inline void
-report_rtt_estimator(struct pt_regs *ctx, struct sock *sk, struct tcp_open_socket_t *sk_info, u64 now, bool adjust)
+static inline u32 tcp_get_rcv_rtt_us(struct sock *sk)
 {
-  int ret;
-  sk_info->last_output = now; // update the time in place
-
   u32 rcv_rtt_us = 0;
   if (LINUX_KERNEL_VERSION < KERNEL_VERSION(4, 12, 0)) {
     bpf_probe_read(&rcv_rtt_us, sizeof(rcv_rtt_us), &((struct tcp_sock___rcv_rtt_est_rtt *)tcp_sk(sk))->rcv_rtt_est.rtt);
   } else {
     bpf_probe_read(&rcv_rtt_us, sizeof(rcv_rtt_us), &tcp_sk(sk)->rcv_rtt_est.rtt_us);
   }
+  return rcv_rtt_us;
+}
+
+static inline void
+report_rtt_estimator(struct pt_regs *ctx, struct sock *sk, struct tcp_open_socket_t *sk_info, u64 now, bool adjust)
+{
+  int ret;
+  sk_info->last_output = now; // update the time in place
+
+  u32 rcv_rtt_us = tcp_get_rcv_rtt_us(sk);
 
   // These values need to be taken from bpf_probe_read
   u32 srtt = 0;
@@ -608,6 +622,16 @@ report_rtt_estimator(struct pt_regs *ctx, struct sock *sk, struct tcp_open_socke
     bytes_received &= ~3ull;
   }
 
+  // in-kernel statistics not drained yet: include this interval's maxima
+  if (tcp_stats_in_kernel && sk_info->stats_epoch == tcp_stats_epoch) {
+    if (sk_info->stats_max_srtt > srtt) {
+      srtt = sk_info->stats_max_srtt;
+    }
+    if (sk_info->stats_max_rcv_rtt > rcv_rtt_us) {
+      rcv_rtt_us = sk_info->stats_max_rcv_rtt;
+    }
+  }
+
   perf_submit_agent_internal__rtt_estimator(
       ctx,
       now,
@@ -2063,8 +2087,40 @@ int handle_receive_udp_skb__2(struct pt_regs *ctx)
 
 ////////////////////////////////////////////////////////////////////////////////////
 /* LIVE TCP */
+// accumulates TCP statistics in the socket's tcp_open_sockets entry, for userland to drain once per stats interval
+static void update_tcp_stats(struct pt_regs *ctx, struct sock *sk, struct tcp_open_socket_t *sk_info)
+{
+  u32 const epoch = tcp_stats_epoch;
+  u32 const srtt = BPF_CORE_READ(tcp_sk(sk), srtt_us);
+  u32 const rcv_rtt_us = tcp_get_rcv_rtt_us(sk);
+
+  if (sk_info->stats_epoch != epoch) {
+    // first update since userland drained this socket: start new maxima
+    sk_info->stats_epoch = epoch;
+    sk_info->stats_max_srtt = srtt;
+    sk_info->stats_max_rcv_rtt = rcv_rtt_us;
+  } else {
+    if (srtt > sk_info->stats_max_srtt) {
+      sk_info->stats_max_srtt = srtt;
+    }
+    if (rcv_rtt_us > sk_info->stats_max_rcv_rtt) {
+      sk_info->stats_max_rcv_rtt = rcv_rtt_us;
+    }
+  }
+
+  sk_info->stats_bytes_acked = BPF_CORE_READ(tcp_sk(sk), bytes_acked);
+  sk_info->stats_bytes_received = BPF_CORE_READ(tcp_sk(sk), bytes_received);
+  sk_info->stats_delivered = tcp_get_delivered(sk);
+  sk_info->stats_retrans = BPF_CORE_READ(tcp_sk(sk), total_retrans);
+}
+
 static void report_rtt_estimator_if_time(struct pt_regs *ctx, struct sock *sk, struct tcp_open_socket_t *sk_info)
 {
+  if (tcp_stats_in_kernel) {
+    update_tcp_stats(ctx, sk, sk_info);
+    return;
+  }
+
   u64 now = get_timestamp();
 
   if ((now - sk_info->last_output) < filter_ns)
@@ -2073,6 +2129,40 @@ static void report_rtt_estimator_if_time(struct pt_regs *ctx, struct sock *sk, s
   report_rtt_estimator(ctx, sk, sk_info, now, false);
 }
 
+// Probes on the TCP receive path have two flavours: kprobes, which read the socket from pt_regs, and fentry programs
+// (BPF trampolines, 5.5+ with kernel BTF), which get typed arguments and avoid the kprobe breakpoint. Userland loads the
+// fentry flavour when the kernel supports it, and falls back to the kprobe per function.
+
+static __always_inline void
+handle_tcp_rtt_estimator(struct pt_regs *ctx, struct sock *sk, struct tcp_open_socket_t *sk_info)
+{
+  report_rtt_estimator_if_time(ctx, sk, sk_info);
+}
+
+static __always_inline void
+handle_tcp_rcv_established(struct pt_regs *ctx, struct sock *sk, struct tcp_open_socket_t *sk_info, u64 bytes_received)
+{
+  if (bytes_received != sk_info->bytes_received) {
+    /* update statistic for next report */
+    sk_info->rcv_holes++;
+    sk_info->rcv_delivered++;
+
+    /* update the bytes_received so we won't report this occurrence again */
+    sk_info->bytes_received = bytes_received;
+
+    report_rtt_estimator_if_time(ctx, sk, sk_info);
+  }
+}
+
+static __always_inline void
+handle_tcp_event_data_recv(struct pt_regs *ctx, struct sock *sk, struct tcp_open_socket_t *sk_info, u64 bytes_received)
+{
+  sk_info->rcv_delivered++;
+  sk_info->bytes_received = bytes_received;
+
+  report_rtt_estimator_if_time(ctx, sk, sk_info);
+}
+
 SEC("kprobe/tcp_rtt_estimator")
 int on_tcp_rtt_estimator(struct pt_regs *ctx)
 {
@@ -2090,7 +2180,24 @@ int on_tcp_rtt_estimator(struct pt_regs *ctx)
     return 0;
   }
 
-  report_rtt_estimator_if_time(ctx, sk, sk_info);
+  handle_tcp_rtt_estimator(ctx, sk, sk_info);
+
+  return 0;
+}
+
+SEC("fentry/tcp_rtt_estimator")
+int BPF_PROG(on_tcp_rtt_estimator__fentry, struct sock *sk)
+{
+  if (sk->sk_state != TCP_ESTABLISHED) {
+    return 0;
+  }
+
+  struct tcp_open_socket_t *sk_info = bpf_map_lookup_elem(&tcp_open_sockets, &sk);
+  if (!sk_info) {
+    return 0;
+  }
+
+  handle_tcp_rtt_estimator((struct pt_regs *)ctx, sk, sk_info);
 
   return 0;
 }
@@ -2115,17 +2222,22 @@ int on_tcp_rcv_established(struct pt_regs *ctx)
     return 0;
   }
 
-  if (bytes_received != sk_info->bytes_received) {
-    /* update statistic for next report */
-    sk_info->rcv_holes++;
-    sk_info->rcv_delivered++;
+  handle_tcp_rcv_established(ctx, sk, sk_info, bytes_received);
 
-    /* update the bytes_received so we won't report this occurrence again */
-    sk_info->bytes_received = bytes_received;
+  return 0;
+}
 
-    report_rtt_estimator_if_time(ctx, sk, sk_info);
+SEC("fentry/tcp_rcv_established")
+int BPF_PROG(on_tcp_rcv_established__fentry, struct sock *sk)
+{
+  struct tcp_open_socket_t *sk_info = bpf_map_lookup_elem(&tcp_open_sockets, &sk);
+  if (!sk_info) {
+    return 0;
   }
 
+  // bpf_skc_to_tcp_sock would allow a direct load, but it needs 5.9+ while fentry programs load on 5.5+
+  handle_tcp_rcv_established((struct pt_regs *)ctx, sk, sk_info, BPF_CORE_READ(tcp_sk(sk), bytes_received));
+
   return 0;
 }
 
@@ -2149,10 +2261,20 @@ int on_tcp_event_data_recv(struct pt_regs *ctx)
     return 0;
   }
 
-  sk_info->rcv_delivered++;
-  sk_info->bytes_received = bytes_received;
+  handle_tcp_event_data_recv(ctx, sk, sk_info, bytes_received);
 
-  report_rtt_estimator_if_time(ctx, sk, sk_info);
+  return 0;
+}
+
+SEC("fentry/tcp_event_data_recv")
+int BPF_PROG(on_tcp_event_data_recv__fentry, struct sock *sk)
+{
+  struct tcp_open_socket_t *sk_info = bpf_map_lookup_elem(&tcp_open_sockets, &sk);
+  if (!sk_info) {
+    return 0;
+  }
+
+  handle_tcp_event_data_recv((struct pt_regs *)ctx, sk, sk_info, BPF_CORE_READ(tcp_sk(sk), bytes_received));
 
   return 0;
 }
@@ -2252,8 +2374,237 @@ struct {
   __type(key, __u32);
   __type(value, struct dns_message_data);
 } dns_message_array SEC(".maps");
+
+// DNS header and record layout (RFC 1035)
+#define DNS_HEADER_LEN 12
+#define DNS_QUESTION_FIXED_LEN 4
+#define DNS_RR_FIXED_LEN 10
+#define DNS_NAME_WIRE_MAX_LEN 255
+#define DNS_CLASS_IN 1
+#define DNS_TYPE_A 1
+#define DNS_TYPE_CNAME 5
+#define DNS_TYPE_AAAA 28
+
+// dns_record messages carry the question name and up to DNS_RECORD_MAX_ANSWERS addresses; the verifier bounds A and AAAA
+// answers separately, so the record has room for both maxima
+#define DNS_RECORD_NAME_MAX_LEN 256
+#define DNS_RECORD_ADDRS_MAX_LEN (DNS_RECORD_MAX_ANSWERS * (4 + 16))
+
+// DNS packet copied by perf_check_and_submit_dns, handed to the handle_parse_dns tail call
+struct dns_parse_state {
+  u64 sk;
+  u32 total_len;
+  u32 valid_len;
+  u8 is_rx;
+  u32 ipv4_addrs[DNS_RECORD_MAX_ANSWERS];
+  u8 ipv6_addrs[DNS_RECORD_MAX_ANSWERS][16];
+  char record[sizeof(struct bpf_agent_internal__dns_record) + DNS_RECORD_NAME_MAX_LEN + DNS_RECORD_ADDRS_MAX_LEN + 16];
+};
+struct {
+  __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+  __uint(max_entries, 1);
+  __type(key, __u32);
+  __type(value, struct dns_parse_state);
+} dns_parse_state_array SEC(".maps");
 #pragma passthrough off
 
+// Sends a DNS packet copied into buf as a dns_packet message, for userland to parse
+static __always_inline void
+submit_dns_packet(struct pt_regs *ctx, char *buf, struct sock *sk, unsigned int len, unsigned int valid_len, int is_rx)
+{
+  char *to = buf + bpf_agent_internal__dns_packet__data_size;
+
+  struct bpf_agent_internal__dns_packet *const msg = (struct bpf_agent_internal__dns_packet *)&buf[0];
+  struct jb_blob blob = {to, valid_len};
+  bpf_fill_agent_internal__dns_packet(msg, get_timestamp(), (u64)sk, blob, len, is_rx);
+
+  u32 const perf_size = ((DNS_MAX_PACKET_LEN + sizeof(struct jb_agent_internal__dns_packet) + 8 + 7) / 8) * 8 + 4;
+  if (use_ringbuf) {
+    // ring buffer records keep the leading u32, in place of the size perf adds to raw samples
+    if (bpf_ringbuf_output(&events_ringbuf, msg, perf_size + sizeof(u32), events_ringbuf_wakeup_flags()) != 0) {
+      __sync_fetch_and_add(&events_ringbuf_lost, 1);
+    }
+    return;
+  }
+
+  bpf_perf_event_output(ctx, &events, BPF_F_CURRENT_CPU, &msg->unpadded_size, perf_size);
+}
+
+static __always_inline u16 dns_read_u16(const unsigned char *pkt, u32 off)
+{
+  return ((u16)pkt[off & (DNS_MAX_PACKET_LEN - 1)] << 8) | pkt[(off + 1) & (DNS_MAX_PACKET_LEN - 1)];
+}
+
+// Parses a DNS query or response into state->record, the way dns_parse_query and dns_parse_a_aaaa_reply would.
+// Returns the record's perf size, or 0 if the packet has to go to userland instead: truncated packets, compressed
+// question names, names dns_parse_query would escape, and answers whose name can't be matched by offset.
+static __always_inline u32 parse_dns_record(struct dns_parse_state *state, const unsigned char *pkt)
+{
+  u32 const len = state->valid_len;
+  if (len < DNS_HEADER_LEN) {
+    return 0;
+  }
+
+  u16 const qid = dns_read_u16(pkt, 0);
+  u8 const is_response = pkt[2] >> 7;
+  u16 const qdcount = dns_read_u16(pkt, 4);
+  u16 const ancount = dns_read_u16(pkt, 6);
+  u16 const nscount = dns_read_u16(pkt, 8);
+  if (qdcount != 1 || (!is_response && (ancount != 0 || nscount != 0)) || ancount > DNS_RECORD_MAX_ANSWERS) {
+    return 0;
+  }
+
+  // question name: labels are copied as dotted text, hashed along the way
+  char *name = state->record + bpf_agent_internal__dns_record__data_size;
+  u32 name_len = 0;
+  u64 name_hash = DNS_NAME_HASH_OFFSET_BASIS;
+  u32 off = DNS_HEADER_LEN;
+  u32 label_remaining = 0;
+  bool name_done = false;
+  for (int i = 0; i < DNS_NAME_WIRE_MAX_LEN; i++) {
+    if (off >= len) {
+      return 0;
+    }
+    u8 c = pkt[off & (DNS_MAX_PACKET_LEN - 1)];
+    off++;
+    if (label_remaining == 0) {
+      if (c == 0) {
+        name_done = true;
+        break;
+      }
+      if (c & 0xc0) {
+        return 0;
+      }
+      label_remaining = c;
+      if (name_len == 0) {
+        continue;
+      }
+      c = '.';
+    } else {
+      if (c == '.' || c == '\\') {
+        return 0;
+      }
+      label_remaining--;
+    }
+    name[name_len & (DNS_RECORD_NAME_MAX_LEN - 1)] = c;
+    name_len++;
+    name_hash = (name_hash ^ c) * DNS_NAME_HASH_PRIME;
+  }
+  if (!name_done || name_len >= DNS_RECORD_NAME_MAX_LEN || off + DNS_QUESTION_FIXED_LEN > len) {
+    return 0;
+  }
+  u16 const qtype = dns_read_u16(pkt, off);
+  off += DNS_QUESTION_FIXED_LEN;
+
+  // answers: A and AAAA records for the question name, following CNAMEs
+  u32 num_ipv4_addrs = 0;
+  u32 num_ipv6_addrs = 0;
+  u32 canonical_name_off = DNS_HEADER_LEN;
+  for (int i = 0; i < DNS_RECORD_MAX_ANSWERS; i++) {
+    if (i >= ancount) {
+      break;
+    }
+    if (off + 2 + DNS_RR_FIXED_LEN > len) {
+      return 0;
+    }
+    u8 const ptr = pkt[off & (DNS_MAX_PACKET_LEN - 1)];
+    if ((ptr & 0xc0) != 0xc0) {
+      return 0;
+    }
+    u32 const rr_name_off = dns_read_u16(pkt, off) & 0x3fff;
+    u16 const rr_type = dns_read_u16(pkt, off + 2);
+    u16 const rr_class = dns_read_u16(pkt, off + 4);
+    u16 const rr_len = dns_read_u16(pkt, off + 10);
+    off += 2 + DNS_RR_FIXED_LEN;
+    if (off + rr_len > len) {
+      return 0;
+    }
+
+    if (rr_class == DNS_CLASS_IN && (rr_type == DNS_TYPE_A || rr_type == DNS_TYPE_AAAA)) {
+      if (rr_name_off != canonical_name_off) {
+        return 0;
+      }
+      if (rr_type == DNS_TYPE_A && rr_len == 4) {
+        bpf_probe_read_kernel(
+            &state->ipv4_addrs[num_ipv4_addrs & (DNS_RECORD_MAX_ANSWERS - 1)], 4, pkt + (off & (DNS_MAX_PACKET_LEN - 1)));
+        num_ipv4_addrs++;
+      } else if (rr_type == DNS_TYPE_AAAA && rr_len == 16) {
+        bpf_probe_read_kernel(
+            &state->ipv6_addrs[num_ipv6_addrs & (DNS_RECORD_MAX_ANSWERS - 1)], 16, pkt + (off & (DNS_MAX_PACKET_LEN - 1)));
+        num_ipv6_addrs++;
+      }
+    } else if (rr_class == DNS_CLASS_IN && rr_type == DNS_TYPE_CNAME) {
+      // later records are for the canonical name, which is either pointed to or spelled out in the data
+      u8 const data_ptr = pkt[off & (DNS_MAX_PACKET_LEN - 1)];
+      canonical_name_off = ((data_ptr & 0xc0) == 0xc0 && rr_len == 2) ? (dns_read_u16(pkt, off) & 0x3fff) : off;
+    }
+
+    off += rr_len;
+  }
+
+  // addresses follow the name in the record
+  if (num_ipv4_addrs > DNS_RECORD_MAX_ANSWERS || num_ipv6_addrs > DNS_RECORD_MAX_ANSWERS) {
+    return 0;
+  }
+  u32 const ipv4_len = num_ipv4_addrs * 4;
+  u32 const ipv6_len = num_ipv6_addrs * 16;
+  char *addrs = name + (name_len & (DNS_RECORD_NAME_MAX_LEN - 1));
+  bpf_probe_read_kernel(addrs, ipv4_len, state->ipv4_addrs);
+  bpf_probe_read_kernel(addrs + ipv4_len, ipv6_len, state->ipv6_addrs);
+
+  struct bpf_agent_internal__dns_record *const msg = (struct bpf_agent_internal__dns_record *)state->record;
+  struct jb_blob name_blob = {name, name_len};
+  struct jb_blob addrs_blob = {addrs, ipv4_len + ipv6_len};
+  bpf_fill_agent_internal__dns_record(
+      msg,
+      get_timestamp(),
+      state->sk,
+      name_hash,
+      qid,
+      qtype,
+      state->total_len,
+      state->is_rx,
+      is_response,
+      num_ipv4_addrs,
+      num_ipv6_addrs,
+      name_blob,
+      addrs_blob);
+
+  return ((msg->jb._len + 8 + 7) / 8) * 8 + 4;
+}
+
+// Tail call: parses the DNS packet left in dns_message_array by perf_check_and_submit_dns and sends a dns_record, or
+// sends the raw packet if it can't be parsed here
+SEC("kprobe")
+int handle_parse_dns(struct pt_regs *ctx)
+{
+  __u32 zero = 0;
+  struct dns_message_data *pkt = bpf_map_lookup_elem(&dns_message_array, &zero);
+  struct dns_parse_state *state = bpf_map_lookup_elem(&dns_parse_state_array, &zero);
+  if (pkt == NULL || state == NULL) {
+    bpf_log(ctx, BPF_LOG_BPF_CALL_FAILED, 0, 0, 0);
+    return 0;
+  }
+
+  u32 perf_size = parse_dns_record(state, (const unsigned char *)pkt->data + bpf_agent_internal__dns_packet__data_size);
+  if (perf_size == 0 || perf_size + sizeof(u32) > sizeof(state->record)) {
+    submit_dns_packet(
+        ctx, pkt->data, (struct sock *)state->sk, state->total_len, state->valid_len & (DNS_MAX_PACKET_LEN - 1), state->is_rx);
+    return 0;
+  }
+
+  struct bpf_agent_internal__dns_record *const msg = (struct bpf_agent_internal__dns_record *)state->record;
+  if (use_ringbuf) {
+    if (bpf_ringbuf_output(&events_ringbuf, msg, perf_size + sizeof(u32), events_ringbuf_wakeup_flags()) != 0) {
+      __sync_fetch_and_add(&events_ringbuf_lost, 1);
+    }
+    return 0;
+  }
+
+  bpf_perf_event_output(ctx, &events, BPF_F_CURRENT_CPU, &msg->unpadded_size, perf_size);
+  return 0;
+}
+
 // Depending on when the skb is inspected, the header may or may not be filled
 // in yet so we are passing in protocol and port components as parameters here
 // sport and dport are in -network byte order-
@@ -2352,20 +2703,21 @@ perf_check_and_submit_dns(struct pt_regs *ctx, struct sock *sk, struct sk_buff *
     /* the actual offset into buf has to start from buf's start */
     char *to = buf + bpf_agent_internal__dns_packet__data_size;
     bpf_probe_read_kernel(to, valid_len, from);
-  }
 
-  char *to = buf + bpf_agent_internal__dns_packet__data_size;
-
-  struct bpf_agent_internal__dns_packet *const msg = (struct bpf_agent_internal__dns_packet *)&buf[0];
-  struct jb_blob blob = {to, valid_len};
-  bpf_fill_agent_internal__dns_packet(msg, get_timestamp(), (u64)sk, blob, len, is_rx);
+    if (dns_parse_in_kernel) {
+      struct dns_parse_state *state = bpf_map_lookup_elem(&dns_parse_state_array, &zero);
+      if (state != NULL) {
+        state->sk = (u64)sk;
+        state->total_len = len;
+        state->valid_len = valid_len;
+        state->is_rx = is_rx;
+        bpf_tail_call(ctx, &tail_calls, TAIL_CALL_PARSE_DNS);
+        // the parser is not registered: send the raw packet
+      }
+    }
+  }
 
-  bpf_perf_event_output(
-      ctx,
-      &events,
-      BPF_F_CURRENT_CPU,
-      &msg->unpadded_size,
-      ((DNS_MAX_PACKET_LEN + sizeof(struct jb_agent_internal__dns_packet) + 8 + 7) / 8) * 8 + 4);
+  submit_dns_packet(ctx, buf, sk, len, valid_len, is_rx);
 }
 
 // - Receive UDP packets ---------------------------------------
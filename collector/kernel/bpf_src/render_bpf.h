@@ -25,6 +25,9 @@
 #define TABLE_SIZE__STACK_TRACES 16384   // Number of stack traces to keep in the table
 #define TABLE_SIZE__NIC_INFO_TABLE 128   // Info per network interface
 
+#define EVENTS_RINGBUF_N_BYTES (16 * 1024 * 1024)    // Size of the shared events ring buffer - power of 2 multiple of page size
+#define EVENTS_RINGBUF_WAKEUP_BYTES (2 * 1024 * 1024) // Wake up userland once this many bytes are waiting in the ring buffer
+
 #define WATERMARK_STACK_TRACES                                                                                                 \
   (TABLE_SIZE__STACK_TRACES - 256) // When to clear the table (unfortunately non-atomic, but that's a lot of stack traces...)
 
@@ -77,6 +80,35 @@
 // #define DEBUG_TCP_DATA 1
 // #define DEBUG_DATA_CHANNEL 1
 
+////////////////////////////////////////////////////////////////////////////
+// Tables shared with userland
+
+/**
+ * Tracking open sockets: value of the tcp_open_sockets table
+ *
+ * When tcp_stats_in_kernel is set, the stats_* fields accumulate TCP statistics in place of rtt_estimator events, and
+ * userland drains them from the table once per stats interval.
+ */
+struct tcp_open_socket_t {
+  u32 tgid;
+  u32 rcv_holes;
+  u64 last_output;
+  u64 bytes_received; /* last observed */
+  u32 rcv_delivered;
+  u32 padding;
+#if TCP_STATS_ON_PARENT
+  struct sock *parent; /* parent listen socket if accepted, null otherwise */
+#endif
+  u64 stats_bytes_acked;    /* as of the last update */
+  u64 stats_bytes_received; /* as of the last update */
+  u32 stats_delivered;      /* as of the last update */
+  u32 stats_retrans;        /* as of the last update */
+  u32 stats_max_srtt;       /* max over stats_epoch */
+  u32 stats_max_rcv_rtt;    /* max over stats_epoch */
+  u32 stats_epoch;          /* tcp_stats_epoch of the last update, 0 if never updated */
+  u32 stats_padding;
+};
+
 ////////////////////////////////////////////////////////////////////////////
 // BPF error report codes
 
@@ -127,7 +159,14 @@ enum BPF_TABLE_ID {
 #define TAIL_CALL_HANDLE_RECEIVE_UDP_SKB__2 5
 #define TAIL_CALL_CONTINUE_TCP_SENDMSG 6
 #define TAIL_CALL_CONTINUE_TCP_RECVMSG 7
-#define NUM_TAIL_CALLS 8
+#define TAIL_CALL_PARSE_DNS 8
+#define NUM_TAIL_CALLS 9
+
+// DNS packets parsed in BPF into dns_record messages
+#define DNS_RECORD_MAX_ANSWERS 16 // responses with more answers are sent as raw packets
+// FNV-1a over the question name, as dns_parse_query writes it
+#define DNS_NAME_HASH_OFFSET_BASIS 0xcbf29ce484222325ull
+#define DNS_NAME_HASH_PRIME 0x100000001b3ull
 
 #if _PROCESSING_BPF
 // Include this until we merge the tcp-processor code into render_bpf more closely
@@ -6,6 +6,7 @@
 #include <collector/kernel/buffered_poller.h>
 #include <collector/kernel/dns/ares.h>
 #include <collector/kernel/dns/dns.h>
+#include <collector/kernel/ingest_passthrough.h>
 #include <collector/kernel/kernel_collector_restarter.h>
 #include <collector/kernel/perf_reader.h>
 #include <collector/kernel/proc_cmdline.h>
@@ -19,6 +20,14 @@
 #include <generated/ebpf_net/agent_internal/wire_message.h>
 #include <generated/ebpf_net/ingest/wire_message.h>
 
+// Include the generated skeleton
+extern "C" {
+#include "generated/render_bpf.skel.h"
+}
+
+#include <absl/container/flat_hash_set.h>
+#include <bpf/bpf.h>
+#include <bpf/libbpf.h>
 #include <spdlog/common.h>
 #include <spdlog/fmt/bin_to_hex.h>
 
@@ -27,6 +36,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <string_view>
+#include <vector>
 
 constexpr u16 DNS_MAX_PACKET_LEN = 512;
 
@@ -36,6 +46,12 @@ static BufferedPoller *singleton_ = nullptr;
 
 static constexpr u64 DNS_TIMEOUT_TIME_NS = 10'000'000'000ull;
 
+/* number of tcp_open_sockets entries read per batched lookup when draining in-kernel TCP stats */
+static constexpr u32 TCP_STATS_DRAIN_BATCH = 4096;
+
+/* minimum time between socket resyncs after lost samples */
+static constexpr u64 SOCKET_RESYNC_MIN_INTERVAL_NS = 5'000'000'000ull;
+
 namespace {
 
 std::string_view comm_to_string(std::uint8_t const (&comm)[16])
@@ -44,6 +60,21 @@ std::string_view comm_to_string(std::uint8_t const (&comm)[16])
   return std::string_view(reinterpret_cast<char const *>(comm), length);
 }
 
+// returns the keys (socket pointers) of a BPF hash map keyed by `struct sock *`
+absl::flat_hash_set<u64> bpf_socket_map_keys(int map_fd)
+{
+  absl::flat_hash_set<u64> keys;
+  u64 key = 0;
+  u64 next_key;
+  void *prev_key = nullptr;
+  while (bpf_map_get_next_key(map_fd, prev_key, &next_key) == 0) {
+    keys.insert(next_key);
+    key = next_key;
+    prev_key = &key;
+  }
+  return keys;
+}
+
 } // namespace
 
 BufferedPoller::BufferedPoller(
@@ -78,6 +109,7 @@ BufferedPoller::BufferedPoller(
       tcp_socket_stats_(tslot_),
       udp_socket_table_ever_full_(false),
       udp_socket_stats_{{{tslot_}, {tslot_}}},
+      direct_encoding_(encoder == nullptr),
       all_probes_loaded_(false),
       kernel_collector_restarter_(kernel_collector_restarter)
 {
@@ -90,14 +122,18 @@ BufferedPoller::BufferedPoller(
 
     memset(handlers_, 0, sizeof(handlers_));
     add_handler<dns_packet_message_metadata, &BufferedPoller::handle_dns_message, DNS_MAX_PACKET_LEN + 16>();
+    add_handler<
+        dns_record_message_metadata,
+        &BufferedPoller::handle_dns_record,
+        DNS_NAME_MAX_LENGTH + DNS_RECORD_MAX_ANSWERS * sizeof(in6_addr) + 16>();
     add_handler<new_sock_created_message_metadata, &BufferedPoller::handle_new_socket>();
     add_handler<set_state_ipv4_message_metadata, &BufferedPoller::handle_set_state_ipv4>();
     add_handler<set_state_ipv6_message_metadata, &BufferedPoller::handle_set_state_ipv6>();
     add_handler<close_sock_info_message_metadata, &BufferedPoller::handle_close_socket>();
     add_handler<rtt_estimator_message_metadata, &BufferedPoller::handle_rtt_estimator>();
     add_handler<reset_tcp_counters_message_metadata, &BufferedPoller::handle_reset_tcp_counters>();
-    add_handler<tcp_syn_timeout_message_metadata, &BufferedPoller::handle_tcp_syn_timeout>();
-    add_handler<tcp_reset_message_metadata, &BufferedPoller::handle_tcp_reset>();
+    add_passthrough_handler<tcp_syn_timeout_message_metadata, &BufferedPoller::handle_tcp_syn_timeout>();
+    add_passthrough_handler<tcp_reset_message_metadata, &BufferedPoller::handle_tcp_reset>();
     add_handler<http_response_message_metadata, &BufferedPoller::handle_http_response>();
     add_handler<udp_new_socket_message_metadata, &BufferedPoller::handle_udp_new_socket>();
     add_handler<udp_destroy_socket_message_metadata, &BufferedPoller::handle_udp_destroy_socket>();
@@ -118,6 +154,19 @@ BufferedPoller::BufferedPoller(
     add_handler<tcp_data_message_metadata, &BufferedPoller::handle_tcp_data>();
   }
 
+  if (probe_handler_.tcp_stats_in_kernel()) {
+    struct bpf_map *map = probe_handler_.get_bpf_map(skel_, "tcp_open_sockets");
+    if (!map) {
+      throw std::runtime_error("BufferedPoller: cannot access tcp_open_sockets");
+    }
+    if (bpf_map__key_size(map) != sizeof(u64) || bpf_map__value_size(map) != sizeof(struct tcp_open_socket_t)) {
+      throw std::runtime_error("BufferedPoller: unexpected tcp_open_sockets layout");
+    }
+    tcp_open_sockets_fd_ = bpf_map__fd(map);
+    tcp_stats_keys_.resize(TCP_STATS_DRAIN_BATCH);
+    tcp_stats_values_.resize(TCP_STATS_DRAIN_BATCH);
+  }
+
   // Create a tcp data handler for the tcp_data message
   tcp_data_handler_ = std::make_unique<TCPDataHandler>(loop_, probe_handler_, skel, writer_, container, log_);
 
@@ -132,12 +181,25 @@ BufferedPoller::BufferedPoller(
 
 void BufferedPoller::handle_event()
 {
-  process_samples(true);
+  poll_rings(PollScheduler::Trigger::event);
 }
 
 void BufferedPoller::poll(void)
 {
-  process_samples(false);
+  poll_rings(PollScheduler::Trigger::timer);
+}
+
+void BufferedPoller::poll_rings(PollScheduler::Trigger trigger)
+{
+  poll_scheduler_.start_poll(trigger);
+  process_samples(trigger == PollScheduler::Trigger::event);
+
+  // a ring that was nearly full has likely filled up again while we were
+  // handling it: drain it now rather than risk losing events until the timer
+  while (poll_scheduler_.finish_poll()) {
+    poll_scheduler_.start_poll(PollScheduler::Trigger::early);
+    process_samples(false);
+  }
 }
 
 void BufferedPoller::process_samples(bool is_event)
@@ -145,6 +207,9 @@ void BufferedPoller::process_samples(bool is_event)
   u64 t = monotonic() + time_adjustment_;
   PerfReader reader(container_, t);
 
+  container_.for_each_fill_level(
+      [this](u32 used_bytes, u32 total_bytes) { poll_scheduler_.record_fill(used_bytes, total_bytes); });
+
   // in the case of event-driven poll, print debugging information to assist
   // with understanding the profile of the perf buffers
   if (is_event && is_log_whitelisted(AgentLogKind::PERF)) {
@@ -156,14 +221,28 @@ void BufferedPoller::process_samples(bool is_event)
   while (!reader.empty()) {
     auto peek_type = reader.peek_type();
 
-    auto handle_bpf_lost_samples = [this]() {
+    auto handle_bpf_lost_samples = [this, t]() {
       send_report_if_recent_loss();
-      log_.warn("Lost {} bpf samples - restarting kernel collector.", lost_count_);
-      kernel_collector_restarter_.request_restart();
+
+      if (!all_probes_loaded_) {
+        // probers haven't finished walking existing processes, cgroups and
+        // sockets, so there is no consistent state to resync against
+        log_.warn("Lost {} bpf samples during startup - restarting kernel collector.", lost_count_);
+        kernel_collector_restarter_.request_restart();
+        return;
+      }
+
+      if (!resync_pending_) {
+        log_.warn("Lost {} bpf samples - resyncing sockets.", lost_count_);
+        resync_pending_ = true;
+        loss_window_start_ = t;
+      }
+      loss_window_end_ = t;
     };
 
 #ifndef NDEBUG
     if (debug_bpf_lost_samples_) {
+      debug_bpf_lost_samples_ = false;
       lost_count_ += 1;
       handle_bpf_lost_samples();
       return;
@@ -199,18 +278,27 @@ void BufferedPoller::process_samples(bool is_event)
       reader.pop();
 
       handle_bpf_lost_samples();
-      return;
+      if (!all_probes_loaded_) {
+        return;
+      }
     } else {
       throw std::runtime_error("Unexpected record type\n");
     }
   }
 
+  /* send the NAT remappings coalesced during this poll, before any stats */
+  nat_handler_.flush_nat_remappings();
+
   /* do we need to process stats? */
   s16 relative = tcp_socket_stats_.relative_timeslot(t);
   if (relative != 0) {
+    if (tcp_open_sockets_fd_ >= 0) {
+      drain_tcp_stats();
+    }
     send_stats_from_queue(t);
     udp_send_stats_from_queue(t);
     send_report_if_recent_loss();
+    send_poll_stats();
   }
 
   // clear out buffer if there's still anything left
@@ -229,11 +317,132 @@ void BufferedPoller::send_report_if_recent_loss()
   notified_lost_count_ = lost_count_;
 }
 
+void BufferedPoller::send_poll_stats()
+{
+  auto const &stats = poll_scheduler_.stats();
+  static_assert(PollScheduler::N_FILL_BUCKETS == 4);
+
+  writer_.perf_poll_stats(
+      stats.fill_histogram[0],
+      stats.fill_histogram[1],
+      stats.fill_histogram[2],
+      stats.fill_histogram[3],
+      stats.timer_polls,
+      stats.event_wakeups,
+      stats.early_polls,
+      static_cast<u32>(poll_scheduler_.interval().count()));
+
+  poll_scheduler_.reset_stats();
+}
+
 u64 BufferedPoller::serv_lost_count()
 {
   return lost_count_;
 }
 
+bool BufferedPoller::resync_pending() const
+{
+  return resync_pending_ && (last_resync_time_ == 0 || monotonic() - last_resync_time_ >= SOCKET_RESYNC_MIN_INTERVAL_NS);
+}
+
+u64 BufferedPoller::reconcile_sockets(std::function<void(void)> const &periodic_cb)
+{
+  resync_pending_ = false;
+  resync_closed_sockets_ = 0;
+  resync_rewalked_sockets_ = 0;
+
+  struct bpf_map *tcp_map = probe_handler_.get_bpf_map(skel_, "tcp_open_sockets");
+  struct bpf_map *udp_map = probe_handler_.get_bpf_map(skel_, "udp_open_sockets");
+  if (!tcp_map || !udp_map) {
+    throw std::runtime_error("reconcile_sockets: cannot access BPF socket tables");
+  }
+  int const tcp_map_fd = bpf_map__fd(tcp_map);
+  int const udp_map_fd = bpf_map__fd(udp_map);
+
+  // snapshot our tables before BPF's: any socket in our snapshot was already
+  // in the BPF tables, so if BPF doesn't have it anymore its close event was
+  // sent before BPF's snapshot was taken, and will have been read by the
+  // next drain unless it was lost
+  periodic_cb();
+  std::vector<u64> tcp_known;
+  tcp_known.reserve(tcp_socket_table_.size());
+  for (auto const &entry : tcp_socket_table_) {
+    tcp_known.push_back(entry.first);
+  }
+  std::vector<u64> udp_known;
+  udp_known.reserve(udp_socket_table_.size());
+  for (auto const &entry : udp_socket_table_) {
+    udp_known.push_back(entry.first);
+  }
+
+  auto const bpf_tcp = bpf_socket_map_keys(tcp_map_fd);
+  auto const bpf_udp = bpf_socket_map_keys(udp_map_fd);
+  periodic_cb();
+
+  message_metadata metadata{.timestamp = monotonic() + time_adjustment_};
+
+  // lost close events
+  for (u64 sk : tcp_known) {
+    if (!bpf_tcp.contains(sk) && tcp_socket_table_.contains(sk)) {
+      LOG::debug_in(AgentLogKind::TCP, "reconcile_sockets: closing stale tcp socket sk={:x}", sk);
+      jb_agent_internal__close_sock_info msg = {.sk = sk};
+      handle_close_socket(metadata, msg);
+      ++resync_closed_sockets_;
+    }
+  }
+  for (u64 sk : udp_known) {
+    if (!bpf_udp.contains(sk) && udp_socket_table_.contains(sk)) {
+      LOG::debug_in(AgentLogKind::UDP, "reconcile_sockets: destroying stale udp socket sk={:x}", sk);
+      jb_agent_internal__udp_destroy_socket msg = {.sk = sk};
+      handle_udp_destroy_socket(metadata, msg);
+      ++resync_closed_sockets_;
+    }
+  }
+
+  // lost creation events: skip when our table was ever full, since BPF then
+  // legitimately tracks sockets we dropped
+  if (!tcp_socket_table_ever_full_) {
+    for (u64 sk : bpf_tcp) {
+      if (!tcp_socket_table_.contains(sk) && bpf_map_delete_elem(tcp_map_fd, &sk) == 0) {
+        LOG::debug_in(AgentLogKind::TCP, "reconcile_sockets: re-walking untracked tcp socket sk={:x}", sk);
+        ++resync_rewalked_sockets_;
+      }
+    }
+  }
+  if (!udp_socket_table_ever_full_) {
+    for (u64 sk : bpf_udp) {
+      if (!udp_socket_table_.contains(sk) && bpf_map_delete_elem(udp_map_fd, &sk) == 0) {
+        LOG::debug_in(AgentLogKind::UDP, "reconcile_sockets: re-walking untracked udp socket sk={:x}", sk);
+        ++resync_rewalked_sockets_;
+      }
+    }
+  }
+
+  return resync_rewalked_sockets_;
+}
+
+void BufferedPoller::resync_completed(u64 duration_ns)
+{
+  last_resync_time_ = monotonic();
+  ++resync_count_;
+  resync_total_ns_ += duration_ns;
+  resync_max_ns_ = std::max(resync_max_ns_, duration_ns);
+
+  log_.info(
+      "Resynced sockets after lost bpf samples in {}ms: lossy window {}..{}, {} stale sockets closed, {} sockets re-walked"
+      " (resyncs: {}, avg {}ms, max {}ms)",
+      duration_ns / 1'000'000,
+      loss_window_start_,
+      loss_window_end_,
+      resync_closed_sockets_,
+      resync_rewalked_sockets_,
+      resync_count_,
+      resync_total_ns_ / resync_count_ / 1'000'000,
+      resync_max_ns_ / 1'000'000);
+
+  writer_.socket_resync_stats(duration_ns, resync_closed_sockets_, resync_rewalked_sockets_);
+}
+
 template <
     typename MessageMetadata,
     BufferedPoller::message_handler_fn<MessageMetadata> Handler,
@@ -306,6 +515,65 @@ void BufferedPoller::add_handler()
   handlers_[idx] = &BufferedPoller::message_handler_entrypoint<MessageMetadata, Handler, MaxPadding, Alignment>;
 }
 
+template <typename MessageMetadata, BufferedPoller::message_handler_fn<MessageMetadata> Handler>
+void BufferedPoller::passthrough_handler_entrypoint(PerfReader &reader, u16 length)
+{
+  if (!direct_encoding_) {
+    message_handler_entrypoint<MessageMetadata, Handler, 0, u64>(reader, length);
+    return;
+  }
+
+  if (length != sizeof(u64) + MessageMetadata::wire_message_size) {
+    throw std::runtime_error(fmt::format(
+        "invalid message length (`{}`: {}/{})",
+        MessageMetadata::name,
+        length,
+        sizeof(u64) + MessageMetadata::wire_message_size));
+  }
+
+  // don't forward the message when disconnected, it is only consumed
+  if (!buffered_writer_.is_writable()) {
+    reader.pop();
+    return;
+  }
+
+  // like the encoder, drop the message if the buffer can't take it
+  if (auto allocated = buffered_writer_.start_write(length)) {
+    encode_passthrough_sample<typename MessageMetadata::wire_message>(*allocated, reader.peek_message());
+    buffered_writer_.finish_write();
+  }
+
+  reader.pop();
+}
+
+template <typename MessageMetadata, BufferedPoller::message_handler_fn<MessageMetadata> Handler>
+void BufferedPoller::add_passthrough_handler()
+{
+  u32 idx = agent_internal_hash(MessageMetadata::rpc_id);
+
+  if (handlers_[idx] != nullptr) {
+    throw std::runtime_error("tried to add_passthrough_handler to an occupied slot");
+  }
+
+  handlers_[idx] = &BufferedPoller::passthrough_handler_entrypoint<MessageMetadata, Handler>;
+}
+
+template <typename AgentMessage> bool BufferedPoller::try_forward_to_ingest(u64 timestamp, AgentMessage const &msg)
+{
+  using passthrough = IngestPassthrough<AgentMessage>;
+
+  if (!direct_encoding_) {
+    return false;
+  }
+
+  // like the encoder, drop the message if the buffer can't take it
+  if (auto allocated = buffered_writer_.start_write(sizeof(u64) + passthrough::size)) {
+    encode_passthrough(*allocated, timestamp, msg);
+    buffered_writer_.finish_write();
+  }
+  return true;
+}
+
 void BufferedPoller::handle_dns_message(message_metadata const &metadata, jb_agent_internal__dns_packet &msg)
 {
   // we are assuming that struct id_addr is exactly 4 bytes and that struct
@@ -377,23 +645,27 @@ void BufferedPoller::handle_dns_message(message_metadata const &metadata, jb_age
 
   if (!is_response) {
     DnsRequests::dns_request_key key{
-        .qid = qid_out, .type = type_out, .name = std::string(hostname_out, hostname_len), .is_rx = (bool)msg.is_rx};
+        .qid = qid_out,
+        .type = type_out,
+        .name = std::string_view(hostname_out, hostname_len),
+        .name_hash = DnsRequests::name_hash(std::string_view(hostname_out, hostname_len)),
+        .is_rx = (bool)msg.is_rx};
 
     // Add request to table, for later processing when response shows up
     DnsRequests::dns_request_value value{.timestamp_ns = metadata.timestamp, .sk = sk};
-    dns_requests_.add(key, value);
+    add_dns_request(key, value);
     return;
   }
 
   // looking for requests in the other direction
   DnsRequests::dns_request_key key{
-      .qid = qid_out, .type = type_out, .name = std::string(hostname_out, hostname_len), .is_rx = !msg.is_rx};
+      .qid = qid_out,
+      .type = type_out,
+      .name = std::string_view(hostname_out, hostname_len),
+      .name_hash = DnsRequests::name_hash(std::string_view(hostname_out, hostname_len)),
+      .is_rx = !msg.is_rx};
 
   // parse the reply
-  int send_a_aaaa_response = 0;
-  u16 sent_hostname_len = 0;
-  char *sent_hostname = NULL;
-
   ret = dns_parse_a_aaaa_reply(
       dns_packet.data(), pkt_len, hostname_out, &hostname_len, ipv4_addrs, &num_ipv4_addrs, ipv6_addrs, &num_ipv6_addrs);
 
@@ -406,7 +678,6 @@ void BufferedPoller::handle_dns_message(message_metadata const &metadata, jb_age
         msg.total_len,
         pkt_len,
         spdlog::to_hex(dns_packet.data(), dns_packet.data() + pkt_len));
-    send_a_aaaa_response = 0;
   } else {
     /**
      * we continue here even if packet was partial or corrupt, as long as we
@@ -418,29 +689,121 @@ void BufferedPoller::handle_dns_message(message_metadata const &metadata, jb_age
         "{}\nnum_ipv4_addrs {} num_ipv6_addrs {}",
         msg.total_len,
         pkt_len,
-        is_response,
-        type_out,
-        qid_out,
-        std::string_view(hostname_out, hostname_len));
+        num_ipv4_addrs,
+        num_ipv6_addrs);
+  }
+
+  report_dns_response(
+      metadata.timestamp,
+      sk,
+      sk_id,
+      msg.is_rx,
+      key,
+      std::string_view(hostname_out, hostname_len),
+      ipv4_addrs,
+      num_ipv4_addrs,
+      ipv6_addrs,
+      num_ipv6_addrs);
+}
+
+void BufferedPoller::handle_dns_record(message_metadata const &metadata, jb_agent_internal__dns_record &msg)
+{
+  LOG::debug_in(AgentLogKind::DNS, "handle_dns_record");
 
-    send_a_aaaa_response = 1;
-    // truncate hostname */
-    sent_hostname_len = (hostname_len < DNS_NAME_MAX_LENGTH) ? (u16)hostname_len : DNS_NAME_MAX_LENGTH;
-    sent_hostname = hostname_out + hostname_len - sent_hostname_len;
+  u64 const sk = msg.sk;
+  auto const payload_len = msg._len - jb_agent_internal__dns_record__data_size;
+  auto const &payload = metadata.padding;
+  auto const addrs_len = payload_len - msg.name;
+  auto const expected_addrs_len = msg.num_ipv4_addrs * sizeof(in_addr) + msg.num_ipv6_addrs * sizeof(in6_addr);
+
+  /* sanity check the message */
+  if (payload.data() + payload_len > metadata.payload.data() + metadata.payload.size() || msg.name > payload_len ||
+      msg.name > DNS_NAME_MAX_LENGTH || msg.num_ipv4_addrs > MAX_ENCODED_IP_ADDRS ||
+      msg.num_ipv6_addrs > MAX_ENCODED_IP_ADDRS || addrs_len != expected_addrs_len) {
+    throw std::runtime_error("dns: garbled record length");
   }
 
+  // Look up the udp socket table entry
+  auto pos = udp_socket_table_.find(sk);
+  if (pos.index == udp_socket_table_.invalid) {
+    if (!udp_socket_table_ever_full_ && all_probes_loaded_) {
+      log_.error("ERROR: handle_dns_record - sk not found. sk={:x}", sk);
+    }
+    return;
+  }
+  u32 sk_id = pos.index;
+
+  std::string_view const hostname(payload.data(), msg.name);
+
+  LOG::debug_in(
+      AgentLogKind::DNS,
+      "dns record, total len {}\nis_response {} type {} qid {} hostname {} num_ipv4_addrs {} num_ipv6_addrs {}",
+      msg.total_len,
+      msg.is_response,
+      msg.qtype,
+      msg.qid,
+      hostname,
+      msg.num_ipv4_addrs,
+      msg.num_ipv6_addrs);
+
+  // the kernel already hashed the name, and requests and responses are matched on the same hash
+  DnsRequests::dns_request_key key{
+      .qid = msg.qid,
+      .type = msg.qtype,
+      .name = hostname,
+      .name_hash = msg.name_hash,
+      .is_rx = msg.is_response ? !msg.is_rx : (bool)msg.is_rx};
+
+  if (!msg.is_response) {
+    // Add request to table, for later processing when response shows up
+    DnsRequests::dns_request_value value{.timestamp_ns = metadata.timestamp, .sk = sk};
+    add_dns_request(key, value);
+    return;
+  }
+
+  /* addresses are unaligned in the message: copy them out */
+  struct in_addr ipv4_addrs[MAX_ENCODED_IP_ADDRS];
+  struct in6_addr ipv6_addrs[MAX_ENCODED_IP_ADDRS];
+  char const *addrs = payload.data() + msg.name;
+  memcpy(ipv4_addrs, addrs, msg.num_ipv4_addrs * sizeof(in_addr));
+  memcpy(ipv6_addrs, addrs + msg.num_ipv4_addrs * sizeof(in_addr), msg.num_ipv6_addrs * sizeof(in6_addr));
+
+  report_dns_response(
+      metadata.timestamp, sk, sk_id, msg.is_rx, key, hostname, ipv4_addrs, msg.num_ipv4_addrs, ipv6_addrs, msg.num_ipv6_addrs);
+}
+
+void BufferedPoller::report_dns_response(
+    u64 timestamp,
+    u64 sk,
+    u32 sk_id,
+    bool is_rx,
+    DnsRequests::dns_request_key const &key,
+    std::string_view hostname,
+    in_addr const *ipv4_addrs,
+    int num_ipv4_addrs,
+    in6_addr const *ipv6_addrs,
+    int num_ipv6_addrs)
+{
+  // only A/AAAA responses with a name and addresses are reported
+  bool const send_a_aaaa_response = !hostname.empty() && (num_ipv4_addrs + num_ipv6_addrs) > 0;
+
+  // truncate hostname
+  u16 const sent_hostname_len = (hostname.size() < DNS_NAME_MAX_LENGTH) ? (u16)hostname.size() : DNS_NAME_MAX_LENGTH;
+  std::string_view const sent_hostname = hostname.substr(hostname.size() - sent_hostname_len);
+
   // Only process DNS replies have have a matching request
   // otherwise someone could be spoofing us
-  std::list<DnsRequests::Request> reqs;
+  auto &reqs = dns_requests_found_;
+  reqs.clear();
   dns_requests_.lookup(key, reqs);
   if (reqs.size() > 0) {
 
     /* see if this response matches requests we have seen */
-    for (auto &req : reqs) {
+    for (auto req : reqs) {
 
       /* submit the dns response with latency information */
-      u64 request_timestamp = req->second.timestamp_ns;
-      u64 latency_ns = metadata.timestamp - request_timestamp;
+      u64 request_timestamp = req->value().timestamp_ns;
+      u64 latency_ns = timestamp - request_timestamp;
 
       if (send_a_aaaa_response) {
         LOG::debug_in(
@@ -453,20 +816,20 @@ void BufferedPoller::handle_dns_message(message_metadata const &metadata, jb_age
             latency_ns);
 
         // if the socket is exactly the same, then we match
-        bool matching = sk == req->second.sk;
+        bool matching = sk == req->value().sk;
         if (!matching) {
           // if it's not, but the port and address is exactly the same, then we
           // also match
           auto pos1 = udp_socket_table_.find(sk);
           if (pos1.index == udp_socket_table_.invalid) {
             if (!udp_socket_table_ever_full_ && all_probes_loaded_) {
-              log_.error("ERROR: handle_dns_message - sk not found. sk={:x}", sk);
+              log_.error("ERROR: report_dns_response - sk not found. sk={:x}", sk);
             }
           }
-          auto pos2 = udp_socket_table_.find(req->second.sk);
+          auto pos2 = udp_socket_table_.find(req->value().sk);
           if (pos2.index == udp_socket_table_.invalid) {
             if (!udp_socket_table_ever_full_ && all_probes_loaded_) {
-              log_.error("ERROR: handle_dns_message - sk2 not found. sk2={}", req->second.sk);
+              log_.error("ERROR: report_dns_response - sk2 not found. sk2={}", req->value().sk);
             }
           }
 
@@ -487,7 +850,7 @@ void BufferedPoller::handle_dns_message(message_metadata const &metadata, jb_age
                 IPv6Address::from(pos1.entry->laddr),
                 pos1.entry->lport,
                 pos1.entry->pid,
-                req->second.sk,
+                req->value().sk,
                 IPv6Address::from(pos2.entry->laddr),
                 pos2.entry->lport,
                 pos2.entry->pid,
@@ -502,16 +865,16 @@ void BufferedPoller::handle_dns_message(message_metadata const &metadata, jb_age
         // appropriate metric if sending a dns response, this is a server and
         // 'processing time' is the appropriate metric
         writer_.dns_response_tstamp(
-            metadata.timestamp,
+            timestamp,
             sk_id,
-            hostname_len,
-            /* domain_name */ jb_blob{sent_hostname, sent_hostname_len},
+            hostname.size(),
+            /* domain_name */ jb_blob{sent_hostname.data(), sent_hostname_len},
             /* ipv4_addrs */
-            jb_blob{(char *)ipv4_addrs, (u16)(sizeof(u32) * num_ipv4_addrs)},
+            jb_blob{(char const *)ipv4_addrs, (u16)(sizeof(u32) * num_ipv4_addrs)},
             /* ipv6_addrs */
-            jb_blob{(char *)ipv6_addrs, (u16)(sizeof(struct in6_addr) * num_ipv6_addrs)},
+            jb_blob{(char const *)ipv6_addrs, (u16)(sizeof(struct in6_addr) * num_ipv6_addrs)},
             latency_ns,
-            msg.is_rx ? SC_CLIENT : SC_SERVER);
+            is_rx ? SC_CLIENT : SC_SERVER);
       }
       // else {
       //  // someday add other dns responses, or dns resolution errors
@@ -523,10 +886,21 @@ void BufferedPoller::handle_dns_message(message_metadata const &metadata, jb_age
   }
 }
 
-void BufferedPoller::timeout_dns_request(u64 timestamp_ns, const DnsRequests::Request &req)
+void BufferedPoller::add_dns_request(
+    DnsRequests::dns_request_key const &key, DnsRequests::dns_request_value const &value)
 {
-  u64 t_req = req->second.timestamp_ns;
-  u64 sk = req->second.sk;
+  if (!dns_requests_.add(key, value)) {
+    if (!dns_requests_ever_full_) {
+      log_.warn("dns request table is full ({} requests)! dropping requests", dns_requests_.capacity());
+    }
+    dns_requests_ever_full_ = true;
+  }
+}
+
+void BufferedPoller::timeout_dns_request(u64 timestamp_ns, DnsRequests::Request req)
+{
+  u64 t_req = req->value().timestamp_ns;
+  u64 sk = req->value().sk;
 
   // Look up the udp socket table entry
   auto pos = udp_socket_table_.find(sk);
@@ -542,12 +916,13 @@ void BufferedPoller::timeout_dns_request(u64 timestamp_ns, const DnsRequests::Re
     u64 duration_ns = (timestamp_ns - t_req);
 
     /* truncate hostname */
-    const char *hostname_out = req->first.name.c_str();
-    size_t hostname_len = req->first.name.size();
+    size_t hostname_len = req->name_length();
+    std::string_view const stored_hostname = req->name();
 
-    u16 sent_hostname_len = (hostname_len < DNS_NAME_MAX_LENGTH) ? (u16)hostname_len : DNS_NAME_MAX_LENGTH;
+    u16 sent_hostname_len =
+        (stored_hostname.size() < DNS_NAME_MAX_LENGTH) ? (u16)stored_hostname.size() : DNS_NAME_MAX_LENGTH;
 
-    const char *sent_hostname = hostname_out + hostname_len - sent_hostname_len;
+    std::string_view const sent_hostname = stored_hostname.substr(stored_hostname.size() - sent_hostname_len);
 
     LOG::debug_in(AgentLogKind::DNS, "sending DNS timeout for hostname {} duration_ns {}", sent_hostname, duration_ns);
 
@@ -555,7 +930,7 @@ void BufferedPoller::timeout_dns_request(u64 timestamp_ns, const DnsRequests::Re
         timestamp_ns,
         sk_id,
         hostname_len,
-        /* domain_name */ jb_blob{sent_hostname, sent_hostname_len},
+        /* domain_name */ jb_blob{sent_hostname.data(), sent_hostname_len},
         duration_ns);
   }
 
@@ -571,9 +946,10 @@ void BufferedPoller::slow_poll()
 
 void BufferedPoller::process_dns_timeouts(u64 t)
 {
-  std::list<DnsRequests::Request> old_reqs;
+  auto &old_reqs = dns_requests_found_;
+  old_reqs.clear();
   dns_requests_.lookup_older_than(t - DNS_TIMEOUT_TIME_NS, old_reqs);
-  for (auto &req : old_reqs) {
+  for (auto req : old_reqs) {
     timeout_dns_request(t, req);
   }
 }
@@ -626,7 +1002,9 @@ void BufferedPoller::handle_set_state_ipv4(message_metadata const &metadata, jb_
     return;
   }
 
-  writer_.set_state_ipv4_tstamp(metadata.timestamp, msg.dest, msg.src, msg.dport, msg.sport, msg.sk, msg.tx_rx);
+  if (!try_forward_to_ingest(metadata.timestamp, msg)) {
+    writer_.set_state_ipv4_tstamp(metadata.timestamp, msg.dest, msg.src, msg.dport, msg.sport, msg.sk, msg.tx_rx);
+  }
 
   nat_handler_.handle_set_state_ipv4(metadata.timestamp, &msg);
 }
@@ -653,12 +1031,17 @@ void BufferedPoller::handle_set_state_ipv6(message_metadata const &metadata, jb_
     return;
   }
 
-  writer_.set_state_ipv6_tstamp(metadata.timestamp, msg.dest, msg.src, msg.dport, msg.sport, msg.sk, msg.tx_rx);
+  if (!try_forward_to_ingest(metadata.timestamp, msg)) {
+    writer_.set_state_ipv6_tstamp(metadata.timestamp, msg.dest, msg.src, msg.dport, msg.sport, msg.sk, msg.tx_rx);
+  }
   nat_handler_.handle_set_state_ipv6(metadata.timestamp, &msg);
 }
 
 void BufferedPoller::handle_close_socket(message_metadata const &metadata, jb_agent_internal__close_sock_info &msg)
 {
+  // the socket's last stats and close go out with its latest NAT mapping
+  nat_handler_.flush_nat_remapping(msg.sk);
+
   auto pos = tcp_socket_table_.find(msg.sk);
   if (pos.index == tcp_socket_table_.invalid) {
     // This should be prevented in BPF except when the socket table was full
@@ -683,7 +1066,9 @@ void BufferedPoller::handle_close_socket(message_metadata const &metadata, jb_ag
     throw std::runtime_error(fmt::format("handle_close_socket: removing socket from table failed sk={:x}", msg.sk));
   }
 
-  writer_.close_sock_info_tstamp(metadata.timestamp, msg.sk);
+  if (!try_forward_to_ingest(metadata.timestamp, msg)) {
+    writer_.close_sock_info_tstamp(metadata.timestamp, msg.sk);
+  }
   nat_handler_.handle_close_socket(metadata.timestamp, &msg);
 
   // Also clean up any tcp data protocol handlers this socket may have
@@ -700,16 +1085,23 @@ void BufferedPoller::handle_rtt_estimator(message_metadata const &metadata, jb_a
     }
     return;
   }
-  auto entry = pos.entry;
 
-  /* we have a valid position. will go on to compute statistics */
-  u64 diff_bytes_acked = msg.bytes_acked - entry->bytes_acked;
-  u32 diff_delivered = msg.packets_delivered - entry->packets_delivered;
-  u32 diff_retrans = msg.packets_retrans - entry->packets_retrans;
+  /* find the statistics, and ask it to enqueue */
+  auto &stats = tcp_socket_stats_.lookup(pos.index, metadata.timestamp, true).second;
 
-  u64 diff_bytes_received = msg.bytes_received - entry->bytes_received;
-  u32 diff_rcv_holes = msg.rcv_holes - entry->rcv_holes;
-  u32 diff_rcv_delivered = msg.rcv_delivered - entry->rcv_delivered;
+  update_tcp_statistics(*pos.entry, stats, msg);
+}
+
+void BufferedPoller::update_tcp_statistics(
+    tcp_socket_entry &entry, tcp_statistics &stats, jb_agent_internal__rtt_estimator const &msg)
+{
+  u64 diff_bytes_acked = msg.bytes_acked - entry.bytes_acked;
+  u32 diff_delivered = msg.packets_delivered - entry.packets_delivered;
+  u32 diff_retrans = msg.packets_retrans - entry.packets_retrans;
+
+  u64 diff_bytes_received = msg.bytes_received - entry.bytes_received;
+  u32 diff_rcv_holes = msg.rcv_holes - entry.rcv_holes;
+  u32 diff_rcv_delivered = msg.rcv_delivered - entry.rcv_delivered;
 
   /* differences should be positive, if interpreted as signed numbers.
      avoid accumulating these huge diffs in stats below. */
@@ -735,16 +1127,13 @@ void BufferedPoller::handle_rtt_estimator(message_metadata const &metadata, jb_a
   }
 
   /* update the entry for next time */
-  entry->bytes_acked = msg.bytes_acked;
-  entry->packets_delivered = msg.packets_delivered;
-  entry->packets_retrans = msg.packets_retrans;
+  entry.bytes_acked = msg.bytes_acked;
+  entry.packets_delivered = msg.packets_delivered;
+  entry.packets_retrans = msg.packets_retrans;
 
-  entry->bytes_received = msg.bytes_received;
-  entry->rcv_holes = msg.rcv_holes;
-  entry->rcv_delivered = msg.rcv_delivered;
-
-  /* find the statistics, and ask it to enqueue */
-  auto &stats = tcp_socket_stats_.lookup(pos.index, metadata.timestamp, true).second;
+  entry.bytes_received = msg.bytes_received;
+  entry.rcv_holes = msg.rcv_holes;
+  entry.rcv_delivered = msg.rcv_delivered;
 
   /* if stats were invalid, reset the values */
   if (!stats.valid) {
@@ -771,6 +1160,62 @@ void BufferedPoller::handle_rtt_estimator(message_metadata const &metadata, jb_a
   }
 }
 
+void BufferedPoller::drain_tcp_stats()
+{
+  // sockets updated from now on start accumulating into the next interval
+  u32 const epoch = __atomic_fetch_add(&skel_->bss->tcp_stats_epoch, 1, __ATOMIC_ACQ_REL);
+
+  u32 batch = 0;
+  bool first = true;
+  for (;;) {
+    u32 count = TCP_STATS_DRAIN_BATCH;
+    int const ret = bpf_map_lookup_batch(
+        tcp_open_sockets_fd_,
+        first ? nullptr : &batch,
+        &batch,
+        tcp_stats_keys_.data(),
+        tcp_stats_values_.data(),
+        &count,
+        nullptr);
+    if (ret != 0 && errno != ENOENT) {
+      LOG::debug_in(AgentLogKind::TCP, "drain_tcp_stats: batch lookup failed: {}", strerror(errno));
+      return;
+    }
+    first = false;
+
+    for (u32 i = 0; i < count; ++i) {
+      auto const &sk_info = tcp_stats_values_[i];
+      if (sk_info.stats_epoch != epoch) {
+        continue; // not updated in the interval being drained
+      }
+
+      u64 const sk = tcp_stats_keys_[i];
+      auto pos = tcp_socket_table_.find(sk);
+      if (pos.index == tcp_socket_table_.invalid) {
+        continue;
+      }
+
+      jb_agent_internal__rtt_estimator msg = {};
+      msg.sk = sk;
+      msg.srtt = sk_info.stats_max_srtt;
+      msg.bytes_acked = sk_info.stats_bytes_acked;
+      msg.packets_delivered = sk_info.stats_delivered;
+      msg.packets_retrans = sk_info.stats_retrans;
+      msg.bytes_received = sk_info.stats_bytes_received;
+      msg.rcv_holes = sk_info.rcv_holes;
+      msg.rcv_delivered = sk_info.rcv_delivered;
+      msg.rcv_rtt = sk_info.stats_max_rcv_rtt;
+
+      auto &stats = tcp_socket_stats_.lookup_relative(pos.index, 0, true).second;
+      update_tcp_statistics(*pos.entry, stats, msg);
+    }
+
+    if (ret != 0) {
+      return; // ENOENT: no more entries
+    }
+  }
+}
+
 void BufferedPoller::handle_reset_tcp_counters(message_metadata const &metadata, jb_agent_internal__reset_tcp_counters &msg)
 {
 
@@ -823,7 +1268,9 @@ void BufferedPoller::handle_http_response(message_metadata const &metadata, jb_a
       msg.latency_ns,
       client_server_type_to_string((enum CLIENT_SERVER_TYPE)msg.client_server));
 
-  writer_.http_response_tstamp(metadata.timestamp, msg.sk, msg.pid, msg.code, msg.latency_ns, msg.client_server);
+  if (!try_forward_to_ingest(metadata.timestamp, msg)) {
+    writer_.http_response_tstamp(metadata.timestamp, msg.sk, msg.pid, msg.code, msg.latency_ns, msg.client_server);
+  }
 }
 
 void BufferedPoller::send_socket_stats(u64 t, u64 sk, tcp_statistics &stats)
@@ -920,9 +1367,10 @@ void BufferedPoller::handle_udp_destroy_socket(message_metadata const &metadata,
   }
 
   // Ensure dns queries on this socket are timed out
-  std::list<DnsRequests::Request> reqs;
+  auto &reqs = dns_requests_found_;
+  reqs.clear();
   dns_requests_.lookup_socket(msg.sk, reqs);
-  for (auto &req : reqs) {
+  for (auto req : reqs) {
     timeout_dns_request(metadata.timestamp, req);
   }
 
@@ -1082,7 +1530,9 @@ void BufferedPoller::handle_pid_close(message_metadata const &metadata, jb_agent
   LOG::debug_in(AgentLogKind::PID, "{}: pid={} comm='{}' pid_count_={}", __func__, msg.pid, comm, pid_count_);
 
   process_handler_.on_process_end(std::chrono::nanoseconds{metadata.timestamp}, msg);
-  writer_.pid_close_info_tstamp(metadata.timestamp, msg.pid, msg.comm);
+  if (!try_forward_to_ingest(metadata.timestamp, msg)) {
+    writer_.pid_close_info_tstamp(metadata.timestamp, msg.pid, msg.comm);
+  }
 }
 
 void BufferedPoller::handle_pid_set_comm(message_metadata const &metadata, jb_agent_internal__pid_set_comm &msg)
@@ -1091,7 +1541,9 @@ void BufferedPoller::handle_pid_set_comm(message_metadata const &metadata, jb_ag
   LOG::debug_in(AgentLogKind::PID, "{}: pid={} comm='{}'", __func__, msg.pid, comm);
 
   process_handler_.set_process_command(std::chrono::nanoseconds{metadata.timestamp}, msg);
-  writer_.pid_set_comm_tstamp(metadata.timestamp, msg.pid, msg.comm);
+  if (!try_forward_to_ingest(metadata.timestamp, msg)) {
+    writer_.pid_set_comm_tstamp(metadata.timestamp, msg.pid, msg.comm);
+  }
 }
 
 void BufferedPoller::handle_pid_exit(message_metadata const &metadata, jb_agent_internal__pid_exit &msg)
@@ -1240,7 +1692,9 @@ void BufferedPoller::handle_css_populate_dir(message_metadata const &metadata, j
 {
   cgroup_handler_.css_populate_dir(metadata.timestamp, &msg);
 
-  writer_.cgroup_create_tstamp(metadata.timestamp, msg.cgroup, msg.cgroup_parent, msg.name);
+  if (!try_forward_to_ingest(metadata.timestamp, msg)) {
+    writer_.cgroup_create_tstamp(metadata.timestamp, msg.cgroup, msg.cgroup_parent, msg.name);
+  }
 }
 
 void BufferedPoller::handle_existing_cgroup_probe(
@@ -1248,7 +1702,9 @@ void BufferedPoller::handle_existing_cgroup_probe(
 {
   cgroup_handler_.existing_cgroup_probe(metadata.timestamp, &msg);
 
-  writer_.cgroup_create_tstamp(metadata.timestamp, msg.cgroup, msg.cgroup_parent, msg.name);
+  if (!try_forward_to_ingest(metadata.timestamp, msg)) {
+    writer_.cgroup_create_tstamp(metadata.timestamp, msg.cgroup, msg.cgroup_parent, msg.name);
+  }
 }
 
 void BufferedPoller::handle_cgroup_attach_task(message_metadata const &metadata, jb_agent_internal__cgroup_attach_task &msg)
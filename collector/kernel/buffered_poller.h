@@ -19,6 +19,7 @@
 #include <collector/kernel/dns_requests.h>
 #include <collector/kernel/nat_handler.h>
 #include <collector/kernel/perf_poller.h>
+#include <collector/kernel/poll_scheduler.h>
 #include <collector/kernel/probe_handler.h>
 #include <collector/kernel/process_handler.h>
 #include <collector/kernel/socket_table.h>
@@ -28,7 +29,10 @@
 #include <generated/ebpf_net/ingest/writer.h>
 #include <generated/ebpf_net/kernel_collector/index.h>
 
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <vector>
 
 // Forward declaration for the skeleton
 struct render_bpf_bpf;
@@ -88,17 +92,23 @@ public:
   /**
    * entrypoint for event-driven polling when the perf container announces
    * it is half full or whatever notification limit is set.
-   * calls through to process_samples()
+   * calls through to poll_rings()
    */
   void handle_event();
 
   /**
-   * entrypoint for manual polling. calls through to process_samples()
+   * entrypoint for manual polling. calls through to poll_rings()
    * @see PerfPoller::poll
    */
 
   virtual void poll();
 
+  /**
+   * Returns how long to wait before the next manual poll, adapted to how
+   *   full the perf rings were in recent polls (see PollScheduler).
+   */
+  std::chrono::milliseconds poll_interval() const { return poll_scheduler_.interval(); }
+
   /**
    * Sends a bpf loss notification to backend, if a loss happened since
    *   the last notification call
@@ -110,6 +120,38 @@ public:
    */
   u64 serv_lost_count();
 
+  /**
+   * Returns true when BPF samples were lost in steady state and the socket
+   *   tables should be resynced, i.e. `reconcile_sockets()` called.
+   *
+   * Resyncs are spaced at least SOCKET_RESYNC_MIN_INTERVAL_NS apart; losses
+   *   in between are folded into the next resync.
+   */
+  bool resync_pending() const;
+
+  /**
+   * First step of a socket resync after lost BPF samples.
+   *
+   * Compares the TCP and UDP socket tables to the sockets tracked in BPF:
+   * - sockets BPF no longer tracks had their close event lost, and are closed
+   *   locally and upstream;
+   * - sockets BPF tracks but that are missing here had their creation events
+   *   lost, and are removed from the BPF tables so that re-walking existing
+   *   sockets (see SocketProber) reports them again.
+   *
+   * @param periodic_cb: callback that drains the perf rings
+   * @returns the number of sockets that need re-walking
+   */
+  u64 reconcile_sockets(std::function<void(void)> const &periodic_cb);
+
+  /**
+   * Last step of a socket resync: updates resync counters, and reports the
+   *   resync upstream.
+   *
+   * @param duration_ns: how long the whole resync took
+   */
+  void resync_completed(u64 duration_ns);
+
   void slow_poll();
 
   /**
@@ -126,6 +168,17 @@ public:
 #endif
 
 private:
+  /**
+   * Calls process_samples(), then polls again right away while a perf ring
+   *   is above PollScheduler's high-water mark.
+   */
+  void poll_rings(PollScheduler::Trigger trigger);
+
+  /**
+   * Sends ring fill levels and poll counts since the last call upstream.
+   */
+  void send_poll_stats();
+
   /**
    * polling point for dns timeout detection
    * called via slow poll
@@ -158,11 +211,36 @@ private:
   template <typename MessageMetadata, message_handler_fn<MessageMetadata>, std::size_t MaxPadding = 0, typename Alignment = u64>
   void add_handler();
 
+  template <typename MessageMetadata, message_handler_fn<MessageMetadata>>
+  void passthrough_handler_entrypoint(PerfReader &reader, u16 length);
+
+  /**
+   * Adds a handler for a message that is only forwarded upstream unchanged
+   *   (see ingest_passthrough.h). With the binary encoder, the message is
+   *   copied from the ring straight into the upstream buffer, and the handler
+   *   is not called. Throws on collision.
+   */
+  template <typename MessageMetadata, message_handler_fn<MessageMetadata>> void add_passthrough_handler();
+
+  /**
+   * Writes @msg upstream as the ingest message with the same layout (see
+   *   ingest_passthrough.h), bypassing the encoder.
+   *
+   * Returns false, writing nothing, when not using the binary encoder: the
+   *   caller then writes the message through `writer_`.
+   */
+  template <typename AgentMessage> bool try_forward_to_ingest(u64 timestamp, AgentMessage const &msg);
+
   /**
    * Handler for DNS RPC messages
    */
   void handle_dns_message(message_metadata const &metadata, jb_agent_internal__dns_packet &msg);
 
+  /**
+   * Handler for DNS packets parsed in BPF
+   */
+  void handle_dns_record(message_metadata const &metadata, jb_agent_internal__dns_record &msg);
+
   /**
    * Handler a new socket message
    */
@@ -188,6 +266,19 @@ private:
    */
   void handle_rtt_estimator(message_metadata const &metadata, jb_agent_internal__rtt_estimator &msg);
 
+  /**
+   * Folds the cumulative counters reported for a TCP socket into its
+   *   statistics, and updates the last observed counters in @entry.
+   */
+  void update_tcp_statistics(tcp_socket_entry &entry, tcp_statistics &stats, jb_agent_internal__rtt_estimator const &msg);
+
+  /**
+   * Reads the TCP statistics accumulated in BPF since the last drain, for all
+   *   sockets, into the current stats interval.
+   * Only used when the probe handler enabled in-kernel TCP statistics.
+   */
+  void drain_tcp_stats();
+
   /**
    * Handler a rtt_estimator telemetry message
    */
@@ -300,7 +391,24 @@ private:
   void handle_existing_conntrack_tuple(message_metadata const &metadata, jb_agent_internal__existing_conntrack_tuple &msg);
 
   /*** DNS ***/
-  void timeout_dns_request(u64 timestamp_ns, const DnsRequests::Request &req);
+  void add_dns_request(DnsRequests::dns_request_key const &key, DnsRequests::dns_request_value const &value);
+  void timeout_dns_request(u64 timestamp_ns, DnsRequests::Request req);
+
+  /**
+   * Reports a DNS response to the requests it answers, then forgets them.
+   * @param key: the key of the requests, in the other direction from the response
+   */
+  void report_dns_response(
+      u64 timestamp,
+      u64 sk,
+      u32 sk_id,
+      bool is_rx,
+      DnsRequests::dns_request_key const &key,
+      std::string_view hostname,
+      in_addr const *ipv4_addrs,
+      int num_ipv4_addrs,
+      in6_addr const *ipv6_addrs,
+      int num_ipv6_addrs);
 
   /*** ERRORS ***/
   void handle_bpf_log(message_metadata const &metadata, jb_agent_internal__bpf_log &msg);
@@ -329,6 +437,20 @@ private:
   /* the last lost count that a message was sent for */
   u64 notified_lost_count_ = 0;
 
+  /* socket resyncs after lost samples */
+  bool resync_pending_ = false;
+  u64 loss_window_start_ = 0; /* timestamp of the first loss not yet resynced */
+  u64 loss_window_end_ = 0;   /* timestamp of the last loss not yet resynced */
+  u64 last_resync_time_ = 0;  /* monotonic time the last resync completed */
+  u64 resync_count_ = 0;
+  u64 resync_total_ns_ = 0;
+  u64 resync_max_ns_ = 0;
+  u64 resync_closed_sockets_ = 0;   /* in the resync in progress */
+  u64 resync_rewalked_sockets_ = 0; /* in the resync in progress */
+
+  /* adapts the polling interval to ring fill levels, and counts polls */
+  PollScheduler poll_scheduler_;
+
   handler_fn handlers_[AGENT_INTERNAL_HASH_SIZE];
 
   /* u64 Hasher */
@@ -349,6 +471,11 @@ private:
   TcpSocketStatistics tcp_socket_stats_;
   u64 tcp_index_to_sk_[tcp_socket_table_max_sockets];
 
+  /* in-kernel TCP statistics: tcp_open_sockets table and batch buffers */
+  int tcp_open_sockets_fd_ = -1;
+  std::vector<u64> tcp_stats_keys_;
+  std::vector<struct tcp_open_socket_t> tcp_stats_values_;
+
   /* UDP */
   typedef FixedHash<u64, udp_socket_entry, udp_socket_table_max_sockets, u64_hasher> UdpSocketTable;
   typedef MetricStore<struct udp_statistics, udp_socket_table_max_sockets, n_epochs> UdpSocketStatistics;
@@ -357,8 +484,14 @@ private:
   bool udp_socket_table_ever_full_;
   std::array<UdpSocketStatistics, 2> udp_socket_stats_; /* 0: TX, 1: RX */
 
+  /* messages in ingest_passthrough.h are copied upstream, not encoded */
+  bool const direct_encoding_;
+
   /* DNS */
   DnsRequests dns_requests_;
+  bool dns_requests_ever_full_ = false;
+  /* requests returned by dns_requests_ lookups, reused to avoid allocating */
+  std::vector<DnsRequests::Request> dns_requests_found_;
 
   bool all_probes_loaded_;
 
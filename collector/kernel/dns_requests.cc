@@ -1,32 +1,185 @@
 // Copyright The OpenTelemetry Authors
 // SPDX-License-Identifier: Apache-2.0
 
-#include "spdlog/common.h"
 #include <collector/kernel/dns_requests.h>
 #include <platform/platform.h>
-#include <util/log.h>
+
+#include <collector/kernel/bpf_src/render_bpf.h>
+
+#include <algorithm>
+#include <cstring>
+
+/**
+ * Index c'tor
+ *
+ * @param[in] capacity The maximum number of entries in the index
+ */
+DnsRequests::Index::Index(u32 capacity)
+{
+  // keep the load factor at or below 1/2, so probe sequences stay short
+  u32 size = 2;
+  while (size < 2 * capacity) {
+    size *= 2;
+  }
+  slots_.assign(size, Slot{.hash = 0, .entry = INVALID});
+  mask_ = size - 1;
+}
+
+/**
+ * Inserts an entry into the index
+ *
+ * @param[in] hash The hash the entry is found by
+ * @param[in] entry The entry's index in the pool
+ */
+void DnsRequests::Index::insert(u32 hash, u32 entry)
+{
+  u32 i = hash & mask_;
+  while (slots_[i].entry != INVALID) {
+    i = (i + 1) & mask_;
+  }
+  slots_[i] = Slot{.hash = hash, .entry = entry};
+}
+
+/**
+ * Removes an entry from the index, shifting back later entries of the probe
+ * sequence into the freed slot so that lookups never need tombstones.
+ *
+ * @param[in] hash The hash the entry was inserted with
+ * @param[in] entry The entry's index in the pool
+ */
+void DnsRequests::Index::erase(u32 hash, u32 entry)
+{
+  u32 i = hash & mask_;
+  while (slots_[i].entry != entry) {
+    if (slots_[i].entry == INVALID) {
+      return;
+    }
+    i = (i + 1) & mask_;
+  }
+  slots_[i].entry = INVALID;
+
+  for (u32 j = (i + 1) & mask_; slots_[j].entry != INVALID; j = (j + 1) & mask_) {
+    u32 const home = slots_[j].hash & mask_;
+    // the entry at j can move to i unless its home slot is cyclically in (i, j]
+    bool const stays = (i < j) ? (home > i && home <= j) : (home > i || home <= j);
+    if (!stays) {
+      slots_[i] = slots_[j];
+      slots_[j].entry = INVALID;
+      i = j;
+    }
+  }
+}
 
 /**
  * DNS requests key hash function
  *
- * @param[in] k The dns request key to hash
+ * @param[in] qid The transaction id
+ * @param[in] type The query type
+ * @param[in] name_hash The hash of the query name
  * @return the hash of the dns request key
  */
-size_t DnsRequests::dns_request_key_hash::operator()(const dns_request_key &k) const noexcept
+u32 DnsRequests::key_hash(u16 qid, u16 type, u64 name_hash)
 {
-  return std::hash<uint16_t>{}(k.qid) ^ std::hash<uint16_t>{}(k.type) ^ std::hash<std::string>{}(k.name);
+  u64 const h = (name_hash ^ ((u64)qid << 32) ^ ((u64)type << 16)) * 0x9e3779b97f4a7c15ull;
+  return static_cast<u32>(h >> 32);
+}
+
+/**
+ * Socket hash function
+ *
+ * @param[in] sk The kernel `struct sock*` pointer of the socket
+ * @return the hash of the socket
+ */
+u32 DnsRequests::sk_hash(u64 sk)
+{
+  return static_cast<u32>((sk * 0x9e3779b97f4a7c15ull) >> 32);
 }
 
 /**
  * DNS requests key comparison function
  *
- * @param[in] k The first dns request key to compare
- * @param[in] k2 The second dns request key to compare
- * @return true if the keys are equal, false otherwise
+ * @param[in] entry The outstanding request to compare
+ * @param[in] key The dns request key to compare
+ * @param[in] hash key_hash() of the dns request key
+ * @return true if the request has the key, false otherwise
+ */
+bool DnsRequests::matches(Entry const &entry, const dns_request_key &key, u32 hash) const
+{
+  if (entry.key_hash_ != hash || entry.qid_ != key.qid || entry.type_ != key.type || entry.name_hash_ != key.name_hash ||
+      entry.name_len_ != key.name.size()) {
+    return false;
+  }
+  return entry.name() == key.name.substr(key.name.size() - entry.stored_name_len_);
+}
+
+/**
+ * FNV-1a hash of a DNS question name
+ *
+ * @param[in] name The question name, as written by dns_parse_query
+ * @return the same hash BPF computes for dns_record messages
  */
-bool DnsRequests::dns_request_key_equal_to::operator()(const dns_request_key &k, const dns_request_key &k2) const noexcept
+u64 DnsRequests::name_hash(std::string_view name)
 {
-  return k.qid == k2.qid && k.type == k2.type && k.name == k2.name;
+  u64 hash = DNS_NAME_HASH_OFFSET_BASIS;
+  for (unsigned char c : name) {
+    hash = (hash ^ c) * DNS_NAME_HASH_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * c'tor
+ *
+ * @param[in] capacity The maximum number of outstanding requests
+ */
+DnsRequests::DnsRequests(u32 capacity) : entries_(capacity), free_head_(INVALID), by_key_(capacity), by_sock_(capacity)
+{
+  for (u32 i = capacity; i > 0; i--) {
+    entries_[i - 1].wheel_next_ = free_head_;
+    free_head_ = i - 1;
+  }
+  for (auto &head : wheel_) {
+    head = INVALID;
+  }
+}
+
+/**
+ * Links an entry into the timing wheel slot of its timestamp, or of the
+ * current tick if lookup_older_than already went past its timestamp.
+ *
+ * @param[in] index The entry's index in the pool
+ */
+void DnsRequests::wheel_link(u32 index)
+{
+  Entry &entry = entries_[index];
+  u64 const tick = std::max(entry.value_.timestamp_ns >> WHEEL_TICK_SHIFT, wheel_tick_);
+  entry.wheel_slot_ = tick % WHEEL_SLOTS;
+  u32 &head = wheel_[entry.wheel_slot_];
+
+  entry.wheel_prev_ = INVALID;
+  entry.wheel_next_ = head;
+  if (head != INVALID) {
+    entries_[head].wheel_prev_ = index;
+  }
+  head = index;
+}
+
+/**
+ * Unlinks an entry from its timing wheel slot
+ *
+ * @param[in] index The entry's index in the pool
+ */
+void DnsRequests::wheel_unlink(u32 index)
+{
+  Entry &entry = entries_[index];
+  if (entry.wheel_prev_ != INVALID) {
+    entries_[entry.wheel_prev_].wheel_next_ = entry.wheel_next_;
+  } else {
+    wheel_[entry.wheel_slot_] = entry.wheel_next_;
+  }
+  if (entry.wheel_next_ != INVALID) {
+    entries_[entry.wheel_next_].wheel_prev_ = entry.wheel_prev_;
+  }
 }
 
 /**
@@ -34,84 +187,111 @@ bool DnsRequests::dns_request_key_equal_to::operator()(const dns_request_key &k,
  *
  * @param[in] key Key of the DNS request
  * @param[in] value Value of the DNS request
+ * @return false if the request was dropped because the pool is full
  */
-void DnsRequests::add(const dns_request_key &key, const dns_request_value &value)
+bool DnsRequests::add(const dns_request_key &key, const dns_request_value &value)
 {
-  auto iter = dns_requests_.insert(dns_requests_.end(), std::make_pair(key, value));
-  dns_requests_by_key_.insert(std::make_pair(key, iter));
-  dns_requests_by_sock_.insert(std::make_pair(value.sk, iter));
+  if (free_head_ == INVALID) {
+    return false;
+  }
+  u32 const index = free_head_;
+  Entry &entry = entries_[index];
+  free_head_ = entry.wheel_next_;
+  size_++;
+
+  // keep the end of long names, which is what gets reported
+  u16 const stored_len = (key.name.size() < MAX_NAME_LENGTH) ? (u16)key.name.size() : MAX_NAME_LENGTH;
+
+  entry.value_ = value;
+  entry.name_hash_ = key.name_hash;
+  entry.key_hash_ = key_hash(key.qid, key.type, key.name_hash);
+  entry.sk_hash_ = sk_hash(value.sk);
+  entry.qid_ = key.qid;
+  entry.type_ = key.type;
+  entry.name_len_ = (key.name.size() < 0xffff) ? (u16)key.name.size() : 0xffff;
+  entry.stored_name_len_ = stored_len;
+  memcpy(entry.name_, key.name.data() + key.name.size() - stored_len, stored_len);
+
+  by_key_.insert(entry.key_hash_, index);
+  by_sock_.insert(entry.sk_hash_, index);
+  wheel_link(index);
+  return true;
 }
 
 /**
- * Return a list of DNS Requests that correspond to a particular key
+ * Return the DNS Requests that correspond to a particular key
  *
  * @param[in] key Key of the DNS Request to look up
- * @param[out] out The list of matching dns request key/value pairs
+ * @param[out] out Receives the matching dns requests
  */
-void DnsRequests::lookup(const dns_request_key &key, std::list<Request> &out)
+void DnsRequests::lookup(const dns_request_key &key, std::vector<Request> &out) const
 {
-  auto key_er = dns_requests_by_key_.equal_range(key);
-  for (auto eriter = key_er.first; eriter != key_er.second; eriter++) {
-    out.push_back(eriter->second);
-  }
+  u32 const hash = key_hash(key.qid, key.type, key.name_hash);
+  by_key_.for_each(hash, [&](u32 index) {
+    if (matches(entries_[index], key, hash)) {
+      out.push_back(&entries_[index]);
+    }
+  });
 }
 
 /**
- * Return a list of DNS Requests that are older than a particular timestamp
+ * Return the DNS Requests that are older than a particular timestamp
+ *
+ * Only visits the timing wheel slots between the previous call's timestamp
+ * and this one, so callers are expected to remove the returned requests.
  *
  * @param[in] timestamp_ns The timestamp to get requests older than
- * @param[out] out The list of matching dns request key/value pairs
+ * @param[out] out Receives the matching dns requests
  */
-
-void DnsRequests::lookup_older_than(u64 timestamp_ns, std::list<DnsRequests::Request> &out)
+void DnsRequests::lookup_older_than(u64 timestamp_ns, std::vector<Request> &out)
 {
-  for (auto iter = dns_requests_.begin(); iter != dns_requests_.end(); iter++) {
-    if (iter->second.timestamp_ns >= timestamp_ns) {
-      break;
-    }
+  u64 const end_tick = std::max(timestamp_ns >> WHEEL_TICK_SHIFT, wheel_tick_);
+  u64 const num_ticks = std::min<u64>(end_tick - wheel_tick_ + 1, WHEEL_SLOTS);
 
-    out.push_back(iter);
+  for (u64 tick = end_tick + 1 - num_ticks; tick <= end_tick; tick++) {
+    for (u32 index = wheel_[tick % WHEEL_SLOTS]; index != INVALID; index = entries_[index].wheel_next_) {
+      if (entries_[index].value_.timestamp_ns < timestamp_ns) {
+        out.push_back(&entries_[index]);
+      }
+    }
   }
+
+  // requests in the last slot might not be old yet, it is visited again next time
+  wheel_tick_ = end_tick;
 }
 
 /**
- * Return a list of DNS Requests that match a particular socket
+ * Return the DNS Requests that match a particular socket
  *
  * @param[in] sk The kernel `struct sock*` pointer of the socket to look up
- * @param[out] out The list of matching dns request key/value pairs
+ * @param[out] out Receives the matching dns requests
  */
-void DnsRequests::lookup_socket(u64 sk, std::list<DnsRequests::Request> &out)
+void DnsRequests::lookup_socket(u64 sk, std::vector<Request> &out) const
 {
-  auto sk_er = dns_requests_by_sock_.equal_range(sk);
-  for (auto eriter = sk_er.first; eriter != sk_er.second; eriter++) {
-    out.push_back(eriter->second);
-  }
+  by_sock_.for_each(sk_hash(sk), [&](u32 index) {
+    if (entries_[index].value_.sk == sk) {
+      out.push_back(&entries_[index]);
+    }
+  });
 }
 
 /**
  * Removes a specific DNS Request
  *
- * @param[in] key The DNS Request to remove, as returned by lookup* functions
+ * @param[in] req The DNS Request to remove, as returned by lookup* functions
  */
-void DnsRequests::remove(const Request &req)
+void DnsRequests::remove(Request req)
 {
-  auto key_er = dns_requests_by_key_.equal_range(req->first);
-  for (auto eriter = key_er.first; eriter != key_er.second; eriter++) {
-    if (eriter->second == req) {
-      dns_requests_by_key_.erase(eriter);
-      break;
-    }
-  }
+  u32 const index = index_of(req);
+  Entry &entry = entries_[index];
 
-  auto sk_er = dns_requests_by_sock_.equal_range(req->second.sk);
-  for (auto skiter = sk_er.first; skiter != sk_er.second; skiter++) {
-    if (skiter->second == req) {
-      dns_requests_by_sock_.erase(skiter);
-      break;
-    }
-  }
+  by_key_.erase(entry.key_hash_, index);
+  by_sock_.erase(entry.sk_hash_, index);
+  wheel_unlink(index);
 
-  dns_requests_.erase(req);
+  entry.wheel_next_ = free_head_;
+  free_head_ = index;
+  size_--;
 }
 
 /**
@@ -121,20 +301,19 @@ void DnsRequests::remove(const Request &req)
  */
 void DnsRequests::remove_all_with_key(const dns_request_key &key)
 {
-  auto key_er = dns_requests_by_key_.equal_range(key);
-  for (auto eriter = key_er.first; eriter != key_er.second;) {
-    auto req = eriter->second;
+  u32 const hash = key_hash(key.qid, key.type, key.name_hash);
 
-    auto sk_er = dns_requests_by_sock_.equal_range(req->second.sk);
-    for (auto skiter = sk_er.first; skiter != sk_er.second; skiter++) {
-      if (skiter->second == req) {
-        dns_requests_by_sock_.erase(skiter);
-        break;
+  // removing shifts the probe sequence, so look up again after each removal
+  for (;;) {
+    u32 found = INVALID;
+    by_key_.for_each(hash, [&](u32 index) {
+      if (found == INVALID && matches(entries_[index], key, hash)) {
+        found = index;
       }
+    });
+    if (found == INVALID) {
+      break;
     }
-
-    dns_requests_.erase(req);
-
-    eriter = dns_requests_by_key_.erase(eriter);
+    remove(&entries_[found]);
   }
 }
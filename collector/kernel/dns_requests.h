@@ -5,19 +5,28 @@
 
 #pragma once
 
-#include <list>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 #include <platform/platform.h>
 
+/**
+ * Outstanding DNS requests, waiting for a response or a timeout.
+ *
+ * Requests live in a pool allocated once at construction, so adding and
+ * removing requests never allocates. Two open-addressing (linear probing)
+ * indexes find requests by key and by socket, and a hashed timing wheel finds
+ * requests older than a timestamp without walking all outstanding requests.
+ */
 class DnsRequests {
   // Type declarations
 public:
   struct dns_request_key {
-    u16 qid;          // transaction id
-    u16 type;         // query type
-    std::string name; // query data
-    bool is_rx;       // was this request 'sent (client)' or 'received (server)'
+    u16 qid;               // transaction id
+    u16 type;              // query type
+    std::string_view name; // query data
+    u64 name_hash;         // name_hash(name), computed by BPF for parsed DNS records
+    bool is_rx;            // was this request 'sent (client)' or 'received (server)'
   };
 
   struct dns_request_value {
@@ -25,34 +34,141 @@ public:
     u64 sk;           // socket that sent the dns request
   };
 
-protected:
-  struct dns_request_key_hash {
-    size_t operator()(const dns_request_key &k) const noexcept;
-  };
-  struct dns_request_key_equal_to {
-    bool operator()(const dns_request_key &k, const dns_request_key &k2) const noexcept;
+  /* longest name suffix kept for each request, the most that is ever reported */
+  static constexpr u16 MAX_NAME_LENGTH = 256;
+
+  /* default maximum number of outstanding requests */
+  static constexpr u32 DEFAULT_CAPACITY = 16384;
+
+  /**
+   * An outstanding request.
+   */
+  class Entry {
+  public:
+    dns_request_value const &value() const { return value_; }
+
+    /* length of the full query name */
+    size_t name_length() const { return name_len_; }
+
+    /* the query name, truncated to its last MAX_NAME_LENGTH bytes */
+    std::string_view name() const { return std::string_view(name_, stored_name_len_); }
+
+  private:
+    friend class DnsRequests;
+
+    dns_request_value value_;
+    u64 name_hash_;
+    u32 key_hash_;
+    u32 sk_hash_;
+    u16 qid_;
+    u16 type_;
+    u16 name_len_;
+    u16 stored_name_len_;
+
+    /* links in a timing wheel slot, or in the free list (next only) */
+    u32 wheel_prev_;
+    u32 wheel_next_;
+    u32 wheel_slot_;
+
+    char name_[MAX_NAME_LENGTH];
   };
 
-  typedef std::list<std::pair<dns_request_key, dns_request_value>> DnsRequestsList;
-  typedef std::unordered_multimap<dns_request_key, DnsRequestsList::iterator, dns_request_key_hash, dns_request_key_equal_to>
-      DnsRequestsByKeyMap;
-  typedef std::unordered_multimap<u64, DnsRequestsList::iterator> DnsRequestsBySockMap;
+  typedef Entry const *Request;
 
-public:
-  typedef DnsRequestsList::iterator Request;
+  /**
+   * Hash of a question name, as dns_parse_query writes it; matches the hash BPF sends in dns_record messages.
+   */
+  static u64 name_hash(std::string_view name);
 
   // Public interface
 public:
-  void add(const dns_request_key &key, const dns_request_value &value);
-  void lookup(const dns_request_key &key, std::list<Request> &out);
-  void lookup_older_than(u64 timestamp_ns, std::list<Request> &out);
-  void lookup_socket(u64 sk, std::list<Request> &out);
-  void remove(const Request &req);
+  /**
+   * @param capacity: maximum number of outstanding requests
+   */
+  explicit DnsRequests(u32 capacity = DEFAULT_CAPACITY);
+
+  /* disallow copy and assignment, requests point into the pool */
+  DnsRequests(DnsRequests const &) = delete;
+  DnsRequests &operator=(DnsRequests const &) = delete;
+
+  /**
+   * Adds a request. Returns false, dropping the request, if `capacity`
+   * requests are already outstanding.
+   */
+  bool add(const dns_request_key &key, const dns_request_value &value);
+
+  /*
+   * The lookup functions append matching requests to @out, which callers can
+   * reuse across calls to avoid allocating. Requests stay valid until removed.
+   */
+  void lookup(const dns_request_key &key, std::vector<Request> &out) const;
+  void lookup_older_than(u64 timestamp_ns, std::vector<Request> &out);
+  void lookup_socket(u64 sk, std::vector<Request> &out) const;
+
+  void remove(Request req);
   void remove_all_with_key(const dns_request_key &key);
 
-  // Protected member variables
-protected:
-  DnsRequestsByKeyMap dns_requests_by_key_;
-  DnsRequestsList dns_requests_;
-  DnsRequestsBySockMap dns_requests_by_sock_;
+  size_t size() const { return size_; }
+  size_t capacity() const { return entries_.size(); }
+
+private:
+  static constexpr u32 INVALID = ~0u;
+
+  /* the timing wheel has WHEEL_SLOTS slots of 2^WHEEL_TICK_SHIFT ns (~268ms), ~17s around */
+  static constexpr u32 WHEEL_SLOTS = 64;
+  static constexpr u32 WHEEL_TICK_SHIFT = 28;
+
+  /**
+   * Open-addressing multiset of entry indexes, keyed by a 32-bit hash that
+   * the caller computes. Several entries can share a hash; callers filter
+   * candidates returned by `for_each`.
+   */
+  class Index {
+  public:
+    explicit Index(u32 capacity);
+
+    void insert(u32 hash, u32 entry);
+    void erase(u32 hash, u32 entry);
+
+    /* calls `f(entry)` for each entry inserted with @hash, and possibly others */
+    template <typename F> void for_each(u32 hash, F &&f) const
+    {
+      for (u32 i = hash & mask_; slots_[i].entry != INVALID; i = (i + 1) & mask_) {
+        if (slots_[i].hash == hash) {
+          f(slots_[i].entry);
+        }
+      }
+    }
+
+  private:
+    struct Slot {
+      u32 hash;
+      u32 entry;
+    };
+
+    std::vector<Slot> slots_;
+    u32 mask_;
+  };
+
+  static u32 key_hash(u16 qid, u16 type, u64 name_hash);
+  static u32 sk_hash(u64 sk);
+
+  bool matches(Entry const &entry, const dns_request_key &key, u32 hash) const;
+
+  u32 index_of(Request req) const { return static_cast<u32>(req - entries_.data()); }
+
+  void wheel_link(u32 index);
+  void wheel_unlink(u32 index);
+
+  std::vector<Entry> entries_;
+  u32 free_head_;
+  size_t size_ = 0;
+
+  Index by_key_;
+  Index by_sock_;
+
+  /* heads of the timing wheel slots */
+  u32 wheel_[WHEEL_SLOTS];
+  /* tick up to which lookup_older_than has expired requests */
+  u64 wheel_tick_ = 0;
 };
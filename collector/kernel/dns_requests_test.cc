@@ -0,0 +1,155 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "dns_requests.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr u64 SECOND_NS = 1'000'000'000ull;
+
+DnsRequests::dns_request_key make_key(u16 qid, std::string_view name)
+{
+  return DnsRequests::dns_request_key{
+      .qid = qid, .type = 1, .name = name, .name_hash = DnsRequests::name_hash(name), .is_rx = false};
+}
+
+} // namespace
+
+TEST(DnsRequestsTest, LookupByKey)
+{
+  DnsRequests requests(16);
+  std::vector<DnsRequests::Request> found;
+
+  EXPECT_TRUE(requests.add(make_key(1, "example.com"), {.timestamp_ns = 10, .sk = 100}));
+  EXPECT_TRUE(requests.add(make_key(2, "example.com"), {.timestamp_ns = 20, .sk = 100}));
+  EXPECT_TRUE(requests.add(make_key(1, "example.org"), {.timestamp_ns = 30, .sk = 200}));
+
+  requests.lookup(make_key(1, "example.com"), found);
+  ASSERT_EQ(1u, found.size());
+  EXPECT_EQ(10u, found[0]->value().timestamp_ns);
+  EXPECT_EQ("example.com", found[0]->name());
+
+  found.clear();
+  requests.lookup(make_key(3, "example.com"), found);
+  EXPECT_TRUE(found.empty());
+
+  // same qid and hash, different name
+  auto key = make_key(1, "example.net");
+  key.name_hash = DnsRequests::name_hash("example.com");
+  requests.lookup(key, found);
+  EXPECT_TRUE(found.empty());
+}
+
+TEST(DnsRequestsTest, RemoveAllWithKey)
+{
+  DnsRequests requests(16);
+  std::vector<DnsRequests::Request> found;
+
+  requests.add(make_key(1, "example.com"), {.timestamp_ns = 10, .sk = 100});
+  requests.add(make_key(1, "example.com"), {.timestamp_ns = 20, .sk = 200});
+  requests.add(make_key(2, "example.com"), {.timestamp_ns = 30, .sk = 100});
+
+  requests.lookup(make_key(1, "example.com"), found);
+  EXPECT_EQ(2u, found.size());
+
+  requests.remove_all_with_key(make_key(1, "example.com"));
+  EXPECT_EQ(1u, requests.size());
+
+  found.clear();
+  requests.lookup(make_key(1, "example.com"), found);
+  EXPECT_TRUE(found.empty());
+
+  requests.lookup_socket(100, found);
+  ASSERT_EQ(1u, found.size());
+  EXPECT_EQ(30u, found[0]->value().timestamp_ns);
+}
+
+TEST(DnsRequestsTest, LookupSocket)
+{
+  DnsRequests requests(16);
+  std::vector<DnsRequests::Request> found;
+
+  requests.add(make_key(1, "a.example.com"), {.timestamp_ns = 10, .sk = 100});
+  requests.add(make_key(2, "b.example.com"), {.timestamp_ns = 20, .sk = 100});
+  requests.add(make_key(3, "c.example.com"), {.timestamp_ns = 30, .sk = 200});
+
+  requests.lookup_socket(100, found);
+  EXPECT_EQ(2u, found.size());
+
+  for (auto req : found) {
+    requests.remove(req);
+  }
+  EXPECT_EQ(1u, requests.size());
+
+  found.clear();
+  requests.lookup_socket(100, found);
+  EXPECT_TRUE(found.empty());
+}
+
+TEST(DnsRequestsTest, LookupOlderThan)
+{
+  DnsRequests requests(64);
+  std::vector<DnsRequests::Request> found;
+
+  for (u16 i = 0; i < 30; i++) {
+    requests.add(make_key(i, "example.com"), {.timestamp_ns = 100 * SECOND_NS + i * SECOND_NS, .sk = 100});
+  }
+
+  requests.lookup_older_than(110 * SECOND_NS, found);
+  EXPECT_EQ(10u, found.size());
+  for (auto req : found) {
+    EXPECT_LT(req->value().timestamp_ns, 110 * SECOND_NS);
+    requests.remove(req);
+  }
+
+  // a late request, with a timestamp before the last lookup, still expires
+  requests.add(make_key(1000, "late.example.com"), {.timestamp_ns = 105 * SECOND_NS, .sk = 100});
+
+  found.clear();
+  requests.lookup_older_than(110 * SECOND_NS + SECOND_NS / 2, found);
+  ASSERT_EQ(2u, found.size());
+  for (auto req : found) {
+    requests.remove(req);
+  }
+
+  // more than a full turn of the wheel later, everything left expires
+  found.clear();
+  requests.lookup_older_than(1000 * SECOND_NS, found);
+  EXPECT_EQ(19u, found.size());
+  for (auto req : found) {
+    requests.remove(req);
+  }
+  EXPECT_EQ(0u, requests.size());
+}
+
+TEST(DnsRequestsTest, FullPool)
+{
+  DnsRequests requests(2);
+
+  EXPECT_TRUE(requests.add(make_key(1, "example.com"), {.timestamp_ns = 10, .sk = 100}));
+  EXPECT_TRUE(requests.add(make_key(2, "example.com"), {.timestamp_ns = 20, .sk = 100}));
+  EXPECT_FALSE(requests.add(make_key(3, "example.com"), {.timestamp_ns = 30, .sk = 100}));
+
+  requests.remove_all_with_key(make_key(1, "example.com"));
+  EXPECT_TRUE(requests.add(make_key(3, "example.com"), {.timestamp_ns = 30, .sk = 100}));
+}
+
+TEST(DnsRequestsTest, LongNameKeepsSuffix)
+{
+  DnsRequests requests(4);
+  std::vector<DnsRequests::Request> found;
+
+  std::string name(DnsRequests::MAX_NAME_LENGTH, 'a');
+  name += ".example.com";
+  requests.add(make_key(1, name), {.timestamp_ns = 10, .sk = 100});
+
+  requests.lookup(make_key(1, name), found);
+  ASSERT_EQ(1u, found.size());
+  EXPECT_EQ(name.size(), found[0]->name_length());
+  EXPECT_EQ(std::string_view(name).substr(name.size() - DnsRequests::MAX_NAME_LENGTH), found[0]->name());
+}
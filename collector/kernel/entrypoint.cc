@@ -311,6 +311,32 @@ static int kernel_collector_run(int argc, char **argv)
   args::Flag enable_userland_tcp_flag(
       *parser, "userland_tcp", "Enable userland tcp processing (experimental)", {"enable-userland-tcp"});
 
+  args::Flag enable_bpf_ring_buffer_flag(
+      *parser,
+      "bpf_ring_buffer",
+      "Send eBPF events through a single ring buffer instead of per-CPU perf rings, on kernels that support it (5.8+)",
+      {"enable-bpf-ring-buffer"});
+
+  args::Flag enable_in_kernel_tcp_stats_flag(
+      *parser,
+      "in_kernel_tcp_stats",
+      "Accumulate TCP socket statistics in eBPF maps and drain them once per stats interval, instead of sending events, on"
+      " kernels that support it (5.6+)",
+      {"enable-in-kernel-tcp-stats"});
+
+  args::Flag enable_in_kernel_dns_parsing_flag(
+      *parser,
+      "in_kernel_dns_parsing",
+      "Parse DNS packets in eBPF and send only queries, names and A/AAAA answers to user space, on kernels that support it"
+      " (5.3+)",
+      {"enable-in-kernel-dns-parsing"});
+
+  args::Flag disable_fentry_probes_flag(
+      *parser,
+      "disable_fentry_probes",
+      "Attach hot TCP probes as kprobes even when the kernel supports fentry programs (BTF, 5.5+)",
+      {"disable-fentry-probes"});
+
   auto force_docker_metadata = parser.add_flag("force-docker-metadata", "Forces the use of docker metadata");
   auto disable_nomad_metadata = parser.add_flag("disable-nomad-metadata", "Disables detection and use of Nomad metadata");
 
@@ -330,7 +356,7 @@ static int kernel_collector_run(int argc, char **argv)
 #ifndef NDEBUG
   auto schedule_bpf_lost_samples = parser.add_arg<std::chrono::seconds::rep>(
       "schedule-bpf-lost-samples",
-      "internal development - will continuously, at the interval in seconds provided, simulate lost BPF samples (PERF_RECORD_LOST) in BufferedPoller to test KernelCollector restarts via that code path");
+      "internal development - will continuously, at the interval in seconds provided, simulate lost BPF samples (PERF_RECORD_LOST) in BufferedPoller to test socket resyncs via that code path");
 #endif
 
   parser.new_handler<LogWhitelistHandler<AgentLogKind>>("agent-log");
@@ -408,6 +434,18 @@ static int kernel_collector_run(int argc, char **argv)
   bool const enable_userland_tcp = enable_userland_tcp_flag.Matched();
   LOG::info("Userland TCP: {}", enabled_disabled[enable_userland_tcp]);
 
+  bool const enable_bpf_ring_buffer = enable_bpf_ring_buffer_flag.Matched();
+  LOG::info("BPF ring buffer: {}", enabled_disabled[enable_bpf_ring_buffer]);
+
+  bool const enable_in_kernel_tcp_stats = enable_in_kernel_tcp_stats_flag.Matched();
+  LOG::info("In-kernel TCP stats: {}", enabled_disabled[enable_in_kernel_tcp_stats]);
+
+  bool const enable_in_kernel_dns_parsing = enable_in_kernel_dns_parsing_flag.Matched();
+  LOG::info("In-kernel DNS parsing: {}", enabled_disabled[enable_in_kernel_dns_parsing]);
+
+  bool const enable_fentry_probes = !disable_fentry_probes_flag.Matched();
+  LOG::info("fentry probes: {}", enabled_disabled[enable_fentry_probes]);
+
   /* Initialize curl */
   curlpp::initialize();
 
@@ -514,7 +552,11 @@ static int kernel_collector_run(int argc, char **argv)
     BpfConfiguration bpf_config{
         .boot_time_adjustment = boot_time_adjustment,
         .filter_ns = args::get(filter_ns),
-        .enable_tcp_data_stream = enable_userland_tcp};
+        .enable_tcp_data_stream = enable_userland_tcp,
+        .use_ring_buffer = enable_bpf_ring_buffer,
+        .tcp_stats_in_kernel = enable_in_kernel_tcp_stats,
+        .use_fentry = enable_fentry_probes,
+        .dns_parse_in_kernel = enable_in_kernel_dns_parsing};
 
     uv_timer_t refill_log_rate_limit_timer;
     if (!disable_log_rate_limit) {
@@ -8,7 +8,9 @@
 #include <platform/platform.h>
 #include <util/lookup3.h>
 
+#include <cstring>
 #include <functional>
+#include <utility>
 
 // Struct represents the 4-tuple of a connection
 // NOTE: when used as a key, src_port and dst_port are in network byte order
@@ -27,8 +29,18 @@ struct hostport_tuple {
   }
 
   hostport_tuple reversed() const { return {dst_ip, src_ip, dst_port, src_port, proto}; }
+
+  // Hashes the tuple as two 64-bit words, rather than field by field.
+  template <typename H> friend H AbslHashValue(H hash_state, const hostport_tuple &t)
+  {
+    u64 words[2];
+    memcpy(words, &t, sizeof(words));
+    return H::combine(std::move(hash_state), words[0], words[1]);
+  }
 };
 
+static_assert(sizeof(hostport_tuple) == 2 * sizeof(u64), "hostport_tuple must be two words with no padding");
+
 namespace std {
 template <> struct hash<hostport_tuple> {
   size_t operator()(const hostport_tuple &t) const noexcept
@@ -0,0 +1,138 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <generated/ebpf_net/agent_internal/wire_message.h>
+#include <generated/ebpf_net/ingest/wire_message.h>
+
+#include <platform/platform.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+/**
+ * agent_internal messages that the kernel collector forwards upstream
+ * unchanged, as an ingest message declared with the same fields.
+ *
+ * Both messages have the same wire layout, so with the binary encoder the
+ * agent_internal message (timestamp included) is copied to the upstream
+ * buffer as is, and only its rpc id is rewritten.
+ *
+ * `IngestPassthrough<jb_agent_internal__X>` is defined for each such message:
+ *  - `message`: the ingest wire message
+ *  - `rpc_id`: the ingest message's rpc id
+ *  - `size`: the size of both wire messages
+ *
+ * The layouts are checked at compile time, so a change to either message in
+ * render/ebpf_net.render that breaks the equivalence fails the build.
+ */
+template <typename AgentMessage> struct IngestPassthrough;
+
+#define INGEST_PASSTHROUGH(AGENT_NAME, INGEST_NAME)                                                                            \
+  template <> struct IngestPassthrough<jb_agent_internal__##AGENT_NAME> {                                                     \
+    using message = jb_ingest__##INGEST_NAME;                                                                                  \
+    static constexpr u16 rpc_id = jb_ingest__##INGEST_NAME##__rpc_id;                                                        \
+    static constexpr u32 size = jb_ingest__##INGEST_NAME##__data_size;                                                       \
+  };                                                                                                                           \
+  static_assert(                                                                                                               \
+      jb_agent_internal__##AGENT_NAME##__data_size == jb_ingest__##INGEST_NAME##__data_size,                                   \
+      "agent_internal " #AGENT_NAME " and ingest " #INGEST_NAME " have different sizes")
+
+#define INGEST_PASSTHROUGH_FIELD(AGENT_NAME, INGEST_NAME, FIELD)                                                               \
+  static_assert(                                                                                                               \
+      offsetof(jb_agent_internal__##AGENT_NAME, FIELD) == offsetof(jb_ingest__##INGEST_NAME, FIELD) &&                         \
+          sizeof(jb_agent_internal__##AGENT_NAME::FIELD) == sizeof(jb_ingest__##INGEST_NAME::FIELD),                           \
+      "agent_internal " #AGENT_NAME " and ingest " #INGEST_NAME " lay out `" #FIELD "` differently")
+
+INGEST_PASSTHROUGH(set_state_ipv4, set_state_ipv4);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv4, set_state_ipv4, dest);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv4, set_state_ipv4, src);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv4, set_state_ipv4, dport);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv4, set_state_ipv4, sport);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv4, set_state_ipv4, sk);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv4, set_state_ipv4, tx_rx);
+
+INGEST_PASSTHROUGH(set_state_ipv6, set_state_ipv6);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv6, set_state_ipv6, dest);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv6, set_state_ipv6, src);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv6, set_state_ipv6, dport);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv6, set_state_ipv6, sport);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv6, set_state_ipv6, sk);
+INGEST_PASSTHROUGH_FIELD(set_state_ipv6, set_state_ipv6, tx_rx);
+
+INGEST_PASSTHROUGH(close_sock_info, close_sock_info);
+INGEST_PASSTHROUGH_FIELD(close_sock_info, close_sock_info, sk);
+
+INGEST_PASSTHROUGH(tcp_syn_timeout, syn_timeout);
+INGEST_PASSTHROUGH_FIELD(tcp_syn_timeout, syn_timeout, sk);
+
+INGEST_PASSTHROUGH(tcp_reset, tcp_reset);
+INGEST_PASSTHROUGH_FIELD(tcp_reset, tcp_reset, sk);
+INGEST_PASSTHROUGH_FIELD(tcp_reset, tcp_reset, is_rx);
+
+INGEST_PASSTHROUGH(http_response, http_response);
+INGEST_PASSTHROUGH_FIELD(http_response, http_response, sk);
+INGEST_PASSTHROUGH_FIELD(http_response, http_response, pid);
+INGEST_PASSTHROUGH_FIELD(http_response, http_response, code);
+INGEST_PASSTHROUGH_FIELD(http_response, http_response, latency_ns);
+INGEST_PASSTHROUGH_FIELD(http_response, http_response, client_server);
+
+INGEST_PASSTHROUGH(pid_close, pid_close_info);
+INGEST_PASSTHROUGH_FIELD(pid_close, pid_close_info, pid);
+INGEST_PASSTHROUGH_FIELD(pid_close, pid_close_info, comm);
+
+INGEST_PASSTHROUGH(pid_set_comm, pid_set_comm);
+INGEST_PASSTHROUGH_FIELD(pid_set_comm, pid_set_comm, pid);
+INGEST_PASSTHROUGH_FIELD(pid_set_comm, pid_set_comm, comm);
+
+INGEST_PASSTHROUGH(css_populate_dir, cgroup_create);
+INGEST_PASSTHROUGH_FIELD(css_populate_dir, cgroup_create, cgroup);
+INGEST_PASSTHROUGH_FIELD(css_populate_dir, cgroup_create, cgroup_parent);
+INGEST_PASSTHROUGH_FIELD(css_populate_dir, cgroup_create, name);
+
+INGEST_PASSTHROUGH(existing_cgroup_probe, cgroup_create);
+INGEST_PASSTHROUGH_FIELD(existing_cgroup_probe, cgroup_create, cgroup);
+INGEST_PASSTHROUGH_FIELD(existing_cgroup_probe, cgroup_create, cgroup_parent);
+INGEST_PASSTHROUGH_FIELD(existing_cgroup_probe, cgroup_create, name);
+
+#undef INGEST_PASSTHROUGH_FIELD
+#undef INGEST_PASSTHROUGH
+
+/**
+ * Writes @msg, preceded by @timestamp, to @dest as the ingest message.
+ *
+ * @dest must have room for `sizeof(u64) + IngestPassthrough<AgentMessage>::size` bytes.
+ */
+template <typename AgentMessage> inline void encode_passthrough(u8 *dest, u64 timestamp, AgentMessage const &msg)
+{
+  using passthrough = IngestPassthrough<AgentMessage>;
+
+  u16 const rpc_id = passthrough::rpc_id;
+  memcpy(dest, &timestamp, sizeof(u64));
+  memcpy(dest + sizeof(u64), &msg, passthrough::size);
+  memcpy(dest + sizeof(u64), &rpc_id, sizeof(rpc_id));
+}
+
+/**
+ * Writes a sample holding an AgentMessage to @dest as the ingest message,
+ * reading the sample in place.
+ *
+ * @sample: the timestamp and message, as returned by `PerfReader::peek_message()`;
+ *   the second chunk is not empty when the sample wraps around the ring
+ * @dest must have room for both chunks.
+ */
+template <typename AgentMessage>
+inline void encode_passthrough_sample(u8 *dest, std::pair<std::string_view, std::string_view> const &sample)
+{
+  using passthrough = IngestPassthrough<AgentMessage>;
+
+  u16 const rpc_id = passthrough::rpc_id;
+  memcpy(dest, sample.first.data(), sample.first.size());
+  memcpy(dest + sample.first.size(), sample.second.data(), sample.second.size());
+  memcpy(dest + sizeof(u64), &rpc_id, sizeof(rpc_id));
+}
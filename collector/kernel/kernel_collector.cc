@@ -12,6 +12,7 @@
 #include <common/cloud_platform.h>
 #include <common/collector_status.h>
 #include <platform/userspace-time.h>
+#include <util/compression_dictionary.h>
 #include <util/log.h>
 #include <util/log_formatters.h>
 #include <util/resource_usage_reporter.h>
@@ -208,6 +209,14 @@ void KernelCollector::polling_steady_state(uv_timer_t *timer)
     return;
   }
 
+  /* follow the interval the poller picked from how full the perf rings were */
+  u64 const interval_ms = bpf_handler_->poll_interval().count();
+  if (interval_ms != uv_timer_get_repeat(&polling_timer_)) {
+    if (uv_timer_start(&polling_timer_, __polling_steady_state_cb, interval_ms, interval_ms) != 0) {
+      log_.error("Could not restart polling_timer with a {}ms interval", interval_ms);
+    }
+  }
+
   /* only print when some messages got lost */
   if (bpf_handler_->serv_lost_count() > last_lost_count_) {
     last_lost_count_ = bpf_handler_->serv_lost_count();
@@ -252,6 +261,7 @@ void KernelCollector::on_upstream_connected()
 void KernelCollector::on_connected()
 {
   LOG::trace("Connected, entering probe hold-off");
+  pace_initial_dump_ = false;
   enter_probe_holdoff();
 
   heartbeat_sender_.start(HEARTBEAT_INTERVAL, HEARTBEAT_INTERVAL);
@@ -259,20 +269,10 @@ void KernelCollector::on_connected()
 
 void KernelCollector::probe_holdoff_timeout(uv_timer_t *timer)
 {
-  auto const upstream_connection_flush_and_close = [this]() {
-    upstream_connection_.flush();
-    upstream_connection_.close();
-  };
-
   LOG::trace("Adding probes");
 
   last_probe_monotonic_time_ns_ = monotonic();
 
-  auto const handle_exception = [&](TroubleshootItem item, std::exception const &e) {
-    log_.error("Exception during BPFHandler initialization, closing connection: {}", e.what());
-    print_troubleshooting_message_and_exit(host_info_, item, e, log_, upstream_connection_flush_and_close);
-  };
-
   auto potential_troubleshoot_item = TroubleshootItem::bpf_load_probes_failed;
   try {
     bpf_handler_.emplace(loop_, bpf_config_, enable_http_metrics_, bpf_dump_file_, log_, encoder_.get(), host_info_);
@@ -290,7 +290,22 @@ void KernelCollector::probe_holdoff_timeout(uv_timer_t *timer)
         kernel_collector_restarter_);
 
     potential_troubleshoot_item = TroubleshootItem::bpf_load_probes_failed;
-    bpf_handler_->load_probes(writer_);
+    bpf_handler_->load_probes(writer_, pace_initial_dump_, [this](std::exception_ptr error) { on_probes_loaded(error); });
+  } catch (std::system_error &e) {
+    handle_startup_exception(
+        e.code().value() == EPERM ? TroubleshootItem::operation_not_permitted : potential_troubleshoot_item, e);
+  } catch (std::exception &e) {
+    handle_startup_exception(potential_troubleshoot_item, e);
+  }
+}
+
+void KernelCollector::on_probes_loaded(std::exception_ptr error)
+{
+  auto potential_troubleshoot_item = TroubleshootItem::bpf_load_probes_failed;
+  try {
+    if (error) {
+      std::rethrow_exception(error);
+    }
 
     /* Start running buf_poller in steady-state */
     potential_troubleshoot_item = TroubleshootItem::unexpected_exception;
@@ -303,18 +318,24 @@ void KernelCollector::probe_holdoff_timeout(uv_timer_t *timer)
 
     enter_polling_state();
   } catch (std::system_error &e) {
-    if (e.code().value() == EPERM) {
-      handle_exception(TroubleshootItem::operation_not_permitted, e);
-      return;
-    }
-    handle_exception(potential_troubleshoot_item, e);
-    return;
+    handle_startup_exception(
+        e.code().value() == EPERM ? TroubleshootItem::operation_not_permitted : potential_troubleshoot_item, e);
   } catch (std::exception &e) {
-    handle_exception(potential_troubleshoot_item, e);
-    return;
+    handle_startup_exception(potential_troubleshoot_item, e);
   }
 }
 
+void KernelCollector::handle_startup_exception(TroubleshootItem item, std::exception const &e)
+{
+  auto const upstream_connection_flush_and_close = [this]() {
+    upstream_connection_.flush();
+    upstream_connection_.close();
+  };
+
+  log_.error("Exception during BPFHandler initialization, closing connection: {}", e.what());
+  print_troubleshooting_message_and_exit(host_info_, item, e, log_, upstream_connection_flush_and_close);
+}
+
 void KernelCollector::send_connection_metadata()
 {
   // send a version_info message
@@ -524,6 +545,22 @@ void KernelCollector::handle_received_command(u64 command)
   if (command == static_cast<u64>(ServerCommand::DISABLE_SEND)) {
     LOG::info("Stop sending data, instructed by the server.");
     disabled_ = true;
+  } else if (command == static_cast<u64>(ServerCommand::PACE_INITIAL_DUMP)) {
+    LOG::info("Pacing the initial dump of existing state, instructed by the server.");
+    pace_initial_dump_ = true;
+  } else if (is_server_command(command, ServerCommand::COMPRESSION_DICTIONARY)) {
+    auto const dictionary_id = server_command_argument(command);
+    if (dictionary_id != compression_dictionary_id()) {
+      LOG::info(
+          "Keeping LZ4 compression: the server's compression dictionary ({}) differs from ours ({}).",
+          dictionary_id,
+          compression_dictionary_id());
+    } else if (!intake_config_.allow_compression() || intake_config_.compression_level() == 0) {
+      LOG::debug("Declining dictionary compression offered by the server.");
+    } else {
+      LOG::info("Compressing with the dictionary offered by the server, level {}.", intake_config_.compression_level());
+      upstream_connection_.enable_dictionary_compression(intake_config_.compression_level());
+    }
   }
 }
 
@@ -11,6 +11,7 @@
 #include <collector/kernel/bpf_handler.h>
 #include <collector/kernel/kernel_collector_restarter.h>
 #include <collector/kernel/probe_handler.h>
+#include <collector/kernel/troubleshoot_item.h>
 #include <common/host_info.h>
 #include <config/intake_config.h>
 #include <generated/ebpf_net/ingest/writer.h>
@@ -23,6 +24,7 @@
 
 #include <uv.h>
 
+#include <exception>
 #include <map>
 
 class KernelCollector {
@@ -122,6 +124,12 @@ private:
   /* enter polling steady state */
   void enter_polling_state();
 
+  /* called once BPF probes are loaded, with the exception thrown while loading them, if any */
+  void on_probes_loaded(std::exception_ptr error);
+
+  /* reports an exception thrown while starting BPF, and exits */
+  void handle_startup_exception(TroubleshootItem item, std::exception const &e);
+
   /* stops all timers */
   void stop_all_timers();
 
@@ -160,6 +168,10 @@ private:
 
   bool disabled_ = false;
 
+  // Set when the server asks for the initial dump of existing state to be
+  // paced, for the current connection.
+  bool pace_initial_dump_ = false;
+
   /* lib_uv objects */
   uv_loop_t &loop_;
   uv_timer_t try_connecting_timer_;
@@ -10,7 +10,8 @@
 class KernelCollector;
 
 /**
- * Helper class to facilitate restarting KernelCollector, i.e. when BufferedPoller detects lost BPF samples (PERF_RECORD_LOST).
+ * Helper class to facilitate restarting KernelCollector, i.e. when BufferedPoller detects lost BPF samples (PERF_RECORD_LOST)
+ * before all probes are loaded. Losses in steady state are recovered by resyncing sockets instead.
  * If KernelCollector startup has completed, then a restart request will be processed immediately.
  * If KernelCollector startup has not completed, then the processing of a restart request will be deferred until after
  * KernelCollector startup has completed.
@@ -79,13 +79,12 @@ void NatHandler::handle_nf_conntrack_alter_reply(u64 timestamp, struct jb_agent_
       .proto = msg->proto,
   };
 
-  record_nat(map_from, map_to);
+  auto const &entry = record_nat(map_from, map_to);
 
   // If we've seen an sk for this four-tuple already, we can report to the
   // server
-  if (auto sk_pos = existing_sk_table_.find(map_from); sk_pos != existing_sk_table_.end()) {
-    u64 sk = sk_pos->second;
-    send_nat_remapping(timestamp, sk, map_to);
+  if (entry.sk != 0) {
+    send_nat_remapping(timestamp, entry.sk, map_to);
   } else {
     LOG::trace_in(AgentLogKind::NAT, "sk doesn't exist for this four-tuple yet");
   }
@@ -196,15 +195,16 @@ void NatHandler::handle_set_state_ipv4(u64 timestamp, jb_agent_internal__set_sta
       .proto = IPPROTO_TCP,
   };
 
-  record_sk(sk, ft);
+  auto const &entry = record_sk(sk, ft);
 
   // We had a NAT table entry before getting the socket info.
-  if (auto mapping = nat_table_.find(ft); mapping != nat_table_.end()) {
-    send_nat_remapping(timestamp, sk, mapping->second);
+  if (entry.has_nat_to) {
+    send_nat_remapping(timestamp, sk, entry.nat_to);
   }
 
-  if (auto rev_mapping = nat_table_rev_.find(ft.reversed()); rev_mapping != nat_table_rev_.end()) {
-    send_nat_remapping(timestamp, sk, rev_mapping->second.reversed());
+  if (auto rev_mapping = tuple_table_.find(ft.reversed());
+      rev_mapping != tuple_table_.end() && rev_mapping->second.has_nat_from) {
+    send_nat_remapping(timestamp, sk, rev_mapping->second.nat_from.reversed());
   }
 }
 
@@ -253,15 +253,16 @@ void NatHandler::handle_set_state_ipv6(u64 timestamp, jb_agent_internal__set_sta
       .proto = IPPROTO_TCP,
   };
 
-  record_sk(sk, ft);
+  auto const &entry = record_sk(sk, ft);
 
   // We had a NAT table entry before getting the socket info.
-  if (auto mapping = nat_table_.find(ft); mapping != nat_table_.end()) {
-    send_nat_remapping(timestamp, sk, mapping->second);
+  if (entry.has_nat_to) {
+    send_nat_remapping(timestamp, sk, entry.nat_to);
   }
 
-  if (auto rev_mapping = nat_table_rev_.find(ft.reversed()); rev_mapping != nat_table_rev_.end()) {
-    send_nat_remapping(timestamp, sk, rev_mapping->second.reversed());
+  if (auto rev_mapping = tuple_table_.find(ft.reversed());
+      rev_mapping != tuple_table_.end() && rev_mapping->second.has_nat_from) {
+    send_nat_remapping(timestamp, sk, rev_mapping->second.nat_from.reversed());
   }
 }
 
@@ -270,12 +271,12 @@ void NatHandler::handle_close_socket(u64 timestamp, jb_agent_internal__close_soc
   remove_sk(msg->sk);
 }
 
-void NatHandler::record_sk(u64 sk, hostport_tuple const &ft)
+NatHandler::tuple_entry &NatHandler::record_sk(u64 sk, hostport_tuple const &ft)
 {
   // We were hitting the assert in remove_sk(), which happens if two sk's use
   // the same four-tuple without a call to remove_sk() in-between.
-  if (auto search = existing_sk_table_.find(ft); search != existing_sk_table_.end()) {
-    const auto &existing_sk = search->second;
+  if (auto search = tuple_table_.find(ft); search != tuple_table_.end() && search->second.sk != 0) {
+    const u64 existing_sk = search->second.sk;
     LOG::debug_in(
         AgentLogKind::NAT,
         "NatHandler::record_sk: rewriting existing ft->sk mapping: "
@@ -292,7 +293,7 @@ void NatHandler::record_sk(u64 sk, hostport_tuple const &ft)
   // There was also an edge-case where we'd have a memory leak of the same sk
   // gets used for two-dfferent four-tuples without a call to remove_sk()
   // in-between.
-  if (auto rev_search = existing_sk_table_rev_.find(sk); rev_search != existing_sk_table_rev_.end()) {
+  if (auto rev_search = sk_table_.find(sk); rev_search != sk_table_.end()) {
     const auto &existing_ft = rev_search->second;
     LOG::debug_in(
         AgentLogKind::NAT,
@@ -310,31 +311,46 @@ void NatHandler::record_sk(u64 sk, hostport_tuple const &ft)
     remove_sk(sk);
   }
 
-  existing_sk_table_[ft] = sk;
-  existing_sk_table_rev_[sk] = ft;
+  sk_table_[sk] = ft;
+
+  auto &entry = tuple_table_[ft];
+  entry.sk = sk;
+  return entry;
 }
 
 void NatHandler::remove_sk(u64 sk)
 {
-  auto rev_search = existing_sk_table_rev_.find(sk);
-  if (rev_search == existing_sk_table_rev_.end()) {
+  auto rev_search = sk_table_.find(sk);
+  if (rev_search == sk_table_.end()) {
     // TODO: this happens pretty frequently. Initially this would happen in the
     // gap between the end and set_state probes. However, this would also happen
     // if any socket closes without reaching established as well.
     return;
   }
-  auto search = existing_sk_table_.find(rev_search->second);
-  assert(search != existing_sk_table_.end()); // tuple should be in existing_sk_table_
+  auto search = tuple_table_.find(rev_search->second);
+  assert(search != tuple_table_.end() && search->second.sk == sk); // tuple should be in tuple_table_
+
+  sk_table_.erase(rev_search);
+  if (search != tuple_table_.end()) {
+    search->second.sk = 0;
+    if (search->second.empty()) {
+      tuple_table_.erase(search);
+    }
+  }
+}
 
-  existing_sk_table_rev_.erase(rev_search);
-  existing_sk_table_.erase(search);
+void NatHandler::erase_if_empty(hostport_tuple const &ft)
+{
+  if (auto it = tuple_table_.find(ft); it != tuple_table_.end() && it->second.empty()) {
+    tuple_table_.erase(it);
+  }
 }
 
-void NatHandler::record_nat(hostport_tuple const &map_from, hostport_tuple const &map_to)
+NatHandler::tuple_entry &NatHandler::record_nat(hostport_tuple const &map_from, hostport_tuple const &map_to)
 {
   // Clean up possible previous records.
   //
-  if (auto it = nat_table_.find(map_from); it != nat_table_.end()) {
+  if (auto it = tuple_table_.find(map_from); it != tuple_table_.end() && it->second.has_nat_to) {
     // map_from->some_to exist, remove some_to->map_from
     LOG::debug_in(
         AgentLogKind::NAT,
@@ -345,10 +361,10 @@ void NatHandler::record_nat(hostport_tuple const &map_from, hostport_tuple const
         ntohs(map_from.src_port),
         IPv4Address::from(map_from.dst_ip),
         ntohs(map_from.dst_port),
-        IPv4Address::from(it->second.src_ip),
-        ntohs(it->second.src_port),
-        IPv4Address::from(it->second.dst_ip),
-        ntohs(it->second.dst_port),
+        IPv4Address::from(it->second.nat_to.src_ip),
+        ntohs(it->second.nat_to.src_port),
+        IPv4Address::from(it->second.nat_to.dst_ip),
+        ntohs(it->second.nat_to.dst_port),
         IPv4Address::from(map_from.src_ip),
         ntohs(map_from.src_port),
         IPv4Address::from(map_from.dst_ip),
@@ -357,19 +373,25 @@ void NatHandler::record_nat(hostport_tuple const &map_from, hostport_tuple const
         ntohs(map_to.src_port),
         IPv4Address::from(map_to.dst_ip),
         ntohs(map_to.dst_port));
-    nat_table_rev_.erase(it->second);
+    // map_from is mapped again below
+    it->second.has_nat_to = false;
+    hostport_tuple const some_to = it->second.nat_to;
+    if (auto some_to_it = tuple_table_.find(some_to); some_to_it != tuple_table_.end()) {
+      some_to_it->second.has_nat_from = false;
+    }
+    erase_if_empty(some_to);
   }
-  if (auto rev_it = nat_table_rev_.find(map_to); rev_it != nat_table_rev_.end()) {
+  if (auto rev_it = tuple_table_.find(map_to); rev_it != tuple_table_.end() && rev_it->second.has_nat_from) {
     // map_to->some_from exists, remove some_from->map_to
     LOG::debug_in(
         AgentLogKind::NAT,
         "NatHandler::record_nat: rewriting existing reverse mapping: "
         "({}:{},{}:{})<-({}:{},{}:{}) with "
         "({}:{},{}:{})<-({}:{},{}:{})",
-        IPv4Address::from(rev_it->second.src_ip),
-        ntohs(rev_it->second.src_port),
-        IPv4Address::from(rev_it->second.dst_ip),
-        ntohs(rev_it->second.dst_port),
+        IPv4Address::from(rev_it->second.nat_from.src_ip),
+        ntohs(rev_it->second.nat_from.src_port),
+        IPv4Address::from(rev_it->second.nat_from.dst_ip),
+        ntohs(rev_it->second.nat_from.dst_port),
         IPv4Address::from(map_to.src_ip),
         ntohs(map_to.src_port),
         IPv4Address::from(map_to.dst_ip),
@@ -382,19 +404,44 @@ void NatHandler::record_nat(hostport_tuple const &map_from, hostport_tuple const
         ntohs(map_to.src_port),
         IPv4Address::from(map_to.dst_ip),
         ntohs(map_to.dst_port));
-    nat_table_.erase(rev_it->second);
+    // map_to is mapped again below
+    rev_it->second.has_nat_from = false;
+    hostport_tuple const some_from = rev_it->second.nat_from;
+    if (auto some_from_it = tuple_table_.find(some_from); some_from_it != tuple_table_.end()) {
+      some_from_it->second.has_nat_to = false;
+    }
+    erase_if_empty(some_from);
   }
 
-  nat_table_[map_from] = map_to;
-  nat_table_rev_[map_to] = map_from;
+  auto &to_entry = tuple_table_[map_to];
+  to_entry.nat_from = map_from;
+  to_entry.has_nat_from = true;
+
+  // inserted last, so that the returned reference stays valid
+  auto &from_entry = tuple_table_[map_from];
+  from_entry.nat_to = map_to;
+  from_entry.has_nat_to = true;
+  return from_entry;
 }
 
 void NatHandler::remove_nat(hostport_tuple const &map_from)
 {
-  if (auto it = nat_table_.find(map_from); it != nat_table_.end()) {
-    const auto &map_to = it->second;
-    nat_table_rev_.erase(map_to);
-    nat_table_.erase(it);
+  auto it = tuple_table_.find(map_from);
+  if (it == tuple_table_.end() || !it->second.has_nat_to) {
+    return;
+  }
+
+  hostport_tuple const map_to = it->second.nat_to;
+  it->second.has_nat_to = false;
+  if (it->second.empty()) {
+    tuple_table_.erase(it);
+  }
+
+  if (auto rev_it = tuple_table_.find(map_to); rev_it != tuple_table_.end()) {
+    rev_it->second.has_nat_from = false;
+    if (rev_it->second.empty()) {
+      tuple_table_.erase(rev_it);
+    }
   }
 }
 
@@ -419,9 +466,9 @@ hostport_tuple *NatHandler::get_nat_mapping(u32 src, u32 dst, u16 sport, u16 dpo
       proto,
   };
 
-  if (auto it = nat_table_.find(ft); it != nat_table_.end()) {
+  if (auto it = tuple_table_.find(ft); it != tuple_table_.end() && it->second.has_nat_to) {
     LOG::trace_in(AgentLogKind::NAT, "mapping found");
-    return &(it->second);
+    return &(it->second.nat_to);
   } else {
     LOG::trace_in(AgentLogKind::NAT, "no mapping found");
     return nullptr;
@@ -441,5 +488,42 @@ void NatHandler::send_nat_remapping(u64 timestamp, u64 sk, hostport_tuple const
         ntohs(ft.dst_port));
   }
 
-  writer_.nat_remapping_tstamp(timestamp, sk, ft.src_ip, ft.dst_ip, ft.src_port, ft.dst_port);
+  // sockets are often remapped more than once in a burst of conntrack events:
+  // only the last mapping is sent, when the poll ends
+  if (auto [it, inserted] = pending_remapping_index_.try_emplace(sk, pending_remappings_.size()); inserted) {
+    pending_remappings_.push_back({.timestamp = timestamp, .sk = sk, .ft = ft});
+  } else {
+    auto &pending = pending_remappings_[it->second];
+    pending.timestamp = timestamp;
+    pending.ft = ft;
+  }
+}
+
+void NatHandler::flush_nat_remappings()
+{
+  for (auto const &pending : pending_remappings_) {
+    if (pending.sk == 0) {
+      continue; // already sent by flush_nat_remapping()
+    }
+    writer_.nat_remapping_tstamp(
+        pending.timestamp, pending.sk, pending.ft.src_ip, pending.ft.dst_ip, pending.ft.src_port, pending.ft.dst_port);
+  }
+
+  pending_remappings_.clear();
+  pending_remapping_index_.clear();
+}
+
+void NatHandler::flush_nat_remapping(u64 sk)
+{
+  auto it = pending_remapping_index_.find(sk);
+  if (it == pending_remapping_index_.end()) {
+    return;
+  }
+
+  auto &pending = pending_remappings_[it->second];
+  writer_.nat_remapping_tstamp(
+      pending.timestamp, pending.sk, pending.ft.src_ip, pending.ft.dst_ip, pending.ft.src_port, pending.ft.dst_port);
+
+  pending.sk = 0;
+  pending_remapping_index_.erase(it);
 }
@@ -14,7 +14,11 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <vector>
+
 class NatHandler {
+  friend class NatHandlerTest;
+
 public:
   /**
    * c'tor
@@ -33,46 +37,79 @@ public:
 
   void handle_close_socket(u64 timestamp, jb_agent_internal__close_sock_info *msg);
 
-  // Returns a pointer to the corresponding val for a key we lookup
-  // in the nat_table_. If there is no corresponding val, return nullptr.
+  // Returns a pointer to the NAT mapping of the given 4-tuple (as the
+  // original direction of a conntrack entry). If there is none, returns
+  // nullptr.
   hostport_tuple *get_nat_mapping(u32 src, u32 dst, u16 sport, u16 dport, u32 proto);
 
-private:
-  // Maps the IP_CT_DIR_ORIGINAL 4-tuple of a conntrack entry to the
-  // IP_CT_DIR_REPLY 4-tuple of a conntrack entry. Only contains NAT-ed
-  // connections
-  absl::flat_hash_map<hostport_tuple, hostport_tuple> nat_table_;
+  // Sends the nat_remapping messages queued since the last call, one per
+  // socket. Called once per poll, after all of its events are handled.
+  void flush_nat_remappings();
 
-  // Maps replies to originals.
-  absl::flat_hash_map<hostport_tuple, hostport_tuple> nat_table_rev_;
+  // Sends the nat_remapping message queued for `sk`, if any. Called before
+  // messages that depend on the socket's addresses, like its last stats.
+  void flush_nat_remapping(u64 sk);
+
+private:
+  // What is known about a 4-tuple. A single table holds all of it, so that
+  // each conntrack or socket event needs one lookup per tuple it touches.
+  struct tuple_entry {
+    // If has_nat_to, the tuple is the IP_CT_DIR_ORIGINAL 4-tuple of a NAT-ed
+    // conntrack entry, and nat_to its IP_CT_DIR_REPLY 4-tuple.
+    hostport_tuple nat_to;
+    // If has_nat_from, the tuple is the IP_CT_DIR_REPLY 4-tuple of a NAT-ed
+    // conntrack entry, and nat_from its IP_CT_DIR_ORIGINAL 4-tuple.
+    hostport_tuple nat_from;
+    // The socket using this tuple, or 0. Used so we don't send NAT msgs for
+    // sk's we haven't seen a set_state_ipv4 msg for yet.
+    u64 sk = 0;
+    bool has_nat_to = false;
+    bool has_nat_from = false;
+
+    bool empty() const { return !has_nat_to && !has_nat_from && sk == 0; }
+  };
+
+  absl::flat_hash_map<hostport_tuple, tuple_entry> tuple_table_;
+
+  // Maps a socket to the tuple it uses in tuple_table_, for cleanup.
+  absl::flat_hash_map<u64, hostport_tuple> sk_table_;
 
   // Maps a struct nf_conntrack_tuple* to the corresponding 4-tuple.
   // Used when we iterate over existing conntrack entries.
   absl::flat_hash_map<u64, hostport_tuple> existing_conntrack_table_;
 
-  // Maps a 4-tuple to its corresponding sk. Used to keep track of
-  // existing sk's so we don't send NAT msgs for sk's we haven't
-  // seen a set_state_ipv4 msg for yet.
-  absl::flat_hash_map<hostport_tuple, u64> existing_sk_table_;
-
-  // A reverse index of our existing_sk_table_ so that we can do cleanup later.
-  absl::flat_hash_map<u64, hostport_tuple> existing_sk_table_rev_;
+  // nat_remapping messages not sent yet, in the order sockets were first
+  // remapped; a socket remapped again replaces its queued message.
+  struct pending_remapping {
+    u64 timestamp;
+    u64 sk;
+    hostport_tuple ft;
+  };
+  std::vector<pending_remapping> pending_remappings_;
+  // index of each socket's message in pending_remappings_
+  absl::flat_hash_map<u64, std::size_t> pending_remapping_index_;
 
   ::ebpf_net::ingest::Writer &writer_;
   logging::Logger &log_;
 
-  // Adds the mapping between a socket and its (local,remote) tuple.
-  void record_sk(u64 sk, hostport_tuple const &ft);
+  // Adds the mapping between a socket and its (local,remote) tuple, returning
+  // the tuple's entry.
+  tuple_entry &record_sk(u64 sk, hostport_tuple const &ft);
 
-  // Removes an entry from our existing_sk_table_
+  // Removes the mapping between a socket and its tuple.
   void remove_sk(u64 sk);
 
-  // Adds the specified NAT mapping to internal tables.
-  void record_nat(hostport_tuple const &map_from, hostport_tuple const &map_to);
+  // Removes `ft` from tuple_table_ if nothing is known about it anymore.
+  void erase_if_empty(hostport_tuple const &ft);
+
+  // Adds the specified NAT mapping to internal tables, returning the entry of
+  // map_from.
+  tuple_entry &record_nat(hostport_tuple const &map_from, hostport_tuple const &map_to);
 
   // Removes the specified NAT mapping from internal tables.
   void remove_nat(hostport_tuple const &map_from);
 
-  // Sends the nat_remapping message to the specified socket.
+  // Queues the nat_remapping message to the specified socket, replacing one
+  // already queued for it.
   void send_nat_remapping(u64 timestamp, u64 sk, hostport_tuple const &ft);
 };
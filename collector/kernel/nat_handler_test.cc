@@ -0,0 +1,290 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <collector/kernel/nat_handler.h>
+
+#include <channel/buffered_writer.h>
+#include <channel/test_channel.h>
+#include <platform/userspace-time.h>
+#include <util/logger.h>
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <vector>
+
+class NatHandlerTest : public ::testing::Test {
+protected:
+  static constexpr u64 SK = 0x1000;
+  static constexpr u64 CT = 0x2000;
+
+  // client -> service, DNAT-ed to client -> pod; the reply direction is pod -> client
+  static constexpr u32 CLIENT_IP = 0x0100000a; // 10.0.0.1
+  static constexpr u32 SERVICE_IP = 0x0a00000a; // 10.0.0.10
+  static constexpr u32 POD_IP = 0x0101010a; // 10.1.1.1
+  static constexpr u32 OTHER_POD_IP = 0x0201010a; // 10.1.1.2
+  static constexpr u16 CLIENT_PORT = 40000;
+  static constexpr u16 SERVICE_PORT = 80;
+  static constexpr u16 POD_PORT = 8080;
+
+  struct Remapping {
+    u64 sk;
+    u32 src;
+    u32 dst;
+    u16 sport;
+    u16 dport;
+
+    bool operator==(Remapping const &) const = default;
+  };
+
+  // tuple of a message's addresses, ports in network byte order
+  static hostport_tuple tuple(u32 src_ip, u16 src_port, u32 dst_ip, u16 dst_port)
+  {
+    return {
+        .src_ip = src_ip,
+        .dst_ip = dst_ip,
+        .src_port = htons(src_port),
+        .dst_port = htons(dst_port),
+        .proto = IPPROTO_TCP,
+    };
+  }
+
+  static Remapping remapping(u64 sk, hostport_tuple const &ft)
+  {
+    return {.sk = sk, .src = ft.src_ip, .dst = ft.dst_ip, .sport = ft.src_port, .dport = ft.dst_port};
+  }
+
+  // conntrack entry `from` getting `to` as its reply direction, reversed
+  void alter_reply(hostport_tuple const &from, hostport_tuple const &to)
+  {
+    jb_agent_internal__nf_conntrack_alter_reply msg = {};
+    msg.ct = CT;
+    msg.src_ip = from.src_ip;
+    msg.src_port = from.src_port;
+    msg.dst_ip = from.dst_ip;
+    msg.dst_port = from.dst_port;
+    msg.proto = from.proto;
+    msg.nat_src_ip = to.src_ip;
+    msg.nat_src_port = to.src_port;
+    msg.nat_dst_ip = to.dst_ip;
+    msg.nat_dst_port = to.dst_port;
+    msg.nat_proto = to.proto;
+    nat_handler_.handle_nf_conntrack_alter_reply(now_++, &msg);
+  }
+
+  void cleanup_conntrack(hostport_tuple const &from)
+  {
+    jb_agent_internal__nf_nat_cleanup_conntrack msg = {};
+    msg.ct = CT;
+    msg.src_ip = from.src_ip;
+    msg.src_port = from.src_port;
+    msg.dst_ip = from.dst_ip;
+    msg.dst_port = from.dst_port;
+    msg.proto = from.proto;
+    nat_handler_.handle_nf_nat_cleanup_conntrack(now_++, &msg);
+  }
+
+  void set_state(u64 sk, hostport_tuple const &ft)
+  {
+    jb_agent_internal__set_state_ipv4 msg = {};
+    msg.sk = sk;
+    msg.src = ft.src_ip;
+    msg.dest = ft.dst_ip;
+    msg.sport = ntohs(ft.src_port);
+    msg.dport = ntohs(ft.dst_port);
+    nat_handler_.handle_set_state_ipv4(now_++, &msg);
+  }
+
+  void close_socket(u64 sk)
+  {
+    jb_agent_internal__close_sock_info msg = {};
+    msg.sk = sk;
+    nat_handler_.handle_close_socket(now_++, &msg);
+  }
+
+  // nat_remapping messages sent so far
+  std::vector<Remapping> sent_remappings()
+  {
+    EXPECT_FALSE(buffered_writer_.flush());
+
+    std::vector<Remapping> remappings;
+    for (auto const &msg : test_channel_.get_json_messages()) {
+      if (msg["name"] != "nat_remapping") {
+        continue;
+      }
+      auto const &data = msg["data"];
+      remappings.push_back({
+          .sk = data["sk"].get<u64>(),
+          .src = data["src"].get<u32>(),
+          .dst = data["dst"].get<u32>(),
+          .sport = data["sport"].get<u16>(),
+          .dport = data["dport"].get<u16>(),
+      });
+    }
+    return remappings;
+  }
+
+  std::size_t tuple_table_size() const { return nat_handler_.tuple_table_.size(); }
+  std::size_t sk_table_size() const { return nat_handler_.sk_table_.size(); }
+
+  channel::TestChannel test_channel_;
+  channel::BufferedWriter buffered_writer_{test_channel_, 16 * 1024};
+  ebpf_net::ingest::Writer writer_{buffered_writer_, monotonic, 0, nullptr};
+  logging::Logger logger_{writer_};
+  NatHandler nat_handler_{writer_, logger_};
+  u64 now_ = 1;
+
+  hostport_tuple const client_to_service_ = tuple(CLIENT_IP, CLIENT_PORT, SERVICE_IP, SERVICE_PORT);
+  hostport_tuple const pod_to_client_ = tuple(POD_IP, POD_PORT, CLIENT_IP, CLIENT_PORT);
+  hostport_tuple const other_pod_to_client_ = tuple(OTHER_POD_IP, POD_PORT, CLIENT_IP, CLIENT_PORT);
+};
+
+TEST_F(NatHandlerTest, remaps_original_direction)
+{
+  set_state(SK, client_to_service_);
+  alter_reply(client_to_service_, pod_to_client_);
+  nat_handler_.flush_nat_remappings();
+
+  EXPECT_EQ(std::vector<Remapping>{remapping(SK, pod_to_client_)}, sent_remappings());
+
+  auto const *mapping = nat_handler_.get_nat_mapping(CLIENT_IP, SERVICE_IP, CLIENT_PORT, SERVICE_PORT, IPPROTO_TCP);
+  ASSERT_NE(nullptr, mapping);
+  EXPECT_EQ(pod_to_client_, *mapping);
+}
+
+TEST_F(NatHandlerTest, remaps_socket_seen_after_conntrack)
+{
+  alter_reply(client_to_service_, pod_to_client_);
+  set_state(SK, client_to_service_);
+  nat_handler_.flush_nat_remappings();
+
+  EXPECT_EQ(std::vector<Remapping>{remapping(SK, pod_to_client_)}, sent_remappings());
+}
+
+TEST_F(NatHandlerTest, remaps_reply_direction)
+{
+  // a socket whose 4-tuple is the reply direction, reversed
+  alter_reply(client_to_service_, pod_to_client_);
+  set_state(SK, pod_to_client_.reversed());
+  nat_handler_.flush_nat_remappings();
+
+  EXPECT_EQ(std::vector<Remapping>{remapping(SK, client_to_service_.reversed())}, sent_remappings());
+}
+
+TEST_F(NatHandlerTest, remove_nat_erases_empty_entries)
+{
+  alter_reply(client_to_service_, pod_to_client_);
+  EXPECT_EQ(2u, tuple_table_size());
+
+  cleanup_conntrack(client_to_service_);
+  EXPECT_EQ(0u, tuple_table_size());
+  EXPECT_EQ(nullptr, nat_handler_.get_nat_mapping(CLIENT_IP, SERVICE_IP, CLIENT_PORT, SERVICE_PORT, IPPROTO_TCP));
+}
+
+TEST_F(NatHandlerTest, remove_nat_keeps_socket_entry)
+{
+  set_state(SK, client_to_service_);
+  alter_reply(client_to_service_, pod_to_client_);
+  EXPECT_EQ(2u, tuple_table_size());
+
+  // the socket's tuple is still in use
+  cleanup_conntrack(client_to_service_);
+  EXPECT_EQ(1u, tuple_table_size());
+  EXPECT_EQ(1u, sk_table_size());
+
+  close_socket(SK);
+  EXPECT_EQ(0u, tuple_table_size());
+  EXPECT_EQ(0u, sk_table_size());
+}
+
+TEST_F(NatHandlerTest, remove_sk_erases_empty_entries)
+{
+  set_state(SK, client_to_service_);
+  EXPECT_EQ(1u, tuple_table_size());
+  EXPECT_EQ(1u, sk_table_size());
+
+  close_socket(SK);
+  EXPECT_EQ(0u, tuple_table_size());
+  EXPECT_EQ(0u, sk_table_size());
+}
+
+TEST_F(NatHandlerTest, remove_sk_keeps_nat_entries)
+{
+  set_state(SK, client_to_service_);
+  alter_reply(client_to_service_, pod_to_client_);
+
+  // the conntrack entry outlives the socket
+  close_socket(SK);
+  EXPECT_EQ(2u, tuple_table_size());
+  EXPECT_EQ(0u, sk_table_size());
+
+  cleanup_conntrack(client_to_service_);
+  EXPECT_EQ(0u, tuple_table_size());
+}
+
+TEST_F(NatHandlerTest, rewritten_mapping_erases_stale_entry)
+{
+  alter_reply(client_to_service_, pod_to_client_);
+  alter_reply(client_to_service_, other_pod_to_client_);
+  EXPECT_EQ(2u, tuple_table_size());
+
+  cleanup_conntrack(client_to_service_);
+  EXPECT_EQ(0u, tuple_table_size());
+}
+
+TEST_F(NatHandlerTest, one_remapping_per_socket_per_poll)
+{
+  set_state(SK, client_to_service_);
+  alter_reply(client_to_service_, pod_to_client_);
+  alter_reply(client_to_service_, other_pod_to_client_);
+  nat_handler_.flush_nat_remappings();
+
+  // only the last mapping is sent
+  EXPECT_EQ(std::vector<Remapping>{remapping(SK, other_pod_to_client_)}, sent_remappings());
+
+  // nothing is left queued for the next poll
+  nat_handler_.flush_nat_remappings();
+  EXPECT_EQ(1u, sent_remappings().size());
+
+  // a later poll sends the socket's next remapping
+  alter_reply(client_to_service_, pod_to_client_);
+  nat_handler_.flush_nat_remappings();
+  EXPECT_EQ(
+      (std::vector<Remapping>{remapping(SK, other_pod_to_client_), remapping(SK, pod_to_client_)}), sent_remappings());
+}
+
+TEST_F(NatHandlerTest, flushes_socket_before_close)
+{
+  set_state(SK, client_to_service_);
+  alter_reply(client_to_service_, pod_to_client_);
+
+  // sent ahead of the socket's last messages, not again when the poll ends
+  nat_handler_.flush_nat_remapping(SK);
+  EXPECT_EQ(std::vector<Remapping>{remapping(SK, pod_to_client_)}, sent_remappings());
+
+  close_socket(SK);
+  nat_handler_.flush_nat_remappings();
+  EXPECT_EQ(1u, sent_remappings().size());
+}
+
+TEST_F(NatHandlerTest, flush_before_close_keeps_other_sockets)
+{
+  constexpr u64 OTHER_SK = SK + 1;
+  hostport_tuple const other_client_to_service = tuple(CLIENT_IP, CLIENT_PORT + 1, SERVICE_IP, SERVICE_PORT);
+  hostport_tuple const pod_to_other_client = tuple(POD_IP, POD_PORT, CLIENT_IP, CLIENT_PORT + 1);
+
+  set_state(SK, client_to_service_);
+  set_state(OTHER_SK, other_client_to_service);
+  alter_reply(client_to_service_, pod_to_client_);
+  alter_reply(other_client_to_service, pod_to_other_client);
+
+  nat_handler_.flush_nat_remapping(SK);
+  close_socket(SK);
+  nat_handler_.flush_nat_remappings();
+
+  EXPECT_EQ(
+      (std::vector<Remapping>{remapping(SK, pod_to_client_), remapping(OTHER_SK, pod_to_other_client)}),
+      sent_remappings());
+}
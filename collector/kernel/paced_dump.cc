@@ -0,0 +1,197 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <collector/kernel/paced_dump.h>
+
+#include <platform/userspace-time.h>
+#include <util/log.h>
+#include <util/uv_helpers.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+PacedDump::PacedDump(
+    uv_loop_t &loop,
+    std::chrono::milliseconds work,
+    std::chrono::milliseconds pause,
+    std::function<void()> poll_cb,
+    std::function<void()> body,
+    DoneCb done_cb)
+    : work_(work),
+      pause_(pause),
+      poll_cb_(std::move(poll_cb)),
+      body_(std::move(body)),
+      done_cb_(std::move(done_cb)),
+      timer_(static_cast<uv_timer_t *>(std::malloc(sizeof(uv_timer_t))))
+{
+  CHECK_UV(uv_timer_init(&loop, timer_));
+  timer_->data = this;
+}
+
+PacedDump::~PacedDump()
+{
+  uv_close(reinterpret_cast<uv_handle_t *>(timer_), reinterpret_cast<uv_close_cb>(&std::free));
+
+  if (started_ && !finished_) {
+    // have checkpoint() throw, so the dump's stack is unwound
+    cancelled_ = true;
+    resume();
+  }
+}
+
+void PacedDump::start()
+{
+  assert(!started_);
+  started_ = true;
+
+  map_stack();
+  if (getcontext(&dump_context_) != 0) {
+    int const error = errno;
+    unmap_stack();
+    throw std::system_error(error, std::generic_category(), "PacedDump couldn't get the current context");
+  }
+  // the stack grows down, towards the guard page
+  dump_context_.uc_stack.ss_sp = static_cast<char *>(stack_mapping_) + (stack_mapping_size_ - STACK_SIZE);
+  dump_context_.uc_stack.ss_size = STACK_SIZE;
+  // where the dump's stack returns to once run() is done
+  dump_context_.uc_link = &loop_context_;
+
+  auto const self = reinterpret_cast<std::uintptr_t>(this);
+  makecontext(
+      &dump_context_,
+      reinterpret_cast<void (*)()>(&PacedDump::entry),
+      2,
+      static_cast<unsigned int>(self >> 32),
+      static_cast<unsigned int>(self));
+
+  resume();
+}
+
+void PacedDump::checkpoint()
+{
+  if (!cancelled_ && !unpaced_ && std::chrono::nanoseconds(monotonic() - resumed_at_) >= work_) {
+    swapcontext(&dump_context_, &loop_context_);
+  }
+
+  if (cancelled_) {
+    throw Cancelled{};
+  }
+}
+
+void PacedDump::map_stack()
+{
+  auto const page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  std::size_t const size = page_size + STACK_SIZE;
+
+  void *const mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+  if (mapping == MAP_FAILED) {
+    throw std::system_error(errno, std::generic_category(), "PacedDump couldn't map its stack");
+  }
+
+  if (mprotect(mapping, page_size, PROT_NONE) != 0) {
+    int const error = errno;
+    munmap(mapping, size);
+    throw std::system_error(error, std::generic_category(), "PacedDump couldn't protect its stack's guard page");
+  }
+
+  stack_mapping_ = mapping;
+  stack_mapping_size_ = size;
+}
+
+void PacedDump::unmap_stack()
+{
+  if (stack_mapping_ == nullptr) {
+    return;
+  }
+
+  munmap(stack_mapping_, stack_mapping_size_);
+  stack_mapping_ = nullptr;
+  stack_mapping_size_ = 0;
+}
+
+void PacedDump::entry(unsigned int self_hi, unsigned int self_lo)
+{
+  auto const self = (static_cast<std::uintptr_t>(self_hi) << 32) | self_lo;
+  reinterpret_cast<PacedDump *>(self)->run();
+}
+
+void PacedDump::run()
+{
+  try {
+    body_();
+  } catch (Cancelled const &) {
+    // being destroyed
+  } catch (...) {
+    error_ = std::current_exception();
+  }
+  finished_ = true;
+}
+
+void PacedDump::resume()
+{
+  resumed_at_ = monotonic();
+  swapcontext(&loop_context_, &dump_context_);
+
+  if (!finished_) {
+    // suspended by checkpoint()
+    suspended_until_ = monotonic() + pause_.count();
+    if (int const error = arm_timer(); error != 0) {
+      LOG::error("unable to pace the dump of existing state, finishing it without pauses: {}", uv_strerror(error));
+      unpaced_ = true;
+      resume();
+    }
+    return;
+  }
+
+  unmap_stack();
+  if (cancelled_) {
+    return;
+  }
+
+  // done_cb may destroy this object
+  auto const done_cb = std::move(done_cb_);
+  auto const error = error_;
+  done_cb(error);
+}
+
+void PacedDump::abort(std::exception_ptr error)
+{
+  cancelled_ = true;
+  resume();
+
+  // done_cb may destroy this object
+  auto const done_cb = std::move(done_cb_);
+  done_cb(error);
+}
+
+int PacedDump::arm_timer()
+{
+  return uv_timer_start(timer_, &PacedDump::on_timer_cb, POLL_INTERVAL.count(), 0);
+}
+
+void PacedDump::on_timer_cb(uv_timer_t *timer)
+{
+  static_cast<PacedDump *>(timer->data)->on_timer();
+}
+
+void PacedDump::on_timer()
+{
+  try {
+    poll_cb_();
+  } catch (...) {
+    abort(std::current_exception());
+    return;
+  }
+
+  if (monotonic() < suspended_until_ && arm_timer() == 0) {
+    return;
+  }
+
+  resume();
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/platform.h>
+
+#include <uv.h>
+
+#include <chrono>
+#include <exception>
+#include <functional>
+
+#include <ucontext.h>
+
+/**
+ * Runs the dump of existing cgroups, processes and sockets in slices, giving
+ *   the loop back between slices.
+ *
+ * The probers walk /proc and the cgroup hierarchy from their constructors, so
+ *   the dump can't be split into steps. Instead it runs on a stack of its own,
+ *   on the loop's thread, and `checkpoint()` suspends it in the middle of a
+ *   walk once it has run for `work`. A timer then polls the rings every
+ *   POLL_INTERVAL until `pause` has passed, and resumes the dump where it left
+ *   off. Other loop handles (heartbeats, the upstream connection) run as usual
+ *   while the dump is suspended.
+ *
+ * The stack is mapped with a guard page below it, so a dump that overflows it
+ *   crashes instead of overwriting the heap.
+ */
+class PacedDump {
+public:
+  using DoneCb = std::function<void(std::exception_ptr)>;
+
+  /* how often the rings are polled while the dump is suspended */
+  static constexpr std::chrono::milliseconds POLL_INTERVAL{5};
+
+  /* stack size of the dump */
+  static constexpr std::size_t STACK_SIZE = 1024 * 1024;
+
+  /**
+   * C'tor
+   *
+   * @param work: how long the dump runs before it is suspended
+   * @param pause: how long the dump stays suspended
+   * @param poll_cb: polls the rings while the dump is suspended
+   * @param body: the dump, which calls `checkpoint()` every once in a while
+   * @param done_cb: called from the loop once `body` returns, with the
+   *   exception it threw, if any, or with the exception thrown by `poll_cb`.
+   *   May destroy this object.
+   */
+  PacedDump(
+      uv_loop_t &loop,
+      std::chrono::milliseconds work,
+      std::chrono::milliseconds pause,
+      std::function<void()> poll_cb,
+      std::function<void()> body,
+      DoneCb done_cb);
+
+  /**
+   * D'tor. A dump that hasn't finished is unwound without calling `done_cb`.
+   *   Must not be called from the dump itself.
+   */
+  ~PacedDump();
+
+  PacedDump(PacedDump const &) = delete;
+  PacedDump &operator=(PacedDump const &) = delete;
+
+  /**
+   * Runs the dump until it is first suspended or finishes
+   */
+  void start();
+
+  /**
+   * Called by the dump: suspends it if it has run for `work` since it was last
+   *   resumed
+   */
+  void checkpoint();
+
+private:
+  /* thrown from `checkpoint()` to unwind a dump that is being destroyed */
+  struct Cancelled {};
+
+  /* entry point of the dump's stack, with `this` split in two halves */
+  static void entry(unsigned int self_hi, unsigned int self_lo);
+
+  /* maps the dump's stack and its guard page */
+  void map_stack();
+
+  /* unmaps the dump's stack, if mapped */
+  void unmap_stack();
+
+  /* runs `body_` on the dump's stack */
+  void run();
+
+  /* switches to the dump until it is suspended again or finishes */
+  void resume();
+
+  /* unwinds the dump and reports `error` to `done_cb` */
+  void abort(std::exception_ptr error);
+
+  /* arms timer_ to fire after POLL_INTERVAL */
+  int arm_timer();
+
+  /* called by timer_ while the dump is suspended */
+  static void on_timer_cb(uv_timer_t *timer);
+  void on_timer();
+
+  std::chrono::nanoseconds const work_;
+  std::chrono::nanoseconds const pause_;
+  std::function<void()> poll_cb_;
+  std::function<void()> body_;
+  DoneCb done_cb_;
+
+  /* allocated with malloc, freed by the loop once closed, after this object is gone */
+  uv_timer_t *timer_;
+
+  /* the dump's stack, with the guard page at its start */
+  void *stack_mapping_ = nullptr;
+  std::size_t stack_mapping_size_ = 0;
+  ucontext_t loop_context_;
+  ucontext_t dump_context_;
+
+  bool started_ = false;
+  bool finished_ = false;
+  bool cancelled_ = false;
+  /* set if the timer can't be started, to finish the dump without pauses */
+  bool unpaced_ = false;
+  std::exception_ptr error_;
+
+  /* monotonic time at which the dump was last resumed */
+  u64 resumed_at_ = 0;
+  /* monotonic time until which the dump stays suspended */
+  u64 suspended_until_ = 0;
+};
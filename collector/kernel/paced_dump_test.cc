@@ -0,0 +1,204 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "paced_dump.h"
+
+#include <platform/userspace-time.h>
+#include <util/defer.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+using namespace std::literals::chrono_literals;
+
+constexpr auto WORK = 1ms;
+constexpr auto PAUSE = 10ms;
+
+// keeps busy for `duration`, calling `checkpoint` all along
+void busy_for(PacedDump &dump, std::chrono::nanoseconds duration)
+{
+  u64 const start = monotonic();
+  while (std::chrono::nanoseconds(monotonic() - start) < duration) {
+    dump.checkpoint();
+  }
+}
+
+class PacedDumpTest : public ::testing::Test {
+protected:
+  void SetUp() override { ASSERT_EQ(0, uv_loop_init(&loop_)); }
+
+  void TearDown() override
+  {
+    // lets closed handles be released
+    uv_run(&loop_, UV_RUN_DEFAULT);
+    ASSERT_EQ(0, uv_loop_close(&loop_));
+  }
+
+  uv_loop_t loop_;
+};
+
+} // namespace
+
+TEST_F(PacedDumpTest, RunsInSlices)
+{
+  int polls = 0;
+  int slices = 0;
+  bool done = false;
+  std::unique_ptr<PacedDump> dump;
+
+  dump = std::make_unique<PacedDump>(
+      loop_,
+      WORK,
+      PAUSE,
+      [&] { polls++; },
+      [&] {
+        for (int i = 0; i < 5; i++) {
+          slices++;
+          busy_for(*dump, WORK);
+        }
+      },
+      [&](std::exception_ptr error) {
+        EXPECT_FALSE(error);
+        done = true;
+      });
+
+  dump->start();
+  // the first slice ran, the rest waits for the loop
+  EXPECT_EQ(1, slices);
+  EXPECT_FALSE(done);
+
+  uv_run(&loop_, UV_RUN_DEFAULT);
+  EXPECT_TRUE(done);
+  EXPECT_EQ(5, slices);
+  // the rings are polled every POLL_INTERVAL during each pause
+  EXPECT_GE(polls, 4 * (PAUSE / PacedDump::POLL_INTERVAL));
+}
+
+TEST_F(PacedDumpTest, LoopRunsWhileSuspended)
+{
+  bool done = false;
+  bool timer_fired_during_dump = false;
+  std::unique_ptr<PacedDump> dump;
+
+  uv_timer_t timer;
+  ASSERT_EQ(0, uv_timer_init(&loop_, &timer));
+  timer.data = &timer_fired_during_dump;
+  ASSERT_EQ(0, uv_timer_start(&timer, [](uv_timer_t *handle) { *static_cast<bool *>(handle->data) = true; }, 1, 0));
+
+  dump = std::make_unique<PacedDump>(
+      loop_,
+      WORK,
+      PAUSE,
+      [] {},
+      [&] {
+        busy_for(*dump, 5 * WORK);
+        EXPECT_TRUE(timer_fired_during_dump);
+      },
+      [&](std::exception_ptr) { done = true; });
+
+  dump->start();
+  uv_run(&loop_, UV_RUN_DEFAULT);
+  EXPECT_TRUE(done);
+
+  uv_close(reinterpret_cast<uv_handle_t *>(&timer), nullptr);
+  uv_run(&loop_, UV_RUN_DEFAULT);
+}
+
+TEST_F(PacedDumpTest, ReportsException)
+{
+  std::exception_ptr reported;
+  std::unique_ptr<PacedDump> dump;
+
+  dump = std::make_unique<PacedDump>(
+      loop_,
+      WORK,
+      PAUSE,
+      [] {},
+      [&] {
+        busy_for(*dump, 2 * WORK);
+        throw std::runtime_error("dump failed");
+      },
+      [&](std::exception_ptr error) { reported = error; });
+
+  dump->start();
+  uv_run(&loop_, UV_RUN_DEFAULT);
+
+  ASSERT_TRUE(reported);
+  EXPECT_THROW(std::rethrow_exception(reported), std::runtime_error);
+}
+
+TEST_F(PacedDumpTest, ReportsPollException)
+{
+  std::exception_ptr reported;
+  bool unwound = false;
+  std::unique_ptr<PacedDump> dump;
+
+  dump = std::make_unique<PacedDump>(
+      loop_,
+      WORK,
+      PAUSE,
+      [] { throw std::runtime_error("poll failed"); },
+      [&] {
+        DEFER([&] { unwound = true; });
+        busy_for(*dump, 2 * WORK);
+        ADD_FAILURE() << "dump resumed after its poll failed";
+      },
+      [&](std::exception_ptr error) { reported = error; });
+
+  dump->start();
+  uv_run(&loop_, UV_RUN_DEFAULT);
+
+  EXPECT_TRUE(unwound);
+  ASSERT_TRUE(reported);
+  EXPECT_THROW(std::rethrow_exception(reported), std::runtime_error);
+}
+
+TEST_F(PacedDumpTest, DestructionUnwindsSuspendedDump)
+{
+  bool unwound = false;
+  bool done = false;
+  std::unique_ptr<PacedDump> dump;
+
+  dump = std::make_unique<PacedDump>(
+      loop_,
+      WORK,
+      PAUSE,
+      [] {},
+      [&] {
+        DEFER([&] { unwound = true; });
+        busy_for(*dump, 10 * WORK);
+      },
+      [&](std::exception_ptr) { done = true; });
+
+  dump->start();
+  EXPECT_FALSE(unwound);
+
+  dump.reset();
+  EXPECT_TRUE(unwound);
+  EXPECT_FALSE(done);
+}
+
+namespace {
+// uses up `depth` KiB of stack
+int recurse(int depth)
+{
+  volatile char frame[1024];
+  frame[0] = static_cast<char>(depth);
+  return (depth == 0) ? frame[0] : recurse(depth - 1) + frame[0];
+}
+} // namespace
+
+TEST_F(PacedDumpTest, StackOverflowHitsGuardPage)
+{
+  EXPECT_DEATH(
+      {
+        PacedDump dump(
+            loop_, WORK, PAUSE, [] {}, [] { recurse(2 * PacedDump::STACK_SIZE / 1024); }, [](std::exception_ptr) {});
+        dump.start();
+      },
+      "");
+}
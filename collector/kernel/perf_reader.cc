@@ -36,8 +36,18 @@ void PerfContainer::add_data_ring(PerfRing &pr)
   data_readers_.push_back(pr);
 }
 
+void PerfContainer::set_ring_buffer(std::unique_ptr<BpfRingBuffer> ring, u64 const volatile *lost_count)
+{
+  ring_buffer_ = std::move(ring);
+  ring_buffer_lost_count_ = lost_count;
+  ring_buffer_reported_lost_ = lost_count ? *lost_count : 0;
+}
+
 void PerfContainer::set_callback(uv_loop_t &loop, void *ctx, CALLBACK cb)
 {
+  if (ring_buffer_) {
+    ring_buffer_->set_callback(loop, ctx, cb);
+  }
   for (auto &reader : readers_) {
     reader.set_callback(loop, ctx, cb);
   }
@@ -50,6 +60,16 @@ std::string PerfContainer::inspect(void)
 {
   std::string out;
 
+  if (ring_buffer_) {
+    u32 total_bytes;
+    u32 bytes = ring_buffer_->bytes_remaining(&total_bytes);
+    out += fmt::format(
+        "ring_buffer_: size={} ({}% full), lost={}\n",
+        bytes,
+        (((double)bytes) / (double)total_bytes) * 100.0,
+        ring_buffer_lost_count_ ? *ring_buffer_lost_count_ : 0);
+  }
+
   size_t num_readers = readers_.size();
   out += fmt::format("readers_: size={}\n", num_readers);
   for (size_t n = 0; n < readers_.size(); n++) {
@@ -66,15 +86,28 @@ std::string PerfContainer::inspect(void)
 }
 
 PerfReader::PerfReader(PerfContainer &container, u64 max_timestamp)
-    : container_(container), max_timestamp_(max_timestamp), active_(true)
+    : container_(container),
+      max_timestamp_(max_timestamp),
+      ring_buffer_(container.ring_buffer_.get()),
+      ring_buffer_lost_(0),
+      active_(true)
 {
+  for (auto &data_reader : container.data_readers_) {
+    data_reader.start_read_batch();
+  }
+
+  if (ring_buffer_) {
+    /* ring buffer records are already sorted, no need for entries_ */
+    ring_buffer_->start_read_batch();
+    if (container.ring_buffer_lost_count_) {
+      ring_buffer_lost_ = *container.ring_buffer_lost_count_ - container.ring_buffer_reported_lost_;
+    }
+  }
+
   for (size_t i = 0; i < container.readers_.size(); i++) {
     auto &reader = container.readers_[i];
     reader.start_read_batch();
 
-    auto &data_reader = container.data_readers_[i];
-    data_reader.start_read_batch();
-
     /* if the reader is already in container.entries_, continue */
     if (container.readers_in_entries_.test(i))
       continue;
@@ -91,11 +124,22 @@ PerfReader::~PerfReader()
 
 bool PerfReader::empty()
 {
+  if (ring_buffer_) {
+    /* lost events are reported first, like PERF_RECORD_LOST in perf rings */
+    return (ring_buffer_lost_ == 0) && (ring_buffer_->peek_size() == -ENOENT);
+  }
   return (container_.n_entries_ == 0) || (container_.entries_[0].timestamp > max_timestamp_);
 }
 
 void PerfReader::pop_unpadded_and_copy_to(char *dest)
 {
+  if (ring_buffer_) {
+    u32 length = ring_buffer_->peek_size();
+    ring_buffer_->peek_copy(dest, 0, length);
+    ring_buffer_->pop();
+    return;
+  }
+
   auto &reader = top();
   /* get length */
   u32 length = reader.peek_size();
@@ -108,6 +152,13 @@ void PerfReader::pop_unpadded_and_copy_to(char *dest)
 
 void PerfReader::pop_and_copy_to(char *dest)
 {
+  if (ring_buffer_) {
+    u32 unpadded = ring_buffer_->peek_aligned_u32(sizeof(u32));
+    ring_buffer_->peek_copy(dest, sizeof(u64), unpadded);
+    ring_buffer_->pop();
+    return;
+  }
+
   auto &reader = top();
   /* get unpadded length */
   u32 unpadded = reader.peek_aligned_u32(sizeof(u32));
@@ -120,6 +171,16 @@ void PerfReader::pop_and_copy_to(char *dest)
 
 void PerfReader::pop()
 {
+  if (ring_buffer_) {
+    if (ring_buffer_lost_) {
+      container_.ring_buffer_reported_lost_ += ring_buffer_lost_;
+      ring_buffer_lost_ = 0;
+    } else {
+      ring_buffer_->pop();
+    }
+    return;
+  }
+
   auto &reader = top();
   reader.pop();
   update_after_pop();
@@ -130,6 +191,9 @@ void PerfReader::stop()
   if (!active_)
     return;
 
+  if (ring_buffer_)
+    ring_buffer_->finish_read_batch();
+
   for (auto &reader : container_.readers_)
     reader.finish_read_batch();
   for (auto &data_reader : container_.data_readers_)
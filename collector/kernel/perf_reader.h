@@ -6,6 +6,7 @@
 #pragma once
 
 #include <bitset>
+#include <memory>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -13,6 +14,7 @@
 #include <platform/platform.h>
 
 #include <collector/kernel/bpf_src/render_bpf.h>
+#include <util/bpf_ring_buffer.h>
 #include <util/perf_ring_cpp.h>
 
 /**
@@ -26,6 +28,12 @@
  *   * if the next entry is PERF_RECORD_SAMPLE, the timestamp will be the one
  *     encoded in the sample. This code assume that a sample starts with
  *      [ perf_event_header + u32 size + u32 unpadded_size + u64 timestamp ]
+ *
+ * Alternatively, control channel events can come from a single BPF ring
+ * buffer shared by all CPUs (see set_ring_buffer). Its records are already in
+ * order, so PerfReader reads them directly instead of merging per-CPU rings.
+ * Ring buffer records have the same layout as perf samples, with the ring
+ * buffer record header in place of perf_event_header.
  */
 class PerfContainer {
 public:
@@ -54,6 +62,19 @@ public:
    */
   void add_data_ring(PerfRing &pr);
 
+  /**
+   * Use a BPF ring buffer for the control channel, instead of per-CPU rings
+   *
+   * @param ring: the ring buffer the BPF code writes events to
+   * @param lost_count: counter of events the BPF code could not write to
+   *   `ring` because it was full. Increases in this counter are reported by
+   *   PerfReader as PERF_RECORD_LOST records.
+   */
+  void set_ring_buffer(std::unique_ptr<BpfRingBuffer> ring, u64 const volatile *lost_count);
+
+  // returns whether the control channel uses a BPF ring buffer
+  bool has_ring_buffer() const { return ring_buffer_ != nullptr; }
+
   /**
    * Set a callback to execute when events show up in the
    * control channel perf ring
@@ -68,6 +89,24 @@ public:
    */
   std::string inspect(void);
 
+  /**
+   * Calls @f(used_bytes, total_bytes) for each control channel ring, or for
+   * the ring buffer when one is used instead, as of their last read batch.
+   */
+  template <typename F> void for_each_fill_level(F &&f) const
+  {
+    u32 total_bytes;
+    if (ring_buffer_) {
+      u32 const bytes = ring_buffer_->bytes_remaining(&total_bytes);
+      f(bytes, total_bytes);
+      return;
+    }
+    for (auto const &reader : readers_) {
+      u32 const bytes = reader.bytes_remaining(&total_bytes);
+      f(bytes, total_bytes);
+    }
+  }
+
   // returns the number of perf rings in this container
   std::size_t size() const { return readers_.size(); }
 
@@ -83,6 +122,12 @@ private:
   std::vector<PerfRing> readers_;
   std::vector<PerfRing> data_readers_;
 
+  /* Control channel ring buffer, if used instead of readers_ */
+  std::unique_ptr<BpfRingBuffer> ring_buffer_;
+  u64 const volatile *ring_buffer_lost_count_ = nullptr;
+  /* lost events already reported */
+  u64 ring_buffer_reported_lost_ = 0;
+
   /* (timestamp, reader_index) pairs */
   struct PerfEntry {
     u64 timestamp;
@@ -135,33 +180,45 @@ public:
    *
    * Assumes reader is not empty (i.e., !empty())
    */
-  inline u32 peek_type() const { return top().peek_type(); }
+  inline u32 peek_type() const
+  {
+    if (ring_buffer_) {
+      return ring_buffer_lost_ ? PERF_RECORD_LOST : PERF_RECORD_SAMPLE;
+    }
+    return top().peek_type();
+  }
 
   /**
    * Returns the total size of the next perf event
    *
    * Assumes reader is not empty (i.e., !empty())
    */
-  inline u32 peek_size() { return top().peek_size(); }
+  inline u32 peek_size() { return ring_buffer_ ? ring_buffer_->peek_size() : top().peek_size(); }
 
   /**
    * Returns the length of the payload of the next value
    *
    * Assumes reader is not empty (i.e., !empty()) and type==PERF_RECORD_SAMPLE
    */
-  inline u16 peek_unpadded_length() { return top().peek_aligned_u32(sizeof(u32)); }
+  inline u16 peek_unpadded_length()
+  {
+    return ring_buffer_ ? ring_buffer_->peek_aligned_u32(sizeof(u32)) : top().peek_aligned_u32(sizeof(u32));
+  }
 
   /**
    * Returns the length of the payload of the next value
    *
    * Assumes reader is not empty (i.e., !empty()) and type==PERF_RECORD_SAMPLE
    */
-  inline u16 peek_rpc_id() { return top().peek_aligned_u16(2 * sizeof(u64)); }
+  inline u16 peek_rpc_id()
+  {
+    return ring_buffer_ ? ring_buffer_->peek_aligned_u16(2 * sizeof(u64)) : top().peek_aligned_u16(2 * sizeof(u64));
+  }
 
   /**
    * Returns the number of lost samples, if type is PERF_RECORD_LOST
    */
-  inline u64 peek_n_lost() { return top().peek_aligned_u64(sizeof(u64)); }
+  inline u64 peek_n_lost() { return ring_buffer_ ? ring_buffer_lost_ : top().peek_aligned_u64(sizeof(u64)); }
 
   /**
    * Returns a view into the sample's contents, without the perf event header.
@@ -176,6 +233,9 @@ public:
    */
   inline std::pair<std::string_view, std::string_view> peek_message() const
   {
+    if (ring_buffer_) {
+      return ring_buffer_->peek();
+    }
     auto const &ring = top();
     assert(ring.peek_type() == PERF_RECORD_SAMPLE);
     return ring.peek();
@@ -183,10 +243,16 @@ public:
 
   /**
    * Returns which cpu index we're reading from next
+   *
+   * Records from a BPF ring buffer don't carry their CPU, so this is always 0
+   * when the container uses one.
    */
 
   inline size_t peek_index() const
   {
+    if (ring_buffer_) {
+      return 0;
+    }
     size_t idx = container_.entries_[0].reader_index;
     return idx;
   }
@@ -255,6 +321,12 @@ private:
   /* the maximum timestamp we should accept */
   u64 max_timestamp_;
 
+  /* the container's ring buffer, if it uses one */
+  BpfRingBuffer *ring_buffer_;
+
+  /* number of lost ring buffer events to report before the next record */
+  u64 ring_buffer_lost_;
+
   /* is the reader active */
   bool active_;
 
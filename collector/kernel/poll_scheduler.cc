@@ -0,0 +1,50 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <collector/kernel/poll_scheduler.h>
+
+#include <algorithm>
+
+void PollScheduler::start_poll(Trigger trigger)
+{
+  max_fill_percent_ = 0;
+
+  switch (trigger) {
+  case Trigger::timer:
+    ++stats_.timer_polls;
+    early_polls_in_a_row_ = 0;
+    break;
+
+  case Trigger::event:
+    ++stats_.event_wakeups;
+    early_polls_in_a_row_ = 0;
+    break;
+
+  case Trigger::early:
+    ++stats_.early_polls;
+    ++early_polls_in_a_row_;
+    break;
+  }
+}
+
+void PollScheduler::record_fill(u32 used_bytes, u32 total_bytes)
+{
+  if (total_bytes == 0) {
+    return;
+  }
+
+  u32 const percent = std::min<u64>(100, (u64{used_bytes} * 100) / total_bytes);
+  ++stats_.fill_histogram[std::min<std::size_t>(N_FILL_BUCKETS - 1, (percent * N_FILL_BUCKETS) / 100)];
+  max_fill_percent_ = std::max(max_fill_percent_, percent);
+}
+
+bool PollScheduler::finish_poll()
+{
+  if (max_fill_percent_ >= 50) {
+    interval_ = std::max(MIN_INTERVAL, interval_ / 2);
+  } else if (max_fill_percent_ < 12) {
+    interval_ = std::min(MAX_INTERVAL, interval_ + std::max(std::chrono::milliseconds{1}, interval_ / 4));
+  }
+
+  return (max_fill_percent_ >= HIGH_WATER_PERCENT) && (early_polls_in_a_row_ < MAX_EARLY_POLLS);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include <platform/platform.h>
+
+/**
+ * Picks how often the perf rings are polled, from how full they are.
+ *
+ * Each poll records the fill level of every ring as the poll starts. When the
+ *   fullest ring was at least half full, the polling interval is halved, down
+ *   to MIN_INTERVAL; when all rings were nearly empty, it grows by a quarter,
+ *   up to MAX_INTERVAL. A ring above the high-water mark asks for an early
+ *   poll, right after the current one, rather than waiting for the timer.
+ *
+ * The kernel's wakeup watermark for each ring is set when the ring is opened
+ *   and can't be changed afterwards, so the polling interval is what adapts.
+ *
+ * Also keeps the statistics reported upstream: a histogram of ring fill
+ *   levels, and how many polls were triggered by the timer, by the kernel
+ *   waking us up, and early.
+ */
+class PollScheduler {
+public:
+  static constexpr std::chrono::milliseconds INITIAL_INTERVAL{100};
+  static constexpr std::chrono::milliseconds MIN_INTERVAL{5};
+  static constexpr std::chrono::milliseconds MAX_INTERVAL{250};
+
+  /* fill level, in percent, above which a ring asks for an early poll */
+  static constexpr u32 HIGH_WATER_PERCENT = 75;
+
+  /* most early polls in a row, so that a busy ring doesn't starve the loop */
+  static constexpr u32 MAX_EARLY_POLLS = 4;
+
+  /* fill level buckets: [0, 25%), [25%, 50%), [50%, 75%), [75%, 100%] */
+  static constexpr std::size_t N_FILL_BUCKETS = 4;
+
+  /* what triggered a poll: the polling timer (or a manual poll), the kernel, or a nearly full ring */
+  enum class Trigger { timer, event, early };
+
+  struct Stats {
+    /* number of ring fill levels recorded in each bucket */
+    std::array<u64, N_FILL_BUCKETS> fill_histogram{};
+    u64 timer_polls = 0;
+    u64 event_wakeups = 0;
+    u64 early_polls = 0;
+  };
+
+  /* Starts a poll */
+  void start_poll(Trigger trigger);
+
+  /* Records the fill level of a ring at the start of the current poll */
+  void record_fill(u32 used_bytes, u32 total_bytes);
+
+  /**
+   * Finishes the current poll, updating the polling interval.
+   *
+   * Returns true when a ring was above the high-water mark, and another poll
+   *   should follow right away.
+   */
+  bool finish_poll();
+
+  /* returns the interval the polling timer should use */
+  std::chrono::milliseconds interval() const { return interval_; }
+
+  /* returns the statistics accumulated since the last reset_stats() */
+  Stats const &stats() const { return stats_; }
+
+  void reset_stats() { stats_ = {}; }
+
+private:
+  std::chrono::milliseconds interval_ = INITIAL_INTERVAL;
+
+  /* fullest ring of the current poll, in percent */
+  u32 max_fill_percent_ = 0;
+
+  /* early polls since the last timer or event-driven poll */
+  u32 early_polls_in_a_row_ = 0;
+
+  Stats stats_;
+};
@@ -0,0 +1,99 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "poll_scheduler.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr u32 RING_N_BYTES = 4 * 1024 * 1024;
+
+// runs a timer poll over rings with the given fill levels, in percent
+template <typename... Percents> bool timer_poll(PollScheduler &scheduler, Percents... percents)
+{
+  scheduler.start_poll(PollScheduler::Trigger::timer);
+  (scheduler.record_fill((u64{RING_N_BYTES} * percents) / 100, RING_N_BYTES), ...);
+  return scheduler.finish_poll();
+}
+
+} // namespace
+
+TEST(PollSchedulerTest, ShortensWhenFull)
+{
+  PollScheduler scheduler;
+  EXPECT_EQ(PollScheduler::INITIAL_INTERVAL, scheduler.interval());
+
+  // one busy ring is enough
+  EXPECT_FALSE(timer_poll(scheduler, 0, 60, 5));
+  EXPECT_EQ(PollScheduler::INITIAL_INTERVAL / 2, scheduler.interval());
+
+  for (int i = 0; i < 10; i++) {
+    timer_poll(scheduler, 60);
+  }
+  EXPECT_EQ(PollScheduler::MIN_INTERVAL, scheduler.interval());
+}
+
+TEST(PollSchedulerTest, LengthensWhenEmpty)
+{
+  PollScheduler scheduler;
+
+  EXPECT_FALSE(timer_poll(scheduler, 0, 5, 10));
+  EXPECT_GT(scheduler.interval(), PollScheduler::INITIAL_INTERVAL);
+
+  for (int i = 0; i < 20; i++) {
+    timer_poll(scheduler, 0);
+  }
+  EXPECT_EQ(PollScheduler::MAX_INTERVAL, scheduler.interval());
+
+  // in between, the interval stays put
+  timer_poll(scheduler, 30);
+  EXPECT_EQ(PollScheduler::MAX_INTERVAL, scheduler.interval());
+}
+
+TEST(PollSchedulerTest, EarlyPollsAreBounded)
+{
+  PollScheduler scheduler;
+
+  ASSERT_TRUE(timer_poll(scheduler, 10, 80));
+  u32 early_polls = 0;
+  for (;;) {
+    scheduler.start_poll(PollScheduler::Trigger::early);
+    scheduler.record_fill(RING_N_BYTES, RING_N_BYTES);
+    ++early_polls;
+    if (!scheduler.finish_poll()) {
+      break;
+    }
+  }
+  EXPECT_EQ(PollScheduler::MAX_EARLY_POLLS, early_polls);
+
+  // an event-driven poll starts over
+  scheduler.start_poll(PollScheduler::Trigger::event);
+  scheduler.record_fill(RING_N_BYTES, RING_N_BYTES);
+  EXPECT_TRUE(scheduler.finish_poll());
+}
+
+TEST(PollSchedulerTest, Stats)
+{
+  PollScheduler scheduler;
+
+  timer_poll(scheduler, 0, 24, 25, 49);
+  timer_poll(scheduler, 50, 74, 75, 100);
+  scheduler.start_poll(PollScheduler::Trigger::event);
+  scheduler.finish_poll();
+  scheduler.start_poll(PollScheduler::Trigger::early);
+  scheduler.finish_poll();
+
+  auto const &stats = scheduler.stats();
+  EXPECT_EQ(2u, stats.fill_histogram[0]);
+  EXPECT_EQ(2u, stats.fill_histogram[1]);
+  EXPECT_EQ(2u, stats.fill_histogram[2]);
+  EXPECT_EQ(2u, stats.fill_histogram[3]);
+  EXPECT_EQ(2u, stats.timer_polls);
+  EXPECT_EQ(1u, stats.event_wakeups);
+  EXPECT_EQ(1u, stats.early_polls);
+
+  scheduler.reset_stats();
+  EXPECT_EQ(0u, scheduler.stats().timer_polls);
+  EXPECT_EQ(0u, scheduler.stats().fill_histogram[3]);
+}
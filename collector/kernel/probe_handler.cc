@@ -3,12 +3,14 @@
 
 #include <cstdarg>
 #include <iostream>
+#include <unistd.h>
 
 #include <config.h>
 #include <linux/bpf.h>
 #include <util/log.h>
 
 #include <bpf/bpf.h>
+#include <bpf/btf.h>
 #include <bpf/libbpf.h>
 
 #include <collector/agent_log.h>
@@ -21,6 +23,7 @@ extern "C" {
 }
 
 #include <memory>
+#include <string_view>
 #include <vector>
 
 #define EVENTS_PERF_RING_N_BYTES (1024 * 4096)
@@ -39,7 +42,68 @@ std::vector<int> get_online_cpus()
   return cpus;
 }
 
-ProbeHandler::ProbeHandler(logging::Logger &log) : log_(log), num_failed_probes_(0), stack_trace_count_(0) {};
+// Returns true if the kernel supports BPF_MAP_LOOKUP_BATCH on hash maps (5.6+)
+bool map_lookup_batch_supported()
+{
+  int fd = bpf_map_create(BPF_MAP_TYPE_HASH, nullptr, sizeof(u64), sizeof(u64), 1, nullptr);
+  if (fd < 0) {
+    return false;
+  }
+
+  u64 keys[1];
+  u64 values[1];
+  u32 batch;
+  u32 count = 1;
+  int ret = bpf_map_lookup_batch(fd, nullptr, &batch, keys, values, &count, nullptr);
+  // the map is empty: supporting kernels report ENOENT, older ones EINVAL
+  bool const supported = (ret == 0) || (errno == ENOENT);
+  close(fd);
+  return supported;
+}
+
+// Returns true if the verifier accepts bounded loops (5.3+), by loading a program that counts to 4
+bool bounded_loops_supported()
+{
+  struct bpf_insn const insns[] = {
+      {.code = BPF_ALU64 | BPF_MOV | BPF_K, .dst_reg = BPF_REG_0, .imm = 0},
+      {.code = BPF_ALU64 | BPF_ADD | BPF_K, .dst_reg = BPF_REG_0, .imm = 1},
+      {.code = BPF_JMP | BPF_JLT | BPF_K, .dst_reg = BPF_REG_0, .off = -2, .imm = 4},
+      {.code = BPF_JMP | BPF_EXIT},
+  };
+  int fd = bpf_prog_load(BPF_PROG_TYPE_SOCKET_FILTER, nullptr, "GPL", insns, sizeof(insns) / sizeof(insns[0]), nullptr);
+  if (fd < 0) {
+    return false;
+  }
+  close(fd);
+  return true;
+}
+
+// Returns the kernel function traced by an fentry/fexit program, from its "fentry/<function>" section name
+std::string_view trace_program_target(struct bpf_program const *prog)
+{
+  std::string_view const section = bpf_program__section_name(prog);
+  auto const slash = section.find('/');
+  return (slash == std::string_view::npos) ? std::string_view() : section.substr(slash + 1);
+}
+
+// Returns true if the kernel can attach BPF trampolines: it has BTF and supports tracing programs (5.5+)
+bool fentry_supported(struct btf const *vmlinux_btf)
+{
+  if (!vmlinux_btf) {
+    return false;
+  }
+  // libbpf versions that can't probe tracing programs report an error: trust kernel BTF then
+  return libbpf_probe_bpf_prog_type(BPF_PROG_TYPE_TRACING, nullptr) != 0;
+}
+
+ProbeHandler::ProbeHandler(logging::Logger &log)
+    : log_(log),
+      num_failed_probes_(0),
+      stack_trace_count_(0),
+      use_ring_buffer_(false),
+      tcp_stats_in_kernel_(false),
+      use_fentry_(false),
+      dns_parse_in_kernel_(false) {};
 
 void ProbeHandler::load_kernel_symbols()
 {
@@ -86,6 +150,25 @@ int ProbeHandler::setup_mmap(int cpu, int perf_fd, PerfContainer &perf, bool is_
   return 0;
 }
 
+int ProbeHandler::setup_ring_buffer(struct render_bpf_bpf *skel, PerfContainer &perf)
+{
+  int ring_fd = get_bpf_map_fd(skel, "events_ringbuf");
+  if (ring_fd < 0) {
+    return ring_fd;
+  }
+
+  std::unique_ptr<BpfRingBuffer> ring;
+  try {
+    ring = std::make_unique<BpfRingBuffer>(ring_fd, EVENTS_RINGBUF_N_BYTES);
+  } catch (std::exception const &exc) {
+    LOG::error("cannot map events ring buffer: {}", exc.what());
+    return -4;
+  }
+
+  perf.set_ring_buffer(std::move(ring), &skel->bss->events_ringbuf_lost);
+  return 0;
+}
+
 int ProbeHandler::get_bpf_map_fd(struct render_bpf_bpf *skel, const char *map_name)
 {
   struct bpf_map *map = get_bpf_map(skel, map_name);
@@ -147,11 +230,81 @@ void ProbeHandler::configure_bpf_skeleton(struct render_bpf_bpf *skel, const Bpf
   skel->rodata->filter_ns = config.filter_ns;
   skel->rodata->enable_tcp_data_stream = config.enable_tcp_data_stream ? 1 : 0;
 
+  use_ring_buffer_ = false;
+  if (config.use_ring_buffer) {
+    if (config.enable_tcp_data_stream) {
+      LOG::warn("BPF ring buffer is not supported with the TCP data stream, falling back to perf rings");
+    } else if (libbpf_probe_bpf_map_type(BPF_MAP_TYPE_RINGBUF, nullptr) != 1) {
+      LOG::info("BPF ring buffer is not supported by the kernel, falling back to perf rings");
+    } else {
+      use_ring_buffer_ = true;
+    }
+  }
+
+  skel->rodata->use_ringbuf = use_ring_buffer_ ? 1 : 0;
+  // the ring buffer map can't be created on kernels without ring buffer support
+  bpf_map__set_autocreate(skel->maps.events_ringbuf, use_ring_buffer_);
+
+  tcp_stats_in_kernel_ = false;
+  if (config.tcp_stats_in_kernel) {
+    if (map_lookup_batch_supported()) {
+      tcp_stats_in_kernel_ = true;
+    } else {
+      LOG::info("batched BPF map lookups are not supported by the kernel, falling back to rtt_estimator events");
+    }
+  }
+
+  skel->rodata->tcp_stats_in_kernel = tcp_stats_in_kernel_ ? 1 : 0;
+
+  dns_parse_in_kernel_ = false;
+  if (config.dns_parse_in_kernel) {
+    if (bounded_loops_supported()) {
+      dns_parse_in_kernel_ = true;
+    } else {
+      LOG::info("bounded loops are not supported by the BPF verifier, sending DNS packets to userland");
+    }
+  }
+
+  skel->rodata->dns_parse_in_kernel = dns_parse_in_kernel_ ? 1 : 0;
+  // the parser loops over names and answers, which older verifiers reject even when the program is never called
+  bpf_program__set_autoload(skel->progs.handle_parse_dns, dns_parse_in_kernel_);
+
+  struct btf *vmlinux_btf = config.use_fentry ? btf__load_vmlinux_btf() : nullptr;
+  use_fentry_ = false;
+  if (config.use_fentry) {
+    if (fentry_supported(vmlinux_btf)) {
+      use_fentry_ = true;
+    } else {
+      LOG::info("fentry programs are not supported by the kernel, falling back to kprobes");
+    }
+  }
+
+  // fentry programs only load when their target is in kernel BTF; start_probe_common falls back to the kprobe otherwise
+  struct bpf_program *prog;
+  bpf_object__for_each_program(prog, skel->obj)
+  {
+    if (bpf_program__type(prog) != BPF_PROG_TYPE_TRACING) {
+      continue;
+    }
+    std::string const target(trace_program_target(prog));
+    bool const traceable = use_fentry_ && btf__find_by_name_kind(vmlinux_btf, target.c_str(), BTF_KIND_FUNC) >= 0;
+    if (use_fentry_ && !traceable) {
+      LOG::debug_in(AgentLogKind::BPF, "{} is not in kernel BTF, not loading {}", target, bpf_program__name(prog));
+    }
+    bpf_program__set_autoload(prog, traceable);
+  }
+  btf__free(vmlinux_btf);
+
   LOG::info(
-      "BPF configuration: boot_time_adjustment={}, filter_ns={}, tcp_data_stream={}",
+      "BPF configuration: boot_time_adjustment={}, filter_ns={}, tcp_data_stream={}, events={}, tcp_stats={}, probes={}, "
+      "dns={}",
       config.boot_time_adjustment,
       config.filter_ns,
-      config.enable_tcp_data_stream ? "enabled" : "disabled");
+      config.enable_tcp_data_stream ? "enabled" : "disabled",
+      use_ring_buffer_ ? "ring buffer" : "perf rings",
+      tcp_stats_in_kernel_ ? "in kernel" : "events",
+      use_fentry_ ? "fentry" : "kprobe",
+      dns_parse_in_kernel_ ? "parsed in kernel" : "packets");
 }
 
 void ProbeHandler::destroy_bpf_skeleton(struct render_bpf_bpf *skel)
@@ -182,14 +335,23 @@ int ProbeHandler::load_bpf_skeleton(struct render_bpf_bpf *skel, PerfContainer &
     return data_channel_fd;
   }
 
+  if (use_ring_buffer_) {
+    res = setup_ring_buffer(skel, perf);
+    if (res < 0) {
+      return res;
+    }
+  }
+
   /* get online cpus */
   auto online_cpus = get_online_cpus();
 
   /* open mmaps */
   for (auto cpu : online_cpus) {
-    res = setup_mmap(cpu, events_fd, perf, false, EVENTS_PERF_RING_N_BYTES, EVENTS_PERF_RING_N_WATERMARK_BYTES);
-    if (res < 0) {
-      return res;
+    if (!use_ring_buffer_) {
+      res = setup_mmap(cpu, events_fd, perf, false, EVENTS_PERF_RING_N_BYTES, EVENTS_PERF_RING_N_WATERMARK_BYTES);
+      if (res < 0) {
+        return res;
+      }
     }
     res =
         setup_mmap(cpu, data_channel_fd, perf, true, DATA_CHANNEL_PERF_RING_N_BYTES, DATA_CHANNEL_PERF_RING_N_WATERMARK_BYTES);
@@ -229,6 +391,8 @@ struct bpf_map *ProbeHandler::get_bpf_map(struct render_bpf_bpf *skel, const std
     return skel->maps.tcp_recvmsg_active;
   if (name == "events")
     return skel->maps.events;
+  if (name == "events_ringbuf")
+    return skel->maps.events_ringbuf;
   if (name == "bpf_log_globals_per_cpu")
     return skel->maps.bpf_log_globals_per_cpu;
   if (name == "tgid_info_table")
@@ -239,6 +403,8 @@ struct bpf_map *ProbeHandler::get_bpf_map(struct render_bpf_bpf *skel, const std
     return skel->maps.udp_open_sockets;
   if (name == "dns_message_array")
     return skel->maps.dns_message_array;
+  if (name == "dns_parse_state_array")
+    return skel->maps.dns_parse_state_array;
   if (name == "_tcp_connections")
     return skel->maps._tcp_connections;
   if (name == "_tcp_control")
@@ -301,6 +467,33 @@ std::string ProbeHandler::get_stack_trace(struct render_bpf_bpf *skel, s32 kerne
 
 #endif
 
+struct bpf_link *ProbeHandler::start_trace_program(
+    struct render_bpf_bpf *skel, bool is_kretprobe, const std::string &func_name, const std::string &k_func_name)
+{
+  if (!use_fentry_) {
+    return nullptr;
+  }
+
+  std::string const trace_func_name = func_name + (is_kretprobe ? "__fexit" : "__fentry");
+  auto bpf_program = bpf_object__find_program_by_name(skel->obj, trace_func_name.c_str());
+  if (!bpf_program || !bpf_program__autoload(bpf_program) || trace_program_target(bpf_program) != k_func_name) {
+    return nullptr;
+  }
+
+  struct bpf_link *link = bpf_program__attach_trace(bpf_program);
+  if (!link) {
+    LOG::debug_in(
+        AgentLogKind::BPF,
+        "Unable to attach {}, falling back to {}. func_name:{} k_func_name:{} errno:{}",
+        is_kretprobe ? "fexit" : "fentry",
+        is_kretprobe ? "kretprobe" : "kprobe",
+        trace_func_name,
+        k_func_name,
+        errno);
+  }
+  return link;
+}
+
 int ProbeHandler::start_probe_common(
     struct render_bpf_bpf *skel,
     bool is_kretprobe,
@@ -308,16 +501,22 @@ int ProbeHandler::start_probe_common(
     const std::string &k_func_name,
     const std::string &event_id_suffix)
 {
+  /* attach the probe */
+  std::string probe_name = (is_kretprobe ? kretprobe_prefix_ : probe_prefix_) + k_func_name + event_id_suffix;
+
+  struct bpf_link *link = start_trace_program(skel, is_kretprobe, func_name, k_func_name);
+  if (link) {
+    probes_.push_back(link);
+    probe_names_.push_back(probe_name);
+    return 0;
+  }
+
   auto bpf_program = bpf_object__find_program_by_name(skel->obj, func_name.c_str());
   if (!bpf_program) {
     LOG::error("Could not get find program. func_name:{} k_func_name:{}", func_name, k_func_name);
     return -1;
   }
 
-  /* attach the probe */
-  std::string probe_name = (is_kretprobe ? kretprobe_prefix_ : probe_prefix_) + k_func_name + event_id_suffix;
-
-  struct bpf_link *link;
   link = bpf_program__attach_kprobe(
       bpf_program,
       is_kretprobe, /* retprobe */
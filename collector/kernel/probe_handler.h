@@ -29,6 +29,18 @@ struct BpfConfiguration {
   u64 boot_time_adjustment = 0;
   u64 filter_ns = 1000000000; // Default 1 second in nanoseconds
   bool enable_tcp_data_stream = false;
+  // Send events through a BPF ring buffer shared by all CPUs when the kernel supports it (5.8+), instead of per-CPU perf
+  // rings. Not compatible with the TCP data stream, which relies on per-CPU ordering between events and data.
+  bool use_ring_buffer = false;
+  // Accumulate per-socket TCP statistics in BPF and drain them once per stats interval when the kernel supports batched
+  // map lookups (5.6+), instead of sending rtt_estimator events.
+  bool tcp_stats_in_kernel = false;
+  // Attach hot probes that have an fentry flavour as BPF trampolines when the kernel has BTF and the target function, instead
+  // of kprobes. Functions that can't be traced that way still get their kprobe.
+  bool use_fentry = true;
+  // Parse DNS packets in BPF and send compact dns_record messages when the kernel supports bounded loops (5.3+), instead of
+  // copying every packet to userland. Packets the BPF parser can't handle are still sent raw.
+  bool dns_parse_in_kernel = false;
 };
 
 /**
@@ -79,6 +91,21 @@ public:
   int load_bpf_skeleton(struct render_bpf_bpf *skel, PerfContainer &perf);
   void destroy_bpf_skeleton(struct render_bpf_bpf *skel);
 
+  /**
+   * Whether TCP statistics are accumulated in BPF, decided by configure_bpf_skeleton
+   */
+  bool tcp_stats_in_kernel() const { return tcp_stats_in_kernel_; }
+
+  /**
+   * Whether fentry programs are loaded for functions the kernel can trace that way, decided by configure_bpf_skeleton
+   */
+  bool use_fentry() const { return use_fentry_; }
+
+  /**
+   * Whether DNS packets are parsed in BPF, decided by configure_bpf_skeleton
+   */
+  bool dns_parse_in_kernel() const { return dns_parse_in_kernel_; }
+
   /**
    * BPF table helpers
    **/
@@ -163,7 +190,15 @@ public:
 
 protected:
   /**
-   * Common code to start a kprobe or kretprobe
+   * Attaches the fentry (or fexit, for kretprobes) flavour of a kprobe program, named with a "__fentry" or "__fexit"
+   * suffix, if it was loaded and traces k_func_name
+   * @returns the link on success, nullptr if there is no such program or attaching failed
+   */
+  struct bpf_link *start_trace_program(
+      struct render_bpf_bpf *skel, bool is_kretprobe, const std::string &func_name, const std::string &k_func_name);
+
+  /**
+   * Common code to start a kprobe or kretprobe, preferring the program's fentry/fexit flavour when there is one
    * @returns 0 on success, negative value on failure
    */
   int start_probe_common(
@@ -198,6 +233,11 @@ protected:
    */
   int setup_mmap(int cpu, int events_fd, PerfContainer &perf, bool is_data, u32 n_bytes, u32 n_watermark_bytes);
 
+  /**
+   * Sets up memory mapping for the events ring buffer
+   */
+  int setup_ring_buffer(struct render_bpf_bpf *skel, PerfContainer &perf);
+
 private:
   static constexpr char probe_prefix_[] = "ebpf_net_p_";
   static constexpr char kretprobe_prefix_[] = "ebpf_net_r_";
@@ -218,6 +258,10 @@ private:
   std::vector<std::string> probe_names_;
   size_t num_failed_probes_; // number of kprobes, kretprobes, and tail_calls that failed to attach
   size_t stack_trace_count_;
+  bool use_ring_buffer_; // whether events go through the events ring buffer, decided by configure_bpf_skeleton
+  bool tcp_stats_in_kernel_; // whether TCP statistics are accumulated in BPF, decided by configure_bpf_skeleton
+  bool use_fentry_; // whether fentry/fexit programs can be attached, decided by configure_bpf_skeleton
+  bool dns_parse_in_kernel_; // whether DNS packets are parsed in BPF, decided by configure_bpf_skeleton
 
   std::optional<KernelSymbols> kernel_symbols_;
 };
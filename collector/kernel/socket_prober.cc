@@ -45,6 +45,18 @@ SocketProber::SocketProber(
   probe_handler.start_probe(skel, "on_udp_v4_get_port", "udp_v4_get_port");
   probe_handler.start_probe(skel, "on_udp_v6_get_port", "udp_v6_get_port");
 
+  periodic_cb();
+  check_cb("socket prober startup");
+
+  probe_existing_sockets(probe_handler, skel, periodic_cb, check_cb);
+}
+
+void SocketProber::probe_existing_sockets(
+    ProbeHandler &probe_handler,
+    struct render_bpf_bpf *skel,
+    std::function<void(void)> periodic_cb,
+    std::function<void(std::string)> check_cb)
+{
   // EXISTING
   probe_handler.start_probe(skel, "on_tcp4_seq_show", "tcp4_seq_show");
   probe_handler.start_probe(skel, "on_tcp6_seq_show", "tcp6_seq_show");
@@ -52,7 +64,7 @@ SocketProber::SocketProber(
   probe_handler.start_probe(skel, "on_udp6_seq_show", "udp6_seq_show");
 
   periodic_cb();
-  check_cb("socket prober startup");
+  check_cb("existing socket probes");
 
   /* First step: fill up the "seen_inodes" bpf hashmap: inode -> pid */
   struct bpf_map *seen_inodes_map = probe_handler.get_bpf_map(skel, "seen_inodes");
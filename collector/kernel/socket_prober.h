@@ -39,6 +39,20 @@ public:
       std::function<void(std::string)> check_cb,
       logging::Logger &log);
 
+  /**
+   * Walks existing sockets through the seq_show probes, reporting those that
+   *   BPF isn't tracking yet. Called on startup, and again to recover sockets
+   *   whose creation events were lost.
+   *
+   * @param periodic_cb: callback to be called every once in a while
+   * @param check_cb: callback to check for lost samples after each step
+   */
+  void probe_existing_sockets(
+      ProbeHandler &probe_handler,
+      struct render_bpf_bpf *skel,
+      std::function<void(void)> periodic_cb,
+      std::function<void(std::string)> check_cb);
+
 private:
   /**
    * Fills the given map with a mapping of inode->pid of existing sockets
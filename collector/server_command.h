@@ -10,4 +10,32 @@
 enum class ServerCommand : u64 {
   NONE,
   DISABLE_SEND = 0xe5c94272c6a3028ful,
+  // Sent by the reducer, once a connection it admitted during a reconnect storm
+  // identifies as a kernel collector: the collector should pace the initial
+  // dump of its state.
+  PACE_INITIAL_DUMP = 0xf0dd82b03e03fffaul,
+  // Sent by the reducer once a connection identifies as a kernel collector,
+  // with the ID of its ingest compression dictionary in the lower 32 bits (see
+  // util/compression_dictionary.h): the collector can compress with the
+  // dictionary, if it has the same one. Kernel collectors that don't know this
+  // command ignore it.
+  COMPRESSION_DICTIONARY = 0x9b1e4f7200000000ul,
 };
+
+// Commands with an argument hold it in their lower 32 bits.
+constexpr u64 SERVER_COMMAND_ARGUMENT_MASK = 0xfffffffful;
+
+constexpr u64 server_command(ServerCommand command, u32 argument)
+{
+  return static_cast<u64>(command) | argument;
+}
+
+constexpr bool is_server_command(u64 value, ServerCommand command)
+{
+  return (value & ~SERVER_COMMAND_ARGUMENT_MASK) == static_cast<u64>(command);
+}
+
+constexpr u32 server_command_argument(u64 value)
+{
+  return static_cast<u32>(value & SERVER_COMMAND_ARGUMENT_MASK);
+}
@@ -66,6 +66,8 @@ void IntakeConfig::read_from_env(IntakeConfig &config)
   if (std::string_view value = try_get_env_var(INTAKE_INTAKE_ENCODER_VAR); !value.empty()) {
     config.encoder_ = try_enum_from_string(value, IntakeEncoder::binary);
   }
+
+  config.compression_level_ = try_get_env_value<int>(INTAKE_COMPRESSION_LEVEL_VAR, config.compression_level_);
 }
 
 IntakeConfig::ArgsHandler::ArgsHandler(cli::ArgsParser &parser)
@@ -76,7 +78,11 @@ IntakeConfig::ArgsHandler::ArgsHandler(cli::ArgsParser &parser)
       encoder_(parser.add_arg<IntakeEncoder>(
           "intake-encoder",
           "Chooses the intake encoder to use"
-          " - this relates to the sink used to dump collected telemetry to"))
+          " - this relates to the sink used to dump collected telemetry to")),
+      compression_level_(parser.add_arg<int>(
+          "intake-compression-level",
+          "zstd level to compress telemetry with when the reducer offers dictionary compression"
+          " - 0 keeps LZ4 compression"))
 {}
 
 void IntakeConfig::ArgsHandler::read_config(IntakeConfig &config)
@@ -94,6 +100,10 @@ void IntakeConfig::ArgsHandler::read_config(IntakeConfig &config)
   if (encoder_) {
     config.encoder(*encoder_);
   }
+
+  if (compression_level_) {
+    config.compression_level(*compression_level_);
+  }
 }
 
 } // namespace config
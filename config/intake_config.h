@@ -29,9 +29,11 @@ class IntakeConfig {
   static constexpr auto INTAKE_PORT_VAR = "EBPF_NET_INTAKE_PORT";
   static constexpr auto INTAKE_INTAKE_ENCODER_VAR = "EBPF_NET_INTAKE_ENCODER";
   static constexpr auto INTAKE_RECORD_OUTPUT_PATH_VAR = "EBPF_NET_RECORD_INTAKE_OUTPUT_PATH";
+  static constexpr auto INTAKE_COMPRESSION_LEVEL_VAR = "EBPF_NET_INTAKE_COMPRESSION_LEVEL";
 
 public:
   static const IntakeConfig DEFAULT_CONFIG;
+  static constexpr int DEFAULT_COMPRESSION_LEVEL = 3;
 
   IntakeConfig() {}
 
@@ -72,6 +74,13 @@ public:
 
   virtual bool allow_compression() const { return encoder_ == IntakeEncoder::binary; }
 
+  /**
+   * zstd level to compress with when the reducer offers dictionary
+   * compression, or 0 to decline the offer and keep using LZ4.
+   */
+  void compression_level(int level) { compression_level_ = level; }
+  int compression_level() const { return compression_level_; }
+
   virtual std::unique_ptr<channel::NetworkChannel> make_channel(uv_loop_t &loop) const;
 
   std::unique_ptr<::ebpf_net::ingest::Encoder> make_encoder() const
@@ -106,6 +115,7 @@ private:
   std::string port_;
   std::string record_path_;
   IntakeEncoder encoder_ = IntakeEncoder::binary;
+  int compression_level_ = DEFAULT_COMPRESSION_LEVEL;
 };
 
 struct IntakeConfig::ArgsHandler : cli::ArgsParser::Handler {
@@ -117,6 +127,7 @@ private:
   cli::ArgsParser::ArgProxy<std::string> host_;
   cli::ArgsParser::ArgProxy<std::string> port_;
   cli::ArgsParser::ArgProxy<IntakeEncoder> encoder_;
+  cli::ArgsParser::ArgProxy<int> compression_level_;
 };
 
 } // namespace config
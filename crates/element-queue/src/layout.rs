@@ -1,84 +1,99 @@
-use core::ptr;
 use core::ptr::{addr_of, addr_of_mut};
+use core::sync::atomic::{AtomicU32, Ordering};
 
-/// C-compatible shared indices for ElementQueue contiguous layout.
+/// Size of a cache line, used to keep producer and consumer state apart.
+pub const CACHE_LINE_SIZE: usize = 64;
+
+/// C-compatible shared indices for ElementQueue contiguous layout (v2).
+///
+/// Mirrors `struct element_queue_shared` in util/element_queue.h: the heads
+/// (written by the consumer) and the tails (written by the producer) each
+/// occupy their own cache line.
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct ElementQueueShared {
     pub elem_head: u32,
     pub buf_head: u32,
+    _pad_head: [u8; CACHE_LINE_SIZE - 8],
     pub elem_tail: u32,
     pub buf_tail: u32,
+    _pad_tail: [u8; CACHE_LINE_SIZE - 8],
 }
 
+const _: () = assert!(core::mem::size_of::<ElementQueueShared>() == 2 * CACHE_LINE_SIZE);
+
 impl ElementQueueShared {
-    /// Initialize shared indices to zero using volatile writes to match C semantics.
+    /// Initialize shared indices to zero.
     pub unsafe fn init(shared: *mut ElementQueueShared) {
         shared.init_zero()
     }
 }
 
-/// Trait providing volatile read/write accessors on raw pointers to the
-/// shared header. Enables pointer-style calls like `self.shared.set_buf_head(v)`.
+/// Trait providing atomic read/write accessors on raw pointers to the shared
+/// header. Enables pointer-style calls like `self.shared.set_buf_head(v)`.
+///
+/// The `elem_*` indices are published last, so they carry the ordering:
+/// setters use release and getters acquire, like EQ_STORE_RELEASE and
+/// EQ_LOAD_ACQUIRE in the C implementation. `buf_*` accesses are relaxed.
 pub(crate) trait ElementQueueSharedOps {
     fn init_zero(self);
 
-    // Volatile getters (READ_ONCE semantics)
     fn get_elem_head(self) -> u32;
     fn get_buf_head(self) -> u32;
     fn get_elem_tail(self) -> u32;
     fn get_buf_tail(self) -> u32;
 
-    // Volatile setters (WRITE_ONCE semantics)
     fn set_elem_head(self, v: u32);
     fn set_buf_head(self, v: u32);
     fn set_elem_tail(self, v: u32);
     fn set_buf_tail(self, v: u32);
 }
 
+#[inline]
+fn atomic<'a>(p: *const u32) -> &'a AtomicU32 {
+    // SAFETY: the shared header is naturally aligned and its indices are only
+    // ever accessed atomically, by both the C and Rust implementations.
+    unsafe { &*(p as *const AtomicU32) }
+}
+
 impl ElementQueueSharedOps for *mut ElementQueueShared {
     #[inline]
     fn init_zero(self) {
-        unsafe {
-            ptr::write_volatile(addr_of_mut!((*self).elem_head), 0);
-            ptr::write_volatile(addr_of_mut!((*self).buf_head), 0);
-            ptr::write_volatile(addr_of_mut!((*self).elem_tail), 0);
-            ptr::write_volatile(addr_of_mut!((*self).buf_tail), 0);
-        }
+        unsafe { core::ptr::write_bytes(self, 0, 1) }
     }
 
     #[inline]
     fn get_elem_head(self) -> u32 {
-        unsafe { ptr::read_volatile(addr_of!((*self).elem_head)) }
+        atomic(unsafe { addr_of!((*self).elem_head) }).load(Ordering::Acquire)
     }
     #[inline]
     fn get_buf_head(self) -> u32 {
-        unsafe { ptr::read_volatile(addr_of!((*self).buf_head)) }
+        atomic(unsafe { addr_of!((*self).buf_head) }).load(Ordering::Acquire)
     }
     #[inline]
     fn get_elem_tail(self) -> u32 {
-        unsafe { ptr::read_volatile(addr_of!((*self).elem_tail)) }
+        atomic(unsafe { addr_of!((*self).elem_tail) }).load(Ordering::Acquire)
     }
     #[inline]
     fn get_buf_tail(self) -> u32 {
-        unsafe { ptr::read_volatile(addr_of!((*self).buf_tail)) }
+        atomic(unsafe { addr_of!((*self).buf_tail) }).load(Ordering::Relaxed)
     }
 
     #[inline]
     fn set_elem_head(self, v: u32) {
-        unsafe { ptr::write_volatile(addr_of_mut!((*self).elem_head), v) }
+        atomic(unsafe { addr_of_mut!((*self).elem_head) }).store(v, Ordering::Release)
     }
     #[inline]
     fn set_buf_head(self, v: u32) {
-        unsafe { ptr::write_volatile(addr_of_mut!((*self).buf_head), v) }
+        atomic(unsafe { addr_of_mut!((*self).buf_head) }).store(v, Ordering::Release)
     }
     #[inline]
     fn set_elem_tail(self, v: u32) {
-        unsafe { ptr::write_volatile(addr_of_mut!((*self).elem_tail), v) }
+        atomic(unsafe { addr_of_mut!((*self).elem_tail) }).store(v, Ordering::Release)
     }
     #[inline]
     fn set_buf_tail(self, v: u32) {
-        unsafe { ptr::write_volatile(addr_of_mut!((*self).buf_tail), v) }
+        atomic(unsafe { addr_of_mut!((*self).buf_tail) }).store(v, Ordering::Relaxed)
     }
 }
 
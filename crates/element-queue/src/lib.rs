@@ -14,12 +14,18 @@ pub mod layout;
 pub mod raw;
 
 // Re-export for backwards-compatibility with the previous single-module layout.
-pub use layout::{contig_size, ElementQueueShared};
+pub use layout::{contig_size, ElementQueueShared, CACHE_LINE_SIZE};
 pub use raw::{ElementQueue, EqError, ReadBatch, WriteBatch};
 
+// Unit of allocation for queue storage, keeping the shared header's cache
+// lines aligned.
+#[repr(C, align(64))]
+#[derive(Clone, Copy)]
+struct CacheLine([u8; CACHE_LINE_SIZE]);
+
 /// Owned contiguous storage for an element queue, similar to MemElementQueueStorage.
 pub struct MemElementQueueStorage {
-    buf: Vec<u64>,
+    buf: Vec<CacheLine>,
     n_elems: u32,
     buf_len: u32,
 }
@@ -27,9 +33,9 @@ pub struct MemElementQueueStorage {
 impl MemElementQueueStorage {
     pub fn new(n_elems: u32, buf_len: u32) -> Self {
         let size = contig_size(n_elems, buf_len);
-        // Allocate with u64 alignment and round up size to u64 words
-        let words = (size + 7) / 8;
-        let mut buf = vec![0u64; words];
+        // Allocate with cache line alignment and round up size to whole lines
+        let lines = size.div_ceil(CACHE_LINE_SIZE);
+        let mut buf = vec![CacheLine([0u8; CACHE_LINE_SIZE]); lines];
         // Initialize shared header
         let ptr = buf.as_mut_ptr() as *mut u8;
         (ptr as *mut ElementQueueShared).init_zero();
@@ -81,6 +87,41 @@ mod tests {
         );
     }
 
+    #[test]
+    fn shared_layout_matches_c() {
+        // struct element_queue_shared in util/element_queue.h
+        assert_eq!(core::mem::size_of::<ElementQueueShared>(), 128);
+        assert_eq!(core::mem::offset_of!(ElementQueueShared, elem_head), 0);
+        assert_eq!(core::mem::offset_of!(ElementQueueShared, buf_head), 4);
+        assert_eq!(core::mem::offset_of!(ElementQueueShared, elem_tail), 64);
+        assert_eq!(core::mem::offset_of!(ElementQueueShared, buf_tail), 68);
+
+        let storage = MemElementQueueStorage::new(8, 128);
+        assert_eq!(storage.data_ptr() as usize % CACHE_LINE_SIZE, 0);
+    }
+
+    #[test]
+    fn writer_reloads_heads_when_full() {
+        let storage = MemElementQueueStorage::new(2, 64);
+        let mut writer = storage.make_queue().unwrap();
+        let mut reader = storage.make_queue().unwrap();
+
+        let mut wb = writer.start_write();
+        wb.write(8).unwrap();
+        wb.write(8).unwrap();
+        assert_eq!(wb.write(8).unwrap_err(), EqError::NoSpace);
+        let _ = wb.finish();
+
+        let rb = reader.start_read();
+        rb.read().unwrap();
+        let _ = rb.finish();
+
+        // The writer's cached heads are stale, but a write reloads them.
+        let mut wb = writer.start_write();
+        assert!(wb.write(8).is_ok());
+        let _ = wb.finish();
+    }
+
     #[test]
     fn write_read_basic() {
         let storage = MemElementQueueStorage::new(8, 128);
@@ -1,6 +1,5 @@
 use core::cell::Cell;
 use core::ptr::{self, NonNull};
-use core::sync::atomic::{fence, Ordering};
 
 use crate::errno;
 use crate::layout::{ElementQueueShared, ElementQueueSharedOps};
@@ -92,7 +91,7 @@ impl ElementQueue {
         let elems_slice: *mut [u32] = ptr::slice_from_raw_parts_mut(elems, n_elems as usize);
         let data_slice: *mut [u8] = ptr::slice_from_raw_parts_mut(data_ptr, buf_len as usize);
 
-        // Load current shared indices using volatile reads (per-field like C).
+        // Load current shared indices (per-field like C).
         let elem_head = shared.get_elem_head();
         let buf_head = shared.get_buf_head();
         let elem_tail = shared.get_elem_tail();
@@ -125,12 +124,8 @@ pub struct WriteBatch<'q> {
 
 impl ElementQueue {
     /// Start a write batch (producer) and return a guard.
-    /// Loads consumer-published heads to check space.
+    /// Consumer-published heads are only reloaded once the queue looks full.
     pub fn start_write<'q>(&'q mut self) -> WriteBatch<'q> {
-        // Read the heads published by consumer (volatile per-field to mirror ACCESS_ONCE).
-        self.elem_head = self.shared.get_elem_head();
-        self.buf_head = self.shared.get_buf_head();
-
         debug_assert!((self.buf_tail as i64 - self.buf_head as i64) >= 0);
         debug_assert!((self.elem_tail as i64 - self.elem_head as i64) >= 0);
         WriteBatch {
@@ -147,21 +142,17 @@ impl<'q> WriteBatch<'q> {
         if aligned_len > self.q.buf_mask {
             return Err(EqError::InvalidArg);
         }
-        // Element ring full?
-        if self.elem_tail.get().wrapping_sub(self.q.elem_head) >= (self.q.elem_mask + 1) {
-            return Err(EqError::NoSpace);
-        }
-
         let buf_mask = self.q.buf_mask;
         let buf_tail =
             ElementQueue::__next_offset_by_len(self.buf_tail.get(), buf_mask, aligned_len);
 
-        // Enough space in data buffer? Use wrapping arithmetic to mirror C semantics.
-        let used = buf_tail
-            .wrapping_add(aligned_len)
-            .wrapping_sub(self.q.buf_head);
-        if used > buf_mask + 1 {
-            return Err(EqError::NoSpace);
+        // Element ring full, or not enough space in data buffer? If so, see
+        // whether the consumer made progress since the heads were cached.
+        if !self.has_space(buf_tail, aligned_len) {
+            self.q.refresh_heads();
+            if !self.has_space(buf_tail, aligned_len) {
+                return Err(EqError::NoSpace);
+            }
         }
 
         // Reserve locally: update tails
@@ -176,11 +167,22 @@ impl<'q> WriteBatch<'q> {
         Ok(&mut self.q.data_mut()[start..end])
     }
 
+    #[inline]
+    fn has_space(&self, buf_tail: u32, aligned_len: u32) -> bool {
+        if self.elem_tail.get().wrapping_sub(self.q.elem_head) >= (self.q.elem_mask + 1) {
+            return false;
+        }
+        // Use wrapping arithmetic to mirror C semantics.
+        let used = buf_tail
+            .wrapping_add(aligned_len)
+            .wrapping_sub(self.q.buf_head);
+        used <= self.q.buf_mask + 1
+    }
+
     pub fn finish(self) -> &'q mut ElementQueue {
         // Commit local tails and publish to shared with release ordering
         self.q.elem_tail = self.elem_tail.get();
         self.q.buf_tail = self.buf_tail.get();
-        fence(Ordering::Release);
         self.q.shared.set_buf_tail(self.q.buf_tail);
         self.q.shared.set_elem_tail(self.q.elem_tail);
         self.q
@@ -210,12 +212,13 @@ pub struct ReadBatch<'q> {
 
 impl ElementQueue {
     /// Start a read batch (consumer) and return a guard.
-    /// Loads writer-published tail and establishes acquire ordering.
+    /// The writer-published tail is only reloaded (with acquire ordering) once
+    /// all previously seen elements have been consumed.
     pub fn start_read<'q>(&'q mut self) -> ReadBatch<'q> {
         // We trust sizes in elem ring; only need elem_tail here.
-        self.elem_tail = self.shared.get_elem_tail();
-        // Acquire barrier: subsequent reads of elems/data happen-after.
-        fence(Ordering::Acquire);
+        if self.elem_tail == self.elem_head {
+            self.elem_tail = self.shared.get_elem_tail();
+        }
         ReadBatch {
             elem_head: Cell::new(self.elem_head),
             buf_head: Cell::new(self.buf_head),
@@ -279,7 +282,6 @@ impl<'q> ReadBatch<'q> {
         // Commit local heads and publish to shared with release ordering
         self.q.elem_head = self.elem_head.get();
         self.q.buf_head = self.buf_head.get();
-        fence(Ordering::Release);
         self.q.shared.set_buf_head(self.q.buf_head);
         self.q.shared.set_elem_head(self.q.elem_head);
         self.q
@@ -287,6 +289,16 @@ impl<'q> ReadBatch<'q> {
 }
 
 impl ElementQueue {
+    /// Reload the consumer-published heads into the producer's cache.
+    #[inline]
+    fn refresh_heads(&mut self) {
+        // buf_head can be newer than elem_head, from a read batch finished in
+        // between: it needs its own acquire so the space it frees isn't
+        // reused before the consumer is done reading it
+        self.elem_head = self.shared.get_elem_head();
+        self.buf_head = self.shared.get_buf_head();
+    }
+
     #[inline]
     pub fn elem_count(&self) -> u32 {
         self.elem_tail.wrapping_sub(self.elem_head)
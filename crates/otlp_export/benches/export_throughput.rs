@@ -0,0 +1,258 @@
+//! Export throughput benchmark.
+//!
+//! Publishes a synthetic reducer-like workload (label sets of about the size
+//! of the reducer's node-pair labels, a fixed set of metrics per label set)
+//! to a stand-in OTLP gRPC collector running in the same process, and reports
+//! how long the publishing thread was busy, the end-to-end throughput and how
+//! many data points were dropped.
+//!
+//! Run with `cargo bench -p otlp_export -- [--name=value ...]`, e.g.
+//! `cargo bench -p otlp_export -- --label-sets=20000 --latency-ms=20`.
+
+use std::net::{SocketAddr, TcpListener};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::Arc;
+use std::time::{Duration, Instant};
+
+use opentelemetry_proto::tonic::collector::metrics::v1::metrics_service_server::{
+    MetricsService, MetricsServiceServer,
+};
+use opentelemetry_proto::tonic::collector::metrics::v1::{
+    ExportMetricsServiceRequest, ExportMetricsServiceResponse,
+};
+use opentelemetry_proto::tonic::metrics::v1::metric::Data;
+use otlp_export::ffi::{Label, MetricKind, OtlpExportConfig, OtlpOverflowPolicy};
+use otlp_export::{otlp_publisher_new, otlp_set_export_config};
+use tonic::{Request, Response, Status};
+
+struct Options {
+    label_sets: usize,
+    metrics_per_label_set: usize,
+    rounds: usize,
+    latency_ms: u64,
+    batch_points: u32,
+    in_flight: u32,
+    queue_mb: u64,
+    overflow: String,
+}
+
+impl Options {
+    fn parse() -> Self {
+        let mut options = Options {
+            label_sets: 10_000,
+            metrics_per_label_set: 20,
+            rounds: 5,
+            latency_ms: 0,
+            batch_points: 1000,
+            in_flight: 4,
+            queue_mb: 64,
+            overflow: "drop-oldest".to_string(),
+        };
+
+        // `cargo bench` passes `--bench` along; ignore anything unknown.
+        for arg in std::env::args().skip(1) {
+            let Some((name, value)) = arg.strip_prefix("--").and_then(|a| a.split_once('=')) else {
+                continue;
+            };
+            let number = || value.parse::<u64>().expect("numeric value");
+            match name {
+                "label-sets" => options.label_sets = number() as usize,
+                "metrics" => options.metrics_per_label_set = number() as usize,
+                "rounds" => options.rounds = number() as usize,
+                "latency-ms" => options.latency_ms = number(),
+                "batch-points" => options.batch_points = number() as u32,
+                "in-flight" => options.in_flight = number() as u32,
+                "queue-mb" => options.queue_mb = number(),
+                "overflow" => options.overflow = value.to_string(),
+                _ => eprintln!("ignoring unknown option --{}", name),
+            }
+        }
+
+        options
+    }
+
+    fn overflow_policy(&self) -> OtlpOverflowPolicy {
+        match self.overflow.as_str() {
+            "drop-newest" => OtlpOverflowPolicy::DropNewest,
+            "block" => OtlpOverflowPolicy::Block,
+            _ => OtlpOverflowPolicy::DropOldest,
+        }
+    }
+}
+
+/// Collector that counts what it receives, optionally taking its time to
+/// respond.
+#[derive(Default)]
+struct StandInCollector {
+    latency: Duration,
+    requests: AtomicU64,
+    data_points: AtomicU64,
+}
+
+#[tonic::async_trait]
+impl MetricsService for StandInCollector {
+    async fn export(
+        &self,
+        request: Request<ExportMetricsServiceRequest>,
+    ) -> Result<Response<ExportMetricsServiceResponse>, Status> {
+        let data_points: usize = request
+            .get_ref()
+            .resource_metrics
+            .iter()
+            .flat_map(|rm| rm.scope_metrics.iter())
+            .flat_map(|sm| sm.metrics.iter())
+            .map(|m| match &m.data {
+                Some(Data::Sum(sum)) => sum.data_points.len(),
+                Some(Data::Gauge(gauge)) => gauge.data_points.len(),
+                _ => 0,
+            })
+            .sum();
+
+        if !self.latency.is_zero() {
+            tokio::time::sleep(self.latency).await;
+        }
+
+        self.requests.fetch_add(1, Ordering::Relaxed);
+        self.data_points
+            .fetch_add(data_points as u64, Ordering::Relaxed);
+        Ok(Response::new(ExportMetricsServiceResponse {
+            partial_success: None,
+        }))
+    }
+}
+
+fn label_sets(count: usize) -> Vec<Vec<Label>> {
+    const KEYS: [&str; 12] = [
+        "workload.name",
+        "workload.uid",
+        "availability_zone",
+        "resolution_type",
+        "image_version",
+        "environment",
+        "namespace.name",
+        "process.name",
+        "container.name",
+        "id",
+        "ip",
+        "pod",
+    ];
+
+    (0..count)
+        .map(|i| {
+            let mut labels = vec![Label {
+                key: "sf_product".to_string(),
+                value: "network-explorer".to_string(),
+            }];
+            for prefix in ["source.", "dest."] {
+                for key in KEYS {
+                    labels.push(Label {
+                        key: format!("{}{}", prefix, key),
+                        value: format!("{}-{}", key, i),
+                    });
+                }
+            }
+            labels.push(Label {
+                key: "aggregation".to_string(),
+                value: "az_id".to_string(),
+            });
+            labels
+        })
+        .collect()
+}
+
+fn main() {
+    let options = Options::parse();
+
+    let collector = Arc::new(StandInCollector {
+        latency: Duration::from_millis(options.latency_ms),
+        ..Default::default()
+    });
+
+    let addr: SocketAddr = {
+        let listener = TcpListener::bind("127.0.0.1:0").expect("bind stand-in collector");
+        listener.local_addr().unwrap()
+    };
+
+    let server_runtime = tokio::runtime::Builder::new_multi_thread()
+        .worker_threads(2)
+        .enable_all()
+        .build()
+        .unwrap();
+    server_runtime.spawn(
+        tonic::transport::Server::builder()
+            .add_service(MetricsServiceServer::from_arc(collector.clone()))
+            .serve(addr),
+    );
+    std::thread::sleep(Duration::from_millis(100));
+
+    otlp_set_export_config(&OtlpExportConfig {
+        max_batch_points: options.batch_points,
+        max_in_flight_requests: options.in_flight,
+        max_queued_bytes: options.queue_mb * 1024 * 1024,
+        overflow_policy: options.overflow_policy(),
+    });
+    let mut publisher = otlp_publisher_new(&addr.to_string());
+
+    let label_sets = label_sets(options.label_sets);
+    let metric_names: Vec<String> = (0..options.metrics_per_label_set)
+        .map(|i| format!("bench.metric_{}", i))
+        .collect();
+
+    let start = Instant::now();
+    let mut publish_time = Duration::ZERO;
+    let mut peak_queued_bytes = 0;
+
+    for round in 0..options.rounds {
+        let round_start = Instant::now();
+        let timestamp = 1_700_000_000_000_000_000 + round as i64 * 30_000_000_000;
+
+        for labels in &label_sets {
+            publisher.set_labels(labels);
+            for (i, name) in metric_names.iter().enumerate() {
+                if i % 2 == 0 {
+                    publisher.publish_u64(name, "1", "", MetricKind::Sum, timestamp, i as u64);
+                } else {
+                    publisher.publish_f64(name, "us", "", MetricKind::Gauge, timestamp, i as f64);
+                }
+            }
+        }
+        publisher.flush();
+
+        publish_time += round_start.elapsed();
+        peak_queued_bytes = peak_queued_bytes.max(publisher.queued_bytes());
+    }
+
+    publisher.shutdown();
+    let total_time = start.elapsed();
+    let stats = publisher.stats();
+
+    let published = (options.rounds * options.label_sets * options.metrics_per_label_set) as f64;
+    println!(
+        "published {} data points in {} rounds ({} label sets x {} metrics)",
+        published, options.rounds, options.label_sets, options.metrics_per_label_set
+    );
+    println!(
+        "publishing thread: {:.3} s busy, {:.0} data points/s",
+        publish_time.as_secs_f64(),
+        published / publish_time.as_secs_f64()
+    );
+    println!(
+        "end to end: {:.3} s, {:.0} data points/s received",
+        total_time.as_secs_f64(),
+        collector.data_points.load(Ordering::Relaxed) as f64 / total_time.as_secs_f64()
+    );
+    println!(
+        "requests: {} sent, {} failed; received by collector: {} requests, {} data points",
+        stats.requests_sent,
+        stats.requests_failed,
+        collector.requests.load(Ordering::Relaxed),
+        collector.data_points.load(Ordering::Relaxed)
+    );
+    println!(
+        "data points: {} sent, {} failed, {} dropped; peak queue {:.1} MiB",
+        stats.data_points_sent,
+        stats.data_points_failed,
+        stats.data_points_dropped,
+        peak_queued_bytes as f64 / (1024.0 * 1024.0)
+    );
+}
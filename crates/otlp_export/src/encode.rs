@@ -0,0 +1,187 @@
+//! Encoding of batched data points into OTLP export requests.
+
+use std::collections::HashMap;
+use std::sync::Arc;
+
+use opentelemetry_proto::tonic::collector::metrics::v1 as otlp_collector;
+use opentelemetry_proto::tonic::common::v1 as otlp_common;
+use opentelemetry_proto::tonic::metrics::v1 as otlp_metrics;
+use opentelemetry_proto::tonic::resource::v1 as otlp_resource;
+
+use crate::ffi::{Label, MetricKind};
+
+/// Length of the time window sums are aggregated over, used as the start time
+/// of sum data points.
+const SUM_WINDOW_NS: i64 = 30_000_000_000;
+
+/// Everything about a metric except its data points. Shared by all points of
+/// the same metric.
+#[derive(Debug, PartialEq)]
+pub struct MetricDesc {
+    pub name: String,
+    pub unit: String,
+    pub description: String,
+    pub kind: MetricKind,
+}
+
+/// Attributes of a data point, converted to OTLP once and shared by all the
+/// points that carry them.
+pub type LabelSet = Arc<Vec<otlp_common::KeyValue>>;
+
+pub enum PointValue {
+    U64(u64),
+    F64(f64),
+}
+
+pub struct Point {
+    pub metric: Arc<MetricDesc>,
+    pub labels: LabelSet,
+    pub timestamp_unix_nano: i64,
+    pub value: PointValue,
+}
+
+/// Data points sent in one export request.
+#[derive(Default)]
+pub struct Batch {
+    pub points: Vec<Point>,
+    /// Approximate size of the encoded points.
+    pub bytes: u64,
+}
+
+/// Resource and scope the exported metrics are attributed to.
+pub struct Origin {
+    pub resource_attributes: Vec<(String, String)>,
+    pub scope_name: String,
+}
+
+pub fn label_set(labels: &[Label]) -> LabelSet {
+    Arc::new(
+        labels
+            .iter()
+            .map(|l| string_kv(l.key.clone(), l.value.clone()))
+            .collect(),
+    )
+}
+
+/// Approximate encoded size of a label set, in bytes.
+pub fn label_set_bytes(labels: &[Label]) -> u64 {
+    labels
+        .iter()
+        .map(|l| l.key.len() as u64 + l.value.len() as u64 + 2)
+        .sum()
+}
+
+/// Builds the export request for `batch`. Points of the same metric end up
+/// as data points of a single OTLP metric.
+pub fn request(batch: &Batch, origin: &Origin) -> otlp_collector::ExportMetricsServiceRequest {
+    let mut metrics: Vec<otlp_metrics::Metric> = Vec::new();
+    let mut metric_index: HashMap<*const MetricDesc, usize> = HashMap::new();
+
+    for point in &batch.points {
+        let index = *metric_index
+            .entry(Arc::as_ptr(&point.metric))
+            .or_insert_with(|| {
+                metrics.push(new_metric(&point.metric));
+                metrics.len() - 1
+            });
+
+        let data_point = data_point(point);
+        match metrics[index].data.as_mut() {
+            Some(otlp_metrics::metric::Data::Sum(sum)) => sum.data_points.push(data_point),
+            Some(otlp_metrics::metric::Data::Gauge(gauge)) => gauge.data_points.push(data_point),
+            _ => unreachable!("metrics are created as sums or gauges"),
+        }
+    }
+
+    let scope_metrics = otlp_metrics::ScopeMetrics {
+        scope: Some(otlp_common::InstrumentationScope {
+            name: origin.scope_name.clone(),
+            version: String::new(),
+            attributes: vec![],
+            dropped_attributes_count: 0,
+        }),
+        metrics,
+        schema_url: String::new(),
+    };
+
+    let resource = otlp_resource::Resource {
+        attributes: origin
+            .resource_attributes
+            .iter()
+            .map(|(k, v)| string_kv(k.clone(), v.clone()))
+            .collect(),
+        dropped_attributes_count: 0,
+        entity_refs: vec![],
+    };
+
+    otlp_collector::ExportMetricsServiceRequest {
+        resource_metrics: vec![otlp_metrics::ResourceMetrics {
+            resource: Some(resource),
+            scope_metrics: vec![scope_metrics],
+            schema_url: String::new(),
+        }],
+    }
+}
+
+fn new_metric(desc: &MetricDesc) -> otlp_metrics::Metric {
+    let data = match desc.kind {
+        MetricKind::Sum => otlp_metrics::metric::Data::Sum(otlp_metrics::Sum {
+            data_points: vec![],
+            aggregation_temporality: otlp_metrics::AggregationTemporality::Delta as i32,
+            is_monotonic: true,
+        }),
+        _ => otlp_metrics::metric::Data::Gauge(otlp_metrics::Gauge {
+            data_points: vec![],
+        }),
+    };
+
+    otlp_metrics::Metric {
+        name: desc.name.clone(),
+        description: desc.description.clone(),
+        unit: desc.unit.clone(),
+        metadata: vec![],
+        data: Some(data),
+    }
+}
+
+fn data_point(point: &Point) -> otlp_metrics::NumberDataPoint {
+    // For sums, set start_time to slot start (30s window) to match reducer
+    // semantics; it is ignored for gauges.
+    let start_time_unix_nano = match point.metric.kind {
+        MetricKind::Sum => point.timestamp_unix_nano.saturating_sub(SUM_WINDOW_NS) as u64,
+        _ => 0,
+    };
+
+    let value = match point.value {
+        PointValue::U64(v) => {
+            otlp_metrics::number_data_point::Value::AsInt(saturating_u64_to_i64(v))
+        }
+        PointValue::F64(v) => otlp_metrics::number_data_point::Value::AsDouble(v),
+    };
+
+    otlp_metrics::NumberDataPoint {
+        attributes: point.labels.as_ref().clone(),
+        start_time_unix_nano,
+        time_unix_nano: point.timestamp_unix_nano as u64,
+        exemplars: vec![],
+        flags: 0,
+        value: Some(value),
+    }
+}
+
+fn string_kv(key: String, value: String) -> otlp_common::KeyValue {
+    otlp_common::KeyValue {
+        key,
+        value: Some(otlp_common::AnyValue {
+            value: Some(otlp_common::any_value::Value::StringValue(value)),
+        }),
+    }
+}
+
+fn saturating_u64_to_i64(v: u64) -> i64 {
+    if v > i64::MAX as u64 {
+        i64::MAX
+    } else {
+        v as i64
+    }
+}
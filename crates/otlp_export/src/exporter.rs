@@ -0,0 +1,119 @@
+//! Exporter task: takes batches off the queue, encodes them and sends them to
+//! the collector, with a bounded number of requests in flight.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::Arc;
+
+use opentelemetry_proto::tonic::collector::metrics::v1::metrics_service_client::MetricsServiceClient;
+use tokio::sync::Semaphore;
+use tonic::transport::Channel;
+use tonic::Request;
+
+use crate::encode::{self, Batch, Origin};
+use crate::ffi::PublisherStats;
+use crate::queue::{BatchQueue, Dropped};
+
+/// Counters shared between the publisher and the exporter task.
+#[derive(Default)]
+pub struct ExportStats {
+    bytes_sent: AtomicU64,
+    bytes_failed: AtomicU64,
+    data_points_sent: AtomicU64,
+    data_points_failed: AtomicU64,
+    data_points_dropped: AtomicU64,
+    requests_sent: AtomicU64,
+    requests_failed: AtomicU64,
+    unknown_response_tags: AtomicU64,
+}
+
+impl ExportStats {
+    pub fn record_dropped(&self, dropped: Dropped) {
+        if dropped.points == 0 {
+            return;
+        }
+        self.data_points_dropped
+            .fetch_add(dropped.points, Ordering::Relaxed);
+        self.bytes_failed
+            .fetch_add(dropped.bytes, Ordering::Relaxed);
+    }
+
+    fn record_sent(&self, points: u64, rejected: u64, bytes: u64) {
+        self.requests_sent.fetch_add(1, Ordering::Relaxed);
+        self.data_points_sent
+            .fetch_add(points.saturating_sub(rejected), Ordering::Relaxed);
+        self.data_points_failed
+            .fetch_add(rejected.min(points), Ordering::Relaxed);
+        self.bytes_sent.fetch_add(bytes, Ordering::Relaxed);
+    }
+
+    fn record_failed(&self, points: u64, bytes: u64) {
+        self.requests_failed.fetch_add(1, Ordering::Relaxed);
+        self.data_points_failed.fetch_add(points, Ordering::Relaxed);
+        self.bytes_failed.fetch_add(bytes, Ordering::Relaxed);
+    }
+
+    pub fn snapshot(&self) -> PublisherStats {
+        PublisherStats {
+            bytes_sent: self.bytes_sent.load(Ordering::Relaxed),
+            bytes_failed: self.bytes_failed.load(Ordering::Relaxed),
+            data_points_sent: self.data_points_sent.load(Ordering::Relaxed),
+            data_points_failed: self.data_points_failed.load(Ordering::Relaxed),
+            data_points_dropped: self.data_points_dropped.load(Ordering::Relaxed),
+            requests_sent: self.requests_sent.load(Ordering::Relaxed),
+            requests_failed: self.requests_failed.load(Ordering::Relaxed),
+            unknown_response_tags: self.unknown_response_tags.load(Ordering::Relaxed),
+        }
+    }
+}
+
+/// Sends the batches queued in `queue` until it is closed and drained, then
+/// waits for the requests still in flight. Without a client (the endpoint
+/// couldn't be parsed), every batch counts as a failed request.
+pub async fn run(
+    queue: Arc<BatchQueue<Batch>>,
+    client: Option<MetricsServiceClient<Channel>>,
+    max_in_flight: usize,
+    origin: Arc<Origin>,
+    stats: Arc<ExportStats>,
+) {
+    let in_flight = Arc::new(Semaphore::new(max_in_flight));
+
+    loop {
+        // Take a batch off the queue only once it can be sent right away, so
+        // that batches waiting for a slot stay subject to the overflow policy.
+        let permit = in_flight.clone().acquire_owned().await.unwrap();
+        let Some(batch) = queue.pop().await else {
+            break;
+        };
+
+        let mut client = client.clone();
+        let origin = origin.clone();
+        let stats = stats.clone();
+        tokio::spawn(async move {
+            let points = batch.points.len() as u64;
+            let bytes = batch.bytes;
+            let request = encode::request(&batch, &origin);
+            drop(batch);
+
+            let result = match client.as_mut() {
+                Some(client) => client.export(Request::new(request)).await,
+                None => Err(tonic::Status::invalid_argument("invalid endpoint")),
+            };
+
+            match result {
+                Ok(response) => {
+                    let rejected = response
+                        .into_inner()
+                        .partial_success
+                        .map_or(0, |ps| ps.rejected_data_points.max(0) as u64);
+                    stats.record_sent(points, rejected, bytes);
+                }
+                Err(_) => stats.record_failed(points, bytes),
+            }
+
+            drop(permit);
+        });
+    }
+
+    let _ = in_flight.acquire_many(max_in_flight as u32).await;
+}
@@ -1,5 +1,9 @@
 #![allow(clippy::new_without_default)]
 
+mod encode;
+mod exporter;
+mod queue;
+
 #[cxx::bridge]
 pub mod ffi {
     /// Lightweight key/value label representation.
@@ -16,6 +20,9 @@ pub mod ffi {
         pub bytes_failed: u64,
         pub data_points_sent: u64,
         pub data_points_failed: u64,
+        /// Data points dropped without being sent, because the export queue
+        /// was full. Included in `bytes_failed`, but not in `data_points_failed`.
+        pub data_points_dropped: u64,
         pub requests_sent: u64,
         pub requests_failed: u64,
         pub unknown_response_tags: u64,
@@ -29,13 +36,66 @@ pub mod ffi {
         Gauge = 1,
     }
 
+    /// What a publisher does with data points that don't fit in its export queue.
+    #[repr(u8)]
+    #[derive(Debug)]
+    pub enum OtlpOverflowPolicy {
+        /// Drop the newest data points.
+        DropNewest = 0,
+        /// Drop the oldest queued data points.
+        DropOldest = 1,
+        /// Block the publishing thread until there is room.
+        Block = 2,
+    }
+
+    /// Export pipeline settings, shared by all publishers.
+    #[derive(Debug)]
+    pub struct OtlpExportConfig {
+        /// Maximum number of data points per export request.
+        pub max_batch_points: u32,
+        /// Maximum number of export requests in flight, per publisher.
+        pub max_in_flight_requests: u32,
+        /// Maximum (approximate) size of the data points waiting to be sent, per publisher.
+        pub max_queued_bytes: u64,
+        pub overflow_policy: OtlpOverflowPolicy,
+    }
+
     extern "Rust" {
         type Publisher;
 
+        /// Sets up the export pipeline of publishers created after this call.
+        fn otlp_set_export_config(config: &OtlpExportConfig);
+
         /// Create a new OTLP publisher. `endpoint` is host:port or full endpoint string.
         fn otlp_publisher_new(endpoint: &str) -> Box<Publisher>;
 
-        /// Publish a u64 metric point.
+        /// Sets the labels of the data points published next. Labels are
+        /// converted once and shared by all those data points.
+        fn set_labels(self: &mut Publisher, labels: &Vec<Label>);
+
+        /// Publish a u64 metric point, labelled with the labels set last.
+        fn publish_u64(
+            self: &mut Publisher,
+            name: &str,
+            unit: &str,
+            description: &str,
+            kind: MetricKind,
+            timestamp_unix_nano: i64,
+            value: u64,
+        );
+
+        /// Publish a f64 metric point, labelled with the labels set last.
+        fn publish_f64(
+            self: &mut Publisher,
+            name: &str,
+            unit: &str,
+            description: &str,
+            kind: MetricKind,
+            timestamp_unix_nano: i64,
+            value: f64,
+        );
+
+        /// Publish a u64 metric point. Same as `set_labels` followed by `publish_u64`.
         fn publish_metric_u64(
             self: &mut Publisher,
             name: &str,
@@ -47,7 +107,7 @@ pub mod ffi {
             value: u64,
         );
 
-        /// Publish a f64 metric point.
+        /// Publish a f64 metric point. Same as `set_labels` followed by `publish_f64`.
         fn publish_metric_f64(
             self: &mut Publisher,
             name: &str,
@@ -75,10 +135,11 @@ pub mod ffi {
             tcp_resets: u64,
         );
 
-        /// Flush any in-flight batches and process responses.
+        /// Queue the data points published so far for export. Doesn't wait for
+        /// them to be sent.
         fn flush(self: &mut Publisher);
 
-        /// Shut down the publisher.
+        /// Shut down the publisher, sending the data points still queued.
         fn shutdown(self: &mut Publisher);
 
         /// Read current counters/statistics.
@@ -86,114 +147,193 @@ pub mod ffi {
     }
 }
 
-use ffi::{Label, MetricKind, PublisherStats};
-use opentelemetry_proto::tonic::collector::metrics::v1 as otlp_collector;
+use std::collections::HashMap;
+use std::sync::{Arc, Mutex};
+use std::time::Duration;
+
+use encode::{Batch, LabelSet, MetricDesc, Origin, Point, PointValue};
+use exporter::ExportStats;
+use ffi::{Label, MetricKind, OtlpExportConfig, OtlpOverflowPolicy, PublisherStats};
 use opentelemetry_proto::tonic::collector::metrics::v1::metrics_service_client::MetricsServiceClient;
-use opentelemetry_proto::tonic::common::v1 as otlp_common;
-use opentelemetry_proto::tonic::metrics::v1 as otlp_metrics;
-use opentelemetry_proto::tonic::resource::v1 as otlp_resource;
+use queue::{BatchQueue, Overflow};
 use tokio::runtime::Runtime;
-use tonic::Request;
+use tokio::task::JoinHandle;
+use tonic::transport::Endpoint;
 
-/// Minimal placeholder publisher. This crate defines the FFI surface and basic accounting.
-/// Internals can be extended to perform real async OTLP export.
-pub struct Publisher {
-    endpoint: String,
-    runtime: Runtime,
-    resource_attributes: Vec<(String, String)>,
-    scope_name: String,
-    // Buffered metrics and logs to export on flush.
-    buf: Vec<PendingMetric>,
-    // Simple counters following the C++ client semantics.
-    bytes_sent: u64,
-    bytes_failed: u64,
-    data_points_sent: u64,
-    data_points_failed: u64,
-    requests_sent: u64,
-    requests_failed: u64,
-    unknown_response_tags: u64,
-    // Simple buffered counters to roll up into a "request" on flush.
-    buffered_points: u64,
-    buffered_bytes: u64,
+/// How long shutting down waits for queued data points to be sent.
+const SHUTDOWN_TIMEOUT: Duration = Duration::from_secs(5);
+
+/// Approximate encoded size of a data point, other than its labels.
+const POINT_BYTES: u64 = 24;
+
+struct Settings {
+    max_batch_points: usize,
+    max_in_flight_requests: usize,
+    max_queued_bytes: u64,
+    overflow: Overflow,
 }
 
-enum PointValue {
-    U64(u64),
-    F64(f64),
+static SETTINGS: Mutex<Settings> = Mutex::new(Settings {
+    max_batch_points: 1000,
+    max_in_flight_requests: 4,
+    max_queued_bytes: 64 * 1024 * 1024,
+    overflow: Overflow::DropOldest,
+});
+
+pub fn otlp_set_export_config(config: &OtlpExportConfig) {
+    let mut settings = SETTINGS.lock().unwrap();
+    settings.max_batch_points = config.max_batch_points.max(1) as usize;
+    settings.max_in_flight_requests = config.max_in_flight_requests.max(1) as usize;
+    settings.max_queued_bytes = config.max_queued_bytes;
+    settings.overflow = match config.overflow_policy {
+        OtlpOverflowPolicy::DropNewest => Overflow::DropNewest,
+        OtlpOverflowPolicy::Block => Overflow::Block,
+        _ => Overflow::DropOldest,
+    };
 }
 
-struct PendingMetric {
-    name: String,
-    unit: String,
-    description: String,
-    kind: MetricKind,
-    labels: Vec<Label>,
-    timestamp_unix_nano: i64,
-    value: PointValue,
+/// Publishes metrics to an OTLP gRPC endpoint.
+///
+/// Data points are collected into batches on the publishing thread. Full
+/// batches (and the last one, on flush) are queued for the exporter task,
+/// which runs on the publisher's own runtime: it encodes the batches into
+/// requests and sends them, keeping up to `max_in_flight_requests` in flight.
+/// The queue is bounded in bytes; when it fills up, the overflow policy
+/// decides between dropping data and blocking the publishing thread.
+pub struct Publisher {
+    runtime: Runtime,
+    queue: Arc<BatchQueue<Batch>>,
+    stats: Arc<ExportStats>,
+    exporter: Option<JoinHandle<()>>,
+    max_batch_points: usize,
+    // Labels set last, and their approximate size.
+    labels: LabelSet,
+    labels_bytes: u64,
+    // Descriptors of the metrics seen so far, by name.
+    metrics: HashMap<String, Arc<MetricDesc>>,
+    batch: Batch,
 }
 
 pub fn otlp_publisher_new(endpoint: &str) -> Box<Publisher> {
+    let (max_batch_points, max_in_flight_requests, max_queued_bytes, overflow) = {
+        let settings = SETTINGS.lock().unwrap();
+        (
+            settings.max_batch_points,
+            settings.max_in_flight_requests,
+            settings.max_queued_bytes,
+            settings.overflow,
+        )
+    };
+
     // Resolve endpoint: accept full URL or host:port and default to http with no path for gRPC.
     let endpoint_resolved = normalize_grpc_endpoint(endpoint);
 
     // Static resource/scope metadata for now; can be extended via FFI later.
-    let resource_attributes = vec![
-        ("service.name".to_string(), "reducer".to_string()),
-        ("telemetry.sdk.language".to_string(), "rust".to_string()),
-    ];
-    let scope_name = "reducer-ffi".to_string();
-
-    // Create a small Tokio runtime for async export.
-    let runtime = Runtime::new().expect("failed to create Tokio runtime");
+    let origin = Arc::new(Origin {
+        resource_attributes: vec![
+            ("service.name".to_string(), "reducer".to_string()),
+            ("telemetry.sdk.language".to_string(), "rust".to_string()),
+        ],
+        scope_name: "reducer-ffi".to_string(),
+    });
+
+    // A small runtime of its own, so that encoding and sending never run on
+    // the publishing thread.
+    let runtime = tokio::runtime::Builder::new_multi_thread()
+        .worker_threads(2)
+        .thread_name("otlp-export")
+        .enable_all()
+        .build()
+        .expect("failed to create Tokio runtime");
+
+    let queue = Arc::new(BatchQueue::new(max_queued_bytes, overflow));
+    let stats = Arc::new(ExportStats::default());
+
+    // The channel connects on first use, and reconnects as needed.
+    let client = {
+        let _guard = runtime.enter();
+        Endpoint::from_shared(endpoint_resolved)
+            .ok()
+            .map(|endpoint| MetricsServiceClient::new(endpoint.connect_lazy()))
+    };
+
+    let exporter = runtime.spawn(exporter::run(
+        queue.clone(),
+        client,
+        max_in_flight_requests,
+        origin,
+        stats.clone(),
+    ));
 
     Box::new(Publisher {
-        endpoint: endpoint_resolved,
         runtime,
-        resource_attributes,
-        scope_name,
-        buf: Vec::new(),
-        bytes_sent: 0,
-        bytes_failed: 0,
-        data_points_sent: 0,
-        data_points_failed: 0,
-        requests_sent: 0,
-        requests_failed: 0,
-        unknown_response_tags: 0,
-        buffered_points: 0,
-        buffered_bytes: 0,
+        queue,
+        stats,
+        exporter: Some(exporter),
+        max_batch_points,
+        labels: LabelSet::default(),
+        labels_bytes: 0,
+        metrics: HashMap::new(),
+        batch: Batch::default(),
     })
 }
 
 impl Publisher {
-    pub fn publish_metric_u64(
+    pub fn set_labels(&mut self, labels: &Vec<Label>) {
+        self.labels = encode::label_set(labels);
+        self.labels_bytes = encode::label_set_bytes(labels);
+    }
+
+    pub fn publish_u64(
         &mut self,
         name: &str,
         unit: &str,
         description: &str,
         kind: MetricKind,
-        labels: &Vec<Label>,
         timestamp_unix_nano: i64,
         value: u64,
     ) {
-        self.buf.push(PendingMetric {
-            name: name.to_string(),
-            unit: unit.to_string(),
-            description: description.to_string(),
+        self.push(
+            name,
+            unit,
+            description,
             kind,
-            labels: labels
-                .iter()
-                .map(|l| Label {
-                    key: l.key.clone(),
-                    value: l.value.clone(),
-                })
-                .collect(),
             timestamp_unix_nano,
-            value: PointValue::U64(value),
-        });
+            PointValue::U64(value),
+        );
+    }
 
-        let approx = approx_bytes_metric(name, labels);
-        self.buffered_points += 1;
-        self.buffered_bytes = self.buffered_bytes.saturating_add(approx);
+    pub fn publish_f64(
+        &mut self,
+        name: &str,
+        unit: &str,
+        description: &str,
+        kind: MetricKind,
+        timestamp_unix_nano: i64,
+        value: f64,
+    ) {
+        self.push(
+            name,
+            unit,
+            description,
+            kind,
+            timestamp_unix_nano,
+            PointValue::F64(value),
+        );
+    }
+
+    pub fn publish_metric_u64(
+        &mut self,
+        name: &str,
+        unit: &str,
+        description: &str,
+        kind: MetricKind,
+        labels: &Vec<Label>,
+        timestamp_unix_nano: i64,
+        value: u64,
+    ) {
+        self.set_labels(labels);
+        self.publish_u64(name, unit, description, kind, timestamp_unix_nano, value);
     }
 
     pub fn publish_metric_f64(
@@ -206,25 +346,67 @@ impl Publisher {
         timestamp_unix_nano: i64,
         value: f64,
     ) {
-        self.buf.push(PendingMetric {
+        self.set_labels(labels);
+        self.publish_f64(name, unit, description, kind, timestamp_unix_nano, value);
+    }
+
+    fn push(
+        &mut self,
+        name: &str,
+        unit: &str,
+        description: &str,
+        kind: MetricKind,
+        timestamp_unix_nano: i64,
+        value: PointValue,
+    ) {
+        let metric = self.metric(name, unit, description, kind);
+
+        self.batch.points.push(Point {
+            metric,
+            labels: self.labels.clone(),
+            timestamp_unix_nano,
+            value,
+        });
+        self.batch.bytes += self.labels_bytes + name.len() as u64 + POINT_BYTES;
+
+        if self.batch.points.len() >= self.max_batch_points {
+            self.submit();
+        }
+    }
+
+    fn metric(
+        &mut self,
+        name: &str,
+        unit: &str,
+        description: &str,
+        kind: MetricKind,
+    ) -> Arc<MetricDesc> {
+        if let Some(metric) = self.metrics.get(name) {
+            if metric.unit == unit && metric.description == description && metric.kind == kind {
+                return metric.clone();
+            }
+        }
+
+        let metric = Arc::new(MetricDesc {
             name: name.to_string(),
             unit: unit.to_string(),
             description: description.to_string(),
             kind,
-            labels: labels
-                .iter()
-                .map(|l| Label {
-                    key: l.key.clone(),
-                    value: l.value.clone(),
-                })
-                .collect(),
-            timestamp_unix_nano,
-            value: PointValue::F64(value),
         });
+        self.metrics.insert(name.to_string(), metric.clone());
+        metric
+    }
 
-        let approx = approx_bytes_metric(name, labels);
-        self.buffered_points += 1;
-        self.buffered_bytes = self.buffered_bytes.saturating_add(approx);
+    fn submit(&mut self) {
+        if self.batch.points.is_empty() {
+            return;
+        }
+
+        let batch = std::mem::take(&mut self.batch);
+        let points = batch.points.len() as u64;
+        let bytes = batch.bytes;
+        let dropped = self.queue.push(batch, points, bytes);
+        self.stats.record_dropped(dropped);
     }
 }
 
@@ -243,242 +425,41 @@ impl Publisher {
         _tcp_new_sockets: u64,
         _tcp_resets: u64,
     ) {
-        // Future: publish logs via opentelemetry logs SDK. For now, account as one data point.
-        self.buffered_points += 1;
-        // Approximate fixed size for a log line.
-        self.buffered_bytes = self.buffered_bytes.saturating_add(128);
+        // Future: publish logs via opentelemetry logs SDK.
     }
 
     pub fn flush(&mut self) {
-        if self.buf.is_empty() {
-            return;
-        }
-
-        // Build OTLP ResourceMetrics -> ScopeMetrics -> Metric with one datapoint each.
-        let mut metrics: Vec<otlp_metrics::Metric> = Vec::with_capacity(self.buf.len());
-        for pm in &self.buf {
-            let attrs = labels_to_otlp_kv(&pm.labels);
-
-            // For sums, set start_time to slot start (30s window) to match reducer semantics.
-            let time_unix_nano = pm.timestamp_unix_nano as u64;
-            let start_time_unix_nano = pm.timestamp_unix_nano.saturating_sub(30_000_000_000) as u64;
-
-            let metric = match pm.kind {
-                MetricKind::Sum => {
-                    let ndp = match pm.value {
-                        PointValue::U64(v) => otlp_metrics::NumberDataPoint {
-                            attributes: attrs,
-                            start_time_unix_nano,
-                            time_unix_nano,
-                            exemplars: vec![],
-                            flags: 0,
-                            value: Some(otlp_metrics::number_data_point::Value::AsInt(
-                                saturating_u64_to_i64(v),
-                            )),
-                        },
-                        PointValue::F64(v) => otlp_metrics::NumberDataPoint {
-                            attributes: attrs,
-                            start_time_unix_nano,
-                            time_unix_nano,
-                            exemplars: vec![],
-                            flags: 0,
-                            value: Some(otlp_metrics::number_data_point::Value::AsDouble(v)),
-                        },
-                    };
-
-                    let sum = otlp_metrics::Sum {
-                        data_points: vec![ndp],
-                        aggregation_temporality: otlp_metrics::AggregationTemporality::Delta as i32,
-                        is_monotonic: true,
-                    };
-
-                    otlp_metrics::Metric {
-                        name: pm.name.clone(),
-                        description: pm.description.clone(),
-                        unit: pm.unit.clone(),
-                        metadata: vec![],
-                        data: Some(otlp_metrics::metric::Data::Sum(sum)),
-                    }
-                }
-                MetricKind::Gauge => {
-                    let ndp = match pm.value {
-                        PointValue::U64(v) => otlp_metrics::NumberDataPoint {
-                            attributes: attrs,
-                            start_time_unix_nano: 0, // ignored for Gauge
-                            time_unix_nano,
-                            exemplars: vec![],
-                            flags: 0,
-                            value: Some(otlp_metrics::number_data_point::Value::AsInt(
-                                saturating_u64_to_i64(v),
-                            )),
-                        },
-                        PointValue::F64(v) => otlp_metrics::NumberDataPoint {
-                            attributes: attrs,
-                            start_time_unix_nano: 0,
-                            time_unix_nano,
-                            exemplars: vec![],
-                            flags: 0,
-                            value: Some(otlp_metrics::number_data_point::Value::AsDouble(v)),
-                        },
-                    };
-                    let gauge = otlp_metrics::Gauge {
-                        data_points: vec![ndp],
-                    };
-                    otlp_metrics::Metric {
-                        name: pm.name.clone(),
-                        description: pm.description.clone(),
-                        unit: pm.unit.clone(),
-                        metadata: vec![],
-                        data: Some(otlp_metrics::metric::Data::Gauge(gauge)),
-                    }
-                }
-                _ => {
-                    let ndp = match pm.value {
-                        PointValue::U64(v) => otlp_metrics::NumberDataPoint {
-                            attributes: attrs,
-                            start_time_unix_nano: 0, // ignored for Gauge
-                            time_unix_nano,
-                            exemplars: vec![],
-                            flags: 0,
-                            value: Some(otlp_metrics::number_data_point::Value::AsInt(
-                                saturating_u64_to_i64(v),
-                            )),
-                        },
-                        PointValue::F64(v) => otlp_metrics::NumberDataPoint {
-                            attributes: attrs,
-                            start_time_unix_nano: 0,
-                            time_unix_nano,
-                            exemplars: vec![],
-                            flags: 0,
-                            value: Some(otlp_metrics::number_data_point::Value::AsDouble(v)),
-                        },
-                    };
-                    let gauge = otlp_metrics::Gauge {
-                        data_points: vec![ndp],
-                    };
-                    otlp_metrics::Metric {
-                        name: pm.name.clone(),
-                        description: pm.description.clone(),
-                        unit: pm.unit.clone(),
-                        metadata: vec![],
-                        data: Some(otlp_metrics::metric::Data::Gauge(gauge)),
-                    }
-                }
-            };
-
-            metrics.push(metric);
-        }
-
-        let scope_metrics = otlp_metrics::ScopeMetrics {
-            scope: Some(otlp_common::InstrumentationScope {
-                name: self.scope_name.clone(),
-                version: String::new(),
-                attributes: vec![],
-                dropped_attributes_count: 0,
-            }),
-            metrics,
-            schema_url: String::new(),
-        };
-
-        let resource = otlp_resource::Resource {
-            attributes: self
-                .resource_attributes
-                .iter()
-                .map(|(k, v)| otlp_common::KeyValue {
-                    key: k.clone(),
-                    value: Some(otlp_common::AnyValue {
-                        value: Some(otlp_common::any_value::Value::StringValue(v.clone())),
-                    }),
-                })
-                .collect(),
-            dropped_attributes_count: 0,
-            entity_refs: vec![],
-        };
+        self.submit();
+    }
 
-        let rm = otlp_metrics::ResourceMetrics {
-            resource: Some(resource),
-            scope_metrics: vec![scope_metrics],
-            schema_url: String::new(),
+    pub fn shutdown(&mut self) {
+        let Some(exporter) = self.exporter.take() else {
+            return;
         };
 
-        let req = otlp_collector::ExportMetricsServiceRequest {
-            resource_metrics: vec![rm],
-        };
+        self.submit();
+        self.queue.close();
 
-        // Send synchronously on our runtime.
-        let endpoint = self.endpoint.clone();
-        let buffered_points = self.buffered_points;
-        let buffered_bytes = self.buffered_bytes;
-        let export_res = self.runtime.block_on(async move {
-            match MetricsServiceClient::connect(endpoint).await {
-                Ok(mut client) => client.export(Request::new(req)).await,
-                Err(e) => Err(tonic::Status::unknown(format!("connect error: {}", e))),
-            }
-        });
-
-        match export_res {
-            Ok(resp) => {
-                self.requests_sent = self.requests_sent.saturating_add(1);
-                let mut accepted = buffered_points;
-                if let Some(ps) = resp.into_inner().partial_success {
-                    if ps.rejected_data_points > 0 {
-                        let rej = ps.rejected_data_points as u64;
-                        let acc = accepted.saturating_sub(rej);
-                        self.data_points_failed = self.data_points_failed.saturating_add(rej);
-                        accepted = acc;
-                    }
-                }
-                self.data_points_sent = self.data_points_sent.saturating_add(accepted);
-                self.bytes_sent = self.bytes_sent.saturating_add(buffered_bytes);
-            }
-            Err(_e) => {
-                self.requests_failed = self.requests_failed.saturating_add(1);
-                self.data_points_failed = self.data_points_failed.saturating_add(buffered_points);
-                self.bytes_failed = self.bytes_failed.saturating_add(buffered_bytes);
-            }
-        }
-
-        self.buf.clear();
-        self.buffered_points = 0;
-        self.buffered_bytes = 0;
-    }
-
-    pub fn shutdown(&mut self) {
-        self.flush();
-        // Nothing else to shutdown for the exporter.
+        // Give the exporter a chance to send what is still queued.
+        let _ = self
+            .runtime
+            .block_on(async { tokio::time::timeout(SHUTDOWN_TIMEOUT, exporter).await });
     }
 
     pub fn stats(&self) -> PublisherStats {
-        PublisherStats {
-            bytes_sent: self.bytes_sent,
-            bytes_failed: self.bytes_failed,
-            data_points_sent: self.data_points_sent,
-            data_points_failed: self.data_points_failed,
-            requests_sent: self.requests_sent,
-            requests_failed: self.requests_failed,
-            unknown_response_tags: self.unknown_response_tags,
-        }
+        self.stats.snapshot()
     }
-}
 
-fn approx_bytes_metric(name: &str, labels: &Vec<Label>) -> u64 {
-    let mut n = name.len() as u64;
-    for kv in labels {
-        n = n.saturating_add(kv.key.len() as u64 + kv.value.len() as u64 + 2);
+    /// Approximate size of the data points waiting to be sent.
+    pub fn queued_bytes(&self) -> u64 {
+        self.queue.queued_bytes()
     }
-    n
 }
 
-fn labels_to_otlp_kv(labels: &Vec<Label>) -> Vec<otlp_common::KeyValue> {
-    labels
-        .iter()
-        .map(|l| otlp_common::KeyValue {
-            key: l.key.clone(),
-            value: Some(otlp_common::AnyValue {
-                value: Some(otlp_common::any_value::Value::StringValue(l.value.clone())),
-            }),
-        })
-        .collect()
+impl Drop for Publisher {
+    fn drop(&mut self) {
+        self.shutdown();
+    }
 }
 
 fn normalize_grpc_endpoint(input: &str) -> String {
@@ -491,11 +472,3 @@ fn normalize_grpc_endpoint(input: &str) -> String {
         format!("http://{}", input)
     }
 }
-
-fn saturating_u64_to_i64(v: u64) -> i64 {
-    if v > i64::MAX as u64 {
-        i64::MAX
-    } else {
-        v as i64
-    }
-}
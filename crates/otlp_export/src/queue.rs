@@ -0,0 +1,250 @@
+//! Byte-bounded queue of batches waiting to be exported.
+//!
+//! Batches are pushed by the (synchronous) thread that produces metrics and
+//! popped by the asynchronous exporter task. When the queue is full, the
+//! overflow policy decides whether the producer loses data or waits.
+
+use std::collections::VecDeque;
+use std::sync::{Condvar, Mutex};
+
+use tokio::sync::Notify;
+
+/// What to do with a batch that doesn't fit in the queue.
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum Overflow {
+    /// Drop the batch being pushed.
+    DropNewest,
+    /// Drop the oldest queued batches until the new one fits.
+    DropOldest,
+    /// Make the producer wait until the exporter makes room.
+    Block,
+}
+
+/// Amount of data a push had to drop.
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+pub struct Dropped {
+    pub batches: u64,
+    pub points: u64,
+    pub bytes: u64,
+}
+
+struct Entry<T> {
+    item: T,
+    points: u64,
+    bytes: u64,
+}
+
+struct State<T> {
+    entries: VecDeque<Entry<T>>,
+    bytes: u64,
+    closed: bool,
+}
+
+pub struct BatchQueue<T> {
+    state: Mutex<State<T>>,
+    max_bytes: u64,
+    overflow: Overflow,
+    // Signalled when a batch is popped, for producers blocked on a full queue.
+    not_full: Condvar,
+    // Signalled when a batch is pushed, for the (single) consumer.
+    not_empty: Notify,
+}
+
+impl<T> BatchQueue<T> {
+    pub fn new(max_bytes: u64, overflow: Overflow) -> Self {
+        Self {
+            state: Mutex::new(State {
+                entries: VecDeque::new(),
+                bytes: 0,
+                closed: false,
+            }),
+            max_bytes,
+            overflow,
+            not_full: Condvar::new(),
+            not_empty: Notify::new(),
+        }
+    }
+
+    /// Queues `item`, which holds `points` data points encoding to about
+    /// `bytes` bytes. A batch is always accepted into an empty queue, even if
+    /// it is larger than the limit, so that it can make progress.
+    pub fn push(&self, item: T, points: u64, bytes: u64) -> Dropped {
+        let mut dropped = Dropped::default();
+        let mut state = self.state.lock().unwrap();
+
+        let fits = |state: &State<T>| {
+            state.entries.is_empty() || state.bytes.saturating_add(bytes) <= self.max_bytes
+        };
+
+        match self.overflow {
+            Overflow::DropNewest => {
+                if !fits(&state) {
+                    return Dropped {
+                        batches: 1,
+                        points,
+                        bytes,
+                    };
+                }
+            }
+            Overflow::DropOldest => {
+                while !fits(&state) {
+                    let entry = state.entries.pop_front().unwrap();
+                    state.bytes -= entry.bytes;
+                    dropped.batches += 1;
+                    dropped.points += entry.points;
+                    dropped.bytes += entry.bytes;
+                }
+            }
+            Overflow::Block => {
+                while !fits(&state) && !state.closed {
+                    state = self.not_full.wait(state).unwrap();
+                }
+            }
+        }
+
+        if state.closed {
+            return Dropped {
+                batches: dropped.batches + 1,
+                points: dropped.points + points,
+                bytes: dropped.bytes + bytes,
+            };
+        }
+
+        state.entries.push_back(Entry {
+            item,
+            points,
+            bytes,
+        });
+        state.bytes += bytes;
+        drop(state);
+
+        self.not_empty.notify_one();
+        dropped
+    }
+
+    /// Waits for the next batch. Returns `None` once the queue is closed and
+    /// drained. Must only be called from a single task.
+    pub async fn pop(&self) -> Option<T> {
+        loop {
+            // `notify_one` leaves a permit behind if nobody is waiting yet, so
+            // a push between the check and the wait below isn't missed.
+            let notified = self.not_empty.notified();
+            {
+                let mut state = self.state.lock().unwrap();
+                if let Some(entry) = state.entries.pop_front() {
+                    state.bytes -= entry.bytes;
+                    self.not_full.notify_all();
+                    return Some(entry.item);
+                }
+                if state.closed {
+                    return None;
+                }
+            }
+            notified.await;
+        }
+    }
+
+    /// Stops accepting batches. Queued batches can still be popped, and
+    /// producers waiting for room give up and drop theirs.
+    pub fn close(&self) {
+        self.state.lock().unwrap().closed = true;
+        self.not_full.notify_all();
+        self.not_empty.notify_one();
+    }
+
+    /// Number of bytes currently queued.
+    pub fn queued_bytes(&self) -> u64 {
+        self.state.lock().unwrap().bytes
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::Arc;
+    use std::time::Duration;
+
+    fn block_on<F: std::future::Future>(f: F) -> F::Output {
+        tokio::runtime::Builder::new_current_thread()
+            .build()
+            .unwrap()
+            .block_on(f)
+    }
+
+    #[test]
+    fn drop_newest_keeps_queued_batches() {
+        let queue = BatchQueue::new(100, Overflow::DropNewest);
+        assert_eq!(queue.push(1, 10, 60), Dropped::default());
+        assert_eq!(
+            queue.push(2, 5, 60),
+            Dropped {
+                batches: 1,
+                points: 5,
+                bytes: 60
+            }
+        );
+        assert_eq!(queue.push(3, 1, 40), Dropped::default());
+        assert_eq!(queue.queued_bytes(), 100);
+
+        block_on(async {
+            assert_eq!(queue.pop().await, Some(1));
+            assert_eq!(queue.pop().await, Some(3));
+        });
+        assert_eq!(queue.queued_bytes(), 0);
+    }
+
+    #[test]
+    fn drop_oldest_evicts_until_the_batch_fits() {
+        let queue = BatchQueue::new(100, Overflow::DropOldest);
+        queue.push(1, 1, 40);
+        queue.push(2, 2, 40);
+        assert_eq!(
+            queue.push(3, 3, 70),
+            Dropped {
+                batches: 2,
+                points: 3,
+                bytes: 80
+            }
+        );
+        assert_eq!(queue.queued_bytes(), 70);
+        block_on(async { assert_eq!(queue.pop().await, Some(3)) });
+    }
+
+    #[test]
+    fn oversized_batch_is_accepted_into_empty_queue() {
+        let queue = BatchQueue::new(100, Overflow::DropNewest);
+        assert_eq!(queue.push(1, 1, 1000), Dropped::default());
+        assert_eq!(queue.push(2, 1, 1).batches, 1);
+    }
+
+    #[test]
+    fn block_waits_for_the_consumer() {
+        let queue = Arc::new(BatchQueue::new(100, Overflow::Block));
+        queue.push(1, 1, 80);
+
+        let producer = {
+            let queue = queue.clone();
+            std::thread::spawn(move || queue.push(2, 1, 80))
+        };
+
+        std::thread::sleep(Duration::from_millis(50));
+        assert_eq!(queue.queued_bytes(), 80);
+
+        block_on(async { assert_eq!(queue.pop().await, Some(1)) });
+        assert_eq!(producer.join().unwrap(), Dropped::default());
+        block_on(async { assert_eq!(queue.pop().await, Some(2)) });
+    }
+
+    #[test]
+    fn close_drains_then_ends() {
+        let queue = BatchQueue::new(100, Overflow::Block);
+        queue.push(1, 1, 10);
+        queue.close();
+        assert_eq!(queue.push(2, 4, 10).points, 4);
+
+        block_on(async {
+            assert_eq!(queue.pop().await, Some(1));
+            assert_eq!(queue.pop().await, None);
+        });
+    }
+}
@@ -0,0 +1,36 @@
+#[cxx::bridge(namespace = "reducer_cfg")]
+pub mod ffi {
+    /// Configuration of the `reducer_bench` pipeline replay benchmark.
+    /// Note: synthetic streams are generated only when `captures` is empty.
+    #[derive(Debug)]
+    pub struct BenchConfig {
+        // Recorded ingest streams, one per collector connection
+        pub captures: Vec<String>,
+
+        // Synthetic cluster shape
+        pub hosts: u32,
+        pub processes_per_host: u32,
+        pub sockets_per_host: u32,
+        pub stats_rounds: u32,
+
+        pub num_ingest_shards: u32,
+        pub num_matching_shards: u32,
+        pub num_aggregation_shards: u32,
+
+        pub sample_interval_us: u32,
+
+        // RPC queue wait policy
+        pub disable_rpc_notify: bool,
+        pub rpc_spin_us: u32,
+    }
+
+    extern "C++" {
+
+        include!("reducer/bench/bench_entrypoint.h");
+
+        // Implemented in C++ (bench_entrypoint.cc)
+        unsafe fn otn_reducer_bench_main(cfg: &BenchConfig) -> i32;
+    }
+}
+
+pub use ffi::*;
@@ -0,0 +1,93 @@
+//! Command line of `reducer_bench`, which replays ingest streams through the
+//! reducer's pipeline in-process and reports its throughput.
+
+use clap::Parser;
+
+mod ffi;
+
+// the reducer's C++ code calls into the reducer crate
+#[allow(unused_extern_crates)]
+extern crate reducer;
+
+use ffi::BenchConfig;
+
+#[derive(Parser, Debug)]
+#[command(
+    name = "reducer_bench",
+    about = "Replays collector streams through the OpenTelemetry eBPF Reducer pipeline"
+)]
+struct BenchCli {
+    /// Log to console (stdout)
+    #[arg(long = "log-console", alias = "console-log")]
+    log_console: bool,
+    /// Set minimum log level to debug
+    #[arg(long = "debug")]
+    debug: bool,
+
+    /// Recorded ingest streams to replay, one per collector connection (see
+    /// EBPF_NET_RECORD_INTAKE_OUTPUT_PATH); synthetic streams are generated if
+    /// none are given
+    #[arg(value_name = "CAPTURE")]
+    captures: Vec<String>,
+
+    // Synthetic cluster
+    /// Number of synthetic hosts
+    #[arg(long = "hosts", default_value_t = 100)]
+    hosts: u32,
+    /// Number of client (and server) processes on each synthetic host
+    #[arg(long = "processes-per-host", default_value_t = 10)]
+    processes_per_host: u32,
+    /// Number of outgoing connections from each synthetic host
+    #[arg(long = "sockets-per-host", default_value_t = 100)]
+    sockets_per_host: u32,
+    /// Number of socket statistics reports for each synthetic socket
+    #[arg(long = "stats-rounds", default_value_t = 10)]
+    stats_rounds: u32,
+
+    // Scaling
+    #[arg(long = "num-ingest-shards", default_value_t = 1)]
+    num_ingest_shards: u32,
+    #[arg(long = "num-matching-shards", default_value_t = 1)]
+    num_matching_shards: u32,
+    #[arg(long = "num-aggregation-shards", default_value_t = 1)]
+    num_aggregation_shards: u32,
+
+    /// Microseconds between samples of the RPC queues
+    #[arg(long = "sample-interval-us", default_value_t = 1000)]
+    sample_interval_us: u32,
+
+    // RPC queue wait policy
+    /// Poll RPC queues periodically instead of waking cores up on new messages
+    #[arg(long = "disable-rpc-notify")]
+    disable_rpc_notify: bool,
+    /// Microseconds a core keeps polling empty RPC queues before parking
+    #[arg(long = "rpc-spin-us", default_value_t = 50)]
+    rpc_spin_us: u32,
+}
+
+fn main() {
+    let cli = BenchCli::parse();
+
+    unsafe {
+        reducer_sys::ffi::otn_init_logging(cli.log_console, true);
+        // warnings only by default, so logging doesn't skew the measurement
+        reducer_sys::ffi::otn_set_log_level(if cli.debug { 1 } else { 3 });
+    }
+
+    let cfg = BenchConfig {
+        captures: cli.captures,
+        hosts: cli.hosts,
+        processes_per_host: cli.processes_per_host,
+        sockets_per_host: cli.sockets_per_host,
+        stats_rounds: cli.stats_rounds,
+        num_ingest_shards: cli.num_ingest_shards,
+        num_matching_shards: cli.num_matching_shards,
+        num_aggregation_shards: cli.num_aggregation_shards,
+        sample_interval_us: cli.sample_interval_us,
+        disable_rpc_notify: cli.disable_rpc_notify,
+        rpc_spin_us: cli.rpc_spin_us,
+    };
+
+    let code = unsafe { ffi::otn_reducer_bench_main(&cfg) };
+    std::process::exit(code);
+}
@@ -40,6 +40,10 @@ pub mod ffi {
         pub otlp_grpc_metrics_address: String,
         pub otlp_grpc_metrics_port: u32,
         pub otlp_grpc_batch_size: i32,
+        pub otlp_grpc_max_in_flight_requests: u32,
+        pub otlp_grpc_max_queued_bytes: u64,
+        /// One of "drop-newest", "drop-oldest" or "block".
+        pub otlp_grpc_overflow_policy: String,
         pub enable_otlp_grpc_metric_descriptions: bool,
 
         pub disable_prometheus_metrics: bool,
@@ -63,6 +67,19 @@ pub mod ffi {
 
         pub index_dump_interval: u64,
 
+        // RPC queue wait policy
+        pub disable_rpc_notify: bool,
+        pub rpc_spin_us: u32,
+
+        // Admission control of collector connections, per second
+        pub ingest_max_connection_rate: u32, // 0 => unlimited
+        pub ingest_max_byte_rate: u64,       // 0 => unlimited
+        /// One of "none", "numa" or "cpu".
+        pub thread_placement: String,
+
+        // Growable span pools: comma-separated span=capacity list
+        pub span_pool_capacity: String,
+
         // Logging whitelist controls
         pub log_whitelist_all: bool,
         pub log_whitelist_client_type: String,
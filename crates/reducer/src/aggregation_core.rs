@@ -7,7 +7,7 @@ use render_parser::Parser;
 use crate::aggregation_message_handler::AggregationMessageHandler;
 use crate::aggregator::Aggregator;
 use crate::otlp_encoding::OtlpExporter;
-use crate::queue_handler::QueueHandler;
+use crate::queue_handler::{QueueHandler, RpcWaiter};
 use encoder_ebpf_net_aggregation::hash::{aggregation_hash, AGGREGATION_HASH_SIZE};
 use std::cell::RefCell;
 use std::rc::Rc;
@@ -26,6 +26,7 @@ pub struct AggregationCore {
 impl AggregationCore {
     pub fn new(
         eq_views: &[(usize, u32, u32)],
+        waiter: Option<RpcWaiter>,
         shard: u32,
         enable_id_id: bool,
         enable_az_id: bool,
@@ -35,7 +36,7 @@ impl AggregationCore {
     ) -> Self {
         // Shared stop flag and queue handler from descriptors
         let stop = Arc::new(AtomicBool::new(false));
-        let queue_handler = QueueHandler::new_from_views(eq_views, stop.clone());
+        let queue_handler = QueueHandler::new_from_views(eq_views, stop.clone(), waiter);
 
         // Build parser with render-provided perfect hash
         let hash_size = AGGREGATION_HASH_SIZE as usize;
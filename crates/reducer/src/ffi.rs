@@ -8,12 +8,25 @@ mod ffi {
         pub buf_len: u32,  // data buffer size (power of two)
     }
 
+    // Doorbell shared with the queue writers, used to park the core when idle
+    #[derive(Debug)]
+    pub struct RpcWaitView {
+        pub enabled: bool,     // false keeps the busy-polling loop
+        pub doorbell_fd: i32,  // eventfd rung by writers while parked
+        pub parked: *mut u32,  // parked flag checked by writers
+        pub wakeups: *mut u64, // counter: woken up by the doorbell
+        pub spins: *mut u64,   // counter: idle passes spent spinning
+        pub parks: *mut u64,   // counter: times the core parked
+        pub spin_ns: u64,      // how long to spin before parking
+    }
+
     extern "Rust" {
         type AggregationCore;
 
         /// Create a new AggregationCore from element-queue descriptors.
         fn aggregation_core_new(
             queues: &CxxVector<EqView>,
+            wait: &RpcWaitView,
             shard: u32,
             enable_id_id: bool,
             enable_az_id: bool,
@@ -29,10 +42,12 @@ mod ffi {
 }
 
 use crate::aggregation_core::AggregationCore;
+use crate::queue_handler::RpcWaiter;
 
 impl AggregationCore {
     fn from_views(
         views: &cxx::CxxVector<ffi::EqView>,
+        wait: &ffi::RpcWaitView,
         shard: u32,
         enable_id_id: bool,
         enable_az_id: bool,
@@ -44,8 +59,23 @@ impl AggregationCore {
         for ev in views {
             v.push((ev.data as usize, ev.n_elems, ev.buf_len));
         }
+        let waiter = if wait.enabled {
+            // SAFETY: the C++ AggCore owns the doorbell and counters and
+            // outlives this core.
+            Some(unsafe {
+                RpcWaiter::new(
+                    wait.doorbell_fd,
+                    wait.parked,
+                    [wait.wakeups, wait.spins, wait.parks],
+                    std::time::Duration::from_nanos(wait.spin_ns),
+                )
+            })
+        } else {
+            None
+        };
         AggregationCore::new(
             &v[..],
+            waiter,
             shard,
             enable_id_id,
             enable_az_id,
@@ -58,6 +88,7 @@ impl AggregationCore {
 
 fn aggregation_core_new(
     queues: &cxx::CxxVector<ffi::EqView>,
+    wait: &ffi::RpcWaitView,
     shard: u32,
     enable_id_id: bool,
     enable_az_id: bool,
@@ -67,6 +98,7 @@ fn aggregation_core_new(
 ) -> Box<AggregationCore> {
     Box::new(AggregationCore::from_views(
         queues,
+        wait,
         shard,
         enable_id_id,
         enable_az_id,
@@ -100,6 +100,12 @@ struct Cli {
     otlp_grpc_metrics_port: Option<u32>,
     #[arg(long = "otlp-grpc-batch-size")]
     otlp_grpc_batch_size: Option<i32>,
+    #[arg(long = "otlp-grpc-max-in-flight-requests")]
+    otlp_grpc_max_in_flight_requests: Option<u32>,
+    #[arg(long = "otlp-grpc-max-queued-bytes")]
+    otlp_grpc_max_queued_bytes: Option<u64>,
+    #[arg(long = "otlp-grpc-overflow-policy", default_value = "drop-oldest")]
+    otlp_grpc_overflow_policy: String,
     #[arg(long = "enable-otlp-grpc-metric-descriptions")]
     enable_otlp_grpc_metric_descriptions: bool,
 
@@ -119,6 +125,30 @@ struct Cli {
     #[arg(long = "index-dump-interval")]
     index_dump_interval: Option<u64>,
 
+    // RPC queue wait policy
+    /// Poll RPC queues periodically instead of waking cores up on new messages
+    #[arg(long = "disable-rpc-notify")]
+    disable_rpc_notify: bool,
+    /// Microseconds a core keeps polling empty RPC queues before parking
+    #[arg(long = "rpc-spin-us")]
+    rpc_spin_us: Option<u32>,
+
+    // Ingest admission control
+    /// New collector connections admitted per second; 0 for no limit
+    #[arg(long = "ingest-max-connection-rate")]
+    ingest_max_connection_rate: Option<u32>,
+    /// Bytes per second received from collectors before new connections are paced; 0 for no limit
+    #[arg(long = "ingest-max-byte-rate")]
+    ingest_max_byte_rate: Option<u64>,
+    /// Where shard threads run: none, numa (pin to a NUMA node) or cpu (pin to a CPU)
+    #[arg(long = "thread-placement", default_value = "none")]
+    thread_placement: String,
+
+    // Span pools
+    /// Caps growable span pools, as a comma-separated list of span=capacity
+    #[arg(long = "span-pool-capacity")]
+    span_pool_capacity: Option<String>,
+
     // Whitelist controls
     /// Enable all logging whitelists (equivalent to '--log-whitelist-*=*')
     #[arg(long = "log-whitelist-all")]
@@ -157,6 +187,9 @@ fn default_config() -> FfiReducerConfig {
         otlp_grpc_metrics_address: "localhost".into(),
         otlp_grpc_metrics_port: 4317,
         otlp_grpc_batch_size: 1000,
+        otlp_grpc_max_in_flight_requests: 4,
+        otlp_grpc_max_queued_bytes: 64 * 1024 * 1024,
+        otlp_grpc_overflow_policy: "drop-oldest".into(),
         enable_otlp_grpc_metric_descriptions: false,
 
         disable_prometheus_metrics: false,
@@ -180,6 +213,15 @@ fn default_config() -> FfiReducerConfig {
 
         index_dump_interval: 0,
 
+        disable_rpc_notify: false,
+        rpc_spin_us: 50,
+
+        ingest_max_connection_rate: 0,
+        ingest_max_byte_rate: 0,
+        thread_placement: "none".into(),
+
+        span_pool_capacity: String::new(),
+
         log_whitelist_all: false,
         log_whitelist_client_type: String::new(),
         log_whitelist_node_resolution_type: String::new(),
@@ -200,6 +242,26 @@ fn parse_tsdb_format(s: &str) -> Result<TsdbFormat, String> {
     }
 }
 
+fn parse_otlp_grpc_overflow_policy(s: &str) -> Result<String, String> {
+    match s.to_ascii_lowercase().as_str() {
+        policy @ ("drop-newest" | "drop-oldest" | "block") => Ok(policy.to_string()),
+        other => Err(format!(
+            "Invalid OTLP gRPC overflow policy: {}. Supported policies: drop-newest, drop-oldest, block",
+            other
+        )),
+    }
+}
+
+fn parse_thread_placement(s: &str) -> Result<String, String> {
+    match s.to_ascii_lowercase().as_str() {
+        policy @ ("none" | "numa" | "cpu") => Ok(policy.to_string()),
+        other => Err(format!(
+            "Invalid thread placement policy: {}. Supported policies: none, numa, cpu",
+            other
+        )),
+    }
+}
+
 fn build_final_config(cli: &Cli) -> Result<FfiReducerConfig, String> {
     let mut cfg = default_config();
 
@@ -232,6 +294,14 @@ fn build_final_config(cli: &Cli) -> Result<FfiReducerConfig, String> {
     if let Some(v) = cli.otlp_grpc_batch_size {
         cfg.otlp_grpc_batch_size = v;
     }
+    if let Some(v) = cli.otlp_grpc_max_in_flight_requests {
+        cfg.otlp_grpc_max_in_flight_requests = v;
+    }
+    if let Some(v) = cli.otlp_grpc_max_queued_bytes {
+        cfg.otlp_grpc_max_queued_bytes = v;
+    }
+    cfg.otlp_grpc_overflow_policy =
+        parse_otlp_grpc_overflow_policy(&cli.otlp_grpc_overflow_policy)?;
     cfg.enable_otlp_grpc_metric_descriptions |= cli.enable_otlp_grpc_metric_descriptions;
 
     cfg.disable_prometheus_metrics |= cli.disable_prometheus_metrics;
@@ -278,6 +348,23 @@ fn build_final_config(cli: &Cli) -> Result<FfiReducerConfig, String> {
         cfg.index_dump_interval = v;
     }
 
+    cfg.disable_rpc_notify |= cli.disable_rpc_notify;
+    if let Some(v) = cli.rpc_spin_us {
+        cfg.rpc_spin_us = v;
+    }
+
+    if let Some(v) = cli.ingest_max_connection_rate {
+        cfg.ingest_max_connection_rate = v;
+    }
+    if let Some(v) = cli.ingest_max_byte_rate {
+        cfg.ingest_max_byte_rate = v;
+    }
+    cfg.thread_placement = parse_thread_placement(&cli.thread_placement)?;
+
+    if let Some(v) = &cli.span_pool_capacity {
+        cfg.span_pool_capacity = v.clone();
+    }
+
     // Logging whitelist pass-through (strings and all-flag)
     cfg.log_whitelist_all |= cli.log_whitelist_all;
     if let Some(v) = &cli.log_whitelist_client_type {
@@ -326,6 +413,18 @@ fn print_config(cfg: &FfiReducerConfig) {
     );
     println!("otlp_grpc_metrics_port: {}", cfg.otlp_grpc_metrics_port);
     println!("otlp_grpc_batch_size: {}", cfg.otlp_grpc_batch_size);
+    println!(
+        "otlp_grpc_max_in_flight_requests: {}",
+        cfg.otlp_grpc_max_in_flight_requests
+    );
+    println!(
+        "otlp_grpc_max_queued_bytes: {}",
+        cfg.otlp_grpc_max_queued_bytes
+    );
+    println!(
+        "otlp_grpc_overflow_policy: {}",
+        cfg.otlp_grpc_overflow_policy
+    );
     println!(
         "enable_otlp_grpc_metric_descriptions: {}",
         cfg.enable_otlp_grpc_metric_descriptions
@@ -378,6 +477,15 @@ fn print_config(cfg: &FfiReducerConfig) {
     println!("disable_metrics: {}", cfg.disable_metrics);
     println!("enable_metrics: {}", cfg.enable_metrics);
     println!("index_dump_interval: {}", cfg.index_dump_interval);
+    println!("disable_rpc_notify: {}", cfg.disable_rpc_notify);
+    println!("rpc_spin_us: {}", cfg.rpc_spin_us);
+    println!(
+        "ingest_max_connection_rate: {}",
+        cfg.ingest_max_connection_rate
+    );
+    println!("ingest_max_byte_rate: {}", cfg.ingest_max_byte_rate);
+    println!("thread_placement: {}", cfg.thread_placement);
+    println!("span_pool_capacity: {}", cfg.span_pool_capacity);
 }
 
 pub fn run_with_env_args() -> i32 {
@@ -1,4 +1,4 @@
-//! OTLP encoding helpers (stubbed in this iteration).
+//! OTLP encoding helpers.
 
 use crate::aggregator::{AllMetrics, Az, Node};
 use crate::metrics::{DnsMetrics, HttpMetrics, TcpMetrics, UdpMetrics};
@@ -173,55 +173,52 @@ impl OtlpExporter {
             publisher,
         }
     }
+    // Publishes a data point labelled with the labels set last.
     fn publish_u64(
         &mut self,
         name: &str,
         unit: &str,
         desc: &str,
         kind: MetricKind,
-        labels: &Labels,
         ts_ns: i64,
         v: u64,
     ) {
-        self.publisher.publish_metric_u64(
+        self.publisher.publish_u64(
             name,
             unit,
             if self.enable_descriptions { desc } else { "" },
             kind,
-            labels,
             ts_ns,
             v,
         );
     }
+    // Publishes a data point labelled with the labels set last.
     fn publish_f64(
         &mut self,
         name: &str,
         unit: &str,
         desc: &str,
         kind: MetricKind,
-        labels: &Labels,
         ts_ns: i64,
         v: f64,
     ) {
-        self.publisher.publish_metric_f64(
+        self.publisher.publish_f64(
             name,
             unit,
             if self.enable_descriptions { desc } else { "" },
             kind,
-            labels,
             ts_ns,
             v,
         );
     }
 
-    // New per-protocol emitters
-    pub fn emit_tcp(&mut self, ts: i64, labels: &Labels, tcp: &TcpMetrics) {
+    // Per-protocol emitters; data points are labelled with the labels set last.
+    pub fn emit_tcp(&mut self, ts: i64, tcp: &TcpMetrics) {
         self.publish_u64(
             "tcp.bytes",
             "By",
             DESC_TCP_BYTES,
             MetricKind::Sum,
-            labels,
             ts,
             tcp.sum_bytes,
         );
@@ -230,7 +227,6 @@ impl OtlpExporter {
             "1",
             DESC_TCP_RTT_NUM,
             MetricKind::Gauge,
-            labels,
             ts,
             tcp.active_rtts,
         );
@@ -239,7 +235,6 @@ impl OtlpExporter {
             "1",
             DESC_TCP_ACTIVE,
             MetricKind::Gauge,
-            labels,
             ts,
             tcp.active_sockets,
         );
@@ -253,7 +248,6 @@ impl OtlpExporter {
             "us",
             DESC_TCP_RTT_AVG,
             MetricKind::Gauge,
-            labels,
             ts,
             avg_us,
         );
@@ -262,7 +256,6 @@ impl OtlpExporter {
             "1",
             DESC_TCP_PACKETS,
             MetricKind::Sum,
-            labels,
             ts,
             tcp.sum_delivered,
         );
@@ -271,7 +264,6 @@ impl OtlpExporter {
             "1",
             DESC_TCP_RETRANS,
             MetricKind::Sum,
-            labels,
             ts,
             tcp.sum_retrans,
         );
@@ -280,7 +272,6 @@ impl OtlpExporter {
             "1",
             DESC_TCP_SYN_TIMEOUTS,
             MetricKind::Sum,
-            labels,
             ts,
             tcp.syn_timeouts,
         );
@@ -289,7 +280,6 @@ impl OtlpExporter {
             "1",
             DESC_TCP_NEW_SOCKETS,
             MetricKind::Sum,
-            labels,
             ts,
             tcp.new_sockets,
         );
@@ -298,19 +288,17 @@ impl OtlpExporter {
             "1",
             DESC_TCP_RESETS,
             MetricKind::Sum,
-            labels,
             ts,
             tcp.tcp_resets,
         );
     }
 
-    pub fn emit_udp(&mut self, ts: i64, labels: &Labels, udp: &UdpMetrics) {
+    pub fn emit_udp(&mut self, ts: i64, udp: &UdpMetrics) {
         self.publish_u64(
             "udp.bytes",
             "By",
             DESC_UDP_BYTES,
             MetricKind::Sum,
-            labels,
             ts,
             udp.bytes,
         );
@@ -319,7 +307,6 @@ impl OtlpExporter {
             "1",
             DESC_UDP_PACKETS,
             MetricKind::Sum,
-            labels,
             ts,
             udp.packets,
         );
@@ -328,7 +315,6 @@ impl OtlpExporter {
             "1",
             DESC_UDP_ACTIVE,
             MetricKind::Gauge,
-            labels,
             ts,
             udp.active_sockets,
         );
@@ -337,19 +323,17 @@ impl OtlpExporter {
             "1",
             DESC_UDP_DROPS,
             MetricKind::Sum,
-            labels,
             ts,
             udp.drops,
         );
     }
 
-    pub fn emit_dns(&mut self, ts: i64, labels: &Labels, dns: &DnsMetrics) {
+    pub fn emit_dns(&mut self, ts: i64, dns: &DnsMetrics) {
         self.publish_u64(
             "dns.active_sockets",
             "1",
             DESC_DNS_ACTIVE,
             MetricKind::Gauge,
-            labels,
             ts,
             dns.active_sockets,
         );
@@ -358,7 +342,6 @@ impl OtlpExporter {
             "1",
             DESC_DNS_RESPONSES,
             MetricKind::Sum,
-            labels,
             ts,
             dns.responses,
         );
@@ -377,7 +360,6 @@ impl OtlpExporter {
             "us",
             DESC_DNS_CLIENT_AVG,
             MetricKind::Gauge,
-            labels,
             ts,
             avg_client_us,
         );
@@ -386,7 +368,6 @@ impl OtlpExporter {
             "us",
             DESC_DNS_SERVER_AVG,
             MetricKind::Gauge,
-            labels,
             ts,
             avg_server_us,
         );
@@ -395,25 +376,24 @@ impl OtlpExporter {
             "1",
             DESC_DNS_TIMEOUTS,
             MetricKind::Sum,
-            labels,
             ts,
             dns.timeouts,
         );
     }
 
+    // Leaves the labels of the last status code set.
     pub fn emit_http(&mut self, ts: i64, labels: &Labels, http: &HttpMetrics) {
         self.publish_u64(
             "http.active_sockets",
             "1",
             DESC_HTTP_ACTIVE,
             MetricKind::Gauge,
-            labels,
             ts,
             http.active_sockets,
         );
         // Requests (sum of codes)
         let total = http.sum_code_200 + http.sum_code_400 + http.sum_code_500 + http.sum_code_other;
-        self.publish_u64("http.requests", "1", "", MetricKind::Sum, labels, ts, total);
+        self.publish_u64("http.requests", "1", "", MetricKind::Sum, ts, total);
         // Average durations per request (0 when no requests)
         let avg_client_us = if total > 0 {
             (http.sum_total_time_ns as f64) / 1_000_000.0 / (total as f64)
@@ -430,7 +410,6 @@ impl OtlpExporter {
             "us",
             DESC_HTTP_CLIENT_AVG,
             MetricKind::Gauge,
-            labels,
             ts,
             avg_client_us,
         );
@@ -439,7 +418,6 @@ impl OtlpExporter {
             "us",
             DESC_HTTP_SERVER_AVG,
             MetricKind::Gauge,
-            labels,
             ts,
             avg_server_us,
         );
@@ -449,12 +427,12 @@ impl OtlpExporter {
             key: "status_code".to_string(),
             value: "200".to_string(),
         });
+        self.publisher.set_labels(&l2);
         self.publish_u64(
             "http.status_code",
             "1",
             DESC_HTTP_STATUS,
             MetricKind::Sum,
-            &l2,
             ts,
             http.sum_code_200,
         );
@@ -463,12 +441,12 @@ impl OtlpExporter {
             key: "status_code".to_string(),
             value: "400".to_string(),
         });
+        self.publisher.set_labels(&l3);
         self.publish_u64(
             "http.status_code",
             "1",
             DESC_HTTP_STATUS,
             MetricKind::Sum,
-            &l3,
             ts,
             http.sum_code_400,
         );
@@ -477,12 +455,12 @@ impl OtlpExporter {
             key: "status_code".to_string(),
             value: "500".to_string(),
         });
+        self.publisher.set_labels(&l4);
         self.publish_u64(
             "http.status_code",
             "1",
             DESC_HTTP_STATUS,
             MetricKind::Sum,
-            &l4,
             ts,
             http.sum_code_500,
         );
@@ -491,31 +469,34 @@ impl OtlpExporter {
             key: "status_code".to_string(),
             value: "other".to_string(),
         });
+        self.publisher.set_labels(&l5);
         self.publish_u64(
             "http.status_code",
             "1",
             DESC_HTTP_STATUS,
             MetricKind::Sum,
-            &l5,
             ts,
             http.sum_code_other,
         );
     }
 
     // Emit a full AllMetrics, gating per protocol using prev-window flags.
+    // The label set is converted once and shared by all the data points.
     pub fn emit_all_metrics(&mut self, ts: i64, labels: &Labels, m: &AllMetrics) {
+        self.publisher.set_labels(labels);
         if !m.tcp.is_zero() || m.tcp_prev_window_had_samples {
-            self.emit_tcp(ts, labels, &m.tcp);
+            self.emit_tcp(ts, &m.tcp);
         }
         if !m.udp.is_zero() || m.udp_prev_window_had_samples {
-            self.emit_udp(ts, labels, &m.udp);
+            self.emit_udp(ts, &m.udp);
         }
+        if !m.dns.is_zero() || m.dns_prev_window_had_samples {
+            self.emit_dns(ts, &m.dns);
+        }
+        // Last, since status codes change the labels.
         if !m.http.is_zero() || m.http_prev_window_had_samples {
             self.emit_http(ts, labels, &m.http);
         }
-        if !m.dns.is_zero() || m.dns_prev_window_had_samples {
-            self.emit_dns(ts, labels, &m.dns);
-        }
     }
 
     pub fn flush(&mut self) {
@@ -1,4 +1,4 @@
-use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::atomic::{fence, AtomicBool, AtomicU32, AtomicU64, Ordering};
 use std::sync::Arc;
 use std::time::{Duration, Instant};
 
@@ -9,6 +9,82 @@ use timeslot::FastDiv;
 // Keep batch size reasonable to avoid starving other work
 const K_MAX_RPC_BATCH_PER_QUEUE: usize = 10_000;
 
+// Upper bound on a single park, in case a doorbell ring is ever missed
+const K_PARK_TIMEOUT_MS: i32 = 1000;
+
+/// Parks the queue handler on an eventfd doorbell shared with the queue
+/// writers once every queue has stayed idle for longer than the spin budget.
+///
+/// Mirrors `Doorbell` in util/doorbell.h: the consumer publishes its parked
+/// flag, re-checks the queues and only then sleeps; writers ring the eventfd
+/// only when they observe the flag set.
+pub struct RpcWaiter {
+    fd: i32,
+    parked: *const AtomicU32,
+    // wakeups, spins, parks
+    counters: [*const AtomicU64; 3],
+    spin: Duration,
+}
+
+const WAKEUPS: usize = 0;
+const SPINS: usize = 1;
+const PARKS: usize = 2;
+
+impl RpcWaiter {
+    /// # Safety
+    /// `parked` and `counters` must point to naturally aligned integers that
+    /// are only accessed atomically and outlive the returned waiter; `fd` must
+    /// be a non-blocking eventfd that stays open for the same duration.
+    pub unsafe fn new(fd: i32, parked: *mut u32, counters: [*mut u64; 3], spin: Duration) -> Self {
+        Self {
+            fd,
+            parked: parked as *const AtomicU32,
+            counters: counters.map(|c| c as *const AtomicU64),
+            spin,
+        }
+    }
+
+    fn count(&self, which: usize) {
+        unsafe { &*self.counters[which] }.fetch_add(1, Ordering::Relaxed);
+    }
+
+    fn park(&self) {
+        unsafe { &*self.parked }.store(1, Ordering::Relaxed);
+        fence(Ordering::SeqCst);
+    }
+
+    fn unpark(&self) {
+        unsafe { &*self.parked }.store(0, Ordering::Relaxed);
+    }
+
+    /// Sleeps until the doorbell rings or the park timeout elapses.
+    /// Returns true if woken by the doorbell.
+    fn wait(&self) -> bool {
+        let mut pfd = libc::pollfd {
+            fd: self.fd,
+            events: libc::POLLIN,
+            revents: 0,
+        };
+        let ready = unsafe { libc::poll(&mut pfd, 1, K_PARK_TIMEOUT_MS) } > 0;
+        if ready {
+            let mut value: u64 = 0;
+            unsafe {
+                libc::read(
+                    self.fd,
+                    &mut value as *mut u64 as *mut libc::c_void,
+                    std::mem::size_of::<u64>(),
+                )
+            };
+        }
+        self.unpark();
+        ready
+    }
+}
+
+// The raw pointers refer to C++-owned atomics that are designed for
+// cross-thread access.
+unsafe impl Send for RpcWaiter {}
+
 /// Drives reading from element queues and advancing a virtual clock, invoking
 /// user-provided callbacks for each message and at the end of each timeslot.
 pub struct QueueHandler {
@@ -17,11 +93,17 @@ pub struct QueueHandler {
     timeslot_div: FastDiv,
     stop: Arc<AtomicBool>,
     last_processed_ts: u64,
+    waiter: Option<RpcWaiter>,
 }
 
 impl QueueHandler {
     /// Construct from contiguous element-queue descriptors and a shared stop flag.
-    pub fn new_from_views(eq_views: &[(usize, u32, u32)], stop: Arc<AtomicBool>) -> Self {
+    /// With a `waiter` the loop parks when idle instead of busy-polling.
+    pub fn new_from_views(
+        eq_views: &[(usize, u32, u32)],
+        stop: Arc<AtomicBool>,
+        waiter: Option<RpcWaiter>,
+    ) -> Self {
         // Build queues from contiguous storage descriptors
         let mut queues = Vec::with_capacity(eq_views.len());
         for (data, n_elems, buf_len) in eq_views.iter().cloned() {
@@ -42,6 +124,7 @@ impl QueueHandler {
             timeslot_div,
             stop,
             last_processed_ts: 0,
+            waiter,
         }
     }
 
@@ -67,9 +150,11 @@ impl QueueHandler {
 
         let mut next_idx: usize = 0;
         let time_budget = Duration::from_millis(20);
+        let mut idle_since: Option<Instant> = None;
 
         while !self.stop.load(Ordering::Relaxed) {
             let start_cycle = Instant::now();
+            let mut any_handled = false;
 
             for _ in 0..self.queues.len() {
                 let i = next_idx;
@@ -129,6 +214,7 @@ impl QueueHandler {
 
                 // Publish read heads
                 let _ = rb.finish();
+                any_handled |= handled_in_queue > 0;
             }
 
             if self.clock.advance() {
@@ -141,6 +227,57 @@ impl QueueHandler {
                     .saturating_add(slot_ns);
                 handle_timeslot_end(window_end_ns);
             }
+
+            if any_handled {
+                idle_since = None;
+            } else {
+                self.idle(&mut idle_since, start_cycle);
+            }
+        }
+    }
+
+    /// Called after a pass that handled no messages: spins while within the
+    /// waiter's spin budget, then parks on the doorbell.
+    fn idle(&mut self, idle_since: &mut Option<Instant>, now: Instant) {
+        let Some(waiter) = self.waiter.as_ref() else {
+            return;
+        };
+
+        if now.duration_since(*idle_since.get_or_insert(now)) < waiter.spin {
+            waiter.count(SPINS);
+            std::hint::spin_loop();
+            return;
+        }
+
+        // Publish the parked flag before the final check so a writer either
+        // sees it and rings, or its message is visible to `has_pending`.
+        waiter.park();
+        if self.stop.load(Ordering::Relaxed) || self.has_pending() {
+            let waiter = self.waiter.as_ref().unwrap();
+            waiter.unpark();
+            waiter.count(SPINS);
+            return;
+        }
+
+        let waiter = self.waiter.as_ref().unwrap();
+        waiter.count(PARKS);
+        if waiter.wait() {
+            waiter.count(WAKEUPS);
+            *idle_since = None;
+        }
+    }
+
+    /// Returns true if any queue the clock allows reading has an element.
+    fn has_pending(&mut self) -> bool {
+        for i in 0..self.queues.len() {
+            if !self.clock.can_update(i) {
+                continue;
+            }
+            // Dropping the guard without finish() leaves the queue untouched
+            if self.queues[i].start_read().peek_len().is_ok() {
+                return true;
+            }
         }
+        false
     }
 }
@@ -0,0 +1,229 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "as_prefix_table.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace geoip {
+
+namespace {
+
+/**
+ * Last address of the prefix of `prefix_length` bits of `address`.
+ */
+template <typename Address> Address prefix_last(Address address, unsigned prefix_length)
+{
+  /* numeric_limits isn't specialized for u128 in strict standard modes */
+  constexpr unsigned bits = sizeof(Address) * 8;
+  assert(prefix_length <= bits);
+
+  if (prefix_length == 0) {
+    return ~Address{0};
+  }
+  return address | ((Address{1} << (bits - prefix_length)) - 1);
+}
+
+/**
+ * First address of the prefix of `prefix_length` bits of `address`.
+ */
+template <typename Address> Address prefix_first(Address address, unsigned prefix_length)
+{
+  return address & ~(prefix_last(Address{0}, prefix_length));
+}
+
+/**
+ * Flattens non-overlapping prefixes into contiguous ranges covering the whole
+ * address space, merging neighbouring ranges with the same value.
+ */
+template <typename Prefix, typename Address>
+void flatten(std::vector<Prefix> &prefixes, std::vector<Address> &starts, std::vector<std::uint32_t> &values)
+{
+  std::sort(prefixes.begin(), prefixes.end(), [](Prefix const &lhs, Prefix const &rhs) { return lhs.first < rhs.first; });
+
+  starts.clear();
+  values.clear();
+
+  auto const append = [&](Address start, std::uint32_t value) {
+    if (values.empty() || values.back() != value) {
+      starts.push_back(start);
+      values.push_back(value);
+    }
+  };
+
+  /* first address not covered yet, unless `done` */
+  Address next = 0;
+  bool done = false;
+
+  for (auto const &prefix : prefixes) {
+    if (done || prefix.first < next) {
+      throw std::invalid_argument("overlapping prefixes in AS prefix table");
+    }
+    if (prefix.first > next) {
+      append(next, as_prefix_table::no_organization);
+    }
+    append(prefix.first, prefix.value);
+
+    done = prefix.last == ~Address{0};
+    next = prefix.last + 1;
+  }
+
+  if (!done) {
+    append(next, as_prefix_table::no_organization);
+  }
+
+  starts.shrink_to_fit();
+  values.shrink_to_fit();
+}
+
+constexpr u128 ipv4_mapped_first = u128{0xffff} << 32;
+constexpr u128 ipv4_mapped_last = ipv4_mapped_first | 0xffffffffu;
+
+} // namespace
+
+/////////////////////
+// as_prefix_table //
+/////////////////////
+
+as_prefix_table::as_prefix_table()
+    : ipv4_starts_{0},
+      ipv4_values_{no_organization},
+      ipv4_index_((1u << ipv4_index_bits) + 1, 0),
+      ipv6_starts_{0},
+      ipv6_values_{no_organization}
+{}
+
+as_prefix_table::organization_id as_prefix_table::find(std::uint32_t ipv4) const
+{
+  auto const slot = ipv4 >> (32 - ipv4_index_bits);
+
+  /* the range holding the address is between those holding the first
+   * addresses of this /16 and of the next one */
+  auto const begin = ipv4_starts_.begin() + ipv4_index_[slot] + 1;
+  auto const end = ipv4_starts_.begin() + ipv4_index_[slot + 1] + 1;
+
+  auto const range = std::upper_bound(begin, end, ipv4) - ipv4_starts_.begin() - 1;
+  return ipv4_values_[range];
+}
+
+as_prefix_table::organization_id as_prefix_table::find(u128 ipv6) const
+{
+  if (ipv4_mapped_alias_ && ipv6 >= ipv4_mapped_first && ipv6 <= ipv4_mapped_last) {
+    return find(static_cast<std::uint32_t>(ipv6));
+  }
+
+  auto const range = std::upper_bound(ipv6_starts_.begin(), ipv6_starts_.end(), ipv6) - ipv6_starts_.begin() - 1;
+  auto const value = ipv6_values_[range];
+
+  if (value != no_organization && (value & ipv4_alias_flag)) {
+    auto const prefix_length = value & ~ipv4_alias_flag;
+    return find(static_cast<std::uint32_t>(ipv6 >> (96 - prefix_length)));
+  }
+
+  return value;
+}
+
+as_prefix_table::organization_id as_prefix_table::find(in6_addr const *address) const
+{
+  u128 value = 0;
+  for (auto const byte : address->s6_addr) {
+    value = (value << 8) | byte;
+  }
+  return find(value);
+}
+
+std::size_t as_prefix_table::memory_usage() const
+{
+  std::size_t size = sizeof(*this);
+
+  size += ipv4_starts_.capacity() * sizeof(ipv4_starts_[0]);
+  size += ipv4_values_.capacity() * sizeof(ipv4_values_[0]);
+  size += ipv4_index_.capacity() * sizeof(ipv4_index_[0]);
+  size += ipv6_starts_.capacity() * sizeof(ipv6_starts_[0]);
+  size += ipv6_values_.capacity() * sizeof(ipv6_values_[0]);
+
+  for (auto const &organization : organizations_) {
+    size += sizeof(organization) + organization.capacity();
+  }
+
+  return size;
+}
+
+/////////////
+// builder //
+/////////////
+
+as_prefix_table::organization_id as_prefix_table::builder::intern(std::string_view organization)
+{
+  auto const [it, inserted] =
+      organization_ids_.try_emplace(std::string(organization), static_cast<organization_id>(organizations_.size()));
+
+  if (inserted) {
+    if (organizations_.size() >= ipv4_alias_flag) {
+      throw std::length_error("too many organizations in AS prefix table");
+    }
+    organizations_.emplace_back(organization);
+  }
+
+  return it->second;
+}
+
+void as_prefix_table::builder::add_ipv4(std::uint32_t address, unsigned prefix_length, organization_id organization)
+{
+  assert(organization < organizations_.size());
+  ipv4_.push_back({prefix_first(address, prefix_length), prefix_last(address, prefix_length), organization});
+}
+
+void as_prefix_table::builder::add_ipv6(u128 address, unsigned prefix_length, organization_id organization)
+{
+  assert(organization < organizations_.size());
+  ipv6_.push_back({prefix_first(address, prefix_length), prefix_last(address, prefix_length), organization});
+}
+
+void as_prefix_table::builder::add_ipv4_alias(u128 address, unsigned prefix_length)
+{
+  if (prefix_length > 96) {
+    throw std::invalid_argument("IPv4 alias prefix longer than 96 bits in AS prefix table");
+  }
+  ipv6_.push_back(
+      {prefix_first(address, prefix_length), prefix_last(address, prefix_length), ipv4_alias_flag | prefix_length});
+}
+
+as_prefix_table as_prefix_table::builder::build()
+{
+  as_prefix_table table;
+
+  flatten(ipv4_, table.ipv4_starts_, table.ipv4_values_);
+  flatten(ipv6_, table.ipv6_starts_, table.ipv6_values_);
+
+  std::size_t range = 0;
+  for (std::size_t slot = 0; slot < (1u << ipv4_index_bits); ++slot) {
+    auto const first = static_cast<std::uint32_t>(slot << (32 - ipv4_index_bits));
+    while (range + 1 < table.ipv4_starts_.size() && table.ipv4_starts_[range + 1] <= first) {
+      ++range;
+    }
+    table.ipv4_index_[slot] = range;
+  }
+  table.ipv4_index_.back() = table.ipv4_starts_.size() - 1;
+
+  /* lets lookups of IPv4-mapped addresses skip the IPv6 ranges */
+  auto const &ipv6_starts = table.ipv6_starts_;
+  std::size_t const mapped =
+      std::upper_bound(ipv6_starts.begin(), ipv6_starts.end(), ipv4_mapped_first) - ipv6_starts.begin() - 1;
+  table.ipv4_mapped_alias_ = table.ipv6_values_[mapped] == (ipv4_alias_flag | 96) &&
+                             (mapped + 1 == ipv6_starts.size() || ipv6_starts[mapped + 1] > ipv4_mapped_last);
+
+  table.organizations_ = std::move(organizations_);
+
+  ipv4_.clear();
+  ipv6_.clear();
+  organizations_.clear();
+  organization_ids_.clear();
+
+  return table;
+}
+
+} // namespace geoip
@@ -0,0 +1,173 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/types.h>
+
+#include <netinet/in.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace geoip {
+
+/**
+ * Autonomous system organizations of IP address prefixes, compiled in memory
+ * from a GeoIP ASN database (see `database::compile_as_table()`), so lookups
+ * don't walk the database's search tree nor decode its data section.
+ *
+ * Prefixes are flattened into sorted, contiguous address ranges, each mapped
+ * to an organization id. IPv4 ranges are found through a table indexed by the
+ * top 16 bits of the address, then a binary search among the few ranges that
+ * start within that /16. IPv6 ranges are binary searched. IPv6 prefixes that
+ * the database maps to its IPv4 tree (e.g. ::ffff:0:0/96) are looked up in the
+ * IPv4 ranges, as the database does.
+ *
+ * Organization names are interned: each one is stored once, and lookups
+ * return its id.
+ *
+ * The table is immutable once built, so it can be shared by threads.
+ *
+ * Example:
+ *
+ *  auto table = db.compile_as_table();
+ *
+ *  auto id = table.find(&address);
+ *  if (id != as_prefix_table::no_organization) {
+ *    std::cout << table.organization(id) << '\n';
+ *  }
+ */
+struct as_prefix_table {
+  using organization_id = std::uint32_t;
+
+  /**
+   * Returned by lookups of addresses with no known organization.
+   */
+  static constexpr organization_id no_organization = ~organization_id{0};
+
+  struct builder;
+
+  /**
+   * An empty table, in which no address has an organization.
+   */
+  as_prefix_table();
+
+  /**
+   * Looks up an IPv4 address, given in host byte order.
+   */
+  organization_id find(std::uint32_t ipv4) const;
+
+  /**
+   * Looks up an IPv6 address, given as a 128-bit integer (see `IPv6Address::as_int()`).
+   */
+  organization_id find(u128 ipv6) const;
+
+  /**
+   * Looks up a raw IPv4 address.
+   */
+  organization_id find(in_addr const *address) const { return find(ntohl(address->s_addr)); }
+
+  /**
+   * Looks up a raw IPv6 address.
+   */
+  organization_id find(in6_addr const *address) const;
+
+  /**
+   * Name of the organization with the given id, which must have been returned
+   * by a lookup into this table.
+   */
+  std::string_view organization(organization_id id) const { return organizations_[id]; }
+
+  /**
+   * Number of distinct organizations; ids range from 0 to this number excluded.
+   */
+  std::size_t organization_count() const { return organizations_.size(); }
+
+  /**
+   * Number of IPv4 and IPv6 address ranges.
+   */
+  std::size_t range_count() const { return ipv4_starts_.size() + ipv6_starts_.size(); }
+
+  /**
+   * Approximate memory used by the table, in bytes.
+   */
+  std::size_t memory_usage() const;
+
+private:
+  /* range values that redirect to the IPv4 ranges: the IPv4 address is taken
+   * from the 32 bits following the first `value & ~ipv4_alias_flag` bits */
+  static constexpr std::uint32_t ipv4_alias_flag = 0x80000000u;
+
+  static constexpr unsigned ipv4_index_bits = 16;
+
+  /* ranges start at each element, and end where the next one starts */
+  std::vector<std::uint32_t> ipv4_starts_;
+  std::vector<organization_id> ipv4_values_;
+  /* for each /16, index of the range holding its first address; one extra
+   * element holds the index of the last range */
+  std::vector<std::uint32_t> ipv4_index_;
+
+  std::vector<u128> ipv6_starts_;
+  std::vector<std::uint32_t> ipv6_values_;
+  /* whether all of ::ffff:0:0/96 maps to the IPv4 ranges */
+  bool ipv4_mapped_alias_ = false;
+
+  std::vector<std::string> organizations_;
+};
+
+/**
+ * Collects prefixes and builds a prefix table out of them.
+ *
+ * Prefixes of the same address family must not overlap.
+ */
+struct as_prefix_table::builder {
+  /**
+   * Returns the id of the organization with the given name, adding it if
+   * needed.
+   */
+  organization_id intern(std::string_view organization);
+
+  /**
+   * Adds an IPv4 prefix, with the address in host byte order.
+   */
+  void add_ipv4(std::uint32_t address, unsigned prefix_length, organization_id organization);
+
+  /**
+   * Adds an IPv6 prefix, with the address as a 128-bit integer.
+   */
+  void add_ipv6(u128 address, unsigned prefix_length, organization_id organization);
+
+  /**
+   * Adds an IPv6 prefix whose addresses are looked up as the IPv4 address in
+   * the 32 bits following the prefix. The prefix can't be longer than 96 bits.
+   */
+  void add_ipv4_alias(u128 address, unsigned prefix_length);
+
+  /**
+   * Builds the table, leaving this builder empty.
+   *
+   * Throws `std::invalid_argument` if prefixes overlap.
+   */
+  as_prefix_table build();
+
+private:
+  template <typename Address> struct prefix {
+    Address first;
+    Address last;
+    std::uint32_t value;
+  };
+
+  std::vector<prefix<std::uint32_t>> ipv4_;
+  std::vector<prefix<u128>> ipv6_;
+  std::vector<std::string> organizations_;
+  std::unordered_map<std::string, organization_id> organization_ids_;
+};
+
+} // namespace geoip
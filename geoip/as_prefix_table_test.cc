@@ -0,0 +1,169 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <geoip/as_prefix_table.h>
+
+#include <arpa/inet.h>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+namespace geoip {
+namespace {
+
+std::uint32_t ipv4(char const *address)
+{
+  in_addr value;
+  EXPECT_EQ(1, inet_pton(AF_INET, address, &value)) << address;
+  return ntohl(value.s_addr);
+}
+
+u128 ipv6(char const *address)
+{
+  in6_addr value;
+  EXPECT_EQ(1, inet_pton(AF_INET6, address, &value)) << address;
+
+  u128 result = 0;
+  for (auto const byte : value.s6_addr) {
+    result = (result << 8) | byte;
+  }
+  return result;
+}
+
+// Name of the organization of `address`, or "-" if it has none.
+template <typename Address> std::string organization(as_prefix_table const &table, Address address)
+{
+  auto const id = table.find(address);
+  return id == as_prefix_table::no_organization ? "-" : std::string(table.organization(id));
+}
+
+} // namespace
+
+TEST(as_prefix_table, empty)
+{
+  as_prefix_table table;
+
+  EXPECT_EQ("-", organization(table, ipv4("0.0.0.0")));
+  EXPECT_EQ("-", organization(table, ipv4("255.255.255.255")));
+  EXPECT_EQ("-", organization(table, ipv6("::ffff:1.2.3.4")));
+  EXPECT_EQ("-", organization(table, ipv6("2001:db8::1")));
+  EXPECT_EQ(0u, table.organization_count());
+}
+
+TEST(as_prefix_table, ipv4_prefixes)
+{
+  as_prefix_table::builder builder;
+  auto const example = builder.intern("Example");
+  auto const other = builder.intern("Other");
+  builder.add_ipv4(ipv4("10.0.0.0"), 8, example);
+  builder.add_ipv4(ipv4("192.168.1.0"), 24, other);
+  builder.add_ipv4(ipv4("192.168.2.128"), 25, example);
+  builder.add_ipv4(ipv4("255.255.255.255"), 32, other);
+  auto const table = builder.build();
+
+  EXPECT_EQ("-", organization(table, ipv4("9.255.255.255")));
+  EXPECT_EQ("Example", organization(table, ipv4("10.0.0.0")));
+  EXPECT_EQ("Example", organization(table, ipv4("10.128.3.4")));
+  EXPECT_EQ("Example", organization(table, ipv4("10.255.255.255")));
+  EXPECT_EQ("-", organization(table, ipv4("11.0.0.0")));
+
+  EXPECT_EQ("-", organization(table, ipv4("192.168.0.255")));
+  EXPECT_EQ("Other", organization(table, ipv4("192.168.1.0")));
+  EXPECT_EQ("Other", organization(table, ipv4("192.168.1.255")));
+  EXPECT_EQ("-", organization(table, ipv4("192.168.2.127")));
+  EXPECT_EQ("Example", organization(table, ipv4("192.168.2.128")));
+  EXPECT_EQ("Example", organization(table, ipv4("192.168.2.255")));
+  EXPECT_EQ("-", organization(table, ipv4("192.168.3.0")));
+
+  EXPECT_EQ("-", organization(table, ipv4("255.255.255.254")));
+  EXPECT_EQ("Other", organization(table, ipv4("255.255.255.255")));
+
+  in_addr raw;
+  inet_pton(AF_INET, "10.1.2.3", &raw);
+  EXPECT_EQ("Example", organization(table, &raw));
+}
+
+TEST(as_prefix_table, interns_organizations)
+{
+  as_prefix_table::builder builder;
+  auto const first = builder.intern("Example");
+  EXPECT_EQ(first, builder.intern("Example"));
+  EXPECT_NE(first, builder.intern("Other"));
+
+  // neighbouring prefixes of the same organization share a range
+  builder.add_ipv4(ipv4("10.0.0.0"), 9, first);
+  builder.add_ipv4(ipv4("10.128.0.0"), 9, first);
+  auto const table = builder.build();
+
+  EXPECT_EQ(2u, table.organization_count());
+  EXPECT_EQ(table.find(ipv4("10.0.0.1")), table.find(ipv4("10.200.0.1")));
+  // up to 10.0.0.0, 10.0.0.0/8, from 11.0.0.0, plus the whole IPv6 space
+  EXPECT_EQ(4u, table.range_count());
+}
+
+TEST(as_prefix_table, ipv6_prefixes)
+{
+  as_prefix_table::builder builder;
+  auto const example = builder.intern("Example");
+  builder.add_ipv6(ipv6("2001:db8::"), 32, example);
+  builder.add_ipv6(ipv6("ffff::"), 16, example);
+  auto const table = builder.build();
+
+  EXPECT_EQ("-", organization(table, ipv6("2001:db7:ffff:ffff:ffff:ffff:ffff:ffff")));
+  EXPECT_EQ("Example", organization(table, ipv6("2001:db8::")));
+  EXPECT_EQ("Example", organization(table, ipv6("2001:db8:ffff:ffff:ffff:ffff:ffff:ffff")));
+  EXPECT_EQ("-", organization(table, ipv6("2001:db9::")));
+  EXPECT_EQ("Example", organization(table, ipv6("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff")));
+
+  in6_addr raw;
+  inet_pton(AF_INET6, "2001:db8::1", &raw);
+  EXPECT_EQ("Example", organization(table, &raw));
+}
+
+TEST(as_prefix_table, ipv4_aliases)
+{
+  as_prefix_table::builder builder;
+  auto const example = builder.intern("Example");
+  builder.add_ipv4(ipv4("192.0.2.0"), 24, example);
+  builder.add_ipv4_alias(ipv6("::"), 96);
+  builder.add_ipv4_alias(ipv6("::ffff:0:0"), 96);
+  builder.add_ipv4_alias(ipv6("2002::"), 16);
+  auto const table = builder.build();
+
+  EXPECT_EQ("Example", organization(table, ipv6("::192.0.2.1")));
+  EXPECT_EQ("Example", organization(table, ipv6("::ffff:192.0.2.1")));
+  EXPECT_EQ("-", organization(table, ipv6("::ffff:192.0.3.1")));
+  // 6to4 addresses hold the IPv4 address after their first 16 bits
+  EXPECT_EQ("Example", organization(table, ipv6("2002:c000:0201::1")));
+  EXPECT_EQ("-", organization(table, ipv6("2002:c000:0301::1")));
+  EXPECT_EQ("-", organization(table, ipv6("2003:c000:0201::1")));
+}
+
+TEST(as_prefix_table, ipv4_mapped_without_alias)
+{
+  as_prefix_table::builder builder;
+  auto const example = builder.intern("Example");
+  auto const other = builder.intern("Other");
+  builder.add_ipv4(ipv4("192.0.2.0"), 24, example);
+  builder.add_ipv6(ipv6("::ffff:0:0"), 96, other);
+  auto const table = builder.build();
+
+  EXPECT_EQ("Example", organization(table, ipv4("192.0.2.1")));
+  EXPECT_EQ("Other", organization(table, ipv6("::ffff:192.0.2.1")));
+  EXPECT_EQ("Other", organization(table, ipv6("::ffff:192.0.3.1")));
+}
+
+TEST(as_prefix_table, overlapping_prefixes)
+{
+  as_prefix_table::builder builder;
+  auto const example = builder.intern("Example");
+  builder.add_ipv4(ipv4("10.0.0.0"), 8, example);
+  builder.add_ipv4(ipv4("10.1.0.0"), 16, example);
+
+  EXPECT_THROW(builder.build(), std::invalid_argument);
+}
+
+} // namespace geoip
@@ -4,9 +4,80 @@
 #include "geoip.h"
 
 #include <cstring>
+#include <unordered_map>
+#include <vector>
 
 namespace geoip {
 
+namespace {
+
+void read_node(MMDB_s const &db, std::uint32_t node_number, MMDB_search_node_s &node)
+{
+  if (auto const error = ::MMDB_read_node(&db, node_number, &node); error != MMDB_SUCCESS) {
+    throw std::runtime_error(::MMDB_strerror(error));
+  }
+}
+
+/**
+ * Walks the search tree from `root`, in an address space of `bits` bits.
+ *
+ * Calls `on_node(prefix, prefix_length, node_number)` for each search node,
+ * which tells whether to walk the node's subtree, and
+ * `on_data(prefix, prefix_length, entry)` for each data record. Prefixes are
+ * relative to `root`.
+ */
+template <typename OnNode, typename OnData>
+void walk_search_tree(MMDB_s const &db, std::uint32_t root, unsigned bits, OnNode &&on_node, OnData &&on_data)
+{
+  struct subtree {
+    std::uint32_t node;
+    u128 prefix;
+    unsigned prefix_length;
+  };
+
+  std::vector<subtree> pending{{root, 0, 0}};
+  MMDB_search_node_s node;
+
+  while (!pending.empty()) {
+    auto const current = pending.back();
+    pending.pop_back();
+
+    if (current.prefix_length >= bits) {
+      throw std::runtime_error("corrupt GeoIP database: search tree too deep");
+    }
+    read_node(db, current.node, node);
+
+    for (unsigned bit = 0; bit < 2; ++bit) {
+      auto const type = bit ? node.right_record_type : node.left_record_type;
+      auto const record = bit ? node.right_record : node.left_record;
+      auto const &entry = bit ? node.right_record_entry : node.left_record_entry;
+
+      auto const prefix = current.prefix | (u128{bit} << (bits - current.prefix_length - 1));
+      auto const prefix_length = current.prefix_length + 1;
+
+      switch (type) {
+      case MMDB_RECORD_TYPE_SEARCH_NODE:
+        if (on_node(prefix, prefix_length, static_cast<std::uint32_t>(record))) {
+          pending.push_back({static_cast<std::uint32_t>(record), prefix, prefix_length});
+        }
+        break;
+
+      case MMDB_RECORD_TYPE_DATA:
+        on_data(prefix, prefix_length, entry);
+        break;
+
+      case MMDB_RECORD_TYPE_EMPTY:
+        break;
+
+      default:
+        throw std::runtime_error("corrupt GeoIP database: invalid search tree record");
+      }
+    }
+  }
+}
+
+} // namespace
+
 ///////////////////
 // address_entry //
 ///////////////////
@@ -117,6 +188,88 @@ address_entry database::lookup(in6_addr const *ip_address)
   return lookup(&address);
 }
 
+as_prefix_table database::compile_as_table() const
+{
+  as_prefix_table::builder builder;
+
+  if (!db_.has_value()) {
+    return builder.build();
+  }
+  auto const &db = *db_;
+
+  // data records are shared by many prefixes: decode each one once
+  std::unordered_map<std::uint32_t, as_prefix_table::organization_id> organizations;
+  auto const organization = [&](MMDB_entry_s const &entry) {
+    auto const [it, inserted] = organizations.try_emplace(entry.offset, as_prefix_table::no_organization);
+    if (inserted) {
+      address_entry data(MMDB_lookup_result_s{.found_entry = true, .entry = entry, .netmask = 0});
+      std::string_view name;
+      if (well_known_data::try_autonomous_system_organization(name, data)) {
+        it->second = builder.intern(name);
+      }
+    }
+    return it->second;
+  };
+
+  // IPv4 addresses are at ::/96 in IPv6 databases, which may also map other
+  // prefixes to that subtree (e.g. ::ffff:0:0/96)
+  std::optional<std::uint32_t> ipv4_root;
+  if (db.metadata.ip_version == 6) {
+    MMDB_search_node_s node;
+    std::uint32_t current = 0;
+    for (unsigned depth = 0; depth < 96; ++depth) {
+      read_node(db, current, node);
+      if (node.left_record_type != MMDB_RECORD_TYPE_SEARCH_NODE) {
+        // all of the IPv4 space is within a single prefix
+        if (node.left_record_type == MMDB_RECORD_TYPE_DATA) {
+          if (auto const id = organization(node.left_record_entry); id != as_prefix_table::no_organization) {
+            builder.add_ipv4(0, 0, id);
+          }
+        }
+        break;
+      }
+      current = static_cast<std::uint32_t>(node.left_record);
+    }
+    if (node.left_record_type == MMDB_RECORD_TYPE_SEARCH_NODE) {
+      ipv4_root = current;
+    }
+
+    walk_search_tree(
+        db,
+        0,
+        128,
+        [&](u128 prefix, unsigned prefix_length, std::uint32_t node_number) {
+          if (node_number == ipv4_root) {
+            builder.add_ipv4_alias(prefix, prefix_length);
+            return false;
+          }
+          return true;
+        },
+        [&](u128 prefix, unsigned prefix_length, MMDB_entry_s const &entry) {
+          if (auto const id = organization(entry); id != as_prefix_table::no_organization) {
+            builder.add_ipv6(prefix, prefix_length, id);
+          }
+        });
+  } else {
+    ipv4_root = 0;
+  }
+
+  if (ipv4_root) {
+    walk_search_tree(
+        db,
+        *ipv4_root,
+        32,
+        [](u128, unsigned, std::uint32_t) { return true; },
+        [&](u128 prefix, unsigned prefix_length, MMDB_entry_s const &entry) {
+          if (auto const id = organization(entry); id != as_prefix_table::no_organization) {
+            builder.add_ipv4(static_cast<std::uint32_t>(prefix), prefix_length, id);
+          }
+        });
+  }
+
+  return builder.build();
+}
+
 address_entry database::lookup(char const *ip)
 {
   int gai_error = 0;
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <geoip/as_prefix_table.h>
+
 #include <maxminddb.h>
 
 #include <initializer_list>
@@ -407,6 +409,18 @@ struct database {
    */
   address_entry lookup(char const *ip);
 
+  /**
+   * Compiles the autonomous system organizations of all the prefixes in the
+   * database into an in-memory table, which can be used for lookups instead of
+   * the database. The table is independent from the database, which can be
+   * closed afterwards.
+   *
+   * Returns an empty table if the database isn't loaded.
+   *
+   * Throws `std::runtime_error` if the database is corrupt.
+   */
+  as_prefix_table compile_as_table() const;
+
   /**
    * Tells whether the database was successfully loaded or not.
    */
@@ -0,0 +1,82 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <reducer/admission_control.h>
+
+#include <algorithm>
+
+namespace reducer {
+
+TokenBucket::TokenBucket(double rate, double burst, u64 now_ns)
+    : rate_(rate), burst_(burst), tokens_(burst), last_refill_ns_(now_ns)
+{}
+
+void TokenBucket::refill(u64 now_ns)
+{
+  if (now_ns <= last_refill_ns_) {
+    return;
+  }
+
+  tokens_ = std::min(burst_, tokens_ + rate_ * (now_ns - last_refill_ns_) / 1e9);
+  last_refill_ns_ = now_ns;
+}
+
+double TokenBucket::available(u64 now_ns)
+{
+  refill(now_ns);
+  return tokens_;
+}
+
+bool TokenBucket::try_take(double tokens, u64 now_ns)
+{
+  if (unlimited()) {
+    return true;
+  }
+
+  refill(now_ns);
+  if (tokens_ < tokens) {
+    return false;
+  }
+
+  tokens_ -= tokens;
+  return true;
+}
+
+void TokenBucket::take(double tokens, u64 now_ns)
+{
+  if (unlimited()) {
+    return;
+  }
+
+  refill(now_ns);
+  tokens_ -= tokens;
+}
+
+AdmissionControl::AdmissionControl(Config const &config, u64 now_ns)
+{
+  if (config.connection_rate > 0) {
+    connections_ = TokenBucket(config.connection_rate, std::max(1.0, config.connection_rate * BURST_SECONDS), now_ns);
+  }
+  if (config.byte_rate > 0) {
+    bytes_ = TokenBucket(config.byte_rate, config.byte_rate * BURST_SECONDS, now_ns);
+  }
+}
+
+AdmissionControl::Decision AdmissionControl::on_new_connection(u64 now_ns)
+{
+  if (!connections_.try_take(1, now_ns)) {
+    return Decision::defer;
+  }
+
+  bool const storm = !connections_.unlimited() && connections_.available(now_ns) < connections_.burst() / 2;
+  bool const over_byte_budget = !bytes_.unlimited() && bytes_.available(now_ns) <= 0;
+
+  return storm || over_byte_budget ? Decision::pace : Decision::admit;
+}
+
+void AdmissionControl::on_bytes_received(u64 bytes, u64 now_ns)
+{
+  bytes_.take(bytes, now_ns);
+}
+
+} // namespace reducer
@@ -0,0 +1,99 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/types.h>
+
+namespace reducer {
+
+// Token bucket refilled at `rate` tokens per second, holding at most `burst`
+// tokens. Tokens can be taken past zero, leaving the bucket in debt until it
+// refills, for costs that are only known after the fact (e.g. bytes already
+// received). A bucket with a rate of zero is unlimited.
+// This class is not thread-safe.
+class TokenBucket {
+public:
+  // Makes an unlimited bucket.
+  TokenBucket() = default;
+
+  // Makes a full bucket. `now_ns` is a monotonic timestamp.
+  TokenBucket(double rate, double burst, u64 now_ns);
+
+  bool unlimited() const { return rate_ == 0; }
+
+  // Returns the tokens available at `now_ns`, negative if in debt.
+  double available(u64 now_ns);
+
+  // Takes `tokens` if that many are available, returning whether it did.
+  bool try_take(double tokens, u64 now_ns);
+
+  // Takes `tokens` whether they are available or not.
+  void take(double tokens, u64 now_ns);
+
+  double burst() const { return burst_; }
+
+private:
+  void refill(u64 now_ns);
+
+  double rate_ = 0;
+  double burst_ = 0;
+  double tokens_ = 0;
+  u64 last_refill_ns_ = 0;
+};
+
+// Decides whether to admit new collector connections, so that a reconnect
+// storm (e.g. after a reducer restart) is spread out over time instead of
+// every collector replaying its full state at once.
+//
+// Two token buckets are kept:
+//   - connections: one token per admitted connection. When empty, new
+//     connections are deferred: they are closed, and collectors retry after
+//     their reconnect backoff.
+//   - bytes: one token per byte received from collectors, taken after the
+//     fact. When in debt, or when more than half the connection budget is
+//     used up, new connections are admitted but asked to pace their initial
+//     state dump.
+//
+// With both rates at zero (the default), every connection is admitted as is.
+// This class is not thread-safe.
+class AdmissionControl {
+public:
+  struct Config {
+    // New connections per second, or zero for no limit.
+    double connection_rate = 0;
+    // Bytes received per second, or zero for no limit.
+    double byte_rate = 0;
+  };
+
+  // Seconds worth of each rate that can be used in a burst.
+  static constexpr double BURST_SECONDS = 1.0;
+
+  enum class Decision {
+    // Admit the connection.
+    admit,
+    // Admit the connection, and ask the collector to pace its initial dump.
+    pace,
+    // Close the connection; the collector will retry.
+    defer,
+  };
+
+  AdmissionControl() = default;
+  AdmissionControl(Config const &config, u64 now_ns);
+
+  bool enabled() const { return !connections_.unlimited() || !bytes_.unlimited(); }
+
+  // Decides what to do with a new connection at `now_ns`.
+  Decision on_new_connection(u64 now_ns);
+
+  // Accounts for `bytes` received from collectors since the last call.
+  void on_bytes_received(u64 bytes, u64 now_ns);
+
+private:
+  TokenBucket connections_;
+  TokenBucket bytes_;
+};
+
+} // namespace reducer
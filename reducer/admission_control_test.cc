@@ -0,0 +1,88 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <reducer/admission_control.h>
+
+#include <gtest/gtest.h>
+
+namespace reducer {
+namespace {
+
+constexpr u64 SECOND_NS = 1'000'000'000;
+
+} // namespace
+
+TEST(token_bucket, refills_up_to_burst)
+{
+  TokenBucket bucket(10, 20, 0);
+  EXPECT_DOUBLE_EQ(20, bucket.available(0));
+
+  EXPECT_TRUE(bucket.try_take(15, 0));
+  EXPECT_FALSE(bucket.try_take(10, 0));
+  EXPECT_DOUBLE_EQ(5, bucket.available(0));
+
+  EXPECT_DOUBLE_EQ(10, bucket.available(SECOND_NS / 2));
+  EXPECT_DOUBLE_EQ(20, bucket.available(10 * SECOND_NS));
+}
+
+TEST(token_bucket, take_goes_into_debt)
+{
+  TokenBucket bucket(10, 10, 0);
+  bucket.take(30, 0);
+  EXPECT_DOUBLE_EQ(-20, bucket.available(0));
+  EXPECT_FALSE(bucket.try_take(1, SECOND_NS));
+  EXPECT_DOUBLE_EQ(0, bucket.available(2 * SECOND_NS));
+}
+
+TEST(token_bucket, unlimited)
+{
+  TokenBucket bucket;
+  EXPECT_TRUE(bucket.unlimited());
+  bucket.take(1'000'000, 0);
+  EXPECT_TRUE(bucket.try_take(1'000'000, 0));
+}
+
+TEST(admission_control, disabled_admits_everything)
+{
+  AdmissionControl admission;
+  EXPECT_FALSE(admission.enabled());
+
+  admission.on_bytes_received(1ull << 40, 0);
+  for (int i = 0; i < 10'000; ++i) {
+    EXPECT_EQ(AdmissionControl::Decision::admit, admission.on_new_connection(0));
+  }
+}
+
+TEST(admission_control, connection_rate)
+{
+  AdmissionControl admission({.connection_rate = 10}, 0);
+  EXPECT_TRUE(admission.enabled());
+
+  // the first half of the burst is admitted as is, the rest is paced
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(i < 5 ? AdmissionControl::Decision::admit : AdmissionControl::Decision::pace, admission.on_new_connection(0))
+        << "connection " << i;
+  }
+  EXPECT_EQ(AdmissionControl::Decision::defer, admission.on_new_connection(0));
+
+  // one connection's worth of tokens is back after a tenth of a second
+  EXPECT_EQ(AdmissionControl::Decision::pace, admission.on_new_connection(SECOND_NS / 10));
+  EXPECT_EQ(AdmissionControl::Decision::defer, admission.on_new_connection(SECOND_NS / 10));
+
+  EXPECT_EQ(AdmissionControl::Decision::admit, admission.on_new_connection(10 * SECOND_NS));
+}
+
+TEST(admission_control, byte_rate)
+{
+  AdmissionControl admission({.byte_rate = 1000}, 0);
+  EXPECT_EQ(AdmissionControl::Decision::admit, admission.on_new_connection(0));
+
+  admission.on_bytes_received(3000, 0);
+  EXPECT_EQ(AdmissionControl::Decision::pace, admission.on_new_connection(0));
+  EXPECT_EQ(AdmissionControl::Decision::pace, admission.on_new_connection(SECOND_NS));
+
+  // the debt is paid off two seconds later
+  EXPECT_EQ(AdmissionControl::Decision::admit, admission.on_new_connection(3 * SECOND_NS));
+}
+
+} // namespace reducer
@@ -11,15 +11,22 @@
 #include <common/constants.h>
 
 #include <platform/userspace-time.h>
+#include <util/doorbell.h>
 #include <util/log.h>
 #include <util/time.h>
 
+#include <atomic>
 #include <stdexcept>
 
 #include <reducer/util/thread_ops.h>
 
 namespace reducer::aggregation {
 
+// The Rust core accesses these counters and the parked flag through plain
+// integer pointers.
+static_assert(sizeof(std::atomic<u64>) == sizeof(u64) && std::atomic<u64>::is_always_lock_free);
+static_assert(sizeof(std::atomic<u32>) == sizeof(u32) && std::atomic<u32>::is_always_lock_free);
+
 bool AggCore::node_ip_field_disabled_ = false;
 
 void AggCore::set_node_ip_field_disabled(bool disabled)
@@ -59,6 +66,7 @@ AggCore::AggCore(
           initial_timestamp,
           aggregation_to_logging_queues.make_writers<ebpf_net::logging::Writer>(
               shard_num, std::bind(&Core::current_timestamp, this))),
+      doorbell_(matching_to_aggregation_queues.doorbell(shard_num)),
       rust_core_([&] {
         auto readers = matching_to_aggregation_queues.make_readers(shard_num);
         std::vector<reducer_agg::EqView> eqs;
@@ -70,8 +78,17 @@ AggCore::AggCore(
           v.buf_len = q.buf_mask + 1;
           eqs.push_back(v);
         }
+        reducer_agg::RpcWaitView wait;
+        wait.enabled = rpc_notify_enabled();
+        wait.doorbell_fd = doorbell_.fd();
+        wait.parked = reinterpret_cast<uint32_t *>(doorbell_.parked_flag());
+        wait.wakeups = reinterpret_cast<uint64_t *>(&rpc_wait_stats_.wakeups);
+        wait.spins = reinterpret_cast<uint64_t *>(&rpc_wait_stats_.spins);
+        wait.parks = reinterpret_cast<uint64_t *>(&rpc_wait_stats_.parks);
+        wait.spin_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(rpc_spin_duration()).count();
         return reducer_agg::aggregation_core_new(
             eqs,
+            wait,
             static_cast<uint32_t>(shard_num),
             id_id_enabled_,
             az_id_enabled_,
@@ -95,8 +112,9 @@ void AggCore::run()
 
 void AggCore::stop_async()
 {
-  // Cooperative stop for the Rust core
+  // Cooperative stop for the Rust core; wake it up in case it is parked
   rust_core_->aggregation_core_stop();
+  doorbell_.ring();
 }
 
 } // namespace reducer::aggregation
@@ -17,6 +17,8 @@
 // cxx::bridge header for Rust AggregationCore
 #include <reducer_aggregation_cxxbridge.h>
 
+class Doorbell;
+
 namespace reducer {
 class RpcQueueMatrix;
 }
@@ -71,6 +73,9 @@ public:
   void stop_async();
 
 private:
+  // Doorbell the Rust core parks on; rung on stop so it notices promptly.
+  Doorbell &doorbell_;
+
   // Opaque Rust AggregationCore owned via cxx rust::Box
   rust::Box<reducer_agg::AggregationCore> rust_core_;
 };
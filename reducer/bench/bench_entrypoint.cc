@@ -0,0 +1,45 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <reducer/bench/bench_entrypoint.h>
+
+#include <reducer/bench/replay_bench.h>
+
+#include <algorithm>
+#include <reducer_bench_cxxbridge.h>
+
+namespace {
+
+reducer::bench::ReplayBenchConfig from_ffi(reducer_cfg::BenchConfig const &in)
+{
+  reducer::bench::ReplayBenchConfig out;
+  for (auto const &capture : in.captures) {
+    out.capture_paths.emplace_back(capture);
+  }
+
+  out.synthetic.num_hosts = in.hosts;
+  out.synthetic.processes_per_host = in.processes_per_host;
+  out.synthetic.sockets_per_host = in.sockets_per_host;
+  out.synthetic.stats_rounds = in.stats_rounds;
+
+  out.num_ingest_shards = in.num_ingest_shards;
+  out.num_matching_shards = in.num_matching_shards;
+  out.num_aggregation_shards = in.num_aggregation_shards;
+
+  out.sample_interval = std::chrono::microseconds{std::max(in.sample_interval_us, 1u)};
+
+  out.disable_rpc_notify = in.disable_rpc_notify;
+  out.rpc_spin_us = in.rpc_spin_us;
+
+  return out;
+}
+
+} // namespace
+
+// C++ entrypoint of reducer_bench: accepts the configuration from Rust and runs the benchmark.
+namespace reducer_cfg {
+int otn_reducer_bench_main(reducer_cfg::BenchConfig const &cfg)
+{
+  return reducer::bench::run_replay_bench(from_ffi(cfg));
+}
+} // namespace reducer_cfg
@@ -0,0 +1,7 @@
+#pragma once
+namespace reducer_cfg {
+// forward declaration
+struct BenchConfig;
+
+int otn_reducer_bench_main(BenchConfig const &cfg);
+} // namespace reducer_cfg
@@ -0,0 +1,513 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <reducer/bench/replay_bench.h>
+
+#include <reducer/aggregation/agg_core.h>
+#include <reducer/core.h>
+#include <reducer/disabled_metrics.h>
+#include <reducer/ingest/npm_connection.h>
+#include <reducer/ingest/shared_state.h>
+#include <reducer/logging/logging_core.h>
+#include <reducer/matching/matching_core.h>
+#include <reducer/null_publisher.h>
+#include <reducer/rpc_queue_matrix.h>
+
+#include <generated/ebpf_net/ingest/index.h>
+#include <generated/ebpf_net/logging/writer.h>
+#include <generated/ebpf_net/matching/writer.h>
+
+#include <platform/userspace-time.h>
+
+#include <util/boot_time.h>
+#include <util/element_queue_cpp.h>
+#include <util/file_ops.h>
+#include <util/log.h>
+#include <util/system_ops.h>
+#include <util/time.h>
+
+#include <absl/synchronization/notification.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <thread>
+
+namespace reducer::bench {
+
+namespace {
+
+// Number of bytes of a stream handled before moving on to the next stream of
+// the same shard, so that streams are interleaved as with live connections.
+constexpr std::size_t REPLAY_SLICE_SIZE = 64 * 1024;
+
+constexpr auto PULSE_INTERVAL = 1s;
+
+// Number of consecutive samples with all queues empty before the pipeline is
+// considered drained.
+constexpr int DRAINED_SAMPLES = 3;
+
+constexpr auto DRAIN_TIMEOUT = 60s;
+
+// Replays a subset of the streams on its own thread, standing in for an
+// IngestWorker with its TCP connections.
+class ReplayShard {
+public:
+  ReplayShard(
+      RpcQueueMatrix &ingest_to_logging_queues,
+      RpcQueueMatrix &ingest_to_matching_queues,
+      u32 shard_num,
+      std::vector<std::string const *> streams)
+      : ingest_to_logging_queues_(ingest_to_logging_queues),
+        ingest_to_matching_queues_(ingest_to_matching_queues),
+        shard_num_(shard_num),
+        streams_(std::move(streams))
+  {}
+
+  void start() { thread_ = std::thread(&ReplayShard::run, this); }
+
+  // Tears down the replayed connections and waits for the thread to exit.
+  void stop()
+  {
+    stop_.Notify();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  bool done() const { return done_.HasBeenNotified(); }
+
+  u64 messages() const { return messages_.load(std::memory_order_relaxed); }
+  u64 bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+  struct Replay {
+    std::string const *stream;
+    std::size_t offset = 0;
+    std::unique_ptr<ingest::NpmConnection> connection;
+    bool finished = false;
+  };
+
+  void run()
+  {
+    // everything ingest-related is created and destroyed on this thread, like
+    // in IngestWorker
+    ebpf_net::ingest::Index index(
+        ingest_to_logging_queues_.make_writers<ebpf_net::logging::Writer>(shard_num_, monotonic, get_boot_time()),
+        ingest_to_matching_queues_.make_writers<ebpf_net::matching::Writer>(shard_num_, monotonic, get_boot_time()));
+
+    {
+      ebpf_net::ingest::auto_handles::logger logger(index.logger.alloc());
+      ebpf_net::ingest::auto_handles::core_stats core_stats(index.core_stats.alloc());
+      ebpf_net::ingest::auto_handles::ingest_core_stats ingest_core_stats(index.ingest_core_stats.alloc());
+
+      ingest::set_local_index(&index);
+      ingest::set_local_logger(&logger);
+      ingest::set_local_core_stats_handle(&core_stats);
+      ingest::set_local_ingest_core_stats_handle(&ingest_core_stats);
+
+      std::vector<Replay> replays;
+      replays.reserve(streams_.size());
+      for (auto const *stream : streams_) {
+        replays.push_back({.stream = stream, .connection = std::make_unique<ingest::NpmConnection>(index)});
+      }
+
+      u64 last_pulse = monotonic();
+      auto pulse_if_due = [&] {
+        if (monotonic() - last_pulse >= integer_time<std::chrono::nanoseconds>(PULSE_INTERVAL)) {
+          index.send_pulse();
+          last_pulse = monotonic();
+        }
+      };
+
+      for (std::size_t remaining = replays.size(); remaining > 0;) {
+        for (auto &replay : replays) {
+          if (!replay.finished && !replay_slice(replay)) {
+            replay.finished = true;
+            --remaining;
+          }
+          pulse_if_due();
+        }
+      }
+
+      done_.Notify();
+
+      // keep the connections open, as idle collectors would, until the
+      // measurement is over
+      while (!stop_.WaitForNotificationWithTimeout(absl::FromChrono(PULSE_INTERVAL))) {
+        index.send_pulse();
+      }
+
+      replays.clear();
+
+      ingest::set_local_connection(nullptr);
+      ingest::set_local_index(nullptr);
+      ingest::set_local_logger(nullptr);
+      ingest::set_local_core_stats_handle(nullptr);
+      ingest::set_local_ingest_core_stats_handle(nullptr);
+    }
+  }
+
+  // Handles up to REPLAY_SLICE_SIZE bytes of the replay's stream, one message
+  // at a time. Returns false once the stream is done with.
+  bool replay_slice(Replay &replay)
+  {
+    auto *const connection = replay.connection.get();
+    std::string const &stream = *replay.stream;
+    std::size_t const slice_end = std::min(stream.size(), replay.offset + REPLAY_SLICE_SIZE);
+
+    ingest::set_local_connection(connection);
+
+    u64 messages = 0;
+    std::size_t const slice_begin = replay.offset;
+    bool more = true;
+
+    try {
+      while (replay.offset < slice_end) {
+        int const res = connection->handle(stream.data() + replay.offset, stream.size() - replay.offset);
+
+        if (res == -EAGAIN) {
+          LOG::warn(
+              "replay shard {}: stream ends with a truncated message, {} bytes ignored",
+              shard_num_,
+              stream.size() - replay.offset);
+          more = false;
+          break;
+        }
+
+        if (res < 0) {
+          LOG::error("replay shard {}: error handling message at offset {}: {}", shard_num_, replay.offset, strerror(-res));
+          more = false;
+          break;
+        }
+
+        replay.offset += res;
+        ++messages;
+      }
+    } catch (std::exception const &e) {
+      LOG::error("replay shard {}: error handling message at offset {}: {}", shard_num_, replay.offset, e.what());
+      more = false;
+    }
+
+    messages_.fetch_add(messages, std::memory_order_relaxed);
+    bytes_.fetch_add(replay.offset - slice_begin, std::memory_order_relaxed);
+
+    return more && replay.offset < stream.size();
+  }
+
+  RpcQueueMatrix &ingest_to_logging_queues_;
+  RpcQueueMatrix &ingest_to_matching_queues_;
+  u32 const shard_num_;
+  std::vector<std::string const *> const streams_;
+
+  std::thread thread_;
+  absl::Notification done_;
+  absl::Notification stop_;
+
+  std::atomic<u64> messages_{0};
+  std::atomic<u64> bytes_{0};
+};
+
+// Samples the depth of every queue of a pipeline stage from the outside, and
+// estimates how long elements stay in them: a probe remembers a queue's tail
+// when sampled, and completes once the reader's head gets past it.
+class StageMonitor {
+public:
+  StageMonitor(std::string name, RpcQueueMatrix &queues) : name_(std::move(name))
+  {
+    for (std::size_t receiver = 0; receiver < queues.num_receivers(); ++receiver) {
+      for (auto &queue : queues.make_readers(receiver)) {
+        queues_.push_back({.queue = std::move(queue)});
+      }
+    }
+  }
+
+  // Returns the total number of elements waiting in this stage's queues.
+  u64 depth() const
+  {
+    u64 depth = 0;
+    for (auto const &observed : queues_) {
+      depth += EQ_LOAD_ACQUIRE(observed.queue.shared->elem_tail) - EQ_LOAD_ACQUIRE(observed.queue.shared->elem_head);
+    }
+    return depth;
+  }
+
+  // Same as depth(), also recording statistics.
+  u64 sample(u64 now)
+  {
+    u64 depth = 0;
+
+    for (auto &observed : queues_) {
+      u32 const head = EQ_LOAD_ACQUIRE(observed.queue.shared->elem_head);
+      u32 const tail = EQ_LOAD_ACQUIRE(observed.queue.shared->elem_tail);
+
+      while (!observed.probes.empty() && static_cast<int>(head - observed.probes.front().tail) >= 0) {
+        latencies_.push_back(now - observed.probes.front().start);
+        observed.probes.pop_front();
+      }
+
+      if (tail != head) {
+        observed.probes.push_back({.start = now, .tail = tail});
+      }
+
+      depth += tail - head;
+    }
+
+    max_depth_ = std::max(max_depth_, depth);
+    total_depth_ += depth;
+    ++num_samples_;
+
+    return depth;
+  }
+
+  void report(std::ostream &out)
+  {
+    out << "  " << std::left << std::setw(24) << name_ << std::right << " depth max " << std::setw(8) << max_depth_
+        << " mean " << std::setw(10) << std::fixed << std::setprecision(1)
+        << (num_samples_ ? static_cast<double>(total_depth_) / num_samples_ : 0.0);
+
+    if (latencies_.empty()) {
+      out << "  latency n/a" << std::endl;
+      return;
+    }
+
+    std::sort(latencies_.begin(), latencies_.end());
+    auto percentile = [&](double p) {
+      auto const index = static_cast<std::size_t>(p * (latencies_.size() - 1));
+      return static_cast<double>(latencies_[index]) / 1e6;
+    };
+
+    out << std::setprecision(3) << "  latency ms p50 " << percentile(0.5) << " p90 " << percentile(0.9) << " p99 "
+        << percentile(0.99) << " max " << percentile(1.0) << std::endl;
+  }
+
+private:
+  struct Probe {
+    u64 start;
+    u32 tail;
+  };
+
+  struct ObservedQueue {
+    ElementQueue queue;
+    std::deque<Probe> probes;
+  };
+
+  std::string name_;
+  std::vector<ObservedQueue> queues_;
+
+  u64 max_depth_ = 0;
+  u64 total_depth_ = 0;
+  u64 num_samples_ = 0;
+  std::vector<u64> latencies_;
+};
+
+std::vector<std::string> load_streams(ReplayBenchConfig const &config)
+{
+  std::vector<std::string> streams;
+
+  if (config.capture_paths.empty()) {
+    LOG::info(
+        "Generating synthetic streams for {} hosts, {} sockets and {} processes per host",
+        config.synthetic.num_hosts,
+        config.synthetic.sockets_per_host,
+        config.synthetic.processes_per_host);
+    return make_synthetic_streams(config.synthetic);
+  }
+
+  for (auto const &path : config.capture_paths) {
+    auto stream = read_file_as_string(path.c_str());
+    if (!stream) {
+      LOG::critical("Failed to read capture file '{}': {}", path, stream.error());
+      return {};
+    }
+    streams.push_back(std::move(*stream));
+  }
+
+  return streams;
+}
+
+} // namespace
+
+int run_replay_bench(ReplayBenchConfig const &config)
+{
+  if (!config.num_ingest_shards || !config.num_matching_shards || !config.num_aggregation_shards) {
+    LOG::critical("Shard counts must be positive");
+    return 1;
+  }
+
+  auto const streams = load_streams(config);
+  if (streams.empty()) {
+    LOG::critical("Nothing to replay: no capture files or synthetic hosts");
+    return 1;
+  }
+
+  Core::set_rpc_notify_enabled(!config.disable_rpc_notify);
+  Core::set_rpc_spin_duration(std::chrono::microseconds{config.rpc_spin_us});
+
+  RpcQueueMatrix ingest_to_matching_queues(config.num_ingest_shards, config.num_matching_shards);
+  RpcQueueMatrix ingest_to_logging_queues(config.num_ingest_shards, 1);
+  RpcQueueMatrix matching_to_logging_queues(config.num_matching_shards, 1);
+  RpcQueueMatrix matching_to_aggregation_queues(config.num_matching_shards, config.num_aggregation_shards);
+  RpcQueueMatrix aggregation_to_logging_queues(config.num_aggregation_shards, 1);
+
+  std::vector<StageMonitor> stages;
+  stages.emplace_back("ingest->matching", ingest_to_matching_queues);
+  stages.emplace_back("matching->aggregation", matching_to_aggregation_queues);
+  stages.emplace_back("ingest->logging", ingest_to_logging_queues);
+  stages.emplace_back("matching->logging", matching_to_logging_queues);
+  stages.emplace_back("aggregation->logging", aggregation_to_logging_queues);
+
+  auto const initial_timestamp = monotonic() + get_boot_time();
+
+  NullPublisher stats_publisher;
+  logging::LoggingCore logging_core(
+      ingest_to_logging_queues,
+      matching_to_logging_queues,
+      aggregation_to_logging_queues,
+      stats_publisher.make_writer(0),
+      DisabledMetrics(""),
+      /* shard */ 0,
+      initial_timestamp);
+  logging_core.set_connection_authenticated();
+
+  std::vector<std::unique_ptr<aggregation::AggCore>> agg_cores;
+  for (size_t shard = 0; shard < config.num_aggregation_shards; ++shard) {
+    // an empty OTLP endpoint keeps aggregated metrics in-process
+    agg_cores.push_back(std::make_unique<aggregation::AggCore>(
+        matching_to_aggregation_queues, aggregation_to_logging_queues, shard, initial_timestamp, "", false));
+    agg_cores.back()->set_connection_authenticated();
+  }
+
+  std::vector<std::unique_ptr<matching::MatchingCore>> matching_cores;
+  for (size_t shard = 0; shard < config.num_matching_shards; ++shard) {
+    matching_cores.push_back(std::make_unique<matching::MatchingCore>(
+        ingest_to_matching_queues,
+        matching_to_aggregation_queues,
+        matching_to_logging_queues,
+        nullptr,
+        shard,
+        initial_timestamp));
+    matching_cores.back()->set_connection_authenticated();
+  }
+
+  std::vector<std::thread> core_threads;
+  core_threads.emplace_back(&logging::LoggingCore::run, &logging_core);
+  for (auto &agg_core : agg_cores) {
+    core_threads.emplace_back(&aggregation::AggCore::run, agg_core.get());
+  }
+  for (auto &matching_core : matching_cores) {
+    core_threads.emplace_back(&matching::MatchingCore::run, matching_core.get());
+  }
+
+  std::vector<std::vector<std::string const *>> shard_streams(config.num_ingest_shards);
+  u64 total_bytes = 0;
+  for (std::size_t i = 0; i < streams.size(); ++i) {
+    shard_streams[i % config.num_ingest_shards].push_back(&streams[i]);
+    total_bytes += streams[i].size();
+  }
+
+  LOG::info("Replaying {} streams ({} bytes) on {} ingest shards", streams.size(), total_bytes, config.num_ingest_shards);
+
+  std::vector<std::unique_ptr<ReplayShard>> shards;
+  for (u32 shard = 0; shard < config.num_ingest_shards; ++shard) {
+    shards.push_back(std::make_unique<ReplayShard>(
+        ingest_to_logging_queues, ingest_to_matching_queues, shard, std::move(shard_streams[shard])));
+  }
+
+  // Samples all stages until the shards are done replaying and the pipeline
+  // has been idle for a few samples. Returns false on timeout.
+  auto wait_for_drain = [&](bool measure) {
+    int drained_samples = 0;
+    std::optional<u64> deadline;
+
+    while (drained_samples < DRAINED_SAMPLES) {
+      std::this_thread::sleep_for(config.sample_interval);
+
+      u64 const now = monotonic();
+      u64 depth = 0;
+      for (auto &stage : stages) {
+        depth += measure ? stage.sample(now) : stage.depth();
+      }
+
+      bool const replaying = std::any_of(shards.begin(), shards.end(), [](auto const &shard) { return !shard->done(); });
+      if (replaying) {
+        continue;
+      }
+
+      drained_samples = (depth == 0) ? drained_samples + 1 : 0;
+
+      if (!deadline) {
+        deadline = now + integer_time<std::chrono::nanoseconds>(DRAIN_TIMEOUT);
+      } else if (now > *deadline) {
+        return false;
+      }
+    }
+
+    return true;
+  };
+
+  auto const start = monotonic();
+  for (auto &shard : shards) {
+    shard->start();
+  }
+
+  bool const drained = wait_for_drain(true);
+  auto const elapsed = monotonic() - start;
+
+  u64 messages = 0;
+  u64 bytes = 0;
+  for (auto const &shard : shards) {
+    messages += shard->messages();
+    bytes += shard->bytes();
+  }
+
+  double const seconds = static_cast<double>(elapsed) / 1e9;
+
+  auto &out = std::cout;
+  out << std::fixed << std::setprecision(3);
+  out << "streams:     " << streams.size() << std::endl;
+  out << "messages:    " << messages << std::endl;
+  out << "bytes:       " << bytes << std::endl;
+  out << "elapsed s:   " << seconds << std::endl;
+  out << "msgs/sec:    " << std::setprecision(0) << (messages / seconds) << std::endl;
+  out << "MB/sec:      " << std::setprecision(3) << (bytes / seconds / 1e6) << std::endl;
+  if (!drained) {
+    out << "(queues did not drain within " << DRAIN_TIMEOUT.count() << "s, results are partial)" << std::endl;
+  }
+  out << "queues:" << std::endl;
+  for (auto &stage : stages) {
+    stage.report(out);
+  }
+  if (auto const usage = get_resource_usage()) {
+    out << "peak RSS MB: " << std::setprecision(1) << (usage->max_resident_set_size / 1e6) << std::endl;
+  }
+
+  // tear down replayed connections first, and let the cores handle the
+  // resulting messages before stopping them
+  for (auto &shard : shards) {
+    shard->stop();
+  }
+  wait_for_drain(false);
+
+  for (auto &matching_core : matching_cores) {
+    matching_core->stop_async();
+  }
+  for (auto &agg_core : agg_cores) {
+    agg_core->stop_async();
+  }
+  logging_core.stop_async();
+
+  for (auto &thread : core_threads) {
+    thread.join();
+  }
+
+  return drained ? 0 : 1;
+}
+
+} // namespace reducer::bench
@@ -0,0 +1,46 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <reducer/bench/synthetic_stream.h>
+
+#include <platform/types.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace reducer::bench {
+
+struct ReplayBenchConfig {
+  // Recorded ingest streams to replay, one collector connection per file (see
+  // EBPF_NET_RECORD_INTAKE_OUTPUT_PATH). If empty, synthetic streams are
+  // generated instead.
+  std::vector<std::string> capture_paths;
+  // Cluster to generate streams for, when no capture files are given.
+  SyntheticStreamConfig synthetic;
+
+  size_t num_ingest_shards = 1;
+  size_t num_matching_shards = 1;
+  size_t num_aggregation_shards = 1;
+
+  // How often queue depths are sampled, which is also the resolution of the
+  // reported queue latencies.
+  std::chrono::microseconds sample_interval{1000};
+
+  bool disable_rpc_notify = false;
+  u32 rpc_spin_us = 0;
+};
+
+// Replays ingest streams through the reducer's ingest, matching, aggregation
+// and logging cores, all in-process, with metrics output discarded. Prints
+// throughput, queue depth and queue latency for each stage between cores, and
+// the peak resident set size.
+//
+// Returns the process exit code.
+int run_replay_bench(ReplayBenchConfig const &config);
+
+} // namespace reducer::bench
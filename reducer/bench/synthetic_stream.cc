@@ -0,0 +1,190 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <reducer/bench/synthetic_stream.h>
+
+#include <channel/buffered_writer.h>
+#include <channel/channel.h>
+#include <common/client_type.h>
+#include <common/constants.h>
+
+#include <generated/ebpf_net/ingest/writer.h>
+
+#include <util/ip_address.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace reducer::bench {
+
+namespace {
+
+constexpr u32 WRITE_BUFFER_SIZE = 16 * 1024;
+
+constexpr u16 SERVER_PORT_BASE = 8000;
+constexpr u16 SERVER_PORT_COUNT = 32;
+constexpr u16 CLIENT_PORT_BASE = 32768;
+constexpr u32 MAX_SOCKETS_PER_HOST = 65536 - CLIENT_PORT_BASE;
+
+constexpr u32 CLIENT_PID_BASE = 1000;
+constexpr u32 SERVER_PID_BASE = 100000;
+
+constexpr u64 CLIENT_SK_BASE = 0x1000'0000;
+constexpr u64 SERVER_SK_BASE = 0x2000'0000;
+
+constexpr u32 NUM_AZS = 3;
+
+// Timestamps of each stream start here and advance by a fixed step per
+// message, so that the same config always yields the same bytes.
+constexpr u64 START_TIME_NS = 1'000'000'000;
+constexpr u64 MESSAGE_INTERVAL_NS = 1'000;
+
+// Channel that appends everything sent through it to a string.
+class StringChannel : public channel::Channel {
+public:
+  explicit StringChannel(std::string &out) : out_(out) {}
+
+  std::error_code send(const u8 *data, int data_len) override
+  {
+    out_.append(reinterpret_cast<char const *>(data), data_len);
+    return {};
+  }
+
+  bool is_open() const override { return true; }
+
+private:
+  std::string &out_;
+};
+
+// One side of a TCP connection, as reported by the collector on its host.
+struct Socket {
+  u64 sk;
+  u32 pid;
+  u32 local_addr;
+  u16 local_port;
+  u32 remote_addr;
+  u16 remote_port;
+  u32 tx_rx;
+};
+
+u32 host_addr(u32 host)
+{
+  return IPv4Address({10, static_cast<u8>(host >> 16), static_cast<u8>(host >> 8), static_cast<u8>(host)}).as_int();
+}
+
+void write_comm(u8 (&comm)[16], std::string_view prefix, u32 n)
+{
+  auto const name = std::string(prefix) + std::to_string(n);
+  std::memset(comm, 0, sizeof(comm));
+  std::memcpy(comm, name.data(), std::min(name.size(), sizeof(comm)));
+}
+
+void write_host_stream(u32 host, u32 num_processes, u32 stats_rounds, std::vector<Socket> const &sockets, std::string &out)
+{
+  StringChannel channel(out);
+  channel::BufferedWriter buffered_writer(channel, WRITE_BUFFER_SIZE);
+  // not monotonic(): the compression dictionary is trained on these streams,
+  // and has to come out the same on every build
+  u64 now = START_TIME_NS;
+  ::ebpf_net::ingest::Writer writer(buffered_writer, [&now] { return now += MESSAGE_INTERVAL_NS; }, 0, nullptr);
+
+  auto const hostname = "bench-host-" + std::to_string(host);
+  auto const az = "bench-zone-" + std::to_string(host % NUM_AZS);
+  auto const instance_id = "i-" + std::to_string(host);
+
+  writer.version_info(versions::release.major(), versions::release.minor(), versions::release.patch());
+  writer.connect(static_cast<u8>(ClientType::kernel), jb_blob{hostname});
+  writer.set_node_info(
+      jb_blob{az}, jb_blob{std::string_view("bench-node")}, jb_blob{instance_id}, jb_blob{std::string_view("bench")});
+
+  u8 vpc_id[22] = {};
+  writer.private_ipv4_addr(host_addr(host), vpc_id);
+
+  u8 comm[16];
+  for (u32 i = 0; i < num_processes; ++i) {
+    write_comm(comm, "client-", i);
+    writer.pid_info_create(CLIENT_PID_BASE + i, comm, 0, 1, jb_blob{});
+    write_comm(comm, "server-", i);
+    writer.pid_info_create(SERVER_PID_BASE + i, comm, 0, 1, jb_blob{});
+  }
+
+  for (auto const &socket : sockets) {
+    writer.new_sock_info(socket.pid, socket.sk);
+    writer.set_state_ipv4(
+        socket.remote_addr, socket.local_addr, socket.remote_port, socket.local_port, socket.sk, socket.tx_rx);
+  }
+
+  for (u32 round = 0; round < stats_rounds; ++round) {
+    for (auto const &socket : sockets) {
+      writer.socket_stats(socket.sk, 1500 * (round + 1), round + 1, round % 2, 250 + round, 0);
+      writer.socket_stats(socket.sk, 500 * (round + 1), round + 1, 0, 250 + round, 1);
+    }
+  }
+
+  if (auto const error = buffered_writer.flush()) {
+    LOG::error("failed to flush synthetic stream for host {}: {}", host, error);
+  }
+}
+
+} // namespace
+
+std::vector<std::string> make_synthetic_streams(SyntheticStreamConfig const &config)
+{
+  u32 const num_hosts = config.num_hosts;
+  u32 const processes = std::max(config.processes_per_host, 1u);
+  u32 const sockets_per_host = std::min(config.sockets_per_host, MAX_SOCKETS_PER_HOST);
+  if (sockets_per_host < config.sockets_per_host) {
+    LOG::warn("limiting synthetic sockets per host to {}", sockets_per_host);
+  }
+
+  // lay out both sides of every connection first, so each host's stream can be
+  // written in one go
+  std::vector<std::vector<Socket>> sockets(num_hosts);
+  std::vector<u64> accepted(num_hosts, 0);
+
+  for (u32 host = 0; host < num_hosts; ++host) {
+    sockets[host].reserve(2 * sockets_per_host);
+  }
+
+  for (u32 host = 0; host < num_hosts; ++host) {
+    for (u32 i = 0; i < sockets_per_host; ++i) {
+      u32 const peer = (num_hosts > 1) ? (host + 1 + i % (num_hosts - 1)) % num_hosts : host;
+      u32 const process = i % processes;
+
+      u32 const client_addr = host_addr(host);
+      u16 const client_port = CLIENT_PORT_BASE + i;
+      u32 const server_addr = host_addr(peer);
+      u16 const server_port = SERVER_PORT_BASE + i % SERVER_PORT_COUNT;
+
+      sockets[host].push_back({
+          .sk = CLIENT_SK_BASE + i,
+          .pid = CLIENT_PID_BASE + process,
+          .local_addr = client_addr,
+          .local_port = client_port,
+          .remote_addr = server_addr,
+          .remote_port = server_port,
+          .tx_rx = 1,
+      });
+
+      sockets[peer].push_back({
+          .sk = SERVER_SK_BASE + accepted[peer]++,
+          .pid = SERVER_PID_BASE + process,
+          .local_addr = server_addr,
+          .local_port = server_port,
+          .remote_addr = client_addr,
+          .remote_port = client_port,
+          .tx_rx = 0,
+      });
+    }
+  }
+
+  std::vector<std::string> streams(num_hosts);
+  for (u32 host = 0; host < num_hosts; ++host) {
+    write_host_stream(host, processes, config.stats_rounds, sockets[host], streams[host]);
+  }
+
+  return streams;
+}
+
+} // namespace reducer::bench
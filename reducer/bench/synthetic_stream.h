@@ -0,0 +1,35 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/types.h>
+
+#include <string>
+#include <vector>
+
+namespace reducer::bench {
+
+// Shape of a synthetic cluster, as seen by the reducer's ingest.
+struct SyntheticStreamConfig {
+  // Number of hosts, each with its own kernel collector connection.
+  u32 num_hosts = 0;
+  // Number of client processes on each host; every host also runs as many
+  // server processes.
+  u32 processes_per_host = 10;
+  // Number of outgoing TCP connections opened from each host. Each one is
+  // accepted by a server process on another host, so every host ends up with
+  // about twice as many sockets, and the cluster with this many flows per host.
+  u32 sockets_per_host = 100;
+  // Number of rounds of socket statistics reported for each socket.
+  u32 stats_rounds = 10;
+};
+
+// Generates one uncompressed ingest stream per host, in the format of a
+// kernel collector's recorded intake output (see
+// EBPF_NET_RECORD_INTAKE_OUTPUT_PATH). The output only depends on `config`.
+std::vector<std::string> make_synthetic_streams(SyntheticStreamConfig const &config);
+
+} // namespace reducer::bench
@@ -70,6 +70,14 @@ static constexpr char GEOIP_PATH_VAR[] = "GEOIP_PATH";
 // Time that RPC handlers wait between checks for messages in message queues.
 static constexpr auto RPC_HANDLE_TIME = 20ms;
 
+// Time that parked RPC handlers wait for a doorbell before checking message
+// queues anyway.
+static constexpr auto RPC_PARK_TIMEOUT = 1s;
+
+// Default time that RPC handlers keep checking empty message queues before
+// parking.
+static constexpr auto RPC_DEFAULT_SPIN_DURATION = 50us;
+
 // Maximum number of messages each RPC handlers handles from each queue in each call
 static constexpr auto kMaxRpcBatchPerQueue = 10 * 1000;
 
@@ -4,9 +4,11 @@
 #include "core.h"
 
 #include <reducer/constants.h>
+#include <reducer/thread_placement.h>
 #include <reducer/util/thread_ops.h>
 
 #include <platform/userspace-time.h>
+#include <util/doorbell.h>
 #include <util/log_formatters.h>
 #include <util/time.h>
 #include <util/uv_helpers.h>
@@ -17,6 +19,19 @@ namespace reducer {
 
 thread_local Core *Core::instance_ = nullptr;
 
+bool Core::rpc_notify_enabled_ = true;
+std::chrono::microseconds Core::rpc_spin_duration_ = RPC_DEFAULT_SPIN_DURATION;
+
+void Core::set_rpc_notify_enabled(bool enabled)
+{
+  rpc_notify_enabled_ = enabled;
+}
+
+void Core::set_rpc_spin_duration(std::chrono::microseconds duration)
+{
+  rpc_spin_duration_ = duration;
+}
+
 Core::Core(std::string_view app_name, size_t shard_num, u64 initial_timestamp)
     : app_name_(app_name), shard_num_(shard_num), current_timestamp_(initial_timestamp)
 {
@@ -34,6 +49,18 @@ Core::Core(std::string_view app_name, size_t shard_num, u64 initial_timestamp)
 
 Core::~Core() {}
 
+void Core::add_rpc_doorbell(Doorbell &doorbell)
+{
+  if (!rpc_notify_enabled_) {
+    return;
+  }
+
+  auto &rpc_doorbell = rpc_doorbells_.emplace_back(std::make_unique<RpcDoorbell>(*this, doorbell));
+
+  CHECK_UV(uv_poll_init(&loop_, &rpc_doorbell->poll, doorbell.fd()));
+  rpc_doorbell->poll.data = rpc_doorbell.get();
+}
+
 void Core::set_connection_authenticated()
 {
   for (auto &rpc_client : rpc_clients_) {
@@ -69,11 +96,17 @@ void Core::run()
     LOG::warn("unable to set name for {} core thread {}: {}", app_name_, shard_num_, error);
   });
 
+  ThreadPlacement::place_current_thread(app_name_, shard_num_);
+
   if (!rpc_clients_.empty()) {
     auto repeat = integer_time<std::chrono::milliseconds>(RPC_HANDLE_TIME);
     CHECK_UV(uv_timer_start(&rpc_timer_, on_rpc_timer, repeat, repeat));
   }
 
+  for (auto &rpc_doorbell : rpc_doorbells_) {
+    CHECK_UV(uv_poll_start(&rpc_doorbell->poll, UV_READABLE, on_rpc_doorbell));
+  }
+
   {
     auto repeat = integer_time<std::chrono::milliseconds>(STATS_PERIOD);
     CHECK_UV(uv_timer_start(&stats_timer_, on_stats_timer, repeat, repeat));
@@ -112,13 +145,116 @@ void Core::on_rpc_timer(uv_timer_t *timer)
 {
   auto core = reinterpret_cast<Core *>(timer->data);
 
+  if (core->rpc_parked_) {
+    // woken up by the safety-net timeout rather than by a doorbell
+    core->rpc_parked_ = false;
+    for (auto &rpc_doorbell : core->rpc_doorbells_) {
+      rpc_doorbell->doorbell.unpark();
+    }
+  }
+
   bool any_handled = core->handle_rpc();
 
+  core->schedule_rpc(any_handled);
+}
+
+void Core::on_rpc_doorbell(uv_poll_t *poll, int status, int events)
+{
+  auto &rpc_doorbell = *reinterpret_cast<RpcDoorbell *>(poll->data);
+  auto &core = rpc_doorbell.core;
+
+  if (status < 0) {
+    LOG::error("{}-{}: error waiting on RPC doorbell: {}", core.app_name(), core.shard_num(), uv_error_t(status));
+    return;
+  }
+
+  rpc_doorbell.doorbell.drain();
+
+  if (!core.rpc_parked_) {
+    // a late notification, e.g. from a doorbell rung after another one had
+    // already woken this core up
+    return;
+  }
+
+  core.rpc_parked_ = false;
+  core.rpc_idle_since_ = 0;
+  ++core.rpc_wait_stats_.wakeups;
+
+  for (auto &other : core.rpc_doorbells_) {
+    other->doorbell.unpark();
+  }
+
+  uv_timer_start(&core.rpc_timer_, on_rpc_timer, 0, core.rpc_timer_.repeat);
+}
+
+void Core::schedule_rpc(bool any_handled)
+{
   if (any_handled) {
+    rpc_idle_since_ = 0;
+
     // restart the timer immediately
     // otherwise the timer will again fire after the normal repeat time
-    uv_timer_start(timer, timer->timer_cb, 0, timer->repeat);
+    uv_timer_start(&rpc_timer_, on_rpc_timer, 0, rpc_timer_.repeat);
+    return;
+  }
+
+  if (rpc_doorbells_.empty()) {
+    // no doorbells, rely on the timer's normal repeat time
+    return;
   }
+
+  u64 const time_now = monotonic();
+  if (rpc_idle_since_ == 0) {
+    rpc_idle_since_ = time_now;
+  }
+
+  if (time_now - rpc_idle_since_ < (u64)integer_time<std::chrono::nanoseconds>(rpc_spin_duration_)) {
+    // keep spinning, but let the event loop handle other events in between
+    ++rpc_wait_stats_.spins;
+    uv_timer_start(&rpc_timer_, on_rpc_timer, 0, rpc_timer_.repeat);
+    return;
+  }
+
+  for (auto &rpc_doorbell : rpc_doorbells_) {
+    rpc_doorbell->doorbell.park();
+  }
+
+  // messages could have been published before the doorbells were flagged
+  if (has_pending_rpc()) {
+    for (auto &rpc_doorbell : rpc_doorbells_) {
+      rpc_doorbell->doorbell.unpark();
+    }
+
+    ++rpc_wait_stats_.spins;
+    uv_timer_start(&rpc_timer_, on_rpc_timer, 0, rpc_timer_.repeat);
+    return;
+  }
+
+  rpc_parked_ = true;
+  ++rpc_wait_stats_.parks;
+
+  // the doorbells will restart the timer; until then only check the queues
+  // once in a long while, as a safety net
+  auto timeout = integer_time<std::chrono::milliseconds>(RPC_PARK_TIMEOUT);
+  uv_timer_start(&rpc_timer_, on_rpc_timer, timeout, rpc_timer_.repeat);
+}
+
+bool Core::has_pending_rpc()
+{
+  for (size_t i = 0; i < rpc_clients_.size(); ++i) {
+    if (!virtual_clock_.can_update(i)) {
+      // can't make progress on this client until the others catch up
+      continue;
+    }
+
+    auto &queue = rpc_clients_[i].queue;
+    queue.start_read_batch();
+    if (queue.peek() > 0) {
+      return true;
+    }
+  }
+
+  return false;
 }
 
 void Core::on_stats_timer(uv_timer_t *timer)
@@ -222,6 +358,8 @@ void Core::write_internal_stats() {}
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Core::RpcDoorbell::RpcDoorbell(Core &_core, Doorbell &_doorbell) : core(_core), doorbell(_doorbell) {}
+
 Core::RpcClient::RpcClient(ElementQueue _queue, std::unique_ptr<IRpcHandler> _handler, ClientType _client_type)
     : queue(std::move(_queue)), handler(std::move(_handler)), client_type(_client_type)
 {}
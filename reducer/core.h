@@ -15,12 +15,16 @@
 #include <absl/synchronization/notification.h>
 #include <uv.h>
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+class Doorbell;
+
 namespace reducer {
 
 // Base class for core implementations.
@@ -29,6 +33,32 @@ class Core {
 public:
   static constexpr auto STATS_PERIOD = 10s;
 
+  // Counters describing how this core waits for incoming RPC messages.
+  // Updated by the core's own thread, can be read from any thread.
+  struct RpcWaitStats {
+    // Number of times the core was woken up by a sender after parking.
+    std::atomic<u64> wakeups{0};
+    // Number of polls of the RPC queues that found nothing to handle while
+    // the core was still spinning.
+    std::atomic<u64> spins{0};
+    // Number of times the core parked itself waiting for a doorbell.
+    std::atomic<u64> parks{0};
+  };
+
+  // Enables waiting on RPC queue doorbells instead of periodically polling the
+  // RPC queues.
+  // NOTE: must be called on startup, before any cores are created.
+  static void set_rpc_notify_enabled(bool enabled);
+  // Returns whether waiting on RPC queue doorbells is enabled.
+  static bool rpc_notify_enabled() { return rpc_notify_enabled_; }
+
+  // Sets for how long a core keeps polling its RPC queues after finding them
+  // empty, before parking itself until a sender rings the doorbell.
+  // NOTE: must be called on startup, before any cores are created.
+  static void set_rpc_spin_duration(std::chrono::microseconds duration);
+  // Returns the RPC queue spin duration.
+  static std::chrono::microseconds rpc_spin_duration() { return rpc_spin_duration_; }
+
   virtual ~Core();
 
   // Runs the core's execution loop.
@@ -56,6 +86,9 @@ public:
   // Returns the current metrics timestamp, for output to a TSDB.
   std::chrono::nanoseconds metrics_timestamp() const;
 
+  // Returns counters describing how this core waits for RPC messages.
+  RpcWaitStats const &rpc_wait_stats() const { return rpc_wait_stats_; }
+
 protected:
   // Subclasses implement to use concrete render-generated classes.
   //
@@ -87,13 +120,35 @@ protected:
   // The virtual clock driven by messages from RPC clients.
   VirtualClock virtual_clock_;
 
+  // How this core has been waiting for RPC messages.
+  RpcWaitStats rpc_wait_stats_;
+
   Core(std::string_view app_name, size_t shard_num, u64 initial_timestamp);
 
+  // Registers a doorbell that gets rung by senders of (some of) the RPC
+  // clients. Cores that have registered doorbells park themselves when idle,
+  // instead of periodically polling the RPC queues.
+  void add_rpc_doorbell(Doorbell &doorbell);
+
 private:
+  // Doorbell registered with this core's event loop.
+  struct RpcDoorbell {
+    RpcDoorbell(Core &core, Doorbell &doorbell);
+
+    Core &core;
+    Doorbell &doorbell;
+    uv_poll_t poll;
+  };
+
   // Core instance belonging to the current thread.
   // Assigned in run().
   static thread_local Core *instance_;
 
+  // Whether waiting on RPC queue doorbells is enabled.
+  static bool rpc_notify_enabled_;
+  // For how long to keep polling RPC queues before parking.
+  static std::chrono::microseconds rpc_spin_duration_;
+
   // This core's application name.
   std::string app_name_;
   // This core's shard number.
@@ -115,6 +170,13 @@ private:
 
   // Timer that services reading RPC messages from the queue.
   uv_timer_t rpc_timer_;
+  // Doorbells rung by RPC senders.
+  std::vector<std::unique_ptr<RpcDoorbell>> rpc_doorbells_;
+  // Monotonic time at which the RPC queues were first found idle, or 0 if
+  // messages were handled in the last poll.
+  u64 rpc_idle_since_{0};
+  // Whether this core is parked waiting on its doorbells.
+  bool rpc_parked_{false};
   // Timer that services writing internal stats to prometheus.
   uv_timer_t stats_timer_;
 
@@ -122,6 +184,8 @@ private:
   static void on_stop_async(uv_async_t *handle);
   // RPC timer callback.
   static void on_rpc_timer(uv_timer_t *timer);
+  // Doorbell callback.
+  static void on_rpc_doorbell(uv_poll_t *poll, int status, int events);
   // Internal stats timer callback.
   static void on_stats_timer(uv_timer_t *timer);
 
@@ -131,6 +195,14 @@ private:
   // Gets invoked periodically by the RPC timer.
   bool handle_rpc();
 
+  // Returns whether any RPC client has a message that can be handled now.
+  bool has_pending_rpc();
+
+  // Decides when the RPC queues will be polled next: immediately, if the
+  // last poll handled messages or the core is still within its spin budget;
+  // otherwise the core parks itself until a doorbell is rung.
+  void schedule_rpc(bool any_handled);
+
   // Called when the current timeslot is complete.
   virtual void on_timeslot_complete();
 
@@ -8,6 +8,7 @@
 #include "core.h"
 
 #include <reducer/publisher.h>
+#include <reducer/rpc_queue_matrix.h>
 #include <reducer/rpc_stats.h>
 #include <reducer/util/index_dumper.h>
 
@@ -70,6 +71,14 @@ protected:
       : Core(app_name, shard_num, initial_timestamp), transform_builder_(), index_(std::forward<Args>(args)...)
   {}
 
+  // Adds an RPC client for each sender in `queues`, reading from this core's
+  // queues and waiting on this core's doorbell.
+  void add_rpc_clients(RpcQueueMatrix &queues, ClientType client_type, RpcReceiverStats &receiver_stats)
+  {
+    add_rpc_clients(queues.make_readers(shard_num()), client_type, receiver_stats);
+    add_rpc_doorbell(queues.doorbell(shard_num()));
+  }
+
   void add_rpc_clients(std::vector<ElementQueue> const &queues, ClientType client_type, RpcReceiverStats &receiver_stats)
   {
     for (auto &queue : queues) {
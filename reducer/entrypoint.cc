@@ -109,6 +109,9 @@ static reducer::ReducerConfig from_ffi(reducer_cfg::ReducerConfig const &in)
   out.otlp_grpc_metrics_address = std::string(in.otlp_grpc_metrics_address);
   out.otlp_grpc_metrics_port = in.otlp_grpc_metrics_port;
   out.otlp_grpc_batch_size = in.otlp_grpc_batch_size;
+  out.otlp_grpc_max_in_flight_requests = in.otlp_grpc_max_in_flight_requests;
+  out.otlp_grpc_max_queued_bytes = in.otlp_grpc_max_queued_bytes;
+  out.otlp_grpc_overflow_policy = std::string(in.otlp_grpc_overflow_policy);
   out.enable_otlp_grpc_metric_descriptions = in.enable_otlp_grpc_metric_descriptions;
 
   out.disable_prometheus_metrics = in.disable_prometheus_metrics;
@@ -144,6 +147,15 @@ static reducer::ReducerConfig from_ffi(reducer_cfg::ReducerConfig const &in)
 
   out.index_dump_interval = in.index_dump_interval;
 
+  out.disable_rpc_notify = in.disable_rpc_notify;
+  out.rpc_spin_us = in.rpc_spin_us;
+
+  out.ingest_max_connection_rate = in.ingest_max_connection_rate;
+  out.ingest_max_byte_rate = in.ingest_max_byte_rate;
+  out.thread_placement = std::string(in.thread_placement);
+
+  out.span_pool_capacity = std::string(in.span_pool_capacity);
+
   return out;
 }
 
@@ -4,6 +4,7 @@
 #include <reducer/ingest/agent_span.h>
 #include <reducer/ingest/component.h>
 #include <reducer/ingest/shared_state.h>
+#include <reducer/ingest/tcp_server.h>
 
 #include <reducer/constants.h>
 #include <reducer/internal_metrics_encoder.h>
@@ -28,6 +29,7 @@
 
 #include <config.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <iostream>
@@ -89,6 +91,10 @@ void AgentSpan::socket_steady_state(
     ::ebpf_net::ingest::weak_refs::agent span_ref, u64 timestamp, jsrv_ingest__socket_steady_state *msg)
 {
   LOG::debug("--------SOCKET STEADY STATE---------");
+
+  if (auto *const server = TcpServer::singleton()->instance; server && !is_socket_steady_state_) {
+    server->on_socket_steady_state(std::chrono::nanoseconds(monotonic() - created_ns_));
+  }
   is_socket_steady_state_ = true;
 }
 
@@ -793,6 +799,33 @@ void AgentSpan::bpf_log(::ebpf_net::ingest::weak_refs::agent span_ref, u64 times
   });
 }
 
+void AgentSpan::perf_poll_stats(
+    ::ebpf_net::ingest::weak_refs::agent span_ref, u64 timestamp, jsrv_ingest__perf_poll_stats *msg)
+{
+  auto &totals = perf_poll_totals_ ? *perf_poll_totals_ : perf_poll_totals_.emplace();
+
+  totals.fill_0_25 += msg->fill_0_25;
+  totals.fill_25_50 += msg->fill_25_50;
+  totals.fill_50_75 += msg->fill_50_75;
+  totals.fill_75_100 += msg->fill_75_100;
+  totals.timer_polls += msg->timer_polls;
+  totals.event_wakeups += msg->event_wakeups;
+  totals.early_polls += msg->early_polls;
+  totals.interval_ms = msg->interval_ms;
+}
+
+void AgentSpan::socket_resync_stats(
+    ::ebpf_net::ingest::weak_refs::agent span_ref, u64 timestamp, jsrv_ingest__socket_resync_stats *msg)
+{
+  auto &totals = socket_resync_totals_ ? *socket_resync_totals_ : socket_resync_totals_.emplace();
+
+  ++totals.count;
+  totals.sum_ns += msg->duration_ns;
+  totals.max_ns = std::max(totals.max_ns, msg->duration_ns);
+  totals.closed_sockets += msg->closed_sockets;
+  totals.rewalked_sockets += msg->rewalked_sockets;
+}
+
 void AgentSpan::write_internal_stats(
     ::ebpf_net::ingest::weak_refs::ingest_core_stats ingest_core_stats, u64 time_ns, int shard, std::string_view module)
 {
@@ -843,6 +876,60 @@ void AgentSpan::write_internal_stats(
   }
 
   bpf_logs_.clear();
+
+  if (perf_poll_totals_) {
+    ingest_core_stats.perf_poll_stats(
+        jb_blob(module),
+        shard,
+        jb_blob(version_as_string),
+        jb_blob(std::to_string(integer_value(cloud_platform()))),
+        jb_blob(cluster()),
+        jb_blob(role()),
+        jb_blob(node_az()),
+        jb_blob(node_id()),
+        jb_blob(kernel_version()),
+        integer_value(client_type()),
+        jb_blob(hostname()),
+        jb_blob(os()),
+        jb_blob(os_version()),
+        time_ns,
+        perf_poll_totals_->fill_0_25,
+        perf_poll_totals_->fill_25_50,
+        perf_poll_totals_->fill_50_75,
+        perf_poll_totals_->fill_75_100,
+        perf_poll_totals_->timer_polls,
+        perf_poll_totals_->event_wakeups,
+        perf_poll_totals_->early_polls,
+        perf_poll_totals_->interval_ms);
+
+    // keep reporting the interval until the collector sends a new one
+    perf_poll_totals_ = perf_poll_totals{.interval_ms = perf_poll_totals_->interval_ms};
+  }
+
+  if (socket_resync_totals_) {
+    ingest_core_stats.socket_resync_stats(
+        jb_blob(module),
+        shard,
+        jb_blob(version_as_string),
+        jb_blob(std::to_string(integer_value(cloud_platform()))),
+        jb_blob(cluster()),
+        jb_blob(role()),
+        jb_blob(node_az()),
+        jb_blob(node_id()),
+        jb_blob(kernel_version()),
+        integer_value(client_type()),
+        jb_blob(hostname()),
+        jb_blob(os()),
+        jb_blob(os_version()),
+        time_ns,
+        socket_resync_totals_->count,
+        socket_resync_totals_->sum_ns,
+        socket_resync_totals_->max_ns,
+        socket_resync_totals_->closed_sockets,
+        socket_resync_totals_->rewalked_sockets);
+
+    socket_resync_totals_.reset();
+  }
 }
 
 thread_local BlobCollector AgentSpan::blob_collector_;
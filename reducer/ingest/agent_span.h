@@ -29,6 +29,7 @@
 
 #include <chrono>
 #include <map>
+#include <optional>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -126,6 +127,9 @@ public:
 
   void log_message(::ebpf_net::ingest::weak_refs::agent span_ref, u64 timestamp, jsrv_ingest__log_message *msg);
   void bpf_log(::ebpf_net::ingest::weak_refs::agent span_ref, u64 timestamp, jsrv_ingest__bpf_log *msg);
+  void perf_poll_stats(::ebpf_net::ingest::weak_refs::agent span_ref, u64 timestamp, jsrv_ingest__perf_poll_stats *msg);
+  void socket_resync_stats(
+      ::ebpf_net::ingest::weak_refs::agent span_ref, u64 timestamp, jsrv_ingest__socket_resync_stats *msg);
 
   u64 agent_id() const { return agent_id_; }
 
@@ -231,6 +235,8 @@ private:
   dns_cache_type ip_to_domain_;
 
   bool is_socket_steady_state_ = false;
+  // When the span was created, i.e. when the collector's connection was set up.
+  u64 const created_ns_ = monotonic();
 
   ::collector::CollectorStatus status_ = ::collector::CollectorStatus::unknown;
   std::uint16_t status_detail_ = 0;
@@ -268,6 +274,31 @@ private:
 
   std::vector<bpf_log_entry> bpf_logs_;
 
+  /* perf ring polling statistics received since the last internal stats report */
+  struct perf_poll_totals {
+    u64 fill_0_25 = 0;
+    u64 fill_25_50 = 0;
+    u64 fill_50_75 = 0;
+    u64 fill_75_100 = 0;
+    u64 timer_polls = 0;
+    u64 event_wakeups = 0;
+    u64 early_polls = 0;
+    u32 interval_ms = 0; /* the latest one */
+  };
+
+  std::optional<perf_poll_totals> perf_poll_totals_;
+
+  /* socket resyncs received since the last internal stats report */
+  struct socket_resync_totals {
+    u64 count = 0;
+    u64 sum_ns = 0;
+    u64 max_ns = 0;
+    u64 closed_sockets = 0;
+    u64 rewalked_sockets = 0;
+  };
+
+  std::optional<socket_resync_totals> socket_resync_totals_;
+
   static thread_local BlobCollector blob_collector_;
 };
 
@@ -35,8 +35,16 @@ constexpr auto NO_MESSAGE_TIMEOUT = 30s;
 constexpr auto MESSAGE_TIMEOUT_CHECK_INTERVAL = 45s;
 constexpr auto WRITE_INTERNAL_STATS_TIMER_REPEAT = 10s;
 constexpr auto PULSE_TIMER_REPEAT = 1s;
+constexpr auto REBALANCE_INTERVAL = 10s;
 } // namespace
 
+AdmissionControl::Config IngestCore::admission_config_;
+
+void IngestCore::set_admission_limits(double connection_rate, double byte_rate)
+{
+  admission_config_ = {.connection_rate = connection_rate, .byte_rate = byte_rate};
+}
+
 void IngestCore::on_write_internal_stats_timer_cb(uv_timer_t *timer)
 {
   auto const core = reinterpret_cast<IngestCore *>(timer->data);
@@ -81,7 +89,7 @@ IngestCore::IngestCore(
   for (uint32_t shard = 0; shard < ingest_shard_count; ++shard) {
     workers.push_back(std::make_unique<IngestWorker>(ingest_to_logging_queues, ingest_to_matching_queues, shard));
   }
-  tcp_server_.reset(new TcpServer(loop_, telemetry_port, localhost, std::move(workers)));
+  tcp_server_.reset(new TcpServer(loop_, telemetry_port, localhost, std::move(workers), admission_config_));
   index_dumper_.resize(ingest_shard_count);
   TcpServer::singleton()->instance = tcp_server_.get();
 
@@ -117,6 +125,12 @@ IngestCore::IngestCore(
     return scheduling::JobFollowUp::ok;
   });
   connection_timeout_handler_->start(MESSAGE_TIMEOUT_CHECK_INTERVAL);
+
+  rebalance_handler_.emplace(loop_, [this] {
+    rebalance_connections();
+    return scheduling::JobFollowUp::ok;
+  });
+  rebalance_handler_->start(REBALANCE_INTERVAL);
 }
 
 IngestCore::~IngestCore()
@@ -162,6 +176,7 @@ void IngestCore::on_write_internal_stats_timer()
   u64 time_ns = fp_get_time_ns();
   std::string_view module = "ingest";
   TcpServer::Stats server_stats = tcp_server_->get_stats();
+  std::vector<TcpServer::WorkerLoad> const worker_loads = tcp_server_->worker_loads();
 
   /* write span statistics */
   tcp_server_->visit_indexes(
@@ -181,8 +196,27 @@ void IngestCore::on_write_internal_stats_timer()
         if (shard == 0) {
           local_ingest_core_stats_handle().server_stats(
               jb_blob(module), server_stats.connection_counter, server_stats.disconnect_counter, time_ns);
+          local_ingest_core_stats_handle().admission_stats(
+              jb_blob(module),
+              server_stats.deferred_counter,
+              server_stats.paced_counter,
+              server_stats.steady_state_counter,
+              server_stats.steady_state_sum_ns,
+              server_stats.steady_state_max_ns,
+              time_ns);
         }
 
+        auto const &worker_load = worker_loads[shard];
+        local_ingest_core_stats_handle().ingest_worker_stats(
+            jb_blob(module),
+            shard,
+            worker_load.connections,
+            worker_load.messages,
+            worker_load.bytes,
+            worker_load.busy_ns,
+            worker_load.interval_ns,
+            time_ns);
+
         index_dumper_[shard].dump(
             "ingest", shard, *index, std::chrono::duration_cast<std::chrono::seconds>(std::chrono::nanoseconds{time_ns}));
       },
@@ -378,4 +412,9 @@ void IngestCore::check_connection_timeouts()
   );
 }
 
+void IngestCore::rebalance_connections()
+{
+  tcp_server_->rebalance();
+}
+
 } // namespace reducer::ingest
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <reducer/admission_control.h>
 #include <reducer/publisher.h>
 #include <reducer/tsdb_format.h>
 
@@ -59,6 +60,13 @@ public:
   void stop_sync();
   void wait_for_shutdown();
 
+  // Limits the rate of new collector connections and of bytes received from
+  // collectors. Beyond these, new connections are closed for collectors to
+  // retry later, or asked to pace the initial dump of their state. Zero means
+  // no limit.
+  // NOTE: must be called on startup, before the core is created.
+  static void set_admission_limits(double connection_rate, double byte_rate);
+
 private:
   /* Callback function for stop_async. */
   static void on_stop_async(uv_async_t *handle);
@@ -83,6 +91,11 @@ private:
    */
   void check_connection_timeouts();
 
+  /**
+   * Measures the load on ingest workers, which new connections are assigned by.
+   */
+  void rebalance_connections();
+
   // Libuv loop object.
   uv_loop_t loop_;
 
@@ -98,6 +111,9 @@ private:
   uv_timer_t write_internal_stats_timer_;
   uv_timer_t pulse_timer_;
   std::optional<scheduling::IntervalScheduler> connection_timeout_handler_;
+  std::optional<scheduling::IntervalScheduler> rebalance_handler_;
+
+  static AdmissionControl::Config admission_config_;
 
   friend void __on_signal_cb(uv_signal_t *, int);
 };
@@ -12,10 +12,14 @@
 #include <generated/ebpf_net/ingest/modifiers.h>
 
 #include <channel/callbacks.h>
+#include <channel/tcp_channel.h>
+#include <collector/server_command.h>
 
 #include <platform/userspace-time.h>
 
 #include <util/boot_time.h>
+#include <util/compression_dictionary.h>
+#include <util/defer.h>
 #include <util/error_handling.h>
 #include <util/log.h>
 
@@ -23,6 +27,7 @@
 
 #include <uv.h>
 
+#include <endian.h>
 #include <memory>
 #include <optional>
 
@@ -46,6 +51,27 @@ void IngestWorker::register_close_callback(OnCloseCallback on_close_cb)
   on_close_cb_ = std::move(on_close_cb);
 }
 
+void IngestWorker::assign_connection(const uv_tcp_t &tcp_conn, bool pace_initial_dump)
+{
+  num_connections_.fetch_add(1, std::memory_order_relaxed);
+  {
+    // the worker's thread opens assigned connections in order, see create_callbacks()
+    absl::MutexLock l(&pending_pace_mu_);
+    pending_pace_.push_back(pace_initial_dump);
+  }
+  assign(tcp_conn);
+}
+
+IngestWorker::Load IngestWorker::load() const
+{
+  return {
+      .connections = num_connections_.load(std::memory_order_relaxed),
+      .messages = messages_handled_.load(std::memory_order_relaxed),
+      .bytes = bytes_handled_.load(std::memory_order_relaxed),
+      .busy_ns = busy_ns_.load(std::memory_order_relaxed),
+  };
+}
+
 std::shared_ptr<absl::Notification> IngestWorker::visit_index(IndexCb cb)
 {
   return visit_thread([this, captured_cb = std::move(cb)] { captured_cb(index_.get()); });
@@ -94,11 +120,20 @@ void IngestWorker::on_thread_stop()
 
 std::unique_ptr<::channel::Callbacks> IngestWorker::create_callbacks(uv_loop_t &loop, ::channel::TCPChannel *const tcp_channel)
 {
-  return std::make_unique<IngestWorker::Callbacks>(this, tcp_channel);
+  bool pace_initial_dump = false;
+  {
+    absl::MutexLock l(&pending_pace_mu_);
+    if (!pending_pace_.empty()) {
+      pace_initial_dump = pending_pace_.front();
+      pending_pace_.pop_front();
+    }
+  }
+
+  return std::make_unique<IngestWorker::Callbacks>(this, tcp_channel, pace_initial_dump);
 }
 
-IngestWorker::Callbacks::Callbacks(IngestWorker *worker, channel::TCPChannel *channel)
-    : worker_(worker), channel_(channel), decompressor_(Worker::kBufferSize)
+IngestWorker::Callbacks::Callbacks(IngestWorker *worker, channel::TCPChannel *channel, bool pace_initial_dump)
+    : worker_(worker), channel_(channel), decompressor_(Worker::kBufferSize), pace_initial_dump_(pace_initial_dump)
 {
   assert(local_index() == worker_->index_.get());
 
@@ -107,10 +142,19 @@ IngestWorker::Callbacks::Callbacks(IngestWorker *worker, channel::TCPChannel *ch
   last_message_seen_ = std::chrono::nanoseconds(fp_get_time_ns());
 }
 
-IngestWorker::Callbacks::~Callbacks() {}
+IngestWorker::Callbacks::~Callbacks()
+{
+  worker_->num_connections_.fetch_sub(1, std::memory_order_relaxed);
+}
 
 uint32_t IngestWorker::Callbacks::received_data(const u8 *data, int data_len)
 {
+  u64 const start = monotonic();
+  DEFER([this, start] {
+    u64 const elapsed = monotonic() - start;
+    worker_->busy_ns_.fetch_add(elapsed, std::memory_order_relaxed);
+  });
+
   const u8 *begin = data;
   const u8 *const end = data + data_len;
   u16 count = 0;
@@ -145,25 +189,42 @@ uint32_t IngestWorker::Callbacks::received_data(const u8 *data, int data_len)
   //    used is being negotiated).
   // 2) This is a subsequent data message, and it is compressed.
   size_t consumed_len = 0;
+  bool output_held_back = false;
   do {
-    const size_t res = decompressor_.process(begin, end - begin, &consumed_len);
+    // Collectors that accept the dictionary compression offered on connection
+    // (see ServerCommand::COMPRESSION_DICTIONARY) switch to it between two LZ4
+    // frames.
+    if (!zstd_decompressor_ && decompressor_.at_frame_boundary() && decompressor_.output_buf_size() == 0) {
+      if (end - begin < static_cast<ptrdiff_t>(ZstdDecompressor::MAGIC_SIZE)) {
+        // Not enough data received to tell.
+        break;
+      }
+
+      if (ZstdDecompressor::is_frame_start(begin)) {
+        zstd_decompressor_ = std::make_unique<ZstdDecompressor>(Worker::kBufferSize);
+      }
+    }
+
+    Decompressor &decompressor = zstd_decompressor_ ? static_cast<Decompressor &>(*zstd_decompressor_) : decompressor_;
+    const size_t res = decompressor.process(begin, end - begin, &consumed_len);
 
     // Check if decompression failed.
     if (res != 0) {
       local_logger().ingest_decompression_error(
           static_cast<u8>(connection_->client_type()),
           jb_blob(connection_->client_hostname()),
-          jb_blob(std::string_view(LZ4F_getErrorName(res))));
+          jb_blob(decompressor.error_name(res)));
       channel_->close_permanently();
       return 0;
     }
 
     // Process the decompressed data.
     begin += consumed_len;
+    bool const output_full = (decompressor.output_buf_size() == Worker::kBufferSize);
 
     ASSUME(decompressor_active_);
     const std::optional<uint32_t> consumed_uncompressed =
-        received_data_internal(decompressor_.output_buf(), decompressor_.output_buf_size());
+        received_data_internal(decompressor.output_buf(), decompressor.output_buf_size());
 
     // An error occurred, close.
     if (!consumed_uncompressed) {
@@ -172,8 +233,9 @@ uint32_t IngestWorker::Callbacks::received_data(const u8 *data, int data_len)
     }
 
     // Remove the handled bytes from decompression buffer.
-    decompressor_.discard(*consumed_uncompressed);
+    decompressor.discard(*consumed_uncompressed);
     ++count;
+    output_held_back = output_full && (*consumed_uncompressed > 0);
 
     // * if we weren't able to decompress any bytes, can exit -- another
     //   iteration will not make progress.
@@ -183,13 +245,17 @@ uint32_t IngestWorker::Callbacks::received_data(const u8 *data, int data_len)
     //   processed bytes or not, another call to the decompressor might make
     //   more bytes available, so if there are more compressed bytes, we should
     //   make another iteration.
-  } while ((consumed_len > 0) && (begin < end));
+    // * if the output buffer was full, the decompressor may be holding back
+    //   data decompressed from bytes already consumed: once handled bytes made
+    //   room for it, another call returns it even without more input.
+  } while (((consumed_len > 0) && (begin < end)) || output_held_back);
 
   worker_->ingest_to_logging_stats_.check_utilization();
   worker_->ingest_to_matching_stats_.check_utilization();
   worker_->invoke_visitors();
 
-  return end - data;
+  // Compressed bytes left over are kept by the channel until more data comes.
+  return begin - data;
 }
 
 std::optional<uint32_t> IngestWorker::Callbacks::received_data_internal(const u8 *const data, const int data_len)
@@ -200,9 +266,16 @@ std::optional<uint32_t> IngestWorker::Callbacks::received_data_internal(const u8
 
   try {
     set_local_connection(ft_conn);
+
+    u64 const messages_before = ft_conn->messages_handled();
+    u64 const bytes_before = ft_conn->bytes_handled();
+
     const int res = first_message_seen_ ? ft_conn->handle_multiple((const char *)data, data_len)
                                         : ft_conn->handle((const char *)data, data_len);
 
+    worker_->messages_handled_.fetch_add(ft_conn->messages_handled() - messages_before, std::memory_order_relaxed);
+    worker_->bytes_handled_.fetch_add(ft_conn->bytes_handled() - bytes_before, std::memory_order_relaxed);
+
     // Check if the received data buffer is too small for the message type.
     // (but do not close).
     if (res == -EAGAIN) {
@@ -224,6 +297,16 @@ std::optional<uint32_t> IngestWorker::Callbacks::received_data_internal(const u8
       first_message_seen_ = true;
     }
 
+    if (ft_conn->client_type() == ClientType::kernel) {
+      if (pace_initial_dump_) {
+        pace_initial_dump_ = false;
+        send_server_command(static_cast<u64>(ServerCommand::PACE_INITIAL_DUMP));
+      }
+      if (!compression_offered_) {
+        offer_dictionary_compression();
+      }
+    }
+
     return res;
   } catch (const std::exception &e) {
     // Catch any thrown errors.
@@ -233,6 +316,21 @@ std::optional<uint32_t> IngestWorker::Callbacks::received_data_internal(const u8
   }
 }
 
+void IngestWorker::Callbacks::offer_dictionary_compression()
+{
+  compression_offered_ = true;
+  send_server_command(server_command(ServerCommand::COMPRESSION_DICTIONARY, compression_dictionary_id()));
+}
+
+void IngestWorker::Callbacks::send_server_command(u64 command)
+{
+  // commands are 8 bytes, most significant byte first
+  u64 const value = htobe64(command);
+  if (auto const error = channel_->send(reinterpret_cast<u8 const *>(&value), sizeof(value))) {
+    LOG::debug("could not send server command {:#x} to '{}': {}", command, connection_->client_hostname(), error.message());
+  }
+}
+
 void IngestWorker::Callbacks::on_error(const int err)
 {
   const ClientType client_type = connection_->client_type();
@@ -18,10 +18,16 @@
 
 #include <util/log.h>
 #include <util/lz4_decompressor.h>
+#include <util/zstd_decompressor.h>
 
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
 #include <absl/time/time.h>
 #include <uv.h>
 
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <memory>
 #include <optional>
 
@@ -38,6 +44,18 @@ class IngestWorker : public Worker {
 public:
   using OnCloseCallback = std::function<void()>;
 
+  // Load handled by a worker since it was started.
+  struct Load {
+    // Number of connections assigned to the worker and not yet closed.
+    u32 connections = 0;
+    // Number of messages handled.
+    u64 messages = 0;
+    // Number of (uncompressed) bytes handled.
+    u64 bytes = 0;
+    // Time spent handling received data, in nanoseconds.
+    u64 busy_ns = 0;
+  };
+
   // Arguments:
   // - index - The ingest index that will be owned by this class.
   // Calling this constructor will set the `local_index()` value.
@@ -49,13 +67,23 @@ public:
   // been called.
   void register_close_callback(OnCloseCallback on_close_cb);
 
+  // Hands off a newly accepted connection to this worker, and counts it in
+  // `load().connections` right away, before the worker's thread opens it.
+  // With `pace_initial_dump`, the connection is sent
+  // ServerCommand::PACE_INITIAL_DUMP once it identifies as a kernel collector.
+  void assign_connection(const uv_tcp_t &tcp_conn, bool pace_initial_dump = false);
+
+  // Returns the load handled by this worker so far. Can be called from any
+  // thread.
+  Load load() const;
+
   // The set of callbacks invoked when data arrives over a TCP connection.
   // There will be an instance of this class for every established connection.
   // When `received_data` is invoked, `local_connection` will be overwritten by
   // the NpmConnection instance owned by this class.
   class Callbacks : public ::channel::Callbacks {
   public:
-    Callbacks(IngestWorker *worker, channel::TCPChannel *tcp_channel);
+    Callbacks(IngestWorker *worker, channel::TCPChannel *tcp_channel, bool pace_initial_dump);
     ~Callbacks() override;
 
     uint32_t received_data(const u8 *data, int data_len) override;
@@ -70,14 +98,29 @@ public:
     // the connection to close).
     std::optional<uint32_t> received_data_internal(const u8 *data, int data_len);
 
+    // Offers the collector to compress the rest of the connection with the
+    // ingest compression dictionary (see ServerCommand::COMPRESSION_DICTIONARY).
+    void offer_dictionary_compression();
+
+    // Sends `command` (see collector/server_command.h) to the collector.
+    void send_server_command(u64 command);
+
     IngestWorker *worker_;
     channel::TCPChannel *channel_;
     Lz4Decompressor decompressor_;
+    // Created when the collector switches to dictionary compression.
+    std::unique_ptr<ZstdDecompressor> zstd_decompressor_;
 
     std::unique_ptr<NpmConnection> connection_;
 
     bool decompressor_active_ = false;
     bool first_message_seen_ = false;
+    // Only kernel collectors are offered dictionary compression, once they have
+    // said they are one.
+    bool compression_offered_ = false;
+    // Admission control asked for the initial dump to be paced, which is sent
+    // to the collector once it has said it is a kernel collector.
+    bool pace_initial_dump_;
     std::chrono::nanoseconds last_message_seen_;
   };
 
@@ -115,6 +158,18 @@ private:
   ::ebpf_net::ingest::auto_handles::core_stats core_stats_;
   ::ebpf_net::ingest::auto_handles::ingest_core_stats ingest_core_stats_;
 
+  // Counters behind load(). Connections are counted by `assign_connection`,
+  // the rest is updated by the worker's thread.
+  std::atomic<u32> num_connections_{0};
+  std::atomic<u64> messages_handled_{0};
+  std::atomic<u64> bytes_handled_{0};
+  std::atomic<u64> busy_ns_{0};
+
+  // `pace_initial_dump` of connections handed to `assign` and not yet opened
+  // by the worker's thread, in the order they were assigned.
+  absl::Mutex pending_pace_mu_;
+  std::deque<bool> pending_pace_ ABSL_GUARDED_BY(pending_pace_mu_);
+
   friend class Callbacks;
 };
 
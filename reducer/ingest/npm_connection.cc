@@ -5,22 +5,45 @@
 
 namespace reducer::ingest {
 
+namespace {
+
+// Transforms are the same for every connection and don't change once built, so
+// connections on all ingest workers share one builder instead of each building
+// its own when a collector connects.
+ebpf_net::ingest::TransformBuilder &shared_transform_builder()
+{
+  static ebpf_net::ingest::TransformBuilder builder;
+  return builder;
+}
+
+} // namespace
+
 NpmConnection::NpmConnection(::ebpf_net::ingest::Index &index)
-    : transform_builder_(), protocol_(transform_builder_), connection_(protocol_, index), time_tracker_()
+    : protocol_(shared_transform_builder()), connection_(protocol_, index), time_tracker_()
 {}
 
 int NpmConnection::handle(const char *msg, uint32_t len)
 {
-  auto const handled = protocol_.handle(msg, len);
-  time_tracker_.message_received(handled.client_timestamp);
-  return handled.result;
+  auto const result = protocol_.handle(msg, len);
+  handled(result);
+  return result.result;
 }
 
 int NpmConnection::handle_multiple(const char *msg, u64 len)
 {
-  auto const handled = protocol_.handle_multiple(msg, len);
-  time_tracker_.message_received(handled.client_timestamp);
-  return handled.result;
+  auto const result = protocol_.handle_multiple(msg, len);
+  handled(result);
+  return result.result;
+}
+
+void NpmConnection::handled(::ebpf_net::ingest::Protocol::handle_result_t const &result)
+{
+  time_tracker_.message_received(result.client_timestamp);
+
+  if (result.result > 0) {
+    messages_handled_ += result.message_count;
+    bytes_handled_ += result.result;
+  }
 }
 
 std::chrono::nanoseconds NpmConnection::clock_offset() const
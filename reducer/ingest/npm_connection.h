@@ -37,13 +37,21 @@ public:
 
   ClientType client_type() const { return client_type_; }
 
+  // Number of messages and bytes handled on this connection so far.
+  u64 messages_handled() const { return messages_handled_; }
+  u64 bytes_handled() const { return bytes_handled_; }
+
 private:
-  ebpf_net::ingest::TransformBuilder transform_builder_;
+  // Accounts for the result of handle() or handle_multiple().
+  void handled(::ebpf_net::ingest::Protocol::handle_result_t const &result);
+
   ebpf_net::ingest::Protocol protocol_;
   ebpf_net::ingest::Connection connection_;
   TimeTracker time_tracker_;
   std::string_view client_hostname_ = kUnknown;
   ClientType client_type_ = ClientType::unknown;
+  u64 messages_handled_ = 0;
+  u64 bytes_handled_ = 0;
 };
 
 } // namespace reducer::ingest
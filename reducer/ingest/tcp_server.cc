@@ -5,8 +5,12 @@
 
 #include <reducer/ingest/ingest_worker.h>
 
+#include <platform/userspace-time.h>
+
+#include <util/log.h>
 #include <util/uv_helpers.h>
 
+#include <algorithm>
 #include <iomanip>
 #include <memory>
 #include <signal.h>
@@ -19,6 +23,18 @@ using std::placeholders::_2;
 
 namespace reducer::ingest {
 
+namespace {
+// Load a worker's open connection counts as, in the same units as the
+// measured load (permille of the time spent busy). Keeps new connections
+// evenly spread among idle workers, and accounts for connections accepted
+// since the last measurement.
+//
+// The balancer only holds the measured part; the connection part is added from
+// the workers' own connection counts whenever a worker is picked, so that
+// connections opened or closed between two measurements are counted once.
+constexpr int CONNECTION_LOAD = 10;
+} // namespace
+
 void TcpServer::on_new_connection_cb(uv_stream_t *stream, int status)
 {
   uv_tcp_t *server_socket = (uv_tcp_t *)stream;
@@ -31,8 +47,17 @@ void TcpServer::on_new_connection_cb(uv_stream_t *stream, int status)
   server->on_new_connection();
 }
 
-TcpServer::TcpServer(uv_loop_t &loop, u32 telemetry_port, bool localhost, std::vector<std::unique_ptr<IngestWorker>> workers)
-    : loop_(loop), workers_(std::move(workers))
+TcpServer::TcpServer(
+    uv_loop_t &loop,
+    u32 telemetry_port,
+    bool localhost,
+    std::vector<std::unique_ptr<IngestWorker>> workers,
+    AdmissionControl::Config const &admission)
+    : loop_(loop),
+      workers_(std::move(workers)),
+      last_loads_(workers_.size()),
+      worker_loads_(workers_.size()),
+      admission_(admission, monotonic())
 {
   // Initialize the workers.
   std::vector<Worker *> worker_ptrs;
@@ -44,6 +69,7 @@ TcpServer::TcpServer(uv_loop_t &loop, u32 telemetry_port, bool localhost, std::v
     worker_ptr->start(i);
   }
   worker_balancer_ = std::make_unique<LoadBalancer<Worker *>>(absl::MakeSpan(worker_ptrs));
+  last_rebalance_ns_ = monotonic();
 
   /* Listen for telemetry connections */
   CHECK_UV(uv_tcp_init(&loop_, &server_));
@@ -70,6 +96,16 @@ TcpServer::Stats TcpServer::get_stats()
   return stats_;
 }
 
+void TcpServer::on_socket_steady_state(std::chrono::nanoseconds elapsed)
+{
+  u64 const elapsed_ns = elapsed.count();
+
+  absl::MutexLock l(&stats_mu_);
+  stats_.steady_state_counter++;
+  stats_.steady_state_sum_ns += elapsed_ns;
+  stats_.steady_state_max_ns = std::max(stats_.steady_state_max_ns, elapsed_ns);
+}
+
 void TcpServer::visit_indexes(const IndexCb &cb, const bool block)
 {
   visit_internal(
@@ -123,10 +159,19 @@ void TcpServer::on_new_connection()
   CHECK_UV(uv_tcp_init(&loop_, conn));
   CHECK_UV(uv_accept(reinterpret_cast<uv_stream_t *>(&server_), reinterpret_cast<uv_stream_t *>(conn)));
 
-  // Hand off connection to worker.
-  Worker *const worker = worker_balancer_->least_loaded();
-  worker_balancer_->increment_load(worker, 1);
-  worker->assign(*conn);
+  auto const decision = admit_connection();
+  if (decision == AdmissionControl::Decision::defer) {
+    // Close the connection; the collector will reconnect after its backoff.
+    uv_close(reinterpret_cast<uv_handle_t *>(conn), reinterpret_cast<uv_close_cb>(&std::free));
+
+    absl::MutexLock l(&stats_mu_);
+    stats_.deferred_counter++;
+    return;
+  }
+
+  // Hand off connection to worker, which asks kernel collectors to pace their
+  // initial dump if needed.
+  least_loaded_worker()->assign_connection(*conn, decision == AdmissionControl::Decision::pace);
 
   // Close the connnection.
   uv_close(reinterpret_cast<uv_handle_t *>(conn), reinterpret_cast<uv_close_cb>(&std::free));
@@ -135,14 +180,45 @@ void TcpServer::on_new_connection()
   {
     absl::MutexLock l(&stats_mu_);
     stats_.connection_counter++;
+    if (decision == AdmissionControl::Decision::pace) {
+      stats_.paced_counter++;
+    }
   }
 }
 
-void TcpServer::on_connection_close(IngestWorker *const worker)
+AdmissionControl::Decision TcpServer::admit_connection()
 {
-  // Update the load balancer.
-  worker_balancer_->increment_load(worker, -1);
+  u64 const now = monotonic();
 
+  if (admission_.enabled()) {
+    u64 bytes = 0;
+    for (auto const &worker : workers_) {
+      bytes += worker->load().bytes;
+    }
+    admission_.on_bytes_received(bytes - admission_bytes_, now);
+    admission_bytes_ = bytes;
+  }
+
+  return admission_.on_new_connection(now);
+}
+
+IngestWorker *TcpServer::least_loaded_worker() const
+{
+  IngestWorker *least_loaded = nullptr;
+  int least_load = 0;
+  for (auto const &worker : workers_) {
+    int const load =
+        worker_balancer_->load(worker.get()) + static_cast<int>(worker->load().connections) * CONNECTION_LOAD;
+    if (!least_loaded || load < least_load) {
+      least_loaded = worker.get();
+      least_load = load;
+    }
+  }
+  return least_loaded;
+}
+
+void TcpServer::on_connection_close(IngestWorker *const worker)
+{
   // Update the connection stats.
   {
     absl::MutexLock l(&stats_mu_);
@@ -150,6 +226,32 @@ void TcpServer::on_connection_close(IngestWorker *const worker)
   }
 }
 
+void TcpServer::rebalance()
+{
+  u64 const now = monotonic();
+  u64 const interval_ns = now - last_rebalance_ns_;
+  last_rebalance_ns_ = now;
+
+  for (std::size_t i = 0; i < workers_.size(); ++i) {
+    auto *const worker = workers_[i].get();
+    auto const load = worker->load();
+    auto const &last = last_loads_[i];
+
+    auto &worker_load = worker_loads_[i];
+    worker_load = {
+        .connections = load.connections,
+        .messages = load.messages - last.messages,
+        .bytes = load.bytes - last.bytes,
+        .busy_ns = load.busy_ns - last.busy_ns,
+        .interval_ns = interval_ns,
+    };
+    last_loads_[i] = load;
+
+    int const busy_permille = static_cast<int>(std::min(worker_load.utilization(), 1.0) * 1000);
+    worker_balancer_->set_load(worker, busy_permille);
+  }
+}
+
 void TcpServer::visit_internal(const WorkerVisitCb &cb, const bool block)
 {
   // Run all the callbacks in parallel.
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "absl/base/thread_annotations.h"
+#include <reducer/admission_control.h>
 #include <reducer/ingest/ingest_worker.h>
 #include <reducer/load_balancer.h>
 #include <reducer/prometheus_handler.h>
@@ -14,6 +15,7 @@
 
 #include <uv.h>
 
+#include <chrono>
 #include <cstddef>
 
 namespace reducer::ingest {
@@ -28,6 +30,31 @@ public:
 
     u64 connection_counter;
     u64 disconnect_counter;
+
+    // Connections closed by admission control, for the collector to retry.
+    u64 deferred_counter = 0;
+    // Connections admitted with a request to pace the initial dump.
+    u64 paced_counter = 0;
+
+    // Collectors that reached socket steady state, and the total and longest
+    // time they took to get there since their connection was set up.
+    u64 steady_state_counter = 0;
+    u64 steady_state_sum_ns = 0;
+    u64 steady_state_max_ns = 0;
+  };
+
+  // Load handled by a worker between the last two calls to `rebalance`.
+  struct WorkerLoad {
+    // Number of open connections at the time of the last call.
+    u32 connections = 0;
+    u64 messages = 0;
+    u64 bytes = 0;
+    u64 busy_ns = 0;
+    // Time between the two calls.
+    u64 interval_ns = 0;
+
+    // Fraction of the interval the worker spent handling received data.
+    double utilization() const { return interval_ns ? static_cast<double>(busy_ns) / interval_ns : 0.0; }
   };
 
   // Arguments:
@@ -36,12 +63,23 @@ public:
   // * localhsot - If true, connects to 127.0.0.1, otherwise uses 0.0.0.0
   // * workers - The ingest workers owned by this class. This constructor
   //    will overwrite the close callback used by these workers.
-  TcpServer(uv_loop_t &loop, u32 telemetry_port, bool localhost, std::vector<std::unique_ptr<IngestWorker>> workers);
+  // * admission - Limits on the rate of new connections and of received
+  //    bytes, beyond which new connections are deferred or paced.
+  TcpServer(
+      uv_loop_t &loop,
+      u32 telemetry_port,
+      bool localhost,
+      std::vector<std::unique_ptr<IngestWorker>> workers,
+      AdmissionControl::Config const &admission = {});
   ~TcpServer();
 
   // Returns various stats related to connects/disconnects, etc.
   Stats get_stats();
 
+  // Records that a collector reached socket steady state, `elapsed` after its
+  // connection was set up. Can be called from any thread.
+  void on_socket_steady_state(std::chrono::nanoseconds elapsed);
+
   // Calls `cb` on the Index objects owned by the workers of this class (the
   // int argument is the index of the worker).
   // These will be executed in parallel. If `block` is true, this function will
@@ -66,6 +104,20 @@ public:
 
   std::size_t workers_count() const { return workers_.size(); }
 
+  // Measures the load on each worker since the previous call, and has new
+  // connections assigned to the least busy worker based on it.
+  //
+  // Connections are never moved once assigned: the spans of a connection live
+  // in its worker's index, along with spans shared with the worker's other
+  // connections, so there is no point at which a connection could be handed
+  // over to another worker without the collector sending its state again.
+  // Should be called periodically from the server's loop.
+  void rebalance();
+
+  // Returns the per-worker load measured by the last call to `rebalance`,
+  // indexed like the workers. Should be called from the server's loop.
+  std::vector<WorkerLoad> const &worker_loads() const { return worker_loads_; }
+
   // Global accessor for the TcpSever. Used by classes who want use the
   // `visit_*` functions but do not have direct access to a `TcpSever` instance
   // for whatever reason (e.g. render-instantiated `*Span` classes).
@@ -96,9 +148,17 @@ private:
   // Basically same as above, but as member function.
   void on_new_connection();
 
+  // Returns the worker with the lowest measured load plus `CONNECTION_LOAD`
+  // for each of its connections.
+  IngestWorker *least_loaded_worker() const;
+
   // Callback invoked when a connection on `worker` has been closed.
   void on_connection_close(IngestWorker *worker);
 
+  // Feeds the bytes received by all workers since the last call to the
+  // admission control, and returns its decision for a new connection.
+  AdmissionControl::Decision admit_connection();
+
   // Internal visitor implementation.
   using WorkerVisitCb = std::function<std::shared_ptr<absl::Notification>(int, IngestWorker *)>;
   void visit_internal(const WorkerVisitCb &cb, bool block);
@@ -107,8 +167,19 @@ private:
   uv_tcp_t server_;
 
   std::vector<std::unique_ptr<IngestWorker>> workers_;
+  // Load measured by the last call to `rebalance`, in permille of the time
+  // each worker spent busy.
   std::unique_ptr<LoadBalancer<Worker *>> worker_balancer_;
 
+  // Cumulative worker loads and time of the previous call to `rebalance`.
+  std::vector<IngestWorker::Load> last_loads_;
+  u64 last_rebalance_ns_;
+  std::vector<WorkerLoad> worker_loads_;
+
+  AdmissionControl admission_;
+  // Total bytes received by the workers, as of the last admission decision.
+  u64 admission_bytes_ = 0;
+
   Stats stats_ ABSL_GUARDED_BY(stats_mu_);
   mutable absl::Mutex stats_mu_;
 };
@@ -267,6 +267,53 @@ struct BpfLogStats {
   END_METRICS
 };
 
+struct PerfRingFillStats {
+  BEGIN_LABELS
+  COMMON_AGENT_SPAN_LABELS
+  LABEL(fill)
+  END_LABELS
+
+  BEGIN_METRICS
+  METRIC(EbpfNetMetricInfo::perf_ring_fill, count)
+  END_METRICS
+};
+
+struct PerfPollStats {
+  BEGIN_LABELS
+  COMMON_AGENT_SPAN_LABELS
+  END_LABELS
+
+  BEGIN_METRICS
+  METRIC(EbpfNetMetricInfo::perf_poll_timer, timer_polls)
+  METRIC(EbpfNetMetricInfo::perf_poll_wakeups, event_wakeups)
+  METRIC(EbpfNetMetricInfo::perf_poll_early, early_polls)
+  METRIC(EbpfNetMetricInfo::perf_poll_interval_ms, interval_ms)
+  END_METRICS
+};
+
+struct SocketResyncStats {
+  BEGIN_LABELS
+  COMMON_AGENT_SPAN_LABELS
+  END_LABELS
+
+  BEGIN_METRICS
+  METRIC(EbpfNetMetricInfo::socket_resyncs, resyncs)
+  METRIC(EbpfNetMetricInfo::socket_resync_mean_time_ms, mean_time_ms)
+  METRIC(EbpfNetMetricInfo::socket_resync_max_time_ms, max_time_ms)
+  END_METRICS
+};
+
+struct SocketResyncSocketStats {
+  BEGIN_LABELS
+  COMMON_AGENT_SPAN_LABELS
+  LABEL(action)
+  END_LABELS
+
+  BEGIN_METRICS
+  METRIC(EbpfNetMetricInfo::socket_resync_sockets, count)
+  END_METRICS
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // IngestCore
 ///////////////////////////////////////////////////////////////////////////////
@@ -352,6 +399,33 @@ struct ServerStats {
   END_METRICS
 };
 
+struct AdmissionStats {
+  BEGIN_LABELS
+  LABEL(module)
+  END_LABELS
+
+  BEGIN_METRICS
+  METRIC(EbpfNetMetricInfo::admission_deferred, deferred)
+  METRIC(EbpfNetMetricInfo::admission_paced, paced)
+  METRIC(EbpfNetMetricInfo::steady_state_collectors, steady_state_collectors)
+  METRIC(EbpfNetMetricInfo::steady_state_mean_time_ms, steady_state_mean_time_ms)
+  METRIC(EbpfNetMetricInfo::steady_state_max_time_ms, steady_state_max_time_ms)
+  END_METRICS
+};
+
+struct IngestWorkerStats {
+  BEGIN_LABELS
+  COMMON_LABELS
+  END_LABELS
+
+  BEGIN_METRICS
+  METRIC(EbpfNetMetricInfo::ingest_worker_connections, connections)
+  METRIC(EbpfNetMetricInfo::ingest_worker_messages, messages)
+  METRIC(EbpfNetMetricInfo::ingest_worker_bytes, bytes)
+  METRIC(EbpfNetMetricInfo::ingest_worker_utilization, utilization)
+  END_METRICS
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // LoggingCore
 ///////////////////////////////////////////////////////////////////////////////
@@ -378,6 +452,7 @@ struct OtlpGrpcStats {
   BEGIN_METRICS
   METRIC(EbpfNetMetricInfo::otlp_grpc_bytes_failed, bytes_failed)
   METRIC(EbpfNetMetricInfo::otlp_grpc_bytes_sent, bytes_sent)
+  METRIC(EbpfNetMetricInfo::otlp_grpc_metrics_dropped, metrics_dropped)
   METRIC(EbpfNetMetricInfo::otlp_grpc_metrics_failed, metrics_failed)
   METRIC(EbpfNetMetricInfo::otlp_grpc_metrics_sent, metrics_sent)
   METRIC(EbpfNetMetricInfo::otlp_grpc_requests_failed, requests_failed)
@@ -447,6 +522,29 @@ struct RpcLatencyStats {
   END_METRICS
 };
 
+struct RpcWakeupStats {
+  BEGIN_LABELS
+  COMMON_LABELS
+  END_LABELS
+
+  BEGIN_METRICS
+  METRIC(EbpfNetMetricInfo::rpc_wakeups, wakeups)
+  METRIC(EbpfNetMetricInfo::rpc_spins, spins)
+  METRIC(EbpfNetMetricInfo::rpc_parks, parks)
+  END_METRICS
+};
+
+struct ThreadPlacementStats {
+  BEGIN_LABELS
+  COMMON_LABELS
+  END_LABELS
+
+  BEGIN_METRICS
+  METRIC(EbpfNetMetricInfo::thread_numa_node, numa_node)
+  METRIC(EbpfNetMetricInfo::thread_cpus, cpus)
+  END_METRICS
+};
+
 #undef BEGIN_LABELS
 #undef END_LABELS
 #undef LABEL
@@ -25,37 +25,6 @@ json_format_prefix(char *buf_ptr, size_t buf_size, std::string_view metric, std:
   return std::string_view(buf_ptr, std::min(len, buf_size));
 }
 
-std::string_view json_format_labels(char *buff_ptr, size_t buff_size, TsdbFormatter::labels_t const &labels)
-{
-  size_t written = 0;
-  auto write = [&written, buff_ptr, buff_size](void const *ptr, size_t len) {
-    size_t const n = std::min(len, (buff_size - written));
-    if (n > 0) {
-      memcpy(buff_ptr + written, ptr, n);
-      written += n;
-    }
-  };
-
-  auto write_str = [write](std::string_view str) { write(str.data(), str.size()); };
-
-  auto write_label = [write_str](std::string_view name, std::string_view value) {
-    if (value.empty()) {
-      return;
-    }
-    write_str("\"");
-    write_str(name);
-    write_str("\":\"");
-    write_str(value);
-    write_str("\",");
-  };
-
-  for (auto const &[name, value] : labels) {
-    write_label(name, value);
-  }
-
-  return std::string_view(buff_ptr, written);
-}
-
 std::string_view json_format_suffix(char *buf_ptr, size_t buf_size, TsdbFormatter::timestamp_t timestamp)
 {
   using namespace std::chrono;
@@ -81,7 +50,7 @@ void JsonTsdbFormatter::format(
     bool aggregation_changed,
     rollup_t rollup,
     bool rollup_changed,
-    labels_t labels,
+    LabelSet const &labels,
     bool labels_changed,
     timestamp_t timestamp,
     bool timestamp_changed,
@@ -95,16 +64,12 @@ void JsonTsdbFormatter::format(
       },
       value);
 
-  if (labels_changed || labels_.empty()) {
-    labels_ = json_format_labels(labels_buf_, sizeof(labels_buf_), labels);
-  }
-
   if (timestamp_changed || suffix_.empty()) {
     suffix_ = json_format_suffix(suffix_buf_, sizeof(suffix_buf_), timestamp);
   }
 
   SCOPED_TIMING(JsonTsdbFormatterFormatWriterWrite);
-  writer->write(prefix, labels_, suffix_);
+  writer->write(prefix, labels.json(), suffix_);
 }
 
 } // namespace reducer
@@ -24,7 +24,7 @@ protected:
       bool aggregation_changed,
       rollup_t rollup,
       bool rollup_changed,
-      labels_t labels,
+      LabelSet const &labels,
       bool labels_changed,
       timestamp_t timestamp,
       bool timestamp_changed,
@@ -33,13 +33,9 @@ protected:
 private:
   // Large enough for metric name, aggregation, rollup and value.
   char prefix_buf_[512];
-  // Large enough for all labels.
-  char labels_buf_[8192];
   // Large enough for ISO timestamp and then some.
   char suffix_buf_[64];
 
-  // Cached labels string, points to labels_buf_ when initialized.
-  std::string_view labels_;
   // Cached suffix string, points to suffix_buf_ when initialized.
   std::string_view suffix_;
   // Cached aggregation label, based on aggregation and rollup.
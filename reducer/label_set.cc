@@ -0,0 +1,72 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "label_set.h"
+
+#include <absl/hash/hash.h>
+
+#include <algorithm>
+
+namespace reducer {
+
+namespace {
+
+std::string encode_prometheus(LabelSet::labels_t const &labels)
+{
+  std::string out;
+  out.push_back('{');
+
+  for (auto const &[name, value] : labels) {
+    if (out.size() > 1) {
+      out.push_back(',');
+    }
+
+    size_t const name_start = out.size();
+    out.append(name);
+    std::replace(out.begin() + name_start, out.end(), '.', '_');
+
+    out.append("=\"");
+    out.append(value);
+    out.push_back('"');
+  }
+
+  out.push_back('}');
+  return out;
+}
+
+std::string encode_json(LabelSet::labels_t const &labels)
+{
+  std::string out;
+
+  for (auto const &[name, value] : labels) {
+    if (value.empty()) {
+      continue;
+    }
+
+    out.push_back('"');
+    out.append(name);
+    out.append("\":\"");
+    out.append(value);
+    out.append("\",");
+  }
+
+  return out;
+}
+
+} // namespace
+
+LabelSet::LabelSet(labels_t labels) : labels_(std::move(labels)), hash_(absl::HashOf(labels_)) {}
+
+std::string_view LabelSet::prometheus() const
+{
+  std::call_once(prometheus_once_, [this] { prometheus_ = encode_prometheus(labels_); });
+  return prometheus_;
+}
+
+std::string_view LabelSet::json() const
+{
+  std::call_once(json_once_, [this] { json_ = encode_json(labels_); });
+  return json_;
+}
+
+} // namespace reducer
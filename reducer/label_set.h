@@ -0,0 +1,83 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/types.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace reducer {
+
+// Immutable set of time-series labels (key/value pairs).
+//
+// A label set is built once and then used for any number of time-series,
+// e.g. all the metrics of a flow. Besides the labels, it keeps their hash and,
+// for each text output format, the labels already encoded the way that format
+// writes them. Encodings are computed the first time they are needed, so a set
+// only pays for the formats it is written in.
+//
+// Label sets are shared through `LabelSet::Ptr`; since they don't change once
+// built, formatters can tell whether the labels changed between two writes by
+// comparing pointers.
+//
+class LabelSet {
+public:
+  using labels_t = std::map<std::string, std::string>;
+  using Ptr = std::shared_ptr<LabelSet const>;
+
+  explicit LabelSet(labels_t labels);
+
+  LabelSet(LabelSet const &) = delete;
+  LabelSet &operator=(LabelSet const &) = delete;
+
+  static Ptr make(labels_t labels) { return std::make_shared<LabelSet const>(std::move(labels)); }
+
+  // Builds a label set from NodeLabels, FlowLabels and similar objects,
+  // leaving out labels with empty values.
+  template <typename Labels> static Ptr make_from(Labels const &labels)
+  {
+    labels_t result;
+    labels.foreach ([&result](std::string_view name, std::string_view value) {
+      if (!value.empty()) {
+        result.insert_or_assign(std::string(name), std::string(value));
+      }
+    });
+    return make(std::move(result));
+  }
+
+  labels_t const &labels() const { return labels_; }
+
+  bool empty() const { return labels_.empty(); }
+
+  // Hash of the labels, fixed for the lifetime of the set.
+  u64 hash() const { return hash_; }
+
+  bool operator==(LabelSet const &other) const { return (hash_ == other.hash_) && (labels_ == other.labels_); }
+
+  // Labels in the Prometheus format: `{label1="xxx",label2="yyy",...}`.
+  // Dots in label names are replaced with underscores.
+  std::string_view prometheus() const;
+
+  // Labels in the JSON format: `"label1":"xxx","label2":"yyy",...,`.
+  // Labels with empty values are left out.
+  std::string_view json() const;
+
+private:
+  labels_t const labels_;
+  u64 const hash_;
+
+  mutable std::once_flag prometheus_once_;
+  mutable std::string prometheus_;
+
+  mutable std::once_flag json_once_;
+  mutable std::string json_;
+};
+
+} // namespace reducer
@@ -0,0 +1,107 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "label_set.h"
+#include "tsdb_formatter.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace reducer {
+
+namespace {
+
+// Keeps the labels part of everything written.
+class LabelsWriter : public Publisher::Writer {
+public:
+  void write(std::string_view prefix, std::string_view labels, std::string_view suffix) override
+  {
+    written.emplace_back(labels);
+  }
+
+  void flush() override {}
+
+  std::vector<std::string> written;
+};
+
+} // namespace
+
+TEST(LabelSetTest, Encodings)
+{
+  auto labels = LabelSet::make({{"sf.product", "network-explorer"}, {"az", "us-east-1a"}, {"empty", ""}});
+
+  EXPECT_EQ(labels->prometheus(), "{az=\"us-east-1a\",empty=\"\",sf_product=\"network-explorer\"}");
+  EXPECT_EQ(labels->json(), "\"az\":\"us-east-1a\",\"sf.product\":\"network-explorer\",");
+
+  // encoded once per set
+  EXPECT_EQ(labels->prometheus().data(), labels->prometheus().data());
+
+  auto empty = LabelSet::make({});
+  EXPECT_TRUE(empty->empty());
+  EXPECT_EQ(empty->prometheus(), "{}");
+  EXPECT_EQ(empty->json(), "");
+}
+
+TEST(LabelSetTest, HashAndEquality)
+{
+  auto a = LabelSet::make({{"x", "1"}, {"y", "2"}});
+  auto b = LabelSet::make({{"y", "2"}, {"x", "1"}});
+  auto c = LabelSet::make({{"x", "1"}, {"y", "3"}});
+
+  EXPECT_EQ(a->hash(), b->hash());
+  EXPECT_EQ(*a, *b);
+  EXPECT_NE(a->hash(), c->hash());
+  EXPECT_FALSE(*a == *c);
+}
+
+TEST(LabelSetTest, FormatterWritesAssignedSet)
+{
+  auto formatter = TsdbFormatter::make(TsdbFormat::prometheus);
+  Publisher::WriterPtr writer = std::make_unique<LabelsWriter>();
+  auto &written = static_cast<LabelsWriter &>(*writer).written;
+
+  auto labels = LabelSet::make({{"x", "1"}});
+  formatter->set_labels(labels);
+  formatter->write("metric_a", u64{1}, writer);
+  formatter->write("metric_b", u64{2}, writer);
+
+  ASSERT_EQ(written.size(), 2u);
+  EXPECT_EQ(written[0], "{x=\"1\"}");
+  EXPECT_EQ(written[1], "{x=\"1\"}");
+
+  // modifying the labels doesn't change the assigned set
+  formatter->assign_label(std::string_view("y"), std::string_view("2"));
+  formatter->write("metric_c", u64{3}, writer);
+
+  ASSERT_EQ(written.size(), 3u);
+  EXPECT_EQ(written[2], "{x=\"1\",y=\"2\"}");
+  EXPECT_EQ(labels->labels().size(), 1u);
+
+  formatter->remove_label("y");
+  formatter->write("metric_d", u64{4}, writer);
+
+  ASSERT_EQ(written.size(), 4u);
+  EXPECT_EQ(written[3], "{x=\"1\"}");
+}
+
+TEST(LabelSetTest, FormatterLabelsFromMap)
+{
+  auto formatter = TsdbFormatter::make(TsdbFormat::json);
+  Publisher::WriterPtr writer = std::make_unique<LabelsWriter>();
+  auto &written = static_cast<LabelsWriter &>(*writer).written;
+
+  formatter->set_labels(TsdbFormatter::labels_t{{"x", "1"}});
+  formatter->write("metric_a", u64{1}, writer);
+
+  formatter->clear_labels();
+  formatter->assign_label(std::string_view("x"), std::string_view("2"));
+  formatter->write("metric_b", u64{2}, writer);
+
+  ASSERT_EQ(written.size(), 2u);
+  EXPECT_EQ(written[0], "\"x\":\"1\",");
+  EXPECT_EQ(written[1], "\"x\":\"2\",");
+}
+
+} // namespace reducer
@@ -0,0 +1,31 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <reducer/load_balancer.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(load_balancer, set_load)
+{
+  std::vector<int> const elems = {1, 2, 3};
+  LoadBalancer<int> balancer(absl::MakeConstSpan(elems));
+
+  EXPECT_EQ(0, balancer.load(1));
+
+  balancer.set_load(1, 300);
+  balancer.set_load(2, 100);
+  EXPECT_EQ(300, balancer.load(1));
+  EXPECT_EQ(100, balancer.load(2));
+  EXPECT_EQ(0, balancer.load(3));
+
+  balancer.increment_load(2, 150);
+  EXPECT_EQ(250, balancer.load(2));
+
+  balancer.increment_load(2, -250);
+  EXPECT_EQ(0, balancer.load(2));
+
+  balancer.set_load(1, 0);
+  EXPECT_EQ(0, balancer.load(1));
+}
@@ -79,6 +79,7 @@ void AggCoreStatsSpan::agg_otlp_grpc_stats(
   stats.labels.client_type = msg->client_type;
   stats.metrics.bytes_failed = msg->bytes_failed;
   stats.metrics.bytes_sent = msg->bytes_sent;
+  stats.metrics.metrics_dropped = msg->data_points_dropped;
   stats.metrics.metrics_failed = msg->data_points_failed;
   stats.metrics.metrics_sent = msg->data_points_sent;
   stats.metrics.requests_failed = msg->requests_failed;
@@ -89,12 +90,13 @@ void AggCoreStatsSpan::agg_otlp_grpc_stats(
 
   LOG::debug_in(
       reducer::logging::Component::internal_metrics,
-      "AggCoreStatsSpan::agg_otlp_grpc_stats module={} shard={} client_type={} bytes_failed={} bytes_sent={} metrics_failed={} metrics_sent={} requests_failed={} requests_sent={} unknown_response_tags={} timestamp={}",
+      "AggCoreStatsSpan::agg_otlp_grpc_stats module={} shard={} client_type={} bytes_failed={} bytes_sent={} metrics_dropped={} metrics_failed={} metrics_sent={} requests_failed={} requests_sent={} unknown_response_tags={} timestamp={}",
       msg->module,
       msg->shard,
       msg->client_type,
       msg->bytes_failed,
       msg->bytes_sent,
+      msg->data_points_dropped,
       msg->data_points_failed,
       msg->data_points_sent,
       msg->requests_failed,
@@ -423,4 +423,178 @@ void IngestCoreStatsSpan::server_stats(
       msg->time_ns);
 }
 
+void IngestCoreStatsSpan::admission_stats(
+    ::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__admission_stats *msg)
+{
+  auto &encoder = local_core<LoggingCore>().encoder_;
+
+  AdmissionStats stats;
+  stats.labels.module = msg->module;
+  stats.metrics.deferred = msg->deferred_counter;
+  stats.metrics.paced = msg->paced_counter;
+  stats.metrics.steady_state_collectors = msg->steady_state_counter;
+  stats.metrics.steady_state_mean_time_ms =
+      msg->steady_state_counter ? static_cast<double>(msg->steady_state_sum_ns) / msg->steady_state_counter / 1e6 : 0.0;
+  stats.metrics.steady_state_max_time_ms = static_cast<double>(msg->steady_state_max_ns) / 1e6;
+
+  encoder.write_internal_stats(stats, msg->time_ns);
+
+  LOG::debug_in(
+      reducer::logging::Component::internal_metrics,
+      "IngestCoreStatsSpan::admission_stats: module={} deferred_counter={} paced_counter={} steady_state_counter={}"
+      " steady_state_sum_ns={} steady_state_max_ns={} timestamp={}",
+      msg->module,
+      msg->deferred_counter,
+      msg->paced_counter,
+      msg->steady_state_counter,
+      msg->steady_state_sum_ns,
+      msg->steady_state_max_ns,
+      msg->time_ns);
+}
+
+void IngestCoreStatsSpan::ingest_worker_stats(
+    ::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__ingest_worker_stats *msg)
+{
+  auto &encoder = local_core<LoggingCore>().encoder_;
+
+  IngestWorkerStats stats;
+  stats.labels.module = msg->module;
+  stats.labels.shard = std::to_string(msg->shard);
+  stats.metrics.connections = msg->connections;
+  stats.metrics.messages = msg->messages;
+  stats.metrics.bytes = msg->bytes;
+  stats.metrics.utilization = msg->interval_ns ? static_cast<double>(msg->busy_ns) / msg->interval_ns : 0.0;
+
+  encoder.write_internal_stats(stats, msg->time_ns);
+
+  LOG::debug_in(
+      reducer::logging::Component::internal_metrics,
+      "IngestCoreStatsSpan::ingest_worker_stats: module={} shard={} connections={} messages={} bytes={} busy_ns={}"
+      " interval_ns={} timestamp={}",
+      msg->module,
+      msg->shard,
+      msg->connections,
+      msg->messages,
+      msg->bytes,
+      msg->busy_ns,
+      msg->interval_ns,
+      msg->time_ns);
+}
+
+void IngestCoreStatsSpan::perf_poll_stats(
+    ::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__perf_poll_stats *msg)
+{
+  auto &encoder = local_core<LoggingCore>().encoder_;
+
+  auto set_labels = [msg](auto &labels) {
+    labels.module = msg->module;
+    labels.shard = std::to_string(msg->shard);
+    labels.version = msg->version;
+    labels.cloud = msg->cloud;
+    labels.env = msg->env;
+    labels.role = msg->role;
+    labels.az = msg->az;
+    labels.id = msg->node_id;
+    labels.kernel = msg->kernel_version;
+    labels.c_type = std::to_string(msg->client_type);
+    labels.c_host = msg->hostname;
+    labels.os = msg->os;
+    labels.os_version = msg->os_version;
+  };
+
+  PerfPollStats stats;
+  set_labels(stats.labels);
+  stats.metrics.timer_polls = msg->timer_polls;
+  stats.metrics.event_wakeups = msg->event_wakeups;
+  stats.metrics.early_polls = msg->early_polls;
+  stats.metrics.interval_ms = msg->interval_ms;
+  encoder.write_internal_stats(stats, msg->time_ns);
+
+  std::pair<std::string_view, u64> const fill_buckets[] = {
+      {"0-25", msg->fill_0_25},
+      {"25-50", msg->fill_25_50},
+      {"50-75", msg->fill_50_75},
+      {"75-100", msg->fill_75_100},
+  };
+  for (auto const &[fill, count] : fill_buckets) {
+    PerfRingFillStats fill_stats;
+    set_labels(fill_stats.labels);
+    fill_stats.labels.fill = fill;
+    fill_stats.metrics.count = count;
+    encoder.write_internal_stats(fill_stats, msg->time_ns);
+  }
+
+  LOG::debug_in(
+      reducer::logging::Component::internal_metrics,
+      "IngestCoreStatsSpan::perf_poll_stats: module={} shard={} agent_hostname={} fill_0_25={} fill_25_50={} fill_50_75={}"
+      " fill_75_100={} timer_polls={} event_wakeups={} early_polls={} interval_ms={} timestamp={}",
+      msg->module,
+      msg->shard,
+      msg->hostname,
+      msg->fill_0_25,
+      msg->fill_25_50,
+      msg->fill_50_75,
+      msg->fill_75_100,
+      msg->timer_polls,
+      msg->event_wakeups,
+      msg->early_polls,
+      msg->interval_ms,
+      msg->time_ns);
+}
+
+void IngestCoreStatsSpan::socket_resync_stats(
+    ::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__socket_resync_stats *msg)
+{
+  auto &encoder = local_core<LoggingCore>().encoder_;
+
+  auto set_labels = [msg](auto &labels) {
+    labels.module = msg->module;
+    labels.shard = std::to_string(msg->shard);
+    labels.version = msg->version;
+    labels.cloud = msg->cloud;
+    labels.env = msg->env;
+    labels.role = msg->role;
+    labels.az = msg->az;
+    labels.id = msg->node_id;
+    labels.kernel = msg->kernel_version;
+    labels.c_type = std::to_string(msg->client_type);
+    labels.c_host = msg->hostname;
+    labels.os = msg->os;
+    labels.os_version = msg->os_version;
+  };
+
+  SocketResyncStats stats;
+  set_labels(stats.labels);
+  stats.metrics.resyncs = msg->resync_counter;
+  stats.metrics.mean_time_ms = msg->resync_counter ? static_cast<double>(msg->resync_sum_ns) / msg->resync_counter / 1e6 : 0.0;
+  stats.metrics.max_time_ms = static_cast<double>(msg->resync_max_ns) / 1e6;
+  encoder.write_internal_stats(stats, msg->time_ns);
+
+  std::pair<std::string_view, u64> const actions[] = {
+      {"closed", msg->closed_sockets},
+      {"rewalked", msg->rewalked_sockets},
+  };
+  for (auto const &[action, count] : actions) {
+    SocketResyncSocketStats socket_stats;
+    set_labels(socket_stats.labels);
+    socket_stats.labels.action = action;
+    socket_stats.metrics.count = count;
+    encoder.write_internal_stats(socket_stats, msg->time_ns);
+  }
+
+  LOG::debug_in(
+      reducer::logging::Component::internal_metrics,
+      "IngestCoreStatsSpan::socket_resync_stats: module={} shard={} agent_hostname={} resync_counter={} resync_sum_ns={}"
+      " resync_max_ns={} closed_sockets={} rewalked_sockets={} timestamp={}",
+      msg->module,
+      msg->shard,
+      msg->hostname,
+      msg->resync_counter,
+      msg->resync_sum_ns,
+      msg->resync_max_ns,
+      msg->closed_sockets,
+      msg->rewalked_sockets,
+      msg->time_ns);
+}
+
 } // namespace reducer::logging
@@ -28,6 +28,14 @@ public:
   void entry_point_stats(
       ::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__entry_point_stats *msg);
   void server_stats(::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__server_stats *msg);
+  void admission_stats(
+      ::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__admission_stats *msg);
+  void ingest_worker_stats(
+      ::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__ingest_worker_stats *msg);
+  void perf_poll_stats(
+      ::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__perf_poll_stats *msg);
+  void socket_resync_stats(
+      ::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__socket_resync_stats *msg);
   void collector_health_stats(
       ::ebpf_net::logging::weak_refs::ingest_core_stats span_ref, u64 timestamp, jsrv_logging__collector_health_stats *msg);
   void
@@ -10,6 +10,7 @@
 #include <reducer/internal_metrics_encoder.h>
 #include <reducer/internal_stats.h>
 #include <reducer/rpc_queue_matrix.h>
+#include <reducer/thread_placement.h>
 
 #include <common/constants.h>
 
@@ -52,14 +53,18 @@ LoggingCore::LoggingCore(
       logger_(index_.logger.alloc())
 {
   // ingest->this
-  add_rpc_clients(ingest_to_logging_queues.make_readers(shard_num), ClientType::ingest, ingest_to_logging_stats_);
+  add_rpc_clients(ingest_to_logging_queues, ClientType::ingest, ingest_to_logging_stats_);
 
   // matching->this
-  add_rpc_clients(matching_to_logging_queues.make_readers(shard_num), ClientType::matching, matching_to_logging_stats_);
+  add_rpc_clients(matching_to_logging_queues, ClientType::matching, matching_to_logging_stats_);
 
   // aggregation->this
-  add_rpc_clients(
-      aggregation_to_logging_queues.make_readers(shard_num), ClientType::aggregation, aggregation_to_logging_stats_);
+  add_rpc_clients(aggregation_to_logging_queues, ClientType::aggregation, aggregation_to_logging_stats_);
+}
+
+void LoggingCore::add_monitored_core(Core const &core)
+{
+  monitored_cores_.push_back({.core = &core});
 }
 
 void LoggingCore::write_internal_stats()
@@ -76,6 +81,9 @@ void LoggingCore::write_internal_stats()
   matching_to_logging_stats_.write_internal_stats(encoder_, time_ns);
   aggregation_to_logging_stats_.write_internal_stats(encoder_, time_ns);
 
+  write_rpc_wait_stats(time_ns);
+  write_thread_placement_stats(time_ns);
+
   stats_writer_->write_internal_stats(encoder_, time_ns, shard, module);
 
   encoder_.flush();
@@ -86,4 +94,39 @@ void LoggingCore::write_internal_stats()
   }
 }
 
+void LoggingCore::write_rpc_wait_stats(u64 time_ns)
+{
+  for (auto &monitored : monitored_cores_) {
+    auto const &wait_stats = monitored.core->rpc_wait_stats();
+
+    u64 const wakeups = wait_stats.wakeups.load(std::memory_order_relaxed);
+    u64 const spins = wait_stats.spins.load(std::memory_order_relaxed);
+    u64 const parks = wait_stats.parks.load(std::memory_order_relaxed);
+
+    RpcWakeupStats stats;
+    stats.labels.module = monitored.core->app_name();
+    stats.labels.shard = std::to_string(monitored.core->shard_num());
+    stats.metrics.wakeups = wakeups - monitored.last_wakeups;
+    stats.metrics.spins = spins - monitored.last_spins;
+    stats.metrics.parks = parks - monitored.last_parks;
+    encoder_.write_internal_stats(stats, time_ns);
+
+    monitored.last_wakeups = wakeups;
+    monitored.last_spins = spins;
+    monitored.last_parks = parks;
+  }
+}
+
+void LoggingCore::write_thread_placement_stats(u64 time_ns)
+{
+  for (auto const &placed : ThreadPlacement::global().shards()) {
+    ThreadPlacementStats stats;
+    stats.labels.module = placed.module;
+    stats.labels.shard = std::to_string(placed.shard);
+    stats.metrics.numa_node = static_cast<u32>(placed.node);
+    stats.metrics.cpus = static_cast<u32>(placed.cpus.size());
+    encoder_.write_internal_stats(stats, time_ns);
+  }
+}
+
 } // namespace reducer::logging
@@ -53,7 +53,20 @@ public:
   // Get tsdb format for Logging core.
   static TsdbFormat get_tsdb_format();
 
+  // Adds a core whose RPC wait stats will be reported by this core.
+  // NOTE: must be called before any of the cores are started.
+  void add_monitored_core(Core const &core);
+
 private:
+  // Core whose RPC wait stats are reported by this core.
+  struct MonitoredCore {
+    Core const *core;
+    u64 last_wakeups{0};
+    u64 last_spins{0};
+    u64 last_parks{0};
+  };
+  std::vector<MonitoredCore> monitored_cores_;
+
   // Keeper of ingest->this RPC stats.
   RpcReceiverStats ingest_to_logging_stats_;
   // Keeper of matching->this RPC stats.
@@ -68,6 +81,12 @@ private:
 
   // Outputs internal stats to be scraped by a time-series DB.
   void write_internal_stats() override;
+
+  // Outputs RPC wait stats of all monitored cores.
+  void write_rpc_wait_stats(u64 time_ns);
+
+  // Outputs the NUMA node and CPUs each shard is placed on, if placement is enabled.
+  void write_thread_placement_stats(u64 time_ns);
 };
 
 } // namespace reducer::logging
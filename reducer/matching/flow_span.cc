@@ -43,6 +43,17 @@ template <typename T> const T &get_or_default(const std::optional<T> &value)
   return value.has_value() ? *value : *kDefault;
 }
 
+// Interns the given string in the string table of this thread's matching core.
+InternedString intern(std::string_view value)
+{
+  return local_core<MatchingCore>().strings.intern(value);
+}
+
+InternedString intern(jb_blob const &value)
+{
+  return intern(std::string_view(value.buf, value.len));
+}
+
 } // namespace
 
 bool FlowSpan::aws_enrichment_enabled_ = false;
@@ -58,11 +69,11 @@ FlowSpan::~FlowSpan() {}
 
 void FlowSpan::agent_info(::ebpf_net::matching::weak_refs::flow span_ref, u64 timestamp, jsrv_matching__agent_info *msg)
 {
-  std::string id{msg->id.buf, msg->id.len};
-  std::string az{msg->az.buf, msg->az.len};
-  std::string env{msg->env.buf, msg->env.len};
-  std::string role{msg->role.buf, msg->role.len};
-  std::string ns{msg->ns.buf, msg->ns.len};
+  auto id = intern(msg->id);
+  auto az = intern(msg->az);
+  auto env = intern(msg->env);
+  auto role = intern(msg->role);
+  auto ns = intern(msg->ns);
 
   LOG::trace_in(
       Component::flow, "matching::FlowSpan::agent_info: side={} id={} az={} env={} ns={}", msg->side, id, az, env, ns);
@@ -82,16 +93,16 @@ void FlowSpan::agent_info(::ebpf_net::matching::weak_refs::flow span_ref, u64 ti
 
 void FlowSpan::task_info(::ebpf_net::matching::weak_refs::flow span_ref, u64 timestamp, jsrv_matching__task_info *msg)
 {
-  std::string comm{msg->comm.buf, msg->comm.len};
-  std::string cgroup_name{msg->cgroup_name.buf, msg->cgroup_name.len};
+  auto comm = intern(msg->comm);
+  auto cgroup_name = intern(msg->cgroup_name);
 
   LOG::trace_in(Component::flow, "matching::FlowSpan::task_info: side={} comm='{}' cgroup='{}'", msg->side, comm, cgroup_name);
 
   auto const side = u8_to_side(msg->side);
 
   task_info_[+side] = {
-      .comm = comm,
-      .cgroup_name = cgroup_name,
+      .comm = std::move(comm),
+      .cgroup_name = std::move(cgroup_name),
   };
 
   n_received_info_messages_++;
@@ -101,7 +112,7 @@ void FlowSpan::socket_info(::ebpf_net::matching::weak_refs::flow span_ref, u64 t
 {
   auto local_addr = IPv6Address::from(msg->local_addr);
   auto remote_addr = IPv6Address::from(msg->remote_addr);
-  std::string remote_dns_name{msg->remote_dns_name.buf, msg->remote_dns_name.len};
+  auto remote_dns_name = intern(msg->remote_dns_name);
 
   LOG::trace_in(
       Component::flow,
@@ -154,11 +165,11 @@ void FlowSpan::container_info(
     ::ebpf_net::matching::weak_refs::flow span_ref, const u64 timestamp, jsrv_matching__container_info *const msg)
 {
   auto const side = u8_to_side(msg->side);
-  std::string name{msg->name.buf, msg->name.len};
-  std::string pod{msg->pod.buf, msg->pod.len};
-  std::string role{msg->role.buf, msg->role.len};
-  std::string version{msg->version.buf, msg->version.len};
-  std::string ns{msg->ns.buf, msg->ns.len};
+  auto name = intern(msg->name);
+  auto pod = intern(msg->pod);
+  auto role = intern(msg->role);
+  auto version = intern(msg->version);
+  auto ns = intern(msg->ns);
   auto const type = static_cast<NodeResolutionType>(msg->node_type);
 
   container_info_[+side] = ContainerInfo{
@@ -176,7 +187,7 @@ void FlowSpan::service_info(
     ::ebpf_net::matching::weak_refs::flow span_ref, const u64 timestamp, jsrv_matching__service_info *const msg)
 {
   auto const side = u8_to_side(msg->side);
-  std::string name{msg->name.buf, msg->name.len};
+  auto name = intern(msg->name);
 
   service_info_[+side] = ServiceInfo{
       .name = std::move(name),
@@ -221,17 +232,17 @@ void FlowSpan::update_node(::ebpf_net::matching::weak_refs::agg_root agg_root, F
   agg_root.update_node(
       static_cast<u8>(side),
       jb_blob(n.id),
-      jb_blob(n.az),
-      jb_blob(n.role),
-      jb_blob(n.version),
-      jb_blob(n.env),
-      jb_blob(n.ns),
+      jb_blob(n.az.view()),
+      jb_blob(n.role.view()),
+      jb_blob(n.version.view()),
+      jb_blob(n.env.view()),
+      jb_blob(n.ns.view()),
       static_cast<u8>(n.node_type),
       jb_blob(n.address),
-      jb_blob(n.comm),
-      jb_blob(n.container_name),
-      jb_blob(n.pod_name),
-      jb_blob(n.role_uid));
+      jb_blob(n.comm.view()),
+      jb_blob(n.container_name.view()),
+      jb_blob(n.pod_name.view()),
+      jb_blob(n.role_uid.view()));
 }
 
 void FlowSpan::create_agg_root(::ebpf_net::matching::weak_refs::flow flow, NodeData const &node_a, NodeData const &node_b)
@@ -316,22 +327,22 @@ FlowSpan::NodeData FlowSpan::resolve_node(::ebpf_net::matching::weak_refs::flow
 
   auto [id, az, is_autonomous_system] = get_id_az(side);
 
-  std::string role;
-  std::string role_uid;
-  std::string version;
-  std::string env;
-  std::string ns;
-  std::string container_name;
+  InternedString role;
+  InternedString role_uid;
+  InternedString version;
+  InternedString env;
+  InternedString ns;
+  InternedString container_name;
   auto node_type = NodeResolutionType::NONE;
 
   if (auto &agent_info = agent_info_[+side]; agent_info.has_value()) {
     env = agent_info->env;
     ns = agent_info->ns;
   } else {
-    env = kNoAgentEnvironmentName;
+    env = intern(kNoAgentEnvironmentName);
   }
 
-  const std::string &pod_name = get_or_default(container_info_[+side]).pod;
+  const InternedString &pod_name = get_or_default(container_info_[+side]).pod;
 
   // sanity checks on messages:
   // we get agent_info_ if and only if task_info and socket info
@@ -365,13 +376,13 @@ FlowSpan::NodeData FlowSpan::resolve_node(::ebpf_net::matching::weak_refs::flow
 
     // enrich
     node_type = NodeResolutionType::K8S_CONTAINER;
-    role = pod.owner_name();
-    role_uid = pod.owner_uid();
-    version = pod.version();
-    ns = pod.ns();
+    role = intern(pod.owner_name());
+    role_uid = intern(pod.owner_uid());
+    version = intern(pod.version());
+    ns = intern(pod.ns());
 
     if (auto &task_info = task_info_[+side]; task_info.has_value()) {
-      auto info = CGroupParser{task_info->cgroup_name}.get();
+      auto info = CGroupParser{task_info->cgroup_name.view()}.get();
       auto container_id = info.container_id;
 
       if (!container_id.empty()) {
@@ -379,10 +390,10 @@ FlowSpan::NodeData FlowSpan::resolve_node(::ebpf_net::matching::weak_refs::flow
         auto k8s_container = span_ref.index().k8s_container.by_key(container_key);
 
         if (k8s_container.valid()) {
-          container_name = k8s_container.name();
+          container_name = intern(k8s_container.name());
 
           if (!k8s_container.version().empty()) {
-            version = k8s_container.version();
+            version = intern(k8s_container.version());
           }
         }
       }
@@ -438,8 +449,8 @@ FlowSpan::NodeData FlowSpan::resolve_node(::ebpf_net::matching::weak_refs::flow
     if (aws_info && !aws_info->role.empty() && !aws_info->az.empty()) {
       // AWS enrichment exists
       node_type = NodeResolutionType::AWS;
-      role = aws_info->role;
-      az = aws_info->az;
+      role = intern(aws_info->role);
+      az = intern(aws_info->az);
       if (!aws_info->id.empty()) {
         id = aws_info->id + "/" + id;
       }
@@ -450,20 +461,20 @@ FlowSpan::NodeData FlowSpan::resolve_node(::ebpf_net::matching::weak_refs::flow
       } else {
         // no agent and no DNS, fall back on the IP address
         node_type = NodeResolutionType::IP;
-        role = is_autonomous_system ? "(internet)" : "(unknown)";
+        role = intern(is_autonomous_system ? "(internet)" : "(unknown)");
       }
     }
   }
 
   if (get_comm(side) == kCommKubelet) {
-    role = "kubelet";
+    role = intern("kubelet");
   } else if (addr_port->port == kPortDNS) {
-    role = "DNS";
+    role = intern("DNS");
   } else if (addr_port->addr == kAddrInstanceMetadata) {
-    role = "instance metadata";
+    role = intern("instance metadata");
     node_type = NodeResolutionType::INSTANCE_METADATA;
     if (auto &agent_info = agent_info_[+(~side)]; agent_info.has_value()) {
-      id = agent_info->id;
+      id = agent_info->id.view();
       az = agent_info->az;
     }
   }
@@ -477,22 +488,22 @@ FlowSpan::NodeData FlowSpan::resolve_node(::ebpf_net::matching::weak_refs::flow
   }
 
   return NodeData{
-      .id = id,
-      .az = az,
-      .role = role,
-      .role_uid = role_uid,
-      .version = version,
-      .env = env,
-      .ns = ns,
+      .id = std::move(id),
+      .az = std::move(az),
+      .role = std::move(role),
+      .role_uid = std::move(role_uid),
+      .version = std::move(version),
+      .env = std::move(env),
+      .ns = std::move(ns),
       .node_type = node_type,
-      .address = address,
+      .address = std::move(address),
       .comm = get_comm(side),
-      .container_name = container_name,
+      .container_name = std::move(container_name),
       .pod_name = pod_name,
   };
 }
 
-std::string FlowSpan::get_comm(FlowSide side) const
+InternedString const &FlowSpan::get_comm(FlowSide side) const
 {
   return get_or_default(task_info_[+side]).comm;
 }
@@ -511,15 +522,15 @@ std::optional<FlowSpan::AddrPort> FlowSpan::get_addr_port(FlowSide side) const
   return std::nullopt;
 }
 
-std::tuple<std::string, std::string, bool> FlowSpan::get_id_az(FlowSide side) const
+std::tuple<std::string, InternedString, bool> FlowSpan::get_id_az(FlowSide side) const
 {
   if (auto &agent_info = agent_info_[+side]; agent_info.has_value()) {
     // use ID and AZ obtained from this side's agent info
-    return std::make_tuple(agent_info->id, agent_info->az, false);
+    return std::make_tuple(std::string(agent_info->id.view()), agent_info->az, false);
   }
 
   std::string id;
-  std::string az = kUnknown;
+  InternedString az = intern(kUnknown);
   bool is_autonomous_system = false;
 
   FlowSide other_side = ~side;
@@ -527,15 +538,17 @@ std::tuple<std::string, std::string, bool> FlowSpan::get_id_az(FlowSide side) co
     // use the remote IP address from other side's socket info for ID
     id = socket_info->remote_addr.tidy_string();
 
-    if (auto &an_db = local_core<MatchingCore>().an_db; an_db) {
-      auto addr = reinterpret_cast<in6_addr const *>(&socket_info->remote_addr);
-      if (auto entry = an_db.lookup(addr)) {
-        is_autonomous_system = geoip::well_known_data::try_autonomous_system_organization(az, entry);
+    auto &core = local_core<MatchingCore>();
+    if (auto const &as_table = core.as_table) {
+      auto const organization = as_table->find(socket_info->remote_addr.as_int());
+      if (organization != geoip::as_prefix_table::no_organization) {
+        is_autonomous_system = true;
+        az = core.as_organization(organization);
       }
     }
   }
 
-  return std::make_tuple(id, az, is_autonomous_system);
+  return std::make_tuple(std::move(id), std::move(az), is_autonomous_system);
 }
 
 ::ebpf_net::matching::auto_handles::k8s_pod FlowSpan::get_k8s_pod(FlowSide side, ::ebpf_net::matching::Index &index)
@@ -558,7 +571,7 @@ std::tuple<std::string, std::string, bool> FlowSpan::get_id_az(FlowSide side) co
   }
 
   if (auto &task_info = task_info_[+side]; task_info.has_value()) {
-    auto info = CGroupParser{task_info->cgroup_name}.get();
+    auto info = CGroupParser{task_info->cgroup_name.view()}.get();
     auto container_id = info.container_id;
 
     if (!container_id.empty()) {
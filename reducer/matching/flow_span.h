@@ -11,11 +11,13 @@
 #include <generated/ebpf_net/matching/span_base.h>
 
 #include <util/ip_address.h>
+#include <util/string_interner.h>
 
 #include <array>
 #include <functional>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <tuple>
 
 namespace reducer::matching {
@@ -47,17 +49,21 @@ public:
   static void enable_aws_enrichment(bool enabled);
 
 private:
+  // Metadata strings repeat across most flows, so they're interned in the
+  // matching core's StringInterner rather than copied into every flow.
+  // Per-flow keys such as IP addresses and ids derived from them are nearly
+  // all unique, so they are kept as plain strings.
   struct AgentInfo {
-    std::string id;
-    std::string az;
-    std::string env;
-    std::string role;
-    std::string ns;
+    InternedString id;
+    InternedString az;
+    InternedString env;
+    InternedString role;
+    InternedString ns;
   };
 
   struct TaskInfo {
-    std::string comm;
-    std::string cgroup_name;
+    InternedString comm;
+    InternedString cgroup_name;
   };
 
   struct SocketInfo {
@@ -66,7 +72,7 @@ private:
     IPv6Address remote_addr;
     u16 remote_port = 0;
     u8 is_connector = 0;
-    std::string remote_dns_name;
+    InternedString remote_dns_name;
   };
 
   struct K8sInfo {
@@ -75,16 +81,16 @@ private:
   };
 
   struct ContainerInfo {
-    std::string name;
-    std::string pod;
-    std::string role;
-    std::string version;
-    std::string ns;
+    InternedString name;
+    InternedString pod;
+    InternedString role;
+    InternedString version;
+    InternedString ns;
     NodeResolutionType type = NodeResolutionType::CONTAINER;
   };
 
   struct ServiceInfo {
-    std::string name;
+    InternedString name;
   };
 
   struct AddrPort {
@@ -95,17 +101,17 @@ private:
   // Fully resolved node information.
   struct NodeData {
     std::string id;
-    std::string az;
-    std::string role;
-    std::string role_uid;
-    std::string version;
-    std::string env;
-    std::string ns;
+    InternedString az;
+    InternedString role;
+    InternedString role_uid;
+    InternedString version;
+    InternedString env;
+    InternedString ns;
     NodeResolutionType node_type;
     std::string address;
-    std::string comm;
-    std::string container_name;
-    std::string pod_name;
+    InternedString comm;
+    InternedString container_name;
+    InternedString pod_name;
   };
 
   std::array<std::optional<AgentInfo>, 2> agent_info_;
@@ -134,7 +140,7 @@ private:
   // Resolves all available information into full node data.
   NodeData resolve_node(::ebpf_net::matching::weak_refs::flow span_ref, FlowSide side);
 
-  std::string get_comm(FlowSide side) const;
+  InternedString const &get_comm(FlowSide side) const;
   std::optional<AddrPort> get_addr_port(FlowSide side) const;
 
   // Write out the entire state of this flow, preceded with the `reason` string.
@@ -143,7 +149,7 @@ private:
 
   // Returns the ID and AZ information for the specified side.
   // The third tuple element indicates whether this is an autonomous system.
-  std::tuple<std::string, std::string, bool> get_id_az(FlowSide side) const;
+  std::tuple<std::string, InternedString, bool> get_id_az(FlowSide side) const;
 
   // Returns the k8s_pod span of the process for the specified side, if any.
   ::ebpf_net::matching::auto_handles::k8s_pod get_k8s_pod(FlowSide side, ::ebpf_net::matching::Index &index);
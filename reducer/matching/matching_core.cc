@@ -26,20 +26,6 @@
 
 namespace reducer::matching {
 
-namespace {
-
-geoip::database make_geoip_db(std::optional<std::string> const &path)
-{
-  if (!path) {
-    // Return a no-op database object.
-    return geoip::database(std::nothrow, {});
-  }
-
-  return geoip::database(std::nothrow, path->c_str());
-}
-
-} // namespace
-
 bool MatchingCore::autonomous_system_ip_enabled_ = false;
 
 bool MatchingCore::autonomous_system_ip_enabled()
@@ -61,7 +47,7 @@ MatchingCore::MatchingCore(
     RpcQueueMatrix &ingest_to_matching_queues,
     RpcQueueMatrix &matching_to_aggregation_queues,
     RpcQueueMatrix &matching_to_logging_queues,
-    std::optional<std::string> geoip_path,
+    std::shared_ptr<geoip::as_prefix_table const> as_table,
     size_t shard_num,
     u64 initial_timestamp)
     : CoreBase(
@@ -72,14 +58,27 @@ MatchingCore::MatchingCore(
               shard_num, std::bind(&Core::current_timestamp, this)),
           matching_to_logging_queues.make_writers<ebpf_net::logging::Writer>(
               shard_num, std::bind(&Core::current_timestamp, this))),
-      an_db(make_geoip_db(geoip_path)),
+      as_table(std::move(as_table)),
       ingest_to_matching_stats_(shard_num, "ingest", "matching"),
       matching_to_aggregation_stats_(shard_num, "matching", "aggregation", matching_to_aggregation_queues),
       matching_to_logging_stats_(shard_num, "matching", "logging", matching_to_logging_queues),
       core_stats_(index_.core_stats.alloc()),
       logger_(index_.logger.alloc())
 {
-  add_rpc_clients(ingest_to_matching_queues.make_readers(shard_num), ClientType::ingest, ingest_to_matching_stats_);
+  add_rpc_clients(ingest_to_matching_queues, ClientType::ingest, ingest_to_matching_stats_);
+
+  if (this->as_table) {
+    as_organizations_.resize(this->as_table->organization_count());
+  }
+}
+
+InternedString const &MatchingCore::as_organization(geoip::as_prefix_table::organization_id id)
+{
+  auto &organization = as_organizations_[id];
+  if (organization.empty()) {
+    organization = strings.intern(as_table->organization(id));
+  }
+  return organization;
 }
 
 ebpf_net::matching::weak_refs::logger MatchingCore::logger()
@@ -7,11 +7,13 @@
 
 #include <reducer/core_base.h>
 
-#include <geoip/geoip.h>
+#include <geoip/as_prefix_table.h>
 #include <reducer/publisher.h>
 #include <reducer/rpc_stats.h>
 #include <reducer/tsdb_format.h>
 
+#include <util/string_interner.h>
+
 #include <generated/ebpf_net/logging/writer.h>
 #include <generated/ebpf_net/matching/connection.h>
 #include <generated/ebpf_net/matching/index.h>
@@ -20,6 +22,7 @@
 #include <generated/ebpf_net/matching/transform_builder.h>
 
 #include <memory>
+#include <vector>
 
 namespace reducer {
 class RpcQueueMatrix;
@@ -48,13 +51,22 @@ public:
   // Returns whether using IP addresses for autonomous systems is enabled.
   static bool autonomous_system_ip_enabled();
 
-  geoip::database an_db;
+  // Autonomous system organizations of IP addresses, compiled from the GeoIP
+  // database and shared by all matching cores. Null if there is no database.
+  std::shared_ptr<geoip::as_prefix_table const> const as_table;
+
+  // Interned flow metadata strings (roles, namespaces, AZs, ...), shared by all
+  // flows handled by this core.
+  StringInterner strings;
+
+  // Returns the interned name of an organization found in `as_table`.
+  InternedString const &as_organization(geoip::as_prefix_table::organization_id id);
 
   MatchingCore(
       RpcQueueMatrix &ingest_to_matching_queues,
       RpcQueueMatrix &matching_to_aggregation_queues,
       RpcQueueMatrix &matching_to_logging_queues,
-      std::optional<std::string> geoip_path,
+      std::shared_ptr<geoip::as_prefix_table const> as_table,
       size_t shard_num,
       u64 initial_timestamp);
 
@@ -65,6 +77,10 @@ private:
   // Flag indicating whether IP addresses should be used for autonomous systems.
   static bool autonomous_system_ip_enabled_;
 
+  // Names of `as_table` organizations interned in `strings`, by organization
+  // id, so each one is interned once rather than on every lookup.
+  std::vector<InternedString> as_organizations_;
+
   // Keeper of ingest->this RPC stats.
   RpcReceiverStats ingest_to_matching_stats_;
   // Keeper of this->aggregation RPC stats.
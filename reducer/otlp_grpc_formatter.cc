@@ -39,15 +39,19 @@ void OtlpGrpcFormatter::flush()
   }
 }
 
-void OtlpGrpcFormatter::rebuild_labels(labels_t const &labels)
+void OtlpGrpcFormatter::rebuild_labels(LabelSet const &labels)
 {
   labels_cache_.clear();
-  for (auto const &kv : labels) {
+  for (auto const &kv : labels.labels()) {
     ::Label l;
     l.key = ::rust::String(kv.first);
     l.value = ::rust::String(kv.second);
     labels_cache_.push_back(l);
   }
+  if (writer_) {
+    // Subsequent data points carry these labels until they change again.
+    writer_->rust_publisher().set_labels(labels_cache_);
+  }
 }
 
 void OtlpGrpcFormatter::format(
@@ -57,7 +61,7 @@ void OtlpGrpcFormatter::format(
     bool /*aggregation_changed*/,
     rollup_t /*rollup*/,
     bool /*rollup_changed*/,
-    labels_t labels,
+    LabelSet const &labels,
     bool labels_changed,
     timestamp_t timestamp,
     bool /*timestamp_changed*/,
@@ -80,16 +84,16 @@ void OtlpGrpcFormatter::format(
 
   std::visit(
       overloaded_visitor{
-          [&](u32 v) { rp.publish_metric_u64(name, unit, description, kind, labels_cache_, ts_ns, static_cast<uint64_t>(v)); },
-          [&](u64 v) { rp.publish_metric_u64(name, unit, description, kind, labels_cache_, ts_ns, v); },
-          [&](double v) { rp.publish_metric_f64(name, unit, description, kind, labels_cache_, ts_ns, v); },
+          [&](u32 v) { rp.publish_u64(name, unit, description, kind, ts_ns, static_cast<uint64_t>(v)); },
+          [&](u64 v) { rp.publish_u64(name, unit, description, kind, ts_ns, v); },
+          [&](double v) { rp.publish_f64(name, unit, description, kind, ts_ns, v); },
       },
       val);
 }
 
 void OtlpGrpcFormatter::format_flow_log(
     ebpf_net::metrics::tcp_metrics const &tcp_metrics,
-    labels_t labels,
+    LabelSet const &labels,
     bool labels_changed,
     timestamp_t timestamp,
     bool /*timestamp_changed*/)
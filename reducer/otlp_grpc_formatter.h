@@ -10,9 +10,6 @@
 
 #include <otlp_export_cxxbridge.h>
 
-// Retained for config compatibility; not used by Rust exporter.
-extern int global_otlp_grpc_batch_size;
-
 namespace reducer {
 
 // TsdbFormatter that calls into Rust OTLP exporter via cxx bridge
@@ -34,7 +31,7 @@ protected:
       bool aggregation_changed,
       rollup_t rollup,
       bool rollup_changed,
-      labels_t labels,
+      LabelSet const &labels,
       bool labels_changed,
       timestamp_t timestamp,
       bool timestamp_changed,
@@ -42,7 +39,7 @@ protected:
 
   void format_flow_log(
       ebpf_net::metrics::tcp_metrics const &tcp_metrics,
-      labels_t labels,
+      LabelSet const &labels,
       bool labels_changed,
       timestamp_t timestamp,
       bool timestamp_changed) override;
@@ -56,7 +53,7 @@ private:
 
   static bool metric_description_field_enabled_;
 
-  void rebuild_labels(labels_t const &labels);
+  void rebuild_labels(LabelSet const &labels);
 };
 
 } // namespace reducer
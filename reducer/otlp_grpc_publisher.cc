@@ -14,6 +14,23 @@ OtlpGrpcPublisher::OtlpGrpcPublisher(size_t /*num_writer_threads*/, const std::s
 
 OtlpGrpcPublisher::~OtlpGrpcPublisher() {}
 
+void OtlpGrpcPublisher::set_export_config(
+    u32 batch_size, u32 max_in_flight_requests, u64 max_queued_bytes, std::string_view overflow_policy)
+{
+  ::OtlpExportConfig config;
+  config.max_batch_points = batch_size;
+  config.max_in_flight_requests = max_in_flight_requests;
+  config.max_queued_bytes = max_queued_bytes;
+  if (overflow_policy == "drop-newest") {
+    config.overflow_policy = ::OtlpOverflowPolicy::DropNewest;
+  } else if (overflow_policy == "block") {
+    config.overflow_policy = ::OtlpOverflowPolicy::Block;
+  } else {
+    config.overflow_policy = ::OtlpOverflowPolicy::DropOldest;
+  }
+  ::otlp_set_export_config(config);
+}
+
 Publisher::WriterPtr OtlpGrpcPublisher::make_writer(size_t thread_num)
 {
   return std::make_unique<Writer>(thread_num, endpoint_);
@@ -38,7 +55,7 @@ void OtlpGrpcPublisher::Writer::flush()
 u64 OtlpGrpcPublisher::Writer::bytes_written() const
 {
   auto s = publisher_->stats();
-  return s.bytes_sent - s.bytes_failed;
+  return s.bytes_sent;
 }
 
 u64 OtlpGrpcPublisher::Writer::bytes_failed_to_write() const
@@ -60,6 +77,7 @@ void OtlpGrpcPublisher::Writer::write_internal_stats(
   stats.labels.client_type = "metrics";
   stats.metrics.bytes_failed = s.bytes_failed;
   stats.metrics.bytes_sent = s.bytes_sent;
+  stats.metrics.metrics_dropped = s.data_points_dropped;
   stats.metrics.metrics_failed = s.data_points_failed;
   stats.metrics.metrics_sent = s.data_points_sent;
   stats.metrics.requests_failed = s.requests_failed;
@@ -91,7 +109,8 @@ void OtlpGrpcPublisher::Writer::write_internal_stats_to_logging_core(
       s.requests_failed,
       s.requests_sent,
       s.unknown_response_tags,
-      time_ns);
+      time_ns,
+      s.data_points_dropped);
 
   agg_core_stats.agg_otlp_grpc_stats(
       jb_blob(module),
@@ -104,7 +123,8 @@ void OtlpGrpcPublisher::Writer::write_internal_stats_to_logging_core(
       s.requests_failed,
       s.requests_sent,
       s.unknown_response_tags,
-      time_ns);
+      time_ns,
+      s.data_points_dropped);
 }
 
 } // namespace reducer
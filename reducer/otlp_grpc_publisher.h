@@ -18,6 +18,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace reducer {
 
@@ -30,6 +31,11 @@ public:
   OtlpGrpcPublisher(size_t num_writer_threads, const std::string &endpoint);
   virtual ~OtlpGrpcPublisher();
 
+  // Configures the export pipeline of writers created afterwards: data points per request, requests in flight and
+  // bytes queued per writer, and what to do when the queue is full ("drop-newest", "drop-oldest" or "block").
+  static void set_export_config(
+      u32 batch_size, u32 max_in_flight_requests, u64 max_queued_bytes, std::string_view overflow_policy);
+
   virtual WriterPtr make_writer(size_t thread_num) override;
 
   virtual void write_internal_stats(InternalMetricsEncoder &encoder, u64 time_ns) const override;
@@ -62,6 +62,30 @@
   X(span_utilization_max,                0x0000'0020'0000'0000, INTERNAL_PREFIX "span_utilization_max") \
   X(time_since_last_message_ns,          0x0000'0040'0000'0000, INTERNAL_PREFIX "time_since_last_message_ns") \
   X(up,                                  0x0000'0080'0000'0000, INTERNAL_PREFIX "up") \
+  X(rpc_wakeups,                         0x0000'0100'0000'0000, INTERNAL_PREFIX "rpc_wakeups") \
+  X(rpc_spins,                           0x0000'0200'0000'0000, INTERNAL_PREFIX "rpc_spins") \
+  X(rpc_parks,                           0x0000'0400'0000'0000, INTERNAL_PREFIX "rpc_parks") \
+  X(ingest_worker_connections,           0x0000'0800'0000'0000, INTERNAL_PREFIX "ingest_worker.connections") \
+  X(ingest_worker_messages,              0x0000'1000'0000'0000, INTERNAL_PREFIX "ingest_worker.messages") \
+  X(ingest_worker_bytes,                 0x0000'2000'0000'0000, INTERNAL_PREFIX "ingest_worker.bytes") \
+  X(ingest_worker_utilization,           0x0000'4000'0000'0000, INTERNAL_PREFIX "ingest_worker.utilization") \
+  X(otlp_grpc_metrics_dropped,           0x0000'8000'0000'0000, INTERNAL_PREFIX "otlp_grpc.metrics_dropped") \
+  X(thread_numa_node,                    0x0001'0000'0000'0000, INTERNAL_PREFIX "thread_numa_node") \
+  X(thread_cpus,                         0x0002'0000'0000'0000, INTERNAL_PREFIX "thread_cpus") \
+  X(perf_ring_fill,                      0x0004'0000'0000'0000, INTERNAL_PREFIX "perf_ring.fill") \
+  X(perf_poll_timer,                     0x0008'0000'0000'0000, INTERNAL_PREFIX "perf_poll.timer") \
+  X(perf_poll_wakeups,                   0x0010'0000'0000'0000, INTERNAL_PREFIX "perf_poll.wakeups") \
+  X(perf_poll_early,                     0x0020'0000'0000'0000, INTERNAL_PREFIX "perf_poll.early") \
+  X(perf_poll_interval_ms,               0x0040'0000'0000'0000, INTERNAL_PREFIX "perf_poll.interval_ms") \
+  X(admission_deferred,                  0x0080'0000'0000'0000, INTERNAL_PREFIX "admission.deferred") \
+  X(admission_paced,                     0x0100'0000'0000'0000, INTERNAL_PREFIX "admission.paced") \
+  X(steady_state_collectors,             0x0200'0000'0000'0000, INTERNAL_PREFIX "steady_state.collectors") \
+  X(steady_state_mean_time_ms,           0x0400'0000'0000'0000, INTERNAL_PREFIX "steady_state.mean_time_ms") \
+  X(steady_state_max_time_ms,            0x0800'0000'0000'0000, INTERNAL_PREFIX "steady_state.max_time_ms") \
+  X(socket_resyncs,                      0x1000'0000'0000'0000, INTERNAL_PREFIX "socket_resync.count") \
+  X(socket_resync_mean_time_ms,          0x2000'0000'0000'0000, INTERNAL_PREFIX "socket_resync.mean_time_ms") \
+  X(socket_resync_max_time_ms,           0x4000'0000'0000'0000, INTERNAL_PREFIX "socket_resync.max_time_ms") \
+  X(socket_resync_sockets,               0x8000'0000'0000'0000, INTERNAL_PREFIX "socket_resync.sockets") \
   X(all,                                 0xFFFF'FFFF'FFFF'FFFF, INTERNAL_PREFIX "all")
 // clang-format on
 #define ENUM_DEFAULT unknown
@@ -25,20 +25,18 @@ protected:
       bool aggregation_changed,
       rollup_t rollup,
       bool rollup_changed,
-      labels_t labels,
+      LabelSet const &labels,
       bool labels_changed,
       timestamp_t timestamp,
       bool timestamp_changed,
       Publisher::WriterPtr const &writer) override;
 
 private:
-  // Large enough for all labels.
-  char labels_buf_[8192];
   // Large enough for value and timestamp.
   char suffix_buf_[64];
 
-  // Cached labels string, points to labels_buf_ when initialized.
-  std::string_view labels_;
+  // Sanitized metric name, reused between calls.
+  std::string metric_name_;
   // Cached textual representation of timestamp.
   std::string timestamp_str_;
 };
@@ -5,7 +5,10 @@
 
 #include <util/log.h>
 
+#include <zlib.h>
+
 #include <charconv>
+#include <limits>
 #include <optional>
 #include <string>
 
@@ -13,268 +16,164 @@ namespace reducer {
 
 namespace {
 
-static constexpr size_t chunk_buffer_size = (1 << 20);
-
 static constexpr char const *response_content_type = "text/plain;version=0.0.4";
 
-static const auto default_timeout = std::chrono::seconds(5);
-
-// Returns number of bytes read and an indication whether there is more
-// content in the queue to be read.
-std::pair<u32, bool> read_from_queue(ElementQueue &queue, char *buffer, u32 buffer_size)
+std::string gzip_compress(std::string_view input)
 {
-  u32 len = 0;
-  bool more = false;
+  z_stream stream{};
 
-  queue.start_read_batch();
+  // 16 added to the window bits selects the gzip wrapper
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return {};
+  }
 
-  while ((more = (queue.peek() > 0)) == true) {
-    if ((len + queue.peek()) > buffer_size) {
-      break; /* we've filled the buffer */
-    }
+  std::string output(deflateBound(&stream, input.size()), '\0');
+
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+  stream.avail_in = input.size();
+  stream.next_out = reinterpret_cast<Bytef *>(output.data());
+  stream.avail_out = output.size();
 
-    char *elem_buf = nullptr;
-    int elem_len = queue.read(elem_buf);
-    assert(elem_len >= 0);
+  int res = deflate(&stream, Z_FINISH);
+  output.resize(stream.total_out);
+  deflateEnd(&stream);
 
-    memcpy(buffer + len, elem_buf, elem_len);
-    len += elem_len;
+  if (res != Z_STREAM_END) {
+    return {};
   }
 
-  queue.finish_read_batch();
+  return output;
+}
 
-  return std::make_pair(len, more);
+bool accepts_gzip(CivetServer *server, mg_connection *conn)
+{
+  char const *hdr = server->getHeader(conn, "Accept-Encoding");
+  return (hdr != nullptr) && (std::string_view(hdr).find("gzip") != std::string_view::npos);
 }
 
 } // namespace
 
-PrometheusHandler::PrometheusHandler(
-    std::vector<ElementQueueStoragePtr> const &queues, std::optional<u64> scrape_size_limit_bytes)
-    : queue_mutex_(queues.size()), scrape_size_limit_bytes_(scrape_size_limit_bytes)
+std::string_view PrometheusSnapshot::content_gzip() const
 {
-  queues_.reserve(queues.size());
-  for (auto &queue_storage : queues) {
-    queues_.emplace_back(queue_storage);
-  }
+  std::call_once(gzip_once_, [this] { content_gzip_ = gzip_compress(content_); });
+  return content_gzip_;
 }
 
-std::optional<PrometheusHandler::timeout_t> PrometheusHandler::get_scrape_timeout(CivetServer *server, mg_connection *conn)
-{
-  char const *hdr = server->getHeader(conn, "X-Prometheus-Scrape-Timeout-Seconds");
-
-  if (hdr == nullptr) {
-    // not specified
-    return std::nullopt;
-  }
-
-  double seconds = atof(hdr);
+PrometheusHandler::PrometheusHandler(
+    std::vector<PrometheusSnapshotSlotPtr> const &slots, std::optional<u64> scrape_size_limit_bytes)
+    : slots_(slots), scrape_size_limit_bytes_(scrape_size_limit_bytes)
+{}
 
-  if (seconds <= 0) {
-    // invalid value
-    return std::nullopt;
+void PrometheusHandler::write_content_from_slots(CivetServer *server, mg_connection *conn)
+{
+  std::vector<PrometheusSnapshotPtr> snapshots;
+  snapshots.reserve(slots_.size());
+  for (auto const &slot : slots_) {
+    snapshots.push_back(slot->load());
   }
 
-  return std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(seconds * 1000));
+  write_snapshots(server, conn, snapshots);
 }
 
-void PrometheusHandler::write_content_from_queues(CivetServer *server, mg_connection *conn)
+void PrometheusHandler::write_content_from_slot(CivetServer *server, mg_connection *conn, size_t slot_num)
 {
-  // max duration of the request
-  timeout_t timeout = default_timeout;
-
-  if (auto scrape_timeout = get_scrape_timeout(server, conn); scrape_timeout) {
-    timeout = *scrape_timeout;
-
-    // leave some time for network
-    //
-    if (timeout > 1s) {
-      // trim half a second
-      timeout -= 500ms;
-    } else {
-      // halve the value
-      timeout /= 2;
-    }
-  }
-
-  // absolute time at which to finish sending
-  u64 timeout_ns = monotonic() + std::chrono::nanoseconds(timeout).count();
-
-  char chunk_buffer[chunk_buffer_size];
-  u32 chunk_len = 0;
-  u64 bytes_sent = 0;
-  bool error = false;
-
-  auto send_chunk = [&]() {
-    if (auto nsent = mg_send_chunk(conn, chunk_buffer, chunk_len); nsent > 0) {
-      bytes_sent += nsent;
-      chunk_len = 0;
-    } else {
-      error = true;
-    }
-  };
-
-  std::lock_guard<std::mutex> lock(handler_mutex_);
-
-  // start the response
-  if (mg_send_http_ok(conn, response_content_type, -1) == -1) {
-    ++num_failed_scrapes_;
-    return;
-  }
+  write_snapshots(server, conn, {slots_[slot_num]->load()});
+}
 
+void PrometheusHandler::write_snapshots(
+    CivetServer *server, mg_connection *conn, std::vector<PrometheusSnapshotPtr> const &snapshots)
+{
   u64 scrape_limit = scrape_size_limit_bytes_.value_or(std::numeric_limits<u64>::max());
 
-  // This will get set when a read from a queue can't be performed because
-  // the scrape size limit would be exceeded. In that case we will complete
-  // the request even if a read some other queue would succeed.
-  bool scrape_size_limited = false;
+  // Pieces of the response body. They point into the snapshots, and are sent
+  // one after the other without being copied into a response buffer.
+  std::vector<std::string_view> body;
+  u64 content_length = 0;
 
-  for (size_t i = 0; i < queues_.size(); ++i) {
-    if (error) {
-      break;
-    }
+  // Set when the scrape size limit cuts the content short.
+  bool truncated = false;
 
-    if (monotonic() >= timeout_ns) {
-      break;
+  for (auto const &snapshot : snapshots) {
+    if (!snapshot || snapshot->content().empty()) {
+      continue;
     }
 
-    if (scrape_size_limited) {
-      break;
-    }
+    auto content = snapshot->content();
 
-    if (bytes_sent >= scrape_limit) {
+    if (content.size() > scrape_limit - content_length) {
+      // Send only the lines that fit within the limit.
+      auto remaining = scrape_limit - content_length;
+      if (auto end = remaining > 0 ? content.rfind('\n', remaining - 1) : std::string_view::npos;
+          end != std::string_view::npos) {
+        body.push_back(content.substr(0, end + 1));
+        content_length += end + 1;
+      }
+      truncated = true;
       break;
     }
 
-    auto &queue = queues_[next_queue_];
-    next_queue_ = (next_queue_ + 1) % queues_.size();
+    body.push_back(content);
+    content_length += content.size();
+  }
 
-    bool more;
-    u32 repeat = 0;
-    do {
-      u64 scrape_remaining = scrape_limit - bytes_sent;
-      u64 chunk_remaining = chunk_buffer_size - chunk_len;
+  // A gzip stream can consist of multiple members, so the snapshots can be
+  // compressed independently of each other (and of the scrape), and the
+  // compressed form reused by every scrape.
+  bool gzip = !truncated && !body.empty() && accepts_gzip(server, conn);
 
-      u32 nread;
-      std::tie(nread, more) = read_from_queue(queue, chunk_buffer + chunk_len, std::min(chunk_remaining, scrape_remaining));
+  if (gzip) {
+    std::vector<std::string_view> compressed;
+    u64 compressed_length = 0;
 
-      if (nread > 0) {
-        // something was read and added to the chunk buffer
-        chunk_len += nread;
+    for (auto const &snapshot : snapshots) {
+      if (!snapshot || snapshot->content().empty()) {
+        continue;
       }
 
-      if (more) {
-        if (chunk_remaining < scrape_remaining) {
-          // There was more to read but didn't fit in the chunk buffer.
-          // We will flush the chunk buffer and try again.
-          send_chunk();
-        } else {
-          // There was more to read but it would go over the scrape size limit.
-          // Setting this flag will conclude this request.
-          scrape_size_limited = true;
-          break;
-        }
+      auto content_gzip = snapshot->content_gzip();
+      if (content_gzip.empty()) {
+        gzip = false;
+        break;
       }
 
-      // If there is more to read it is because there was not enough space in
-      // the chunk buffer. We will repeat the read -- only once, otherwise we
-      // can get into a race with the producer.
-    } while (more && !error && (bytes_sent < scrape_limit) && (repeat++ < 2));
-  }
-
-  if (!error && (chunk_len > 0)) {
-    // send what is left to send
-    send_chunk();
-  }
-
-  // terminating chunk
-  mg_send_chunk(conn, nullptr, 0);
-
-  bytes_served_ += bytes_sent;
-  if (error) {
-    ++num_failed_scrapes_;
-  }
-}
-
-void PrometheusHandler::write_content_from_queue(CivetServer *server, mg_connection *conn, size_t queue_num)
-{
-  // max duration of the request
-  timeout_t timeout = default_timeout;
-
-  if (auto scrape_timeout = get_scrape_timeout(server, conn); scrape_timeout) {
-    timeout = *scrape_timeout;
+      compressed.push_back(content_gzip);
+      compressed_length += content_gzip.size();
+    }
 
-    // leave some time for network
-    //
-    if (timeout > 1s) {
-      // trim half a second
-      timeout -= 500ms;
-    } else {
-      // halve the value
-      timeout /= 2;
+    if (gzip) {
+      body = std::move(compressed);
+      content_length = compressed_length;
     }
   }
 
-  // absolute time at which to finish sending
-  u64 timeout_ns = monotonic() + std::chrono::nanoseconds(timeout).count();
-
-  char chunk_buffer[chunk_buffer_size];
-  u64 bytes_sent = 0;
-  bool error = false;
-
-  std::lock_guard<std::mutex> lock(queue_mutex_[queue_num]);
-
-  auto &queue = queues_[queue_num];
-
-  // start the response
-  if (mg_send_http_ok(conn, response_content_type, -1) == -1) {
+  if (mg_printf(
+          conn,
+          "HTTP/1.1 200 OK\r\n"
+          "Content-Type: %s\r\n"
+          "%s"
+          "Content-Length: %llu\r\n"
+          "\r\n",
+          response_content_type,
+          gzip ? "Content-Encoding: gzip\r\n" : "",
+          static_cast<unsigned long long>(content_length)) <= 0) {
     ++num_failed_scrapes_;
     return;
   }
 
-  while (monotonic() < timeout_ns) {
-    u64 read_size = chunk_buffer_size;
-
-    if (scrape_size_limit_bytes_.has_value()) {
-      // Limit this read so the total number of bytes returned doesn't go
-      // over the scrape limit.
-      if (*scrape_size_limit_bytes_ > bytes_sent) {
-        read_size = std::min(chunk_buffer_size, *scrape_size_limit_bytes_ - bytes_sent);
-      } else {
-        // Already went over the limit. This can happen because mg_send_chunk
-        // is writing additional data (chunk headers, etc.)
-        break;
-      }
-    }
-
-    auto [nread, more] = read_from_queue(queue, chunk_buffer, read_size);
-
-    if (nread == 0) {
-      // nothing more to read from the queue
-      // assert(!more)
-      break;
-    }
-
-    // NOTE: mg_send_chunk doesn't do partial writes
-    auto nsent = mg_send_chunk(conn, chunk_buffer, nread);
+  u64 bytes_sent = 0;
+  bool error = false;
 
-    if (nsent > 0) {
+  for (auto piece : body) {
+    // NOTE: mg_write doesn't do partial writes
+    if (auto nsent = mg_write(conn, piece.data(), piece.size()); nsent > 0) {
       bytes_sent += nsent;
     } else {
       // zero signifies connection closed -- we count that also as failed write
       error = true;
       break;
     }
-
-    if (!more) {
-      // Exhausted the queue. We don't want to try to read again as that can get
-      // us into a race with the producer.
-      break;
-    }
   }
 
-  // terminating chunk
-  mg_send_chunk(conn, nullptr, 0);
-
   bytes_served_ += bytes_sent;
   if (error) {
     ++num_failed_scrapes_;
@@ -284,13 +183,13 @@ void PrometheusHandler::write_content_from_queue(CivetServer *server, mg_connect
 ////////////////////////////////////////////////////////////////////////////////
 
 PortRangePromHandler::PortRangePromHandler(
-    std::vector<ElementQueueStoragePtr> const &queues,
+    std::vector<PrometheusSnapshotSlotPtr> const &slots,
     std::optional<u64> scrape_size_limit_bytes,
     std::optional<u16> extra_ports_base)
-    : PrometheusHandler(queues, scrape_size_limit_bytes), extra_ports_base_(extra_ports_base)
+    : PrometheusHandler(slots, scrape_size_limit_bytes), extra_ports_base_(extra_ports_base)
 {}
 
-int PortRangePromHandler::choose_queue(CivetServer *server, mg_connection *conn)
+int PortRangePromHandler::choose_slot(CivetServer *server, mg_connection *conn)
 {
   std::string queue_query_parameter;
 
@@ -370,19 +269,19 @@ int PortRangePromHandler::choose_queue(CivetServer *server, mg_connection *conn)
 
 bool PortRangePromHandler::handleGet(CivetServer *server, mg_connection *conn)
 {
-  auto requested_queue = choose_queue(server, conn);
-  if (requested_queue < 0) {
+  auto requested_slot = choose_slot(server, conn);
+  if (requested_slot < 0) {
     // there was a failure, error already printed and error code sent.
     return true;
   }
 
-  if ((size_t)requested_queue >= num_queues()) {
+  if ((size_t)requested_slot >= num_slots()) {
     LOG::error("PrometheusHandler: invalid queue number");
     mg_printf(conn, "HTTP/1.1 400 Bad Request\r\n\r\n");
     return true;
   }
 
-  write_content_from_queue(server, conn, requested_queue);
+  write_content_from_slot(server, conn, requested_slot);
 
   return true;
 }
@@ -390,13 +289,13 @@ bool PortRangePromHandler::handleGet(CivetServer *server, mg_connection *conn)
 ////////////////////////////////////////////////////////////////////////////////
 
 SinglePortPromHandler::SinglePortPromHandler(
-    std::vector<ElementQueueStoragePtr> const &queues, std::optional<u64> scrape_size_limit_bytes)
-    : PrometheusHandler(queues, scrape_size_limit_bytes)
+    std::vector<PrometheusSnapshotSlotPtr> const &slots, std::optional<u64> scrape_size_limit_bytes)
+    : PrometheusHandler(slots, scrape_size_limit_bytes)
 {}
 
 bool SinglePortPromHandler::handleGet(CivetServer *server, mg_connection *conn)
 {
-  write_content_from_queues(server, conn);
+  write_content_from_slots(server, conn);
 
   return true;
 }
@@ -5,20 +5,72 @@
 
 #pragma once
 
-#include <util/element_queue_cpp.h>
+#include <platform/types.h>
 
 #include <CivetServer.h>
 
 #include <atomic>
-#include <chrono>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace reducer {
 
+// Scrape content published by one writer. Immutable once published, so any
+// number of scrapes can serve it at the same time.
+//
+class PrometheusSnapshot {
+public:
+  explicit PrometheusSnapshot(std::string content) : content_(std::move(content)) {}
+
+  // Content in the Prometheus text format.
+  std::string_view content() const { return content_; }
+
+  // Content compressed as a single gzip member. Compressed on first use, once
+  // per snapshot. Empty if compression failed.
+  std::string_view content_gzip() const;
+
+private:
+  std::string content_;
+
+  mutable std::once_flag gzip_once_;
+  mutable std::string content_gzip_;
+};
+
+using PrometheusSnapshotPtr = std::shared_ptr<PrometheusSnapshot const>;
+
+// Holds the latest snapshot published by a writer.
+//
+// The writer thread replaces the snapshot and HTTP threads take a reference
+// to it; the lock only covers swapping the pointer.
+//
+class PrometheusSnapshotSlot {
+public:
+  void store(PrometheusSnapshotPtr snapshot)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_.swap(snapshot);
+  }
+
+  PrometheusSnapshotPtr load() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot_;
+  }
+
+private:
+  mutable std::mutex mutex_;
+  PrometheusSnapshotPtr snapshot_;
+};
+
+using PrometheusSnapshotSlotPtr = std::shared_ptr<PrometheusSnapshotSlot>;
+
 class PrometheusHandler : public CivetHandler {
 public:
-  PrometheusHandler(std::vector<ElementQueueStoragePtr> const &queues, std::optional<u64> scrape_size_limit_bytes);
+  PrometheusHandler(std::vector<PrometheusSnapshotSlotPtr> const &slots, std::optional<u64> scrape_size_limit_bytes);
 
   // Number of bytes of content served by this handler.
   u64 bytes_served() const { return bytes_served_; };
@@ -26,29 +78,22 @@ public:
   // Number of times writing a response has failed.
   u64 num_failed_scrapes() const { return num_failed_scrapes_; }
 
-  // Number of queues this handler is reading from.
-  size_t num_queues() const { return queues_.size(); }
+  // Number of writers whose snapshots this handler is serving.
+  size_t num_slots() const { return slots_.size(); }
 
 protected:
-  using timeout_t = std::chrono::milliseconds;
-
-  // Returns the scrape timeout that is passed in the
-  // X-Prometheus-Scrape-Timeout-Seconds header.
-  std::optional<timeout_t> get_scrape_timeout(CivetServer *server, mg_connection *conn);
-
-  // Writes the content response by reading from all queues.
-  void write_content_from_queues(CivetServer *server, mg_connection *conn);
+  // Writes the content response from the latest snapshots of all writers.
+  void write_content_from_slots(CivetServer *server, mg_connection *conn);
 
-  // Writes the content response by reading from the specified queue.
-  void write_content_from_queue(CivetServer *server, mg_connection *conn, size_t queue_num);
+  // Writes the content response from the latest snapshot of the specified writer.
+  void write_content_from_slot(CivetServer *server, mg_connection *conn, size_t slot_num);
 
 private:
-  // Queues from which the content will be read from.
-  std::vector<ElementQueue> queues_;
-  // A mutex for each individual queue.
-  std::vector<std::mutex> queue_mutex_;
-  // This mutex needs to be locked when reading from multiple queues.
-  std::mutex handler_mutex_;
+  // Sends the snapshots as one response, gzip-compressed if the client accepts it.
+  void write_snapshots(CivetServer *server, mg_connection *conn, std::vector<PrometheusSnapshotPtr> const &snapshots);
+
+  // Slots holding the snapshots to serve, one per writer.
+  std::vector<PrometheusSnapshotSlotPtr> slots_;
 
   // Maximum number of bytes to return in one response.
   std::optional<u64> scrape_size_limit_bytes_;
@@ -57,24 +102,17 @@ private:
   std::atomic<u64> bytes_served_{0};
   // Number of times writing a response has failed.
   std::atomic<u64> num_failed_scrapes_{0};
-
-  // Next queue to be scraped.
-  //
-  // This is used in `write_content_from_queues()`, where reading from queues
-  // can be interrupted by timeout or scrape size limit. In such case, on the
-  // next scrape request it is important to start on the next queue in line.
-  size_t next_queue_{0};
 };
 
 // Prometheus handler for scraping on a port range.
 //
-// Each scrape port is associated with a single queue.
+// Each scrape port is associated with a single writer.
 // The port is obtained from the `Host` HTTP header.
 //
 class PortRangePromHandler : public PrometheusHandler {
 public:
   PortRangePromHandler(
-      std::vector<ElementQueueStoragePtr> const &queues,
+      std::vector<PrometheusSnapshotSlotPtr> const &slots,
       std::optional<u64> scrape_size_limit_bytes,
       std::optional<u16> extra_ports_base = std::nullopt);
 
@@ -82,17 +120,17 @@ private:
   std::optional<u16> extra_ports_base_;
   bool handleGet(CivetServer *server, mg_connection *conn) override;
 
-  // Decides which queue this request should service, and sends an error
-  // response if there is no valid queue communicated in the request.
-  // @returns a positive queue index, on success. Negative on failure.
-  int choose_queue(CivetServer *server, mg_connection *conn);
+  // Decides which writer's snapshot this request should be served, and sends
+  // an error response if there is no valid writer communicated in the request.
+  // @returns a positive slot index, on success. Negative on failure.
+  int choose_slot(CivetServer *server, mg_connection *conn);
 };
 
 // Prometheus handler for scraping on a single port.
 //
 class SinglePortPromHandler : public PrometheusHandler {
 public:
-  SinglePortPromHandler(std::vector<ElementQueueStoragePtr> const &queues, std::optional<u64> scrape_size_limit_bytes);
+  SinglePortPromHandler(std::vector<PrometheusSnapshotSlotPtr> const &slots, std::optional<u64> scrape_size_limit_bytes);
 
 private:
   bool handleGet(CivetServer *server, mg_connection *conn) override;
@@ -13,6 +13,7 @@
 
 #include <CivetServer.h>
 
+#include <sstream>
 #include <stdexcept>
 #include <string>
 
@@ -23,18 +24,14 @@ namespace {
 // 1MB upper limit
 constexpr std::streamoff UPPER_LIMIT = 1 * 1024 * 1024;
 
-std::vector<ElementQueueStoragePtr> make_queue_buffers(size_t n)
+std::vector<PrometheusSnapshotSlotPtr> make_snapshot_slots(size_t n)
 {
-  static constexpr u32 queue_n_elems = (1 << 19);
-  // Each element is 4 bytes
-  static constexpr u32 queue_buf_len = (queue_n_elems << 5);
-
   assert(n > 0);
 
-  std::vector<ElementQueueStoragePtr> result;
+  std::vector<PrometheusSnapshotSlotPtr> result;
 
   for (size_t i = 0; i < n; ++i) {
-    result.emplace_back(std::make_shared<MemElementQueueStorage>(queue_n_elems, queue_buf_len));
+    result.emplace_back(std::make_shared<PrometheusSnapshotSlot>());
   }
 
   return result;
@@ -75,8 +72,8 @@ PrometheusPublisher::PrometheusPublisher(
     std::string_view http_bind_addr,
     int http_num_threads,
     std::optional<u64> scrape_size_limit_bytes)
-    : queue_buffers_(make_queue_buffers(num_writer_threads)),
-      http_handler_(make_handler(handler_type, queue_buffers_, scrape_size_limit_bytes)),
+    : snapshot_slots_(make_snapshot_slots(num_writer_threads)),
+      http_handler_(make_handler(handler_type, snapshot_slots_, scrape_size_limit_bytes)),
       http_server_(make_http_server(http_bind_addr, http_num_threads))
 {
   http_server_->addHandler("", *http_handler_);
@@ -86,8 +83,8 @@ PrometheusPublisher::~PrometheusPublisher() {}
 
 Publisher::WriterPtr PrometheusPublisher::make_writer(size_t thread_num)
 {
-  assert(thread_num < queue_buffers_.size());
-  return std::make_unique<Writer>(queue_buffers_[thread_num]);
+  assert(thread_num < snapshot_slots_.size());
+  return std::make_unique<Writer>(snapshot_slots_[thread_num]);
 }
 
 u64 PrometheusPublisher::bytes_served() const
@@ -112,45 +109,13 @@ void PrometheusPublisher::write_internal_stats(InternalMetricsEncoder &encoder,
 // Writer
 //
 
-namespace {
-
-ssize_t write_to_queue(ElementQueue &write_queue, std::stringstream &ss)
-{
-  size_t len = ss.tellp();
-
-  // write msg to queue to be read by by prometheus handler
-  int res = eq_write(&write_queue, len);
-
-  if (res == -EINVAL) {
-    // attempted to write more than the queue size! This is never okay,
-    // and should never happen. In this catastrophic case, throw an
-    // exception so we can know about it and debug.
-    throw std::runtime_error("tried to write more than queue length");
-  }
-
-  if (res == -ENOSPC) {
-    // no space in the queue
-    return -1;
-  }
-
-  assert(res >= 0);
-
-  // if we reached here, can write the element to offset
-  ss.read((char *)write_queue.data + res, len);
-
-  return len;
-}
-
-} // namespace
-
-PrometheusPublisher::Writer::Writer(ElementQueueStoragePtr const &queue) : write_queue_(queue)
-{
-  write_queue_.start_write_batch();
-}
+PrometheusPublisher::Writer::Writer(PrometheusSnapshotSlotPtr slot) : slot_(std::move(slot)) {}
 
 PrometheusPublisher::Writer::~Writer()
 {
-  write_queue_.finish_write_batch();
+  if (slot_) {
+    flush();
+  }
 }
 
 void PrometheusPublisher::Writer::write(std::stringstream &stream)
@@ -171,42 +136,71 @@ void PrometheusPublisher::Writer::write(std::stringstream &stream)
     return;
   }
 
-  auto n = write_to_queue(write_queue_, stream);
+  size_t len = stream.tellp();
 
-  if (n < 0) {
-    bytes_failed_to_write_ += static_cast<u64>(static_cast<std::streamoff>(stream.tellp()));
-  } else {
-    bytes_written_ += n;
+  if (series_bytes_ + records_.size() + len > max_snapshot_bytes) {
+    bytes_failed_to_write_ += len;
+    return;
   }
+
+  size_t offset = records_.size();
+  records_.resize(offset + len);
+  stream.read(records_.data() + offset, len);
+
+  bytes_written_ += len;
 }
 
 void PrometheusPublisher::Writer::write(std::string_view prefix, std::string_view labels, std::string_view suffix)
 {
-  u32 len = prefix.size() + labels.size() + suffix.size();
-
-  int res = eq_write(&write_queue_, len);
+  u64 len = prefix.size() + labels.size() + suffix.size();
 
-  if (res == -EINVAL) {
-    throw std::runtime_error("tried to write more than queue length");
-  } else if (res == -ENOSPC) {
-    bytes_failed_to_write_ += len;
-    return;
-  }
-  assert(res >= 0);
+  key_.assign(prefix);
+  key_.append(labels);
 
-  char *cur = write_queue_.data + res;
+  if (auto it = series_.find(key_); it != series_.end()) {
+    auto &series = it->second;
+    series_bytes_ = series_bytes_ - series.sample.size() + suffix.size();
+    series.sample.assign(suffix);
+    series.generation = generation_;
+  } else {
+    if (series_bytes_ + records_.size() + len > max_snapshot_bytes) {
+      bytes_failed_to_write_ += len;
+      return;
+    }
 
-  memcpy(cur, prefix.data(), prefix.size());
-  memcpy(cur + prefix.size(), labels.data(), labels.size());
-  memcpy(cur + prefix.size() + labels.size(), suffix.data(), suffix.size());
+    series_.emplace(key_, Series{.sample = std::string(suffix), .generation = generation_});
+    series_bytes_ += len;
+  }
 
   bytes_written_ += len;
 }
 
 void PrometheusPublisher::Writer::flush()
 {
-  write_queue_.finish_write_batch();
-  write_queue_.start_write_batch();
+  // drop series that are no longer being written
+  for (auto it = series_.begin(); it != series_.end();) {
+    if (generation_ - it->second.generation >= series_ttl_flushes) {
+      series_bytes_ -= it->first.size() + it->second.sample.size();
+      it = series_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  std::string content;
+  content.reserve(series_bytes_ + records_.size());
+
+  for (auto const &[key, series] : series_) {
+    content.append(key);
+    content.append(series.sample);
+  }
+
+  content.append(records_);
+  records_.clear();
+
+  slot_->store(std::make_shared<PrometheusSnapshot>(std::move(content)));
+
+  ++generation_;
 }
 
 void PrometheusPublisher::Writer::write_internal_stats(
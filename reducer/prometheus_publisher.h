@@ -8,11 +8,12 @@
 #include "prometheus_handler.h"
 #include "publisher.h"
 
-#include <util/element_queue_cpp.h>
+#include <absl/container/btree_map.h>
 
 #include <iosfwd>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 class CivetServer;
@@ -27,11 +28,13 @@ class PrometheusHandler;
 // a HTTP server to serve requests.
 //
 // As publishing to Prometheus is usually done from multiple threads, this
-// class allows for it by keeping a queue for each publishing thread.
+// class allows for it by keeping a snapshot slot for each publishing thread.
 //
 // To write time-series data the |make_writer| method is first used.
 // It creates an object that exposes various writing functions.
-// Each such writer can only be used from a single thread.
+// Each such writer can only be used from a single thread. On every flush, the
+// writer renders the latest sample of each of its series into an immutable
+// snapshot, which is then served to every scrape until the next flush.
 //
 class PrometheusPublisher : public Publisher {
 public:
@@ -76,8 +79,8 @@ public:
   virtual void write_internal_stats(InternalMetricsEncoder &encoder, u64 time_ns) const override;
 
 private:
-  // Queue buffer for sending to prometheus handler.
-  std::vector<ElementQueueStoragePtr> queue_buffers_;
+  // Latest snapshot of each writer, served by the prometheus handler.
+  std::vector<PrometheusSnapshotSlotPtr> snapshot_slots_;
   // Handler for HTTP requests.
   std::unique_ptr<PrometheusHandler> http_handler_;
   // HTTP server for prometheus to query.
@@ -88,20 +91,28 @@ private:
 //
 class PrometheusPublisher::Writer : public Publisher::Writer {
 public:
-  Writer(ElementQueueStoragePtr const &queue);
+  // Series that haven't been written for this many flushes are dropped from
+  // snapshots (five minutes at the reducer's stats period).
+  static constexpr u64 series_ttl_flushes = 30;
+
+  // Maximum size of a snapshot.
+  static constexpr u64 max_snapshot_bytes = 16 * 1024 * 1024;
+
+  Writer(PrometheusSnapshotSlotPtr slot);
 
   Writer(Writer const &) = delete;
   Writer(Writer &&) = default;
 
   ~Writer();
 
-  // Writes provided stream's content.
+  // Writes provided stream's content. It is only included in the next snapshot.
   void write(std::stringstream &ss) override;
 
-  // Writes prefix, followed by labels, finished with suffix.
+  // Writes prefix, followed by labels, finished with suffix. Prefix and labels
+  // identify the series; the suffix replaces the series' previous sample.
   void write(std::string_view prefix, std::string_view labels, std::string_view suffix) override;
 
-  // Finishes this and starts a new batch.
+  // Publishes a snapshot of the series written so far.
   void flush() override;
 
   // Number of bytes successfully written.
@@ -114,7 +125,27 @@ public:
   void write_internal_stats(InternalMetricsEncoder &encoder, u64 time_ns, int shard, std::string_view module) const override;
 
 private:
-  ElementQueue write_queue_;
+  struct Series {
+    // Latest sample, i.e. the suffix of the last write.
+    std::string sample;
+    // Flush count at the time of the last write.
+    u64 generation;
+  };
+
+  PrometheusSnapshotSlotPtr slot_;
+
+  // Series keyed by prefix and labels, kept sorted so that the series of a
+  // metric are grouped together in snapshots.
+  absl::btree_map<std::string, Series> series_;
+  // Size of all the series' content.
+  u64 series_bytes_{0};
+  // Number of flushes so far.
+  u64 generation_{0};
+  // Scratch buffer for series keys.
+  std::string key_;
+  // Content written as streams since the last flush.
+  std::string records_;
+
   u64 bytes_written_{0};
   u64 bytes_failed_to_write_{0};
 
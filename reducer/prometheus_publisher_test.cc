@@ -0,0 +1,122 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "prometheus_publisher.h"
+
+#include <gtest/gtest.h>
+
+#include <zlib.h>
+
+namespace reducer {
+
+namespace {
+
+std::string snapshot_content(PrometheusSnapshotSlot const &slot)
+{
+  auto snapshot = slot.load();
+  return snapshot ? std::string(snapshot->content()) : std::string();
+}
+
+std::string gunzip(std::string_view input)
+{
+  z_stream stream{};
+  EXPECT_EQ(inflateInit2(&stream, 15 + 16), Z_OK);
+
+  std::string output(1 << 16, '\0');
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+  stream.avail_in = input.size();
+  stream.next_out = reinterpret_cast<Bytef *>(output.data());
+  stream.avail_out = output.size();
+
+  EXPECT_EQ(inflate(&stream, Z_FINISH), Z_STREAM_END);
+  output.resize(stream.total_out);
+  inflateEnd(&stream);
+
+  return output;
+}
+
+} // namespace
+
+TEST(PrometheusPublisherTest, SnapshotHoldsLatestSampleOfEachSeries)
+{
+  auto slot = std::make_shared<PrometheusSnapshotSlot>();
+  PrometheusPublisher::Writer writer(slot);
+
+  writer.write("b_metric", "{x=\"1\"}", " 1 1000\n");
+  writer.write("a_metric", "{x=\"1\"}", " 2 1000\n");
+  writer.write("b_metric", "{x=\"2\"}", " 3 1000\n");
+
+  EXPECT_EQ(slot->load(), nullptr);
+
+  writer.flush();
+  EXPECT_EQ(
+      snapshot_content(*slot),
+      "a_metric{x=\"1\"} 2 1000\n"
+      "b_metric{x=\"1\"} 1 1000\n"
+      "b_metric{x=\"2\"} 3 1000\n");
+
+  writer.write("b_metric", "{x=\"1\"}", " 10 2000\n");
+  writer.flush();
+  EXPECT_EQ(
+      snapshot_content(*slot),
+      "a_metric{x=\"1\"} 2 1000\n"
+      "b_metric{x=\"1\"} 10 2000\n"
+      "b_metric{x=\"2\"} 3 1000\n");
+}
+
+TEST(PrometheusPublisherTest, SnapshotsAreImmutable)
+{
+  auto slot = std::make_shared<PrometheusSnapshotSlot>();
+  PrometheusPublisher::Writer writer(slot);
+
+  writer.write("metric", "{}", " 1 1000\n");
+  writer.flush();
+  auto first = slot->load();
+
+  writer.write("metric", "{}", " 2 2000\n");
+  writer.flush();
+
+  EXPECT_EQ(first->content(), "metric{} 1 1000\n");
+  EXPECT_EQ(snapshot_content(*slot), "metric{} 2 2000\n");
+}
+
+TEST(PrometheusPublisherTest, SeriesExpireWhenNoLongerWritten)
+{
+  auto slot = std::make_shared<PrometheusSnapshotSlot>();
+  PrometheusPublisher::Writer writer(slot);
+
+  writer.write("gone", "{}", " 1 1000\n");
+  writer.flush();
+
+  for (u64 i = 1; i < PrometheusPublisher::Writer::series_ttl_flushes; ++i) {
+    writer.write("kept", "{}", " 1 1000\n");
+    writer.flush();
+    EXPECT_NE(snapshot_content(*slot).find("gone"), std::string::npos);
+  }
+
+  writer.write("kept", "{}", " 1 1000\n");
+  writer.flush();
+  EXPECT_EQ(snapshot_content(*slot), "kept{} 1 1000\n");
+}
+
+TEST(PrometheusPublisherTest, GzipContentMatchesContent)
+{
+  auto slot = std::make_shared<PrometheusSnapshotSlot>();
+  PrometheusPublisher::Writer writer(slot);
+
+  for (int i = 0; i < 100; ++i) {
+    writer.write("metric", "{i=\"" + std::to_string(i) + "\"}", " 1 1000\n");
+  }
+  writer.flush();
+
+  auto snapshot = slot->load();
+  auto content_gzip = snapshot->content_gzip();
+  ASSERT_FALSE(content_gzip.empty());
+  EXPECT_LT(content_gzip.size(), snapshot->content().size());
+  EXPECT_EQ(gunzip(content_gzip), snapshot->content());
+
+  // computed once per snapshot
+  EXPECT_EQ(snapshot->content_gzip().data(), content_gzip.data());
+}
+
+} // namespace reducer
@@ -23,16 +23,21 @@
 #include <geoip/geoip.h>
 
 #include <util/boot_time.h>
+#include <util/cpu_topology.h>
 #include <util/debug.h>
 #include <util/environment_variables.h>
 #include <util/error_handling.h>
 #include <util/file_ops.h>
 #include <util/log.h>
+#include <util/string.h>
+#include <util/string_view.h>
 #include <util/uv_helpers.h>
 
 #include <spdlog/fmt/chrono.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
 #include <ctime>
 #include <filesystem>
 #include <iomanip>
@@ -42,15 +47,80 @@
 
 namespace reducer {
 
+namespace {
+
+// Applies a comma-separated list of span=capacity entries to the growable span
+// pools of every app that has a span type by that name.
+void set_span_pool_capacities(std::string_view spec)
+{
+  while (!spec.empty()) {
+    auto entry = views::trim_ws(views::trim_up_to(spec, ',', views::SeekBehavior::CONSUME));
+    if (entry.empty()) {
+      continue;
+    }
+
+    auto value = entry;
+    auto const span_name = views::trim_ws(views::trim_up_to(value, '=', views::SeekBehavior::CONSUME));
+
+    std::size_t capacity = 0;
+    if (span_name.empty() || !integer_from_string(std::string(views::trim_ws(value)).c_str(), capacity)) {
+      LOG::error("Invalid span pool capacity '{}', expected span=capacity", entry);
+      continue;
+    }
+
+    bool found = false;
+    found |= ebpf_net::ingest::Index::set_pool_capacity(span_name, capacity);
+    found |= ebpf_net::matching::Index::set_pool_capacity(span_name, capacity);
+    found |= ebpf_net::aggregation::Index::set_pool_capacity(span_name, capacity);
+    found |= ebpf_net::logging::Index::set_pool_capacity(span_name, capacity);
+
+    if (found) {
+      LOG::info("Span pool capacity for '{}' set to {}", span_name, capacity);
+    } else {
+      LOG::warn("No growable span pool named '{}'", span_name);
+    }
+  }
+}
+
+// Decides where shard threads run, according to the configured policy.
+ThreadPlacement make_thread_placement(ReducerConfig const &config)
+{
+  auto const policy = ThreadPlacement::parse_policy(config.thread_placement);
+  if (!policy) {
+    LOG::error("Invalid thread placement policy '{}', threads will not be placed", config.thread_placement);
+    return {};
+  }
+
+  if (*policy == ThreadPlacement::Policy::none) {
+    return {};
+  }
+
+  auto const topology = detect_cpu_topology();
+  LOG::info(
+      "Placing threads with the '{}' policy on {} NUMA node(s) with {} CPU(s)",
+      config.thread_placement,
+      topology.nodes.size(),
+      topology.num_cpus());
+
+  return ThreadPlacement(
+      *policy, topology, config.num_ingest_shards, config.num_matching_shards, config.num_aggregation_shards);
+}
+
+} // namespace
+
 Reducer::Reducer(uv_loop_t &loop, ReducerConfig &config)
     : loop_(loop),
       config_(config),
-      ingest_to_matching_queues_(config_.num_ingest_shards, config_.num_matching_shards),
-      ingest_to_logging_queues_(config_.num_ingest_shards, 1),
-      matching_to_logging_queues_(config_.num_matching_shards, 1),
-      matching_to_aggregation_queues_(config_.num_matching_shards, config_.num_aggregation_shards),
-      aggregation_to_logging_queues_(config_.num_aggregation_shards, 1)
-{}
+      placement_(make_thread_placement(config_)),
+      ingest_to_matching_queues_(config_.num_ingest_shards, placement_.nodes("matching", config_.num_matching_shards)),
+      ingest_to_logging_queues_(config_.num_ingest_shards, placement_.nodes("logging", 1)),
+      matching_to_logging_queues_(config_.num_matching_shards, placement_.nodes("logging", 1)),
+      matching_to_aggregation_queues_(
+          config_.num_matching_shards, placement_.nodes("aggregation", config_.num_aggregation_shards)),
+      aggregation_to_logging_queues_(config_.num_aggregation_shards, placement_.nodes("logging", 1))
+{
+  ThreadPlacement::set_global(placement_);
+}
 
 void Reducer::startup()
 {
@@ -100,22 +170,44 @@ void Reducer::init_config()
 
   reducer::logging::LoggingCore::set_otlp_formatted_internal_metrics_enabled(config_.enable_otlp_grpc_metrics);
   reducer::OtlpGrpcFormatter::set_metric_description_field_enabled(config_.enable_otlp_grpc_metric_descriptions);
+  reducer::OtlpGrpcPublisher::set_export_config(
+      std::max(config_.otlp_grpc_batch_size, 1),
+      config_.otlp_grpc_max_in_flight_requests,
+      config_.otlp_grpc_max_queued_bytes,
+      config_.otlp_grpc_overflow_policy);
 
   reducer::aggregation::AggCore::set_node_ip_field_disabled(config_.disable_node_ip_field);
   reducer::matching::MatchingCore::set_autonomous_system_ip_enabled(config_.enable_autonomous_system_ip);
 
+  reducer::Core::set_rpc_notify_enabled(!config_.disable_rpc_notify);
+  reducer::Core::set_rpc_spin_duration(std::chrono::microseconds{config_.rpc_spin_us});
+
+  reducer::ingest::IngestCore::set_admission_limits(config_.ingest_max_connection_rate, config_.ingest_max_byte_rate);
+
+  set_span_pool_capacities(config_.span_pool_capacity);
+
   // If the path to a GeoIP database is defined, try loading the database here
   // and print an error message if it fails.
-  // Unfortunately, the database structure is not thread safe and is not
-  // cloneable, so each matching shard will have to load it again for itself.
+  // The database structure is not thread safe, so rather than having each
+  // matching shard load it, it is compiled once into an immutable in-memory
+  // table which all matching shards share.
   //
   if (config_.geoip_path) {
     try {
+      auto const start = std::chrono::steady_clock::now();
       geoip::database geoip_db(config_.geoip_path->c_str());
-      LOG::info("Loaded GeoIP database from '{}'.", *config_.geoip_path);
+      as_table_ = std::make_shared<geoip::as_prefix_table const>(geoip_db.compile_as_table());
+      std::chrono::duration<double, std::milli> const elapsed = std::chrono::steady_clock::now() - start;
+      LOG::info(
+          "Loaded GeoIP database from '{}': {} organizations in {} address ranges, {} KiB, compiled in {:.1f}ms.",
+          *config_.geoip_path,
+          as_table_->organization_count(),
+          as_table_->range_count(),
+          as_table_->memory_usage() / 1024,
+          elapsed.count());
     } catch (std::exception &exc) {
       LOG::error("Failed to load GeoIP database from '{}': {}.", *config_.geoip_path, exc.what());
-      config_.geoip_path.reset(); // so matching shards don't try loading it for naught
+      as_table_.reset();
     }
   }
 
@@ -214,7 +306,7 @@ void Reducer::init_cores()
         ingest_to_matching_queues_,
         matching_to_aggregation_queues_,
         matching_to_logging_queues_,
-        config_.geoip_path,
+        as_table_,
         shard,
         initial_timestamp);
     matching_core->set_connection_authenticated();
@@ -224,6 +316,14 @@ void Reducer::init_cores()
   ingest_core_ = std::make_unique<reducer::ingest::IngestCore>(
       ingest_to_logging_queues_, ingest_to_matching_queues_, config_.telemetry_port);
 
+  logging_core_->add_monitored_core(*logging_core_);
+  for (auto &agg_core : agg_cores_) {
+    logging_core_->add_monitored_core(*agg_core);
+  }
+  for (auto &matching_core : matching_cores_) {
+    logging_core_->add_monitored_core(*matching_core);
+  }
+
   // all writers created
   ASSUME(stat_writer_num == num_stat_writers);
 }
@@ -12,7 +12,9 @@
 #include <reducer/publisher.h>
 #include <reducer/reducer_config.h>
 #include <reducer/rpc_queue_matrix.h>
+#include <reducer/thread_placement.h>
 
+#include <memory>
 #include <thread>
 
 namespace reducer {
@@ -34,6 +36,13 @@ private:
 
   std::unique_ptr<reducer::Publisher> stats_publisher_;
 
+  // Compiled from the GeoIP database, if any, and shared by matching cores.
+  std::shared_ptr<geoip::as_prefix_table const> as_table_;
+
+  // Where shard threads run, and where their RPC queues live.
+  // NOTE: must be initialized before the queues.
+  reducer::ThreadPlacement placement_;
+
   reducer::RpcQueueMatrix ingest_to_matching_queues_;
   reducer::RpcQueueMatrix ingest_to_logging_queues_;
   reducer::RpcQueueMatrix matching_to_logging_queues_;
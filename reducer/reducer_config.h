@@ -31,6 +31,9 @@ struct ReducerConfig {
   std::string otlp_grpc_metrics_address;
   u32 otlp_grpc_metrics_port = 0;
   int otlp_grpc_batch_size = 0;
+  u32 otlp_grpc_max_in_flight_requests = 4;
+  u64 otlp_grpc_max_queued_bytes = 64 * 1024 * 1024;
+  std::string otlp_grpc_overflow_policy = "drop-oldest";
   bool enable_otlp_grpc_metric_descriptions = false;
 
   bool disable_prometheus_metrics = false;
@@ -53,6 +56,19 @@ struct ReducerConfig {
   std::string enable_metrics;
 
   u64 index_dump_interval = 0;
+
+  bool disable_rpc_notify = false;
+  u32 rpc_spin_us = 0;
+
+  // Admission control of collector connections, per second (0 => unlimited).
+  u32 ingest_max_connection_rate = 0;
+  u64 ingest_max_byte_rate = 0;
+
+  // Thread placement policy: "none", "numa" or "cpu".
+  std::string thread_placement = "none";
+
+  // Comma-separated list of span=capacity overrides for growable span pools.
+  std::string span_pool_capacity;
 };
 
 // No defaults defined here; defaults live in Rust layer.
@@ -23,6 +23,9 @@ template <typename Out> Out &&operator<<(Out &&out, ReducerConfig const &config)
       << "otlp_grpc_metrics_address: " << config.otlp_grpc_metrics_address << "\n"
       << "otlp_grpc_metrics_port: " << config.otlp_grpc_metrics_port << "\n"
       << "otlp_grpc_batch_size: " << config.otlp_grpc_batch_size << "\n"
+      << "otlp_grpc_max_in_flight_requests: " << config.otlp_grpc_max_in_flight_requests << "\n"
+      << "otlp_grpc_max_queued_bytes: " << config.otlp_grpc_max_queued_bytes << "\n"
+      << "otlp_grpc_overflow_policy: " << config.otlp_grpc_overflow_policy << "\n"
       << "enable_otlp_grpc_metric_descriptions: " << config.enable_otlp_grpc_metric_descriptions << "\n"
       << "disable_prometheus_metrics: " << config.disable_prometheus_metrics << "\n"
       << "shard_prometheus_metrics: " << config.shard_prometheus_metrics << "\n"
@@ -49,7 +52,13 @@ template <typename Out> Out &&operator<<(Out &&out, ReducerConfig const &config)
       << "enable_percentile_latencies: " << config.enable_percentile_latencies << "\n"
       << "disable_metrics: " << config.disable_metrics << "\n"
       << "enable_metrics: " << config.enable_metrics << "\n"
-      << "index_dump_interval: " << config.index_dump_interval << "\n";
+      << "index_dump_interval: " << config.index_dump_interval << "\n"
+      << "disable_rpc_notify: " << config.disable_rpc_notify << "\n"
+      << "rpc_spin_us: " << config.rpc_spin_us << "\n"
+      << "ingest_max_connection_rate: " << config.ingest_max_connection_rate << "\n"
+      << "ingest_max_byte_rate: " << config.ingest_max_byte_rate << "\n"
+      << "thread_placement: " << config.thread_placement << "\n"
+      << "span_pool_capacity: " << config.span_pool_capacity << "\n";
 
   return std::forward<Out>(out);
 }
@@ -5,11 +5,18 @@
 
 #pragma once
 
+#include <util/cpu_topology.h>
+#include <util/doorbell.h>
 #include <util/element_queue_cpp.h>
 #include <util/element_queue_writer.h>
 
+#include <unistd.h>
+
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace reducer {
@@ -31,14 +38,37 @@ public:
       size_t num_receivers,
       u32 queue_n_elems = default_queue_n_elems,
       u32 queue_buf_len = default_queue_buf_len)
-      : num_senders_(num_senders), num_receivers_(num_receivers)
+      : RpcQueueMatrix(num_senders, std::vector<int>(num_receivers, -1), queue_n_elems, queue_buf_len)
+  {}
+
+  // Constructs the object for |num_senders| senders and as many receivers as
+  // there are entries in |receiver_nodes|.
+  //
+  // Memory of each receiver's queues is allocated on the NUMA node given for
+  // that receiver, so that the receiver reads from local memory. A negative
+  // node leaves the placement to the kernel.
+  //
+  RpcQueueMatrix(
+      size_t num_senders,
+      std::vector<int> const &receiver_nodes,
+      u32 queue_n_elems = default_queue_n_elems,
+      u32 queue_buf_len = default_queue_buf_len)
+      : num_senders_(num_senders), num_receivers_(receiver_nodes.size())
   {
+    size_t const num_receivers = num_receivers_;
     size_t const num_entries = num_receivers * num_senders;
 
+    doorbells_.reserve(num_receivers);
+    for (size_t i = 0; i < num_receivers; ++i) {
+      doorbells_.emplace_back(std::make_unique<Doorbell>());
+    }
+
     entries_.reserve(num_entries);
 
     for (size_t i = 0; i < num_entries; ++i) {
-      entries_.emplace_back(make_storage(queue_n_elems, queue_buf_len));
+      // receiver-major ordering, see make_readers()
+      entries_.emplace_back(
+          make_storage(queue_n_elems, queue_buf_len, receiver_nodes[i / num_senders]), doorbells_[i / num_senders].get());
     }
   }
 
@@ -91,6 +121,17 @@ public:
     return writers;
   }
 
+  // Returns the doorbell shared by all queues of the specified receiver.
+  //
+  // Writers ring it whenever they publish messages, so a receiver that parked
+  // itself waiting for messages can be woken up.
+  //
+  Doorbell &doorbell(size_t receiver)
+  {
+    assert(receiver < num_receivers_);
+    return *doorbells_[receiver];
+  }
+
   // Returns the number of senders this matrix is constructed for.
   size_t num_senders() const { return num_senders_; }
   // Returns the number of receivers this matrix is constructed for.
@@ -103,16 +144,47 @@ private:
     ElementQueue writer_queue;
     ElementQueueWriter queue_writer;
 
-    Entry(ElementQueueStoragePtr s) : storage(s), writer_queue(storage), queue_writer(writer_queue) {}
+    Entry(ElementQueueStoragePtr s, Doorbell *doorbell)
+        : storage(s), writer_queue(storage), queue_writer(writer_queue, doorbell)
+    {}
   };
 
   size_t num_senders_;
   size_t num_receivers_;
 
+  // One doorbell per receiver.
+  std::vector<std::unique_ptr<Doorbell>> doorbells_;
+
   std::vector<Entry> entries_;
 
-  static ElementQueueStoragePtr make_storage(u32 num_elems, u32 buf_len)
+  // Queue storage whose pages are allocated on a specific NUMA node.
+  class NodeLocalStorage : public ElementQueueStorage {
+  public:
+    NodeLocalStorage(u32 n_elems, u32 buf_len, int node) : ElementQueueStorage(n_elems, buf_len)
+    {
+      size_t const page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      size_t const size = (eq_contig_size(n_elems, buf_len) + page_size - 1) & ~(page_size - 1);
+
+      data_ = (char *)aligned_alloc(page_size, size);
+      if (data_ == NULL)
+        throw std::runtime_error("Unable to allocate memory for element queue");
+
+      // must come before the pages are first touched; if it fails, the pages
+      // simply end up wherever the kernel puts them
+      prefer_numa_node(data_, size, node);
+
+      memset(data_, 0, size);
+      eq_init_shared((element_queue_shared *)data_);
+    }
+
+    ~NodeLocalStorage() override { free(data_); }
+  };
+
+  static ElementQueueStoragePtr make_storage(u32 num_elems, u32 buf_len, int node)
   {
+    if (node >= 0) {
+      return std::make_shared<NodeLocalStorage>(num_elems, buf_len, node);
+    }
     return std::make_shared<MemElementQueueStorage>(num_elems, buf_len);
   }
 };
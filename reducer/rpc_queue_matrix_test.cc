@@ -106,5 +106,41 @@ TEST(RpcQueueMatrixTest, TestMessaging)
   }
 }
 
+TEST(RpcQueueMatrixTest, TestNodeLocalMessaging)
+{
+  size_t const num_senders = 2;
+  std::vector<int> const receiver_nodes = {0, -1};
+
+  RpcQueueMatrix queues(num_senders, receiver_nodes);
+
+  for (size_t s = 0; s < num_senders; ++s) {
+    std::vector<Writer> writers = queues.make_writers<Writer>(s);
+
+    EXPECT_EQ(writers.size(), receiver_nodes.size());
+
+    for (size_t r = 0; r < receiver_nodes.size(); ++r) {
+      std::string msg = make_msg(s, r);
+      writers[r].write(msg.c_str(), msg.size());
+    }
+  }
+
+  for (size_t r = 0; r < receiver_nodes.size(); ++r) {
+    std::vector<ElementQueue> readers = queues.make_readers(r);
+
+    for (size_t s = 0; s < num_senders; ++s) {
+      ElementQueue &reader = readers[s];
+      reader.start_read_batch();
+
+      char *buf = nullptr;
+      int len = reader.read(buf);
+
+      EXPECT_THAT(buf, NotNull());
+      EXPECT_EQ(std::string(buf, len), make_msg(s, r));
+
+      reader.finish_read_batch();
+    }
+  }
+}
+
 } // namespace
 } // namespace reducer
@@ -26,8 +26,8 @@ void RpcSenderStats::check_utilization()
   for (auto &writer_ref : writers_) {
     ElementQueue const &queue = writer_ref.get().queue();
 
-    u32 buf_used = queue.buf_used();
-    u32 elem_count = queue.elem_count();
+    u32 buf_used = queue.writer_buf_used();
+    u32 elem_count = queue.writer_elem_count();
 
     double buf_util = buf_used / (double)queue.buf_capacity();
     double elem_util = elem_count / (double)queue.elem_capacity();
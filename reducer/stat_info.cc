@@ -7,6 +7,7 @@ namespace {
 
 static constexpr std::string_view UNIT_BYTES = "By";
 static constexpr std::string_view UNIT_MICROSECONDS = "us";
+static constexpr std::string_view UNIT_MILLISECONDS = "ms";
 static constexpr std::string_view UNIT_DIMENSIONLESS = "1";
 
 } // namespace
@@ -191,6 +192,11 @@ EbpfNetMetricInfo EbpfNetMetricInfo::clock_offset_ns{
     " some description.",
     UNIT_DIMENSIONLESS};
 
+EbpfNetMetricInfo EbpfNetMetricInfo::otlp_grpc_metrics_dropped{
+    EbpfNetMetrics::otlp_grpc_metrics_dropped,
+    "Number of OTLP grpc metrics dropped because the export queue was full.",
+    UNIT_DIMENSIONLESS};
+
 EbpfNetMetricInfo EbpfNetMetricInfo::otlp_grpc_metrics_failed{
     EbpfNetMetrics::otlp_grpc_metrics_failed,
     " some definitions"
@@ -256,4 +262,109 @@ EbpfNetMetricInfo EbpfNetMetricInfo::rpc_write_stalls{
     " some definitions"
     " some description.",
     UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::rpc_wakeups{
+    EbpfNetMetrics::rpc_wakeups,
+    "Number of times a parked core was woken up by an RPC sender.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::rpc_spins{
+    EbpfNetMetrics::rpc_spins,
+    "Number of times a core polled its RPC queues without finding any message to handle.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::rpc_parks{
+    EbpfNetMetrics::rpc_parks,
+    "Number of times a core parked itself waiting for RPC messages.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::ingest_worker_connections{
+    EbpfNetMetrics::ingest_worker_connections,
+    "Number of collector connections open on an ingest shard.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::ingest_worker_messages{
+    EbpfNetMetrics::ingest_worker_messages,
+    "Number of collector messages handled by an ingest shard since the previous report.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::ingest_worker_bytes{
+    EbpfNetMetrics::ingest_worker_bytes,
+    "Number of (uncompressed) collector bytes handled by an ingest shard since the previous report.",
+    UNIT_BYTES};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::ingest_worker_utilization{
+    EbpfNetMetrics::ingest_worker_utilization,
+    "Fraction of time an ingest shard spent handling collector data since the previous report.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::thread_numa_node{
+    EbpfNetMetrics::thread_numa_node, "NUMA node a reducer shard's thread is placed on.", UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::thread_cpus{
+    EbpfNetMetrics::thread_cpus, "Number of CPUs a reducer shard's thread is allowed to run on.", UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::perf_ring_fill{
+    EbpfNetMetrics::perf_ring_fill,
+    "Number of times a kernel collector perf ring was found within a range of fill levels when polled.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::perf_poll_timer{
+    EbpfNetMetrics::perf_poll_timer,
+    "Number of times a kernel collector polled its perf rings on its polling timer.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::perf_poll_wakeups{
+    EbpfNetMetrics::perf_poll_wakeups,
+    "Number of times the kernel woke up a kernel collector to poll its perf rings.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::perf_poll_early{
+    EbpfNetMetrics::perf_poll_early,
+    "Number of times a kernel collector polled its perf rings again right away because one was nearly full.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::perf_poll_interval_ms{
+    EbpfNetMetrics::perf_poll_interval_ms,
+    "Interval at which a kernel collector polls its perf rings, adapted to how full they are.",
+    UNIT_MILLISECONDS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::admission_deferred{
+    EbpfNetMetrics::admission_deferred,
+    "Collector connections closed by admission control, for the collector to retry later.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::admission_paced{
+    EbpfNetMetrics::admission_paced,
+    "Collector connections admitted with a request to pace the initial dump of their state.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::steady_state_collectors{
+    EbpfNetMetrics::steady_state_collectors, "Collectors that reached socket steady state.", UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::steady_state_mean_time_ms{
+    EbpfNetMetrics::steady_state_mean_time_ms,
+    "Mean time collectors took to reach socket steady state after connecting.",
+    UNIT_MILLISECONDS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::steady_state_max_time_ms{
+    EbpfNetMetrics::steady_state_max_time_ms,
+    "Longest time a collector took to reach socket steady state after connecting.",
+    UNIT_MILLISECONDS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::socket_resyncs{
+    EbpfNetMetrics::socket_resyncs,
+    "Number of times a kernel collector resynced its socket tables with BPF's after losing samples.",
+    UNIT_DIMENSIONLESS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::socket_resync_mean_time_ms{
+    EbpfNetMetrics::socket_resync_mean_time_ms, "Mean time a kernel collector socket resync took.", UNIT_MILLISECONDS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::socket_resync_max_time_ms{
+    EbpfNetMetrics::socket_resync_max_time_ms, "Longest time a kernel collector socket resync took.", UNIT_MILLISECONDS};
+
+EbpfNetMetricInfo EbpfNetMetricInfo::socket_resync_sockets{
+    EbpfNetMetrics::socket_resync_sockets,
+    "Number of sockets a kernel collector closed or re-walked while resyncing its socket tables.",
+    UNIT_DIMENSIONLESS};
 } // namespace reducer
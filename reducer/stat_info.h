@@ -34,6 +34,7 @@ struct EbpfNetMetricInfo : public OutboundMetricInfo<EbpfNetMetrics> {
   static EbpfNetMetricInfo message;
   static EbpfNetMetricInfo otlp_grpc_bytes_failed;
   static EbpfNetMetricInfo otlp_grpc_bytes_sent;
+  static EbpfNetMetricInfo otlp_grpc_metrics_dropped;
   static EbpfNetMetricInfo otlp_grpc_metrics_failed;
   static EbpfNetMetricInfo otlp_grpc_metrics_sent;
   static EbpfNetMetricInfo otlp_grpc_requests_failed;
@@ -56,6 +57,29 @@ struct EbpfNetMetricInfo : public OutboundMetricInfo<EbpfNetMetrics> {
   static EbpfNetMetricInfo span_utilization_max;
   static EbpfNetMetricInfo time_since_last_message_ns;
   static EbpfNetMetricInfo up;
+  static EbpfNetMetricInfo rpc_wakeups;
+  static EbpfNetMetricInfo rpc_spins;
+  static EbpfNetMetricInfo rpc_parks;
+  static EbpfNetMetricInfo ingest_worker_connections;
+  static EbpfNetMetricInfo ingest_worker_messages;
+  static EbpfNetMetricInfo ingest_worker_bytes;
+  static EbpfNetMetricInfo ingest_worker_utilization;
+  static EbpfNetMetricInfo thread_numa_node;
+  static EbpfNetMetricInfo thread_cpus;
+  static EbpfNetMetricInfo perf_ring_fill;
+  static EbpfNetMetricInfo perf_poll_timer;
+  static EbpfNetMetricInfo perf_poll_wakeups;
+  static EbpfNetMetricInfo perf_poll_early;
+  static EbpfNetMetricInfo perf_poll_interval_ms;
+  static EbpfNetMetricInfo admission_deferred;
+  static EbpfNetMetricInfo admission_paced;
+  static EbpfNetMetricInfo steady_state_collectors;
+  static EbpfNetMetricInfo steady_state_mean_time_ms;
+  static EbpfNetMetricInfo steady_state_max_time_ms;
+  static EbpfNetMetricInfo socket_resyncs;
+  static EbpfNetMetricInfo socket_resync_mean_time_ms;
+  static EbpfNetMetricInfo socket_resync_max_time_ms;
+  static EbpfNetMetricInfo socket_resync_sockets;
 };
 
 } // namespace reducer
@@ -0,0 +1,115 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <reducer/thread_placement.h>
+
+#include <reducer/util/thread_ops.h>
+
+#include <util/log.h>
+#include <util/log_formatters.h>
+
+namespace reducer {
+
+ThreadPlacement ThreadPlacement::global_;
+
+std::optional<ThreadPlacement::Policy> ThreadPlacement::parse_policy(std::string_view name)
+{
+  if (name == "none") {
+    return Policy::none;
+  }
+  if (name == "numa") {
+    return Policy::numa;
+  }
+  if (name == "cpu") {
+    return Policy::cpu;
+  }
+  return std::nullopt;
+}
+
+ThreadPlacement::ThreadPlacement(
+    Policy policy,
+    CpuTopology const &topology,
+    size_t num_ingest_shards,
+    size_t num_matching_shards,
+    size_t num_aggregation_shards)
+    : policy_(policy)
+{
+  if (policy == Policy::none || topology.nodes.empty()) {
+    policy_ = Policy::none;
+    return;
+  }
+
+  size_t const num_nodes = topology.nodes.size();
+
+  // next CPU to hand out on each node, for the cpu policy
+  std::vector<size_t> next_cpu(num_nodes, 0);
+
+  auto place = [&](std::string_view module, size_t num_shards) {
+    for (size_t shard = 0; shard < num_shards; ++shard) {
+      // contiguous blocks of shards per node
+      auto const &node = topology.nodes[shard * num_nodes / num_shards];
+      size_t const node_index = &node - topology.nodes.data();
+
+      std::vector<int> cpus;
+      if (policy == Policy::cpu) {
+        cpus.push_back(node.cpus[next_cpu[node_index]++ % node.cpus.size()]);
+      } else {
+        cpus = node.cpus;
+      }
+
+      shards_.push_back({.module = std::string(module), .shard = shard, .node = node.id, .cpus = std::move(cpus)});
+    }
+  };
+
+  place("matching", num_matching_shards);
+  place("aggregation", num_aggregation_shards);
+  place("ingest", num_ingest_shards);
+  place("logging", 1);
+}
+
+ThreadPlacement::Shard const *ThreadPlacement::find(std::string_view module, size_t shard) const
+{
+  for (auto const &placed : shards_) {
+    if (placed.module == module && placed.shard == shard) {
+      return &placed;
+    }
+  }
+  return nullptr;
+}
+
+int ThreadPlacement::node(std::string_view module, size_t shard) const
+{
+  auto const *placed = find(module, shard);
+  return placed ? placed->node : -1;
+}
+
+std::vector<int> ThreadPlacement::nodes(std::string_view module, size_t num_shards) const
+{
+  std::vector<int> result;
+  result.reserve(num_shards);
+  for (size_t shard = 0; shard < num_shards; ++shard) {
+    result.push_back(node(module, shard));
+  }
+  return result;
+}
+
+void ThreadPlacement::place_current_thread(std::string_view module, size_t shard)
+{
+  auto const *placed = global_.find(module, shard);
+  if (!placed || placed->cpus.empty()) {
+    return;
+  }
+
+  set_self_thread_affinity(placed->cpus)
+      .on_error([&](auto const &error) {
+        LOG::warn("unable to place {} core thread {} on NUMA node {}: {}", module, shard, placed->node, error);
+      })
+      .on_value([&](auto) { LOG::debug("placed {} core thread {} on NUMA node {}", module, shard, placed->node); });
+}
+
+void ThreadPlacement::set_global(ThreadPlacement placement)
+{
+  global_ = std::move(placement);
+}
+
+} // namespace reducer
@@ -0,0 +1,94 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <util/cpu_topology.h>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reducer {
+
+// Decides which NUMA node and CPUs each reducer shard runs on.
+//
+// Shards of each stage are spread over the NUMA nodes in contiguous blocks, so
+// with the same number of matching and aggregation shards, matching shard N
+// and aggregation shard N end up on the same node. The logging core goes on the
+// first node.
+//
+// Placement policies:
+//   - none: threads are left to the scheduler and queue memory to the kernel.
+//   - numa: each shard may run on any CPU of its node.
+//   - cpu: each shard is pinned to a single CPU of its node; shards share CPUs
+//     only if a node has fewer CPUs than shards.
+//
+// Under the numa and cpu policies, memory of RPC queues is allocated on the
+// node of the shard that reads from them.
+//
+class ThreadPlacement {
+public:
+  enum class Policy { none, numa, cpu };
+
+  // Placement of a single shard.
+  struct Shard {
+    // Application name of the shard's core, e.g. "matching".
+    std::string module;
+    size_t shard;
+    // NUMA node id, or -1 if not placed.
+    int node;
+    // CPUs the shard may run on, empty if not placed.
+    std::vector<int> cpus;
+  };
+
+  // Parses a policy name ("none", "numa" or "cpu").
+  static std::optional<Policy> parse_policy(std::string_view name);
+
+  // Makes a placement that leaves all shards unplaced.
+  ThreadPlacement() = default;
+
+  ThreadPlacement(
+      Policy policy,
+      CpuTopology const &topology,
+      size_t num_ingest_shards,
+      size_t num_matching_shards,
+      size_t num_aggregation_shards);
+
+  Policy policy() const { return policy_; }
+
+  // Returns the NUMA node of the specified shard, or -1 if it is not placed.
+  int node(std::string_view module, size_t shard) const;
+
+  // Returns the NUMA nodes of shards 0..num_shards-1 of the specified module,
+  // for use as RPC queue receiver nodes.
+  std::vector<int> nodes(std::string_view module, size_t num_shards) const;
+
+  // Returns the placement of all shards.
+  std::vector<Shard> const &shards() const { return shards_; }
+
+  // Restricts the calling thread to the CPUs of the specified shard, according
+  // to the process-wide placement. Does nothing if the shard is not placed.
+  static void place_current_thread(std::string_view module, size_t shard);
+
+  // Sets the process-wide placement used by `place_current_thread`.
+  // NOTE: must be called on startup, before any shard threads are started.
+  static void set_global(ThreadPlacement placement);
+
+  // Returns the process-wide placement.
+  static ThreadPlacement const &global() { return global_; }
+
+private:
+  Shard const *find(std::string_view module, size_t shard) const;
+
+  Policy policy_ = Policy::none;
+  std::vector<Shard> shards_;
+
+  static ThreadPlacement global_;
+};
+
+} // namespace reducer
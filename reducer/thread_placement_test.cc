@@ -0,0 +1,81 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <reducer/thread_placement.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace reducer {
+namespace {
+
+// Two nodes with four CPUs each, as on a small 2-socket host.
+CpuTopology two_node_topology()
+{
+  return CpuTopology{.nodes = {{.id = 0, .cpus = {0, 1, 2, 3}}, {.id = 1, .cpus = {4, 5, 6, 7}}}};
+}
+
+} // namespace
+
+TEST(thread_placement, parse_policy)
+{
+  EXPECT_EQ(ThreadPlacement::Policy::none, ThreadPlacement::parse_policy("none"));
+  EXPECT_EQ(ThreadPlacement::Policy::numa, ThreadPlacement::parse_policy("numa"));
+  EXPECT_EQ(ThreadPlacement::Policy::cpu, ThreadPlacement::parse_policy("cpu"));
+  EXPECT_FALSE(ThreadPlacement::parse_policy("socket"));
+}
+
+TEST(thread_placement, none_leaves_shards_unplaced)
+{
+  ThreadPlacement placement(ThreadPlacement::Policy::none, two_node_topology(), 2, 2, 2);
+
+  EXPECT_TRUE(placement.shards().empty());
+  EXPECT_EQ(std::vector<int>({-1, -1}), placement.nodes("matching", 2));
+}
+
+TEST(thread_placement, numa_pairs_matching_and_aggregation_shards)
+{
+  ThreadPlacement placement(ThreadPlacement::Policy::numa, two_node_topology(), 2, 4, 4);
+
+  EXPECT_EQ(std::vector<int>({0, 0, 1, 1}), placement.nodes("matching", 4));
+  EXPECT_EQ(std::vector<int>({0, 0, 1, 1}), placement.nodes("aggregation", 4));
+  EXPECT_EQ(std::vector<int>({0, 1}), placement.nodes("ingest", 2));
+  EXPECT_EQ(std::vector<int>({0}), placement.nodes("logging", 1));
+
+  for (auto const &shard : placement.shards()) {
+    EXPECT_EQ(4u, shard.cpus.size()) << shard.module << " " << shard.shard;
+  }
+}
+
+TEST(thread_placement, cpu_pins_each_shard_to_a_cpu_of_its_node)
+{
+  ThreadPlacement placement(ThreadPlacement::Policy::cpu, two_node_topology(), 2, 2, 2);
+
+  std::vector<int> used;
+  for (auto const &shard : placement.shards()) {
+    ASSERT_EQ(1u, shard.cpus.size());
+    int const cpu = shard.cpus.front();
+    EXPECT_EQ(shard.node, cpu / 4) << shard.module << " " << shard.shard;
+    used.push_back(cpu);
+  }
+
+  // 7 shards on 8 CPUs: no CPU is shared
+  std::sort(used.begin(), used.end());
+  EXPECT_EQ(used.end(), std::adjacent_find(used.begin(), used.end()));
+}
+
+TEST(thread_placement, cpu_shares_cpus_when_oversubscribed)
+{
+  CpuTopology topology{.nodes = {{.id = 3, .cpus = {10, 11}}}};
+  ThreadPlacement placement(ThreadPlacement::Policy::cpu, topology, 1, 2, 2);
+
+  ASSERT_EQ(6u, placement.shards().size());
+  for (auto const &shard : placement.shards()) {
+    EXPECT_EQ(3, shard.node);
+    ASSERT_EQ(1u, shard.cpus.size());
+    EXPECT_TRUE(shard.cpus.front() == 10 || shard.cpus.front() == 11);
+  }
+}
+
+} // namespace reducer
@@ -57,15 +57,31 @@ void TsdbFormatter::set_timestamp(timestamp_t timestamp)
 void TsdbFormatter::set_labels(labels_t labels)
 {
   labels_ = std::move(labels);
+  labels_valid_ = true;
+  label_set_.reset();
   labels_changed_ = true;
 }
 
 void TsdbFormatter::set_labels(std::initializer_list<std::tuple<std::string_view, std::string_view>> labels)
 {
   labels_.clear();
+  labels_valid_ = true;
   for (auto const &[name, value] : labels) {
     assign_label(name, value);
   }
+  label_set_.reset();
+  labels_changed_ = true;
+}
+
+void TsdbFormatter::set_labels(LabelSet::Ptr label_set)
+{
+  if ((label_set == label_set_) || (label_set && label_set_ && (*label_set == *label_set_))) {
+    // no change
+    return;
+  }
+
+  label_set_ = std::move(label_set);
+  labels_valid_ = false;
   labels_changed_ = true;
 }
 
@@ -76,22 +92,64 @@ void TsdbFormatter::assign_label(std::string_view name, std::string_view value)
 
 void TsdbFormatter::assign_label(std::string name, std::string value)
 {
-  labels_.insert_or_assign(name, value);
+  auto &labels = mutable_labels();
+
+  if (auto it = labels.find(name); (it != labels.end()) && (it->second == value)) {
+    // no change
+    return;
+  }
+
+  labels.insert_or_assign(std::move(name), std::move(value));
+  label_set_.reset();
   labels_changed_ = true;
 }
 
 void TsdbFormatter::remove_label(std::string_view name)
 {
-  labels_.erase(std::string(name));
+  if (mutable_labels().erase(std::string(name)) == 0) {
+    return;
+  }
+
+  label_set_.reset();
   labels_changed_ = true;
 }
 
 void TsdbFormatter::clear_labels()
 {
   labels_.clear();
+  labels_valid_ = true;
+  label_set_.reset();
   labels_changed_ = true;
 }
 
+TsdbFormatter::labels_t &TsdbFormatter::mutable_labels()
+{
+  if (!labels_valid_) {
+    labels_ = label_set_ ? label_set_->labels() : labels_t{};
+    labels_valid_ = true;
+  }
+
+  return labels_;
+}
+
+LabelSet const &TsdbFormatter::current_label_set()
+{
+  if (!label_set_) {
+    // the labels move into the set, and are copied back only if modified again
+    label_set_ = LabelSet::make(std::move(mutable_labels()));
+    labels_valid_ = false;
+
+    if (written_label_set_ && (*label_set_ == *written_label_set_)) {
+      // labels were modified but ended up the same as last written
+      label_set_ = written_label_set_;
+      labels_changed_ = false;
+    }
+  }
+
+  written_label_set_ = label_set_;
+  return *label_set_;
+}
+
 void TsdbFormatter::write(std::string_view metric_name, value_t value, Publisher::WriterPtr const &writer)
 {
   write(MetricInfo{metric_name}, value, writer);
@@ -106,7 +164,7 @@ void TsdbFormatter::write(MetricInfo const &metric, value_t value, Publisher::Wr
       aggregation_changed_,
       rollup_,
       rollup_changed_,
-      labels_,
+      current_label_set(),
       labels_changed_,
       timestamp_,
       timestamp_changed_,
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "label_set.h"
 #include "metric_info.h"
 #include "publisher.h"
 #include "tsdb_format.h"
@@ -19,6 +20,7 @@
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <variant>
 
 namespace reducer {
@@ -40,6 +42,12 @@ namespace reducer {
 // to format and cache portions of the output that doesn't change between calls
 // to `write`.
 //
+// Labels that are used for many time-series can be built once into a
+// `LabelSet` and assigned with `set_labels(LabelSet::Ptr)`. Labels that are
+// the same as the ones last written don't count as a change, and formatters
+// write the labels encoded by the set instead of encoding them for every
+// time-series.
+//
 class TsdbFormatter {
   friend class OtlpGrpcFormatterTest;
 
@@ -50,7 +58,7 @@ public:
 
   using value_t = std::variant<u32, u64, double>;
   using rollup_t = std::optional<int>;
-  using labels_t = std::map<std::string, std::string>;
+  using labels_t = LabelSet::labels_t;
   using timestamp_t = std::chrono::nanoseconds;
 
   virtual ~TsdbFormatter() {}
@@ -69,15 +77,14 @@ public:
   void set_labels(labels_t labels);
   void set_labels(std::initializer_list<std::tuple<std::string_view, std::string_view>> labels);
 
+  // Assigns a prebuilt label set.
+  void set_labels(LabelSet::Ptr label_set);
+
   // Helper function to set labels from NodeLabels, FlowLabels objects.
-  template <typename Labels> void set_labels(Labels const &labels)
+  template <typename Labels>
+  requires(!std::is_convertible_v<Labels, LabelSet::Ptr>) void set_labels(Labels const &labels)
   {
-    labels_.clear();
-    labels.foreach ([this](std::string_view name, std::string_view value) {
-      if (!value.empty()) {
-        assign_label(name, value);
-      };
-    });
+    set_labels(LabelSet::make_from(labels));
   }
 
   // Assigns a specific label.
@@ -99,7 +106,7 @@ public:
   // Writes the formatted entry as a flow log.
   template <typename TMetrics> void write_flow_log(TMetrics const &metrics)
   {
-    format_flow_log(metrics, labels_, labels_changed_, timestamp_, timestamp_changed_);
+    format_flow_log(metrics, current_label_set(), labels_changed_, timestamp_, timestamp_changed_);
 
     aggregation_changed_ = false;
     rollup_changed_ = false;
@@ -116,7 +123,7 @@ protected:
       bool aggregation_changed,
       rollup_t rollup,
       bool rollup_changed,
-      labels_t labels,
+      LabelSet const &labels,
       bool labels_changed,
       timestamp_t timestamp,
       bool timestamp_changed,
@@ -125,21 +132,35 @@ protected:
   // Subclasses that support formatting metrics as flow logs implement this function to do the actual formatting.
   virtual void format_flow_log(
       ebpf_net::metrics::tcp_metrics const &tcp_metrics,
-      labels_t labels,
+      LabelSet const &labels,
       bool labels_changed,
       timestamp_t timestamp,
       bool timestamp_changed) {};
 
 private:
+  // Makes `labels_` hold the current labels, so that they can be modified.
+  labels_t &mutable_labels();
+
+  // Returns the current label set, building it if the labels were modified.
+  LabelSet const &current_label_set();
+
   std::string aggregation_;
   bool aggregation_changed_{false};
 
   rollup_t rollup_;
   bool rollup_changed_{false};
 
+  // Current labels. `label_set_` is reset when `labels_` is modified, and is
+  // rebuilt from it on the next write. When a label set is assigned,
+  // `labels_` is only brought up to date if the labels are then modified.
   labels_t labels_;
+  bool labels_valid_{true};
+  LabelSet::Ptr label_set_;
   bool labels_changed_{false};
 
+  // Label set passed to the last `format` or `format_flow_log` call.
+  LabelSet::Ptr written_label_set_;
+
   timestamp_t timestamp_{0};
   bool timestamp_changed_{false};
 };
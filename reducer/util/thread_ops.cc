@@ -4,6 +4,7 @@
 #include <reducer/util/thread_ops.h>
 
 #include <pthread.h>
+#include <sched.h>
 
 Expected<bool, std::errc> set_self_thread_name(std::string_view name)
 {
@@ -18,3 +19,21 @@ Expected<bool, std::errc> set_self_thread_name(std::string_view name)
 
   return true;
 }
+
+Expected<bool, std::errc> set_self_thread_affinity(std::vector<int> const &cpus)
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int const cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return {unexpected, std::errc::invalid_argument};
+    }
+    CPU_SET(cpu, &set);
+  }
+
+  if (int const error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+    return {unexpected, static_cast<std::errc>(error)};
+  }
+
+  return true;
+}
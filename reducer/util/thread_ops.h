@@ -9,6 +9,7 @@
 
 #include <system_error>
 #include <thread>
+#include <vector>
 
 /**
  * Sets the current thread name to the given string.
@@ -19,3 +20,10 @@
  * Returns true on success or an error code on failure.
  */
 Expected<bool, std::errc> set_self_thread_name(std::string_view name);
+
+/**
+ * Restricts the current thread to run only on the given CPUs.
+ *
+ * Returns true on success or an error code on failure.
+ */
+Expected<bool, std::errc> set_self_thread_affinity(std::vector<int> const &cpus);
@@ -6,6 +6,7 @@
 #include <channel/callbacks.h>
 #include <channel/tcp_channel.h>
 #include <reducer/ingest/component.h>
+#include <reducer/thread_placement.h>
 #include <reducer/util/thread_ops.h>
 #include <util/defer.h>
 #include <util/log.h>
@@ -103,6 +104,7 @@ void Worker::start(std::size_t thread_num)
     set_self_thread_name(fmt::format("ingest_{}", thread_num)).on_error([=](auto const &error) {
       LOG::warn("unable to set name for ingest core worker thread {}: {}", thread_num, error);
     });
+    ThreadPlacement::place_current_thread("ingest", thread_num);
     on_thread_start();
     thread_started_.Notify();
     uv_run(&loop_, UV_RUN_DEFAULT);
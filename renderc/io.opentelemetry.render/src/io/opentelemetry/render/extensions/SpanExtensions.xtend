@@ -70,6 +70,25 @@ class SpanExtensions {
     }
   }
 
+  /**
+   * Spans with a pool_chunk_size get pools that grow in chunks of that many
+   * elements, up to a runtime capacity of at most pool_size.
+   */
+  static def isGrowablePool(Span span) {
+    span.pool_chunk_size_ > 0
+  }
+
+  /**
+   * The pool type holding spans (or per-connection handles) of this span type.
+   */
+  static def poolTypeName(Span span, String elementType) {
+    if (span.isGrowablePool) {
+      '''ChunkedPool<«elementType», «span.pool_size», «span.pool_chunk_size_»>'''
+    } else {
+      '''Pool<«elementType», «span.pool_size»>'''
+    }
+  }
+
   static def conn_hash(Span span) {
     if (span.conn_hash_) {
       return span.conn_hash_
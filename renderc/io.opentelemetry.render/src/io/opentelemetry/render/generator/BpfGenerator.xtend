@@ -172,6 +172,18 @@ class BpfGenerator {
     static inline int perf_submit_«app.name»__«msg.name»(struct pt_regs *ctx,
       u64 __now «msg.commaPrototype»)
     {
+      if (use_ringbuf) {
+        /* fill the message in place: ring buffer records keep the leading u32 */
+        struct «bpf_struct_name» *__rb_msg = bpf_ringbuf_reserve(&events_ringbuf, «bpf_struct_name»__perf_size + sizeof(u32), 0);
+        if (!__rb_msg) {
+          __sync_fetch_and_add(&events_ringbuf_lost, 1);
+          return -1;
+        }
+        bpf_fill_«app.name»__«msg.name»(__rb_msg, __now «msg.commaCallPrototype»);
+        bpf_ringbuf_submit(__rb_msg, events_ringbuf_wakeup_flags());
+        return 0;
+      }
+
       struct «bpf_struct_name» __msg = {};
       bpf_fill_«app.name»__«msg.name»(&__msg, __now «msg.commaCallPrototype»);
       return bpf_perf_event_output(ctx, &events, BPF_F_CURRENT_CPU, &__msg.unpadded_size, «bpf_struct_name»__perf_size);
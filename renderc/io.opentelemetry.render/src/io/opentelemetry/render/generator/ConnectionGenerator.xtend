@@ -34,6 +34,7 @@ class ConnectionGenerator {
     #include "weak_refs.h"
 
     #include <platform/types.h>
+    #include <util/chunked_pool.h>
     #include <util/fixed_hash.h>
 
     «FOR app_span : app.spans.filter[include !== null]»
@@ -86,7 +87,12 @@ class ConnectionGenerator {
       // Hash table types for each span type.
       //
       «FOR span : app.spans.filter[conn_hash]»
+        «IF span.isGrowablePool»
+        using «fixedHashTypeName(span)» = FixedHash<«span.referenceType.wireCType», handles::«span.name», «span.pool_size», «fixedHashHasherName(span)»,
+          std::equal_to<«span.referenceType.wireCType»>, std::allocator<handles::«span.name»>, «span.poolTypeName("handles::" + span.name)»>;
+        «ELSE»
         using «fixedHashTypeName(span)» = FixedHash<«span.referenceType.wireCType», handles::«span.name», «span.pool_size», «fixedHashHasherName(span)»>;
+        «ENDIF»
       «ENDFOR»
 
       // Pools for each span type.
@@ -189,6 +195,10 @@ class ConnectionGenerator {
     Connection::Connection(Protocol &protocol, Index &index)
       : protocol_(protocol), index_(index)
     {
+      «FOR span : app.spans.filter[conn_hash].filter[isGrowablePool]»
+        «fixedHashName(span)».set_capacity(containers::«span.name»::pool_capacity());
+      «ENDFOR»
+
       «FOR span : app.spans.filter[isSingleton] SEPARATOR "\n"»
         if (auto ref = index_.«span.name».alloc(); ref.valid()) {
           «span.instanceName» = ref.to_handle();
@@ -52,6 +52,8 @@ class ProtocolGenerator {
       struct handle_result_t {
         int result;
         std::chrono::nanoseconds client_timestamp;
+        // Number of messages handled.
+        u32 message_count = 0;
       };
 
       Protocol(TransformBuilder &builder);
@@ -208,7 +210,7 @@ class ProtocolGenerator {
         // Call the handler function.
         handler->handler_fn(handler->context, remote_timestamp.count(), (char *)dst_buffer);
 
-        return {.result = static_cast<int>(size + sizeof(u64)), .client_timestamp = remote_timestamp};
+        return {.result = static_cast<int>(size + sizeof(u64)), .client_timestamp = remote_timestamp, .message_count = 1};
       «ENDIF»
     }
 
@@ -217,7 +219,7 @@ class ProtocolGenerator {
       u64 processed = 0;
       u64 remaining = len;
       int ret = 0;
-      u16 count = 0;
+      u32 count = 0;
       auto client_timestamp = std::chrono::nanoseconds::zero();
 
       while (len > processed) {
@@ -243,7 +245,7 @@ class ProtocolGenerator {
       }
 
       if (processed > 0) {
-        return {.result = static_cast<int>(processed), .client_timestamp = client_timestamp};
+        return {.result = static_cast<int>(processed), .client_timestamp = client_timestamp, .message_count = count};
       }
 
       // Error, return code (or in edge case of len == 0, returns 0).
@@ -347,7 +347,8 @@ class SpanGenerator {
       /**
        * Extract size statistics for each container type.
        *
-       * The given functor is called with (span name, num_allocated_spans, pool_size)
+       * The given functor is called with (span name, num_allocated_spans,
+       * max_allocated_spans, pool capacity)
        */
       using size_statistics_cb =
         std::function<void(
@@ -357,6 +358,15 @@ class SpanGenerator {
           std::size_t pool_size)>;
       void size_statistics(size_statistics_cb f);
 
+      /**
+       * Sets the maximum number of spans that the growable pool of the given
+       * span type (one declared with pool_chunk_size) can grow to, capped at
+       * its pool_size. Applies to containers constructed afterwards.
+       *
+       * @return false if there is no span with a growable pool by that name.
+       */
+      static bool set_pool_capacity(std::string_view span_name, std::size_t capacity);
+
       /**
        * forbid copy constructor
        */
@@ -411,10 +421,21 @@ class SpanGenerator {
     void «app.pkg.name»::«app.name»::Index::size_statistics(size_statistics_cb f)
     {
       «FOR span : app.spans»
-        f("«span.name»", «span.name».size(), «span.name».max_size(), «span.pool_size»);
+        f("«span.name»", «span.name».size(), «span.name».max_size(), «span.name».capacity());
       «ENDFOR»
     }
 
+    bool «app.pkg.name»::«app.name»::Index::set_pool_capacity(std::string_view span_name, std::size_t capacity)
+    {
+      «FOR span : app.spans.filter[isGrowablePool]»
+        if (span_name == "«span.name»") {
+          containers::«span.name»::set_pool_capacity(capacity);
+          return true;
+        }
+      «ENDFOR»
+      return false;
+    }
+
     void «app.pkg.name»::«app.name»::Index::send_pulse()
     {
       «FOR ran : app.remoteApps.map[name].sort»
@@ -460,6 +481,7 @@ class SpanGenerator {
     #include "../metrics.h"
 
     #include <util/short_string.h>
+    #include <util/chunked_pool.h>
     #include <util/fixed_hash.h>
     #include <util/metric_store.h>
 
@@ -473,9 +495,14 @@ class SpanGenerator {
       /**
        * Container for span «span.name».
        *
-       * The container maintains a constant-sized pool from which spans are
-       * allocated, and if the span is indexd, a map from the index key
-       * to the spans.
+       * The container maintains a pool from which spans are allocated, and
+       * if the span is indexd, a map from the index key to the spans.
+       «IF span.isGrowablePool»
+       * The pool grows in chunks of pool_chunk_size spans, up to
+       * pool_capacity().
+       «ELSE»
+       * The pool has a constant size.
+       «ENDIF»
        *
        * Access to elements is performed through handles which keep a reference
        * to an allocated span, or through a weak reference ("weak_ref"),
@@ -484,9 +511,23 @@ class SpanGenerator {
       class «span.name» {
       public:
         /**
-         * pool_size: size of the constant-sized pool of spans available
+         * pool_size: maximum number of spans the pool can hold
          */
         static constexpr u32 pool_size = «span.pool_size»;
+        «IF span.isGrowablePool»
+
+        /**
+         * pool_chunk_size: number of spans the pool grows by at a time
+         */
+        static constexpr u32 pool_chunk_size = «span.pool_chunk_size_»;
+
+        /**
+         * Maximum number of spans the pool of containers constructed from now
+         * on can grow to.
+         */
+        static std::size_t pool_capacity() { return pool_capacity_; }
+        static void set_pool_capacity(std::size_t capacity) { pool_capacity_ = std::min<std::size_t>(capacity, pool_size); }
+        «ENDIF»
 
         /**
          * C'tor
@@ -540,6 +581,11 @@ class SpanGenerator {
          */
         std::size_t max_size() const;
 
+        /**
+         * @return maximum number of spans of type «span.name» that can be allocated
+         */
+        std::size_t capacity() const;
+
         /***********************
          * Metrics
          */
@@ -626,12 +672,16 @@ class SpanGenerator {
           };
 
           /* map type */
+          «IF span.isGrowablePool»
+          using map_t = FixedHash<key_t, span_t, pool_size, hasher_t, equals_t, std::allocator<span_t>, «span.poolTypeName("span_t")»>;
+          «ELSE»
           using map_t = FixedHash<key_t, span_t, pool_size, hasher_t, equals_t>;
+          «ENDIF»
 
           map_t map;
         «ELSE»
           /* pool */
-          Pool<span_t, pool_size> map;
+          «span.poolTypeName("span_t")» map;
         «ENDIF»
 
         /* metric stores */
@@ -652,6 +702,11 @@ class SpanGenerator {
           what.dump_json(out);
           return out;
         }
+      «IF span.isGrowablePool»
+
+      private:
+        static std::size_t pool_capacity_;
+      «ENDIF»
       };
 
     «ENDFOR»
@@ -810,6 +865,10 @@ class SpanGenerator {
       /*****************************************************************************
        * «span.name»
        ****************************************************************************/
+      «IF span.isGrowablePool»
+      std::size_t «span.name»::pool_capacity_ = «span.name»::pool_size;
+
+      «ENDIF»
       /* c'tor */
       «span.name»::«span.name»()
       «FOR agg: span.aggs BEFORE " : " SEPARATOR ","»
@@ -818,7 +877,11 @@ class SpanGenerator {
           «agg.name»_«rollup.rollup_count»(fast_div(double(«agg.interval» * 1e9) * «rollup.rollup_count», 16))
         «ENDFOR»
       «ENDFOR»
-      {}
+      {
+        «IF span.isGrowablePool»
+        map.set_capacity(pool_capacity_);
+        «ENDIF»
+      }
 
       «IF span.index !== null»
       ::«app.pkg.name»::«app.name»::auto_handles::«span.name»
@@ -998,6 +1061,10 @@ class SpanGenerator {
         return map.max_size();
       }
 
+      std::size_t «span.name»::capacity() const {
+        return map.capacity();
+      }
+
       /* metric aggregators */
       «FOR agg : span.aggs»
       «IF agg.isRoot»
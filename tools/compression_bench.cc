@@ -0,0 +1,294 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Ingest stream compression benchmark
+ *
+ * Compresses ingest streams the way collectors send them, one write buffer
+ * flush at a time, and reports the compression ratio and the CPU time spent
+ * per uncompressed byte to compress, and to decompress as the reducer does.
+ *
+ *  - lz4: each flush is a self-contained LZ4 frame (Lz4Channel)
+ *  - zstd: one zstd frame per connection, flushed after each write buffer
+ *    flush, without a dictionary
+ *  - zstd-dict: like zstd, with the ingest compression dictionary, at a few
+ *    levels (ZstdChannel)
+ *
+ * Streams are read from files recorded from kernel collectors (see
+ * EBPF_NET_RECORD_INTAKE_OUTPUT_PATH), each one compressed as one connection,
+ * or synthetic streams are used. Note that the dictionary built by default is
+ * trained on synthetic streams, so recorded streams give a fairer ratio.
+ */
+
+#include <channel/lz4_channel.h>
+#include <channel/zstd_channel.h>
+#include <collector/constants.h>
+#include <reducer/bench/synthetic_stream.h>
+#include <util/compression_dictionary.h>
+#include <util/file_ops.h>
+#include <util/lz4_decompressor.h>
+#include <util/raii.h>
+#include <util/zstd_decompressor.h>
+
+#include <zstd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t DECOMPRESSION_BUFFER_SIZE = 64 * 1024;
+constexpr int DICTIONARY_LEVELS[] = {1, 3, 6};
+constexpr int NO_DICTIONARY_LEVEL = 3;
+
+constexpr reducer::bench::SyntheticStreamConfig SYNTHETIC_CLUSTER{
+    .num_hosts = 16,
+    .processes_per_host = 20,
+    .sockets_per_host = 500,
+    .stats_rounds = 10,
+};
+
+// Channel that appends everything sent through it to a string.
+class StringChannel : public channel::Channel {
+public:
+  std::error_code send(const u8 *data, int data_len) override
+  {
+    out.append(reinterpret_cast<char const *>(data), data_len);
+    return {};
+  }
+
+  bool is_open() const override { return true; }
+
+  std::string out;
+};
+
+// Streaming zstd without a dictionary, flushed after each send.
+class PlainZstdChannel : public channel::Channel {
+public:
+  PlainZstdChannel(Channel &channel, int level) : channel_(channel), ctx_(ZSTD_createCCtx())
+  {
+    ZSTD_CCtx_setParameter(ctx_.get(), ZSTD_c_compressionLevel, level);
+    ZSTD_CCtx_setParameter(ctx_.get(), ZSTD_c_windowLog, COMPRESSION_WINDOW_LOG);
+    buffer_.resize(ZSTD_CStreamOutSize());
+  }
+
+  std::error_code send(const u8 *data, int data_len) override
+  {
+    ZSTD_inBuffer input = {.src = data, .size = static_cast<size_t>(data_len), .pos = 0};
+    size_t remaining;
+    do {
+      ZSTD_outBuffer output = {.dst = buffer_.data(), .size = buffer_.size(), .pos = 0};
+      remaining = ZSTD_compressStream2(ctx_.get(), &output, &input, ZSTD_e_flush);
+      if (ZSTD_isError(remaining)) {
+        std::cerr << "zstd compression failed: " << ZSTD_getErrorName(remaining) << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      channel_.send(buffer_.data(), output.pos);
+    } while (remaining > 0);
+    return {};
+  }
+
+  bool is_open() const override { return true; }
+
+private:
+  Channel &channel_;
+  pod_unique_ptr<ZSTD_CCtx, size_t, ZSTD_freeCCtx> ctx_;
+  std::vector<u8> buffer_;
+};
+
+enum class Mode { lz4, zstd, zstd_dict };
+
+struct Result {
+  u64 uncompressed = 0;
+  u64 compressed = 0;
+  std::chrono::nanoseconds compress_time{0};
+  std::chrono::nanoseconds decompress_time{0};
+};
+
+std::unique_ptr<channel::Channel> make_channel(Mode mode, int level, StringChannel &out)
+{
+  switch (mode) {
+  case Mode::lz4: {
+    auto channel = std::make_unique<channel::Lz4Channel>(out, WRITE_BUFFER_SIZE);
+    channel->set_compression(true);
+    return channel;
+  }
+  case Mode::zstd:
+    return std::make_unique<PlainZstdChannel>(out, level);
+  case Mode::zstd_dict: {
+    auto channel = std::make_unique<channel::ZstdChannel>(out, WRITE_BUFFER_SIZE);
+    channel->set_level(level);
+    channel->set_compression(true);
+    return channel;
+  }
+  }
+  return nullptr;
+}
+
+// Plain zstd decompression, for streams compressed without a dictionary.
+class PlainZstdDecompressor {
+public:
+  PlainZstdDecompressor() : ctx_(ZSTD_createDCtx()), buffer_(DECOMPRESSION_BUFFER_SIZE) {}
+
+  u64 decompress(std::string_view in)
+  {
+    u64 total = 0;
+    ZSTD_inBuffer input = {.src = in.data(), .size = in.size(), .pos = 0};
+    bool output_full;
+    do {
+      ZSTD_outBuffer output = {.dst = buffer_.data(), .size = buffer_.size(), .pos = 0};
+      auto const res = ZSTD_decompressStream(ctx_.get(), &output, &input);
+      if (ZSTD_isError(res)) {
+        std::cerr << "zstd decompression failed: " << ZSTD_getErrorName(res) << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      total += output.pos;
+      // a full output buffer may leave decompressed data behind in the context
+      output_full = (output.pos == output.size);
+    } while (input.pos < input.size || output_full);
+    return total;
+  }
+
+private:
+  pod_unique_ptr<ZSTD_DCtx, size_t, ZSTD_freeDCtx> ctx_;
+  std::vector<u8> buffer_;
+};
+
+// Decompresses all of `in`, discarding the output, and returns its size.
+u64 decompress(Decompressor &decompressor, std::string_view in)
+{
+  u64 total = 0;
+  auto const *data = reinterpret_cast<u8 const *>(in.data());
+  std::size_t left = in.size();
+
+  bool output_full = false;
+
+  // a full output buffer may hold back data, which comes out of process()
+  // even without more input
+  while (left > 0 || output_full) {
+    std::size_t consumed = 0;
+    if (auto const error = decompressor.process(data, left, &consumed)) {
+      std::cerr << "decompression failed: " << decompressor.error_name(error) << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    data += consumed;
+    left -= consumed;
+    output_full = (decompressor.output_buf_size() == DECOMPRESSION_BUFFER_SIZE);
+
+    total += decompressor.output_buf_size();
+    decompressor.discard(decompressor.output_buf_size());
+  }
+
+  return total;
+}
+
+Result measure(Mode mode, int level, std::vector<std::string> const &streams, std::size_t flush_size)
+{
+  Result result;
+
+  for (auto const &stream : streams) {
+    StringChannel out;
+    auto channel = make_channel(mode, level, out);
+
+    auto const compress_start = std::chrono::steady_clock::now();
+    for (std::size_t offset = 0; offset < stream.size(); offset += flush_size) {
+      auto const size = std::min(flush_size, stream.size() - offset);
+      channel->send(reinterpret_cast<u8 const *>(stream.data() + offset), size);
+    }
+    auto const decompress_start = std::chrono::steady_clock::now();
+
+    u64 decompressed;
+    switch (mode) {
+    case Mode::lz4: {
+      Lz4Decompressor decompressor(DECOMPRESSION_BUFFER_SIZE);
+      decompressed = decompress(decompressor, out.out);
+      break;
+    }
+    case Mode::zstd:
+      decompressed = PlainZstdDecompressor().decompress(out.out);
+      break;
+    case Mode::zstd_dict: {
+      ZstdDecompressor decompressor(DECOMPRESSION_BUFFER_SIZE);
+      decompressed = decompress(decompressor, out.out);
+      break;
+    }
+    }
+    auto const end = std::chrono::steady_clock::now();
+
+    if (decompressed != stream.size()) {
+      std::cerr << "decompressed " << decompressed << " bytes out of " << stream.size() << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    result.uncompressed += stream.size();
+    result.compressed += out.out.size();
+    result.compress_time += decompress_start - compress_start;
+    result.decompress_time += end - decompress_start;
+  }
+
+  return result;
+}
+
+void report(std::string_view label, Result const &result)
+{
+  std::cout << std::left << std::setw(14) << label << std::right << std::fixed << std::setprecision(2) << " ratio "
+            << std::setw(6) << static_cast<double>(result.uncompressed) / result.compressed << ", compress "
+            << std::setw(6) << static_cast<double>(result.compress_time.count()) / result.uncompressed
+            << " ns/B, decompress " << std::setw(6)
+            << static_cast<double>(result.decompress_time.count()) / result.uncompressed << " ns/B" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  static constexpr std::string_view FLUSH_SIZE_ARG = "--flush-size=";
+
+  std::size_t flush_size = WRITE_BUFFER_SIZE;
+  std::vector<std::string> streams;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view const arg = argv[i];
+    if (arg.substr(0, FLUSH_SIZE_ARG.size()) == FLUSH_SIZE_ARG) {
+      flush_size = std::strtoull(argv[i] + FLUSH_SIZE_ARG.size(), nullptr, 10);
+      if (flush_size == 0 || flush_size > WRITE_BUFFER_SIZE) {
+        std::cerr << "usage: compression_bench [--flush-size=bytes] [recorded streams...]" << std::endl;
+        return EXIT_FAILURE;
+      }
+      continue;
+    }
+
+    auto stream = read_file_as_string(argv[i]);
+    if (!stream) {
+      std::cerr << "failed to read '" << argv[i] << "': " << stream.error() << std::endl;
+      return EXIT_FAILURE;
+    }
+    streams.push_back(std::move(*stream));
+  }
+
+  if (streams.empty()) {
+    streams = reducer::bench::make_synthetic_streams(SYNTHETIC_CLUSTER);
+  }
+
+  u64 total = 0;
+  for (auto const &stream : streams) {
+    total += stream.size();
+  }
+  std::cout << streams.size() << " streams, " << total / 1024 << "KiB, flushed every " << flush_size << "B" << std::endl;
+
+  report("lz4", measure(Mode::lz4, 0, streams, flush_size));
+  report("zstd-" + std::to_string(NO_DICTIONARY_LEVEL), measure(Mode::zstd, NO_DICTIONARY_LEVEL, streams, flush_size));
+  for (int level : DICTIONARY_LEVELS) {
+    report("zstd-dict-" + std::to_string(level), measure(Mode::zstd_dict, level, streams, flush_size));
+  }
+
+  return EXIT_SUCCESS;
+}
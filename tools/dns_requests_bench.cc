@@ -0,0 +1,137 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * DNS request table micro-benchmark
+ *
+ * Measures the cost of the `DnsRequests` operations the kernel collector runs
+ * for every DNS query and response, in nanoseconds per operation, with
+ * 100k queries outstanding: adding a query, matching a response to it by key,
+ * removing it once answered, and expiring unanswered queries from the
+ * periodic timeout sweep.
+ *
+ * Queries are spread over a few thousand sockets and a ten second window,
+ * like on a node running a busy resolver.
+ */
+
+#include <collector/kernel/dns_requests.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr u32 OUTSTANDING_QUERIES = 100000;
+constexpr u32 NUM_SOCKETS = 4096;
+constexpr u64 QUERY_WINDOW_NS = 10'000'000'000ull;
+
+// time between timeout sweeps, as BufferedPoller::slow_poll runs
+constexpr u64 SWEEP_INTERVAL_NS = 100'000'000ull;
+
+struct Query {
+  std::string name;
+  DnsRequests::dns_request_key key;
+  DnsRequests::dns_request_value value;
+};
+
+std::vector<Query> make_queries(u64 start_ns)
+{
+  std::mt19937 rng(42);
+  std::vector<Query> queries(OUTSTANDING_QUERIES);
+  for (u32 i = 0; i < OUTSTANDING_QUERIES; i++) {
+    auto &query = queries[i];
+    query.name = "svc-" + std::to_string(rng() % 20000) + ".ns.svc.cluster.local";
+    query.key = DnsRequests::dns_request_key{
+        .qid = static_cast<u16>(rng()),
+        .type = static_cast<u16>((rng() % 2) ? 1 : 28),
+        .name = query.name,
+        .name_hash = DnsRequests::name_hash(query.name),
+        .is_rx = false};
+    query.value = DnsRequests::dns_request_value{
+        .timestamp_ns = start_ns + (QUERY_WINDOW_NS * i) / OUTSTANDING_QUERIES,
+        .sk = 0xffff888000000000ull + (rng() % NUM_SOCKETS) * 1024};
+  }
+  return queries;
+}
+
+template <typename F> double time_ns_per_op(u64 ops, F &&f)
+{
+  auto const start = std::chrono::steady_clock::now();
+  f();
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / ops;
+}
+
+void report(char const *what, double ns_per_op)
+{
+  std::cout << what << ": " << ns_per_op << " ns/op" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  if (argc > 1) {
+    std::cerr << "usage: dns_requests_bench" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  u64 const start_ns = 1'000'000'000'000ull;
+  auto const queries = make_queries(start_ns);
+  DnsRequests requests(2 * OUTSTANDING_QUERIES);
+  std::vector<DnsRequests::Request> found;
+
+  report("add", time_ns_per_op(OUTSTANDING_QUERIES, [&] {
+           for (auto const &query : queries) {
+             requests.add(query.key, query.value);
+           }
+         }));
+
+  u64 matched = 0;
+  report("lookup", time_ns_per_op(OUTSTANDING_QUERIES, [&] {
+           for (auto const &query : queries) {
+             found.clear();
+             requests.lookup(query.key, found);
+             matched += found.size();
+           }
+         }));
+
+  found.clear();
+  report("lookup_socket", time_ns_per_op(NUM_SOCKETS, [&] {
+           for (u64 sk = 0; sk < NUM_SOCKETS; sk++) {
+             requests.lookup_socket(0xffff888000000000ull + sk * 1024, found);
+           }
+         }));
+
+  // answer every other query, then let the rest time out
+  report("remove_all_with_key", time_ns_per_op(OUTSTANDING_QUERIES / 2, [&] {
+           for (u32 i = 0; i < OUTSTANDING_QUERIES; i += 2) {
+             requests.remove_all_with_key(queries[i].key);
+           }
+         }));
+
+  u64 const remaining = requests.size();
+  u64 sweeps = 0;
+  double const sweep_ns = time_ns_per_op(remaining, [&] {
+    for (u64 t = start_ns; requests.size() > 0; t += SWEEP_INTERVAL_NS, sweeps++) {
+      found.clear();
+      requests.lookup_older_than(t, found);
+      for (auto req : found) {
+        requests.remove(req);
+      }
+    }
+  });
+  report("lookup_older_than + remove, per expired query", sweep_ns);
+  std::cout << "  " << remaining << " queries expired over " << sweeps << " sweeps, "
+            << static_cast<u64>(sweep_ns * remaining / sweeps) << " ns/sweep" << std::endl;
+
+  if (matched < OUTSTANDING_QUERIES) {
+    std::cerr << "matched " << matched << " queries, expected at least " << OUTSTANDING_QUERIES << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * GeoIP autonomous system lookup micro-benchmark
+ *
+ * Measures the cost of finding the autonomous system organization of a remote
+ * address, as the matching core does for every flow with no agent on its
+ * remote side, in nanoseconds per lookup:
+ *
+ *  - database: walks the GeoIP database's search tree with libmaxminddb, then
+ *    decodes the organization into a string
+ *  - as_prefix_table: looks up the table compiled from the database, which
+ *    returns an interned organization id
+ *
+ * Half the addresses are IPv4-mapped, half are global unicast IPv6 addresses.
+ * Both lookups must find the same organization for every address.
+ *
+ * The time taken to compile the table and its size are reported as well.
+ */
+
+#include <geoip/as_prefix_table.h>
+#include <geoip/geoip.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+
+namespace {
+
+constexpr std::size_t NUM_ADDRESSES = 1'000'000;
+
+std::vector<in6_addr> make_addresses()
+{
+  std::mt19937_64 rng(42);
+  std::vector<in6_addr> addresses(NUM_ADDRESSES);
+  for (std::size_t i = 0; i < NUM_ADDRESSES; i++) {
+    auto &address = addresses[i];
+    for (auto &byte : address.s6_addr) {
+      byte = static_cast<std::uint8_t>(rng());
+    }
+    if (i % 2) {
+      // ::ffff:0:0/96
+      std::fill(address.s6_addr, address.s6_addr + 10, 0);
+      address.s6_addr[10] = address.s6_addr[11] = 0xff;
+    } else {
+      // 2000::/3
+      address.s6_addr[0] = 0x20 | (address.s6_addr[0] & 0x1f);
+    }
+  }
+  return addresses;
+}
+
+template <typename F> double time_ns_per_op(std::size_t ops, F &&f)
+{
+  auto const start = std::chrono::steady_clock::now();
+  f();
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / ops;
+}
+
+void report(char const *what, double ns_per_op)
+{
+  std::cout << what << ": " << std::fixed << std::setprecision(1) << ns_per_op << " ns/lookup" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  if (argc > 2) {
+    std::cerr << "usage: geoip_lookup_bench [GeoLite2-ASN.mmdb path]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::unique_ptr<geoip::database> db;
+  try {
+    if (argc > 1) {
+      db = std::make_unique<geoip::database>(argv[1]);
+    } else {
+      db = std::make_unique<geoip::database>(
+          std::initializer_list<char const *>{geoip::database::local_asn_path, geoip::database::global_asn_path});
+    }
+  } catch (std::exception const &exc) {
+    std::cerr << "failed to open GeoIP database: " << exc.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto const compile_start = std::chrono::steady_clock::now();
+  auto const table = db->compile_as_table();
+  std::chrono::duration<double, std::milli> const compile_time = std::chrono::steady_clock::now() - compile_start;
+  std::cout << "compiled " << table.organization_count() << " organizations in " << table.range_count()
+            << " address ranges, " << table.memory_usage() / 1024 << " KiB, in " << std::fixed << std::setprecision(1)
+            << compile_time.count() << "ms" << std::endl;
+
+  auto const addresses = make_addresses();
+
+  std::vector<std::optional<std::string>> from_database(NUM_ADDRESSES);
+  std::size_t found = 0;
+  report("database", time_ns_per_op(NUM_ADDRESSES, [&] {
+           for (std::size_t i = 0; i < NUM_ADDRESSES; i++) {
+             std::string organization;
+             auto entry = db->lookup(&addresses[i]);
+             if (entry && geoip::well_known_data::try_autonomous_system_organization(organization, entry)) {
+               from_database[i] = std::move(organization);
+               found++;
+             }
+           }
+         }));
+
+  std::vector<geoip::as_prefix_table::organization_id> from_table(NUM_ADDRESSES);
+  report("as_prefix_table", time_ns_per_op(NUM_ADDRESSES, [&] {
+           for (std::size_t i = 0; i < NUM_ADDRESSES; i++) {
+             from_table[i] = table.find(&addresses[i]);
+           }
+         }));
+
+  std::cout << found << " of " << NUM_ADDRESSES << " addresses have an organization" << std::endl;
+
+  std::size_t mismatches = 0;
+  for (std::size_t i = 0; i < NUM_ADDRESSES; i++) {
+    if (from_table[i] == geoip::as_prefix_table::no_organization
+            ? from_database[i].has_value()
+            : from_database[i] != table.organization(from_table[i])) {
+      mismatches++;
+    }
+  }
+
+  if (mismatches) {
+    std::cerr << mismatches << " lookups found different organizations" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
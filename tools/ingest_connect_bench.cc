@@ -0,0 +1,170 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Reducer ingest reconnect micro-benchmark
+ *
+ * Measures what it costs the reducer to set up the protocol of a collector
+ * connection, the way NpmConnection does, when many collectors connect at once
+ * (e.g. after a reducer restart): the time from a connection being accepted to
+ * its first message being handled, and how many TransformBuilders are built.
+ *
+ *  - per-connection: each connection builds its own TransformBuilder
+ *  - shared: all connections share one process-wide TransformBuilder
+ *
+ * Each connection handles a version_info message, as collectors send first.
+ */
+
+#include <generated/ebpf_net/ingest/meta.h>
+#include <generated/ebpf_net/ingest/protocol.h>
+#include <generated/ebpf_net/ingest/transform_builder.h>
+#include <generated/ebpf_net/ingest/writer.h>
+
+#include <channel/ibuffered_writer.h>
+#include <util/meta.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using ingest_metadata = ebpf_net::ingest_metadata;
+
+constexpr std::size_t DEFAULT_CONNECTIONS = 5000;
+
+constexpr u32 ENCODE_BUFFER_SIZE = 64 * 1024;
+
+enum class Mode { per_connection, shared };
+
+// Keeps what was written, to be handled as received data.
+class CapturingBufferedWriter : public IBufferedWriter {
+public:
+  CapturingBufferedWriter() : buf_(ENCODE_BUFFER_SIZE) {}
+
+  Expected<u8 *, std::error_code> start_write(u32 length) override
+  {
+    length_ = length;
+    return &buf_[size_];
+  }
+
+  void finish_write() override { size_ += length_; }
+
+  std::error_code flush() override { return {}; }
+
+  u32 buf_size() const override { return ENCODE_BUFFER_SIZE; }
+
+  bool is_writable() const override { return true; }
+
+  std::string_view data() const { return {reinterpret_cast<char const *>(buf_.data()), size_}; }
+
+private:
+  std::vector<u8> buf_;
+  u32 size_ = 0;
+  u32 length_ = 0;
+};
+
+void handle_message(void *context, u64 timestamp, char *msg)
+{
+  ++*reinterpret_cast<u64 *>(context);
+}
+
+struct Result {
+  u64 builds = 0;
+  u64 messages = 0;
+  std::vector<std::chrono::nanoseconds> time_to_first_message;
+};
+
+Result run(Mode mode, std::size_t connections, std::string_view first_message)
+{
+  Result result;
+  result.time_to_first_message.reserve(connections);
+
+  // built by the first connection, in shared mode
+  std::unique_ptr<ebpf_net::ingest::TransformBuilder> shared_builder;
+
+  for (std::size_t i = 0; i < connections; ++i) {
+    auto const start = std::chrono::steady_clock::now();
+
+    std::unique_ptr<ebpf_net::ingest::TransformBuilder> own_builder;
+    if (mode == Mode::per_connection || !shared_builder) {
+      own_builder = std::make_unique<ebpf_net::ingest::TransformBuilder>();
+      ++result.builds;
+    }
+    if (mode == Mode::shared && !shared_builder) {
+      shared_builder = std::move(own_builder);
+    }
+    auto &builder = own_builder ? *own_builder : *shared_builder;
+
+    // sets up handlers and transforms like the generated Connection does
+    ebpf_net::ingest::Protocol protocol(builder);
+    meta::foreach<ingest_metadata::messages>([&](auto tag) {
+      using message = decltype(meta::tag_type(tag));
+      protocol.add_handler(message::rpc_id, &result.messages, &handle_message);
+    });
+    protocol.insert_no_auth_identity_transforms();
+
+    if (protocol.handle_multiple(first_message.data(), first_message.size()).result <= 0) {
+      std::cerr << "first message not handled" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    result.time_to_first_message.push_back(std::chrono::steady_clock::now() - start);
+  }
+
+  return result;
+}
+
+void report(char const *label, Result &result, std::size_t connections)
+{
+  auto &times = result.time_to_first_message;
+  std::sort(times.begin(), times.end());
+
+  std::chrono::nanoseconds total{};
+  for (auto const time : times) {
+    total += time;
+  }
+
+  u64 const reuses = connections - result.builds;
+
+  std::cout << label << ": " << result.builds << " TransformBuilders built, " << (100 * reuses / connections)
+            << "% of connections reused one" << std::endl
+            << "  time to first message: mean " << (total / connections).count() << "ns, p99 "
+            << times[(times.size() * 99) / 100].count() << "ns" << std::endl
+            << "  all connections: " << std::chrono::duration_cast<std::chrono::microseconds>(total).count() << "us"
+            << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  std::size_t connections = DEFAULT_CONNECTIONS;
+
+  if (argc > 2) {
+    std::cerr << "usage: ingest_connect_bench [connections]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (argc == 2) {
+    connections = std::strtoull(argv[1], nullptr, 10);
+  }
+  if (connections == 0) {
+    std::cerr << "connections must be positive" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  CapturingBufferedWriter encoded;
+  ebpf_net::ingest::Writer writer(encoded, [] { return 0ull; });
+  writer.version_info(0, 1, 0);
+
+  for (Mode mode : {Mode::per_connection, Mode::shared}) {
+    auto result = run(mode, connections, encoded.data());
+    report(mode == Mode::per_connection ? "per-connection" : "shared", result, connections);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,296 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Kernel collector NAT tracking micro-benchmark
+ *
+ * Measures how fast NatHandler handles conntrack and socket events, in
+ * nanoseconds per event, and how many nat_remapping messages it sends.
+ *
+ * Events come either from a recording made with the kernel collector's
+ * `--bpf-dump-file` flag, of which only NAT-related messages are replayed, or
+ * from a synthetic trace resembling kube-proxy: connections to a service
+ * address are DNAT-ed to one of its pods, and some of them are re-mapped to
+ * other pods before they close. As in BufferedPoller, queued nat_remapping
+ * messages are flushed every POLL_EVENTS events and before a socket closes.
+ */
+
+#include <collector/kernel/nat_handler.h>
+
+#include <channel/ibuffered_writer.h>
+#include <generated/ebpf_net/agent_internal/wire_message.h>
+#include <generated/ebpf_net/ingest/writer.h>
+#include <util/logger.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace {
+
+// Events handled between two flushes, about what a busy poll reads.
+constexpr size_t POLL_EVENTS = 256;
+
+// Connections in the synthetic trace, and how many are open at once.
+constexpr size_t SYNTHETIC_CONNECTIONS = 256 * 1024;
+constexpr size_t SYNTHETIC_OPEN_CONNECTIONS = 4096;
+
+// Pods behind the synthetic service, and how often connections are re-mapped.
+constexpr u32 SYNTHETIC_PODS = 16;
+constexpr size_t SYNTHETIC_REMAPPINGS = 3;
+
+constexpr u32 UPSTREAM_BUFFER_SIZE = 64 * 1024;
+
+// Upstream buffer that discards its contents, counting messages.
+class DiscardingBufferedWriter : public IBufferedWriter {
+public:
+  DiscardingBufferedWriter() : buf_(UPSTREAM_BUFFER_SIZE) {}
+
+  Expected<u8 *, std::error_code> start_write(u32 length) override
+  {
+    if (UPSTREAM_BUFFER_SIZE - offset_ < length) {
+      offset_ = 0;
+    }
+    length_ = length;
+    return &buf_[offset_];
+  }
+
+  void finish_write() override
+  {
+    offset_ += length_;
+    ++messages_written_;
+  }
+
+  std::error_code flush() override
+  {
+    offset_ = 0;
+    return {};
+  }
+
+  u32 buf_size() const override { return UPSTREAM_BUFFER_SIZE; }
+
+  bool is_writable() const override { return true; }
+
+  u64 messages_written() const { return messages_written_; }
+
+private:
+  std::vector<u8> buf_;
+  u32 offset_ = 0;
+  u32 length_ = 0;
+  u64 messages_written_ = 0;
+};
+
+using Event = std::variant<
+    jb_agent_internal__nf_conntrack_alter_reply,
+    jb_agent_internal__nf_nat_cleanup_conntrack,
+    jb_agent_internal__existing_conntrack_tuple,
+    jb_agent_internal__set_state_ipv4,
+    jb_agent_internal__close_sock_info>;
+
+struct TimedEvent {
+  u64 timestamp;
+  Event event;
+};
+
+template <typename Message> Message read_message(std::string_view sample)
+{
+  Message msg = {};
+  memcpy(&msg, sample.data() + 2 * sizeof(u64), std::min(sample.size() - 2 * sizeof(u64), sizeof(Message)));
+  return msg;
+}
+
+// Reads NAT-related events from a `--bpf-dump-file` recording, where each
+// sample is: u32 (size or unused), u32 unpadded size, u64 timestamp, wire
+// message, padding to 8 bytes.
+std::vector<TimedEvent> read_dump(char const *path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::cerr << "could not open " << path << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  std::string const dump{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+  std::vector<TimedEvent> events;
+  for (size_t offset = 0; offset + 2 * sizeof(u64) + sizeof(u16) <= dump.size();) {
+    u32 unpadded;
+    memcpy(&unpadded, &dump[offset + sizeof(u32)], sizeof(unpadded));
+    size_t const size = (sizeof(u32) + sizeof(u32) + unpadded + 7) & ~size_t{7};
+    if (unpadded < sizeof(u64) || offset + size > dump.size()) {
+      break;
+    }
+
+    std::string_view const sample(&dump[offset], size);
+    offset += size;
+
+    u64 timestamp;
+    u16 rpc_id;
+    memcpy(&timestamp, sample.data() + sizeof(u64), sizeof(timestamp));
+    memcpy(&rpc_id, sample.data() + 2 * sizeof(u64), sizeof(rpc_id));
+
+    switch (rpc_id) {
+    case jb_agent_internal__nf_conntrack_alter_reply__rpc_id:
+      events.push_back({timestamp, read_message<jb_agent_internal__nf_conntrack_alter_reply>(sample)});
+      break;
+    case jb_agent_internal__nf_nat_cleanup_conntrack__rpc_id:
+      events.push_back({timestamp, read_message<jb_agent_internal__nf_nat_cleanup_conntrack>(sample)});
+      break;
+    case jb_agent_internal__existing_conntrack_tuple__rpc_id:
+      events.push_back({timestamp, read_message<jb_agent_internal__existing_conntrack_tuple>(sample)});
+      break;
+    case jb_agent_internal__set_state_ipv4__rpc_id:
+      events.push_back({timestamp, read_message<jb_agent_internal__set_state_ipv4>(sample)});
+      break;
+    case jb_agent_internal__close_sock_info__rpc_id:
+      events.push_back({timestamp, read_message<jb_agent_internal__close_sock_info>(sample)});
+      break;
+    default:
+      break;
+    }
+  }
+
+  return events;
+}
+
+// Builds a kube-proxy-like trace: clients connect to a service address, which
+// conntrack maps to a pod; some connections are re-mapped before closing.
+std::vector<TimedEvent> make_synthetic_trace()
+{
+  u32 const client_ip = htonl(0x0a000001);  // 10.0.0.1
+  u32 const service_ip = htonl(0x0a60000a); // 10.96.0.10
+  u16 const service_port = 80;
+  u16 const pod_port = 8080;
+
+  std::vector<TimedEvent> events;
+  u64 timestamp = 0;
+
+  auto const close = [&](size_t i) {
+    u64 const sk = 0xffff888000000000ull + i * 2048;
+    jb_agent_internal__nf_nat_cleanup_conntrack cleanup = {};
+    cleanup._rpc_id = jb_agent_internal__nf_nat_cleanup_conntrack__rpc_id;
+    cleanup.ct = 0xffff889000000000ull + i * 320;
+    cleanup.src_ip = client_ip;
+    cleanup.dst_ip = service_ip;
+    cleanup.src_port = htons(static_cast<u16>(1024 + i % 60000));
+    cleanup.dst_port = htons(service_port);
+    cleanup.proto = IPPROTO_TCP;
+    jb_agent_internal__close_sock_info close_sock = {};
+    close_sock._rpc_id = jb_agent_internal__close_sock_info__rpc_id;
+    close_sock.sk = sk;
+    events.push_back({timestamp++, close_sock});
+    events.push_back({timestamp++, cleanup});
+  };
+
+  for (size_t i = 0; i < SYNTHETIC_CONNECTIONS; ++i) {
+    u64 const sk = 0xffff888000000000ull + i * 2048;
+    u16 const client_port = static_cast<u16>(1024 + i % 60000);
+
+    jb_agent_internal__set_state_ipv4 set_state = {};
+    set_state._rpc_id = jb_agent_internal__set_state_ipv4__rpc_id;
+    set_state.src = client_ip;
+    set_state.dest = service_ip;
+    set_state.sport = client_port;
+    set_state.dport = service_port;
+    set_state.sk = sk;
+    set_state.tx_rx = 1;
+    events.push_back({timestamp++, set_state});
+
+    for (size_t remapping = 0; remapping <= (i % 4 == 0 ? SYNTHETIC_REMAPPINGS : 0); ++remapping) {
+      u32 const pod_ip = htonl(0x0af40000 + static_cast<u32>((i + remapping) % SYNTHETIC_PODS) + 2); // 10.244.0.x
+
+      jb_agent_internal__nf_conntrack_alter_reply alter_reply = {};
+      alter_reply._rpc_id = jb_agent_internal__nf_conntrack_alter_reply__rpc_id;
+      alter_reply.ct = 0xffff889000000000ull + i * 320;
+      alter_reply.src_ip = client_ip;
+      alter_reply.dst_ip = service_ip;
+      alter_reply.src_port = htons(client_port);
+      alter_reply.dst_port = htons(service_port);
+      alter_reply.proto = IPPROTO_TCP;
+      alter_reply.nat_src_ip = client_ip;
+      alter_reply.nat_dst_ip = pod_ip;
+      alter_reply.nat_src_port = htons(client_port);
+      alter_reply.nat_dst_port = htons(pod_port);
+      alter_reply.nat_proto = IPPROTO_TCP;
+      events.push_back({timestamp++, alter_reply});
+    }
+
+    if (i >= SYNTHETIC_OPEN_CONNECTIONS) {
+      close(i - SYNTHETIC_OPEN_CONNECTIONS);
+    }
+  }
+
+  for (size_t i = SYNTHETIC_CONNECTIONS - SYNTHETIC_OPEN_CONNECTIONS; i < SYNTHETIC_CONNECTIONS; ++i) {
+    close(i);
+  }
+
+  return events;
+}
+
+// Handles the events the way BufferedPoller does, returning elapsed time.
+std::chrono::steady_clock::duration replay(NatHandler &handler, std::vector<TimedEvent> events)
+{
+  auto const start = std::chrono::steady_clock::now();
+
+  size_t in_poll = 0;
+  for (auto &[timestamp, event] : events) {
+    if (auto *msg = std::get_if<jb_agent_internal__nf_conntrack_alter_reply>(&event)) {
+      handler.handle_nf_conntrack_alter_reply(timestamp, msg);
+    } else if (auto *msg = std::get_if<jb_agent_internal__nf_nat_cleanup_conntrack>(&event)) {
+      handler.handle_nf_nat_cleanup_conntrack(timestamp, msg);
+    } else if (auto *msg = std::get_if<jb_agent_internal__existing_conntrack_tuple>(&event)) {
+      handler.handle_existing_conntrack_tuple(timestamp, msg);
+    } else if (auto *msg = std::get_if<jb_agent_internal__set_state_ipv4>(&event)) {
+      handler.handle_set_state_ipv4(timestamp, msg);
+    } else if (auto *msg = std::get_if<jb_agent_internal__close_sock_info>(&event)) {
+      handler.flush_nat_remapping(msg->sk);
+      handler.handle_close_socket(timestamp, msg);
+    }
+
+    if (++in_poll == POLL_EVENTS) {
+      handler.flush_nat_remappings();
+      in_poll = 0;
+    }
+  }
+  handler.flush_nat_remappings();
+
+  return std::chrono::steady_clock::now() - start;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  if (argc > 2) {
+    std::cerr << "usage: nat_handler_bench [bpf_dump_file]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<TimedEvent> const events = argc == 2 ? read_dump(argv[1]) : make_synthetic_trace();
+  if (events.empty()) {
+    std::cerr << "no NAT-related events to replay" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  DiscardingBufferedWriter upstream;
+  ebpf_net::ingest::Writer writer(upstream, [] { return 0ull; });
+  logging::Logger log(writer);
+  NatHandler handler(writer, log);
+
+  auto const elapsed = replay(handler, events);
+
+  std::cout << "events: " << events.size() << std::endl
+            << "ns/event: " << std::chrono::duration<double, std::nano>(elapsed).count() / events.size() << std::endl
+            << "nat_remapping messages: " << upstream.messages_written() << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,277 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Kernel collector pass-through encoding micro-benchmark
+ *
+ * Measures how fast samples of agent_internal messages that are forwarded
+ * upstream unchanged (see collector/kernel/ingest_passthrough.h) go from perf
+ * rings to the upstream buffer, in bytes per second, the way
+ * `BufferedPoller::process_samples` moves them:
+ *
+ *  - encoder: each sample is copied out of the ring, then re-encoded through
+ *    the ingest `Writer`
+ *  - direct: each sample is copied from the ring, in place even when it wraps
+ *    around, straight into the upstream buffer as the ingest message
+ *
+ * Rings live in process memory and are filled with a mix of set_state_ipv4,
+ * tcp_reset and http_response samples; only draining is timed. The upstream
+ * buffer is discarded when full, so the channel's cost is not included.
+ */
+
+#include <collector/kernel/ingest_passthrough.h>
+#include <collector/kernel/perf_reader.h>
+
+#include <channel/ibuffered_writer.h>
+#include <generated/ebpf_net/ingest/writer.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Per-CPU perf ring size, as in the kernel collector.
+constexpr u32 PERF_RING_N_BYTES = 1024 * 4096;
+
+constexpr size_t NUM_CPUS = 8;
+
+// Events written, then read, per round; fits in the perf rings.
+constexpr size_t EVENTS_PER_ROUND = 64 * 1024;
+
+// Upstream buffer size, as the kernel collector's BufferedWriter.
+constexpr u32 UPSTREAM_BUFFER_SIZE = 64 * 1024;
+
+enum class Mode { encoder, direct };
+
+// Perf ring storage in process memory.
+class HeapPerfRingStorage : public PerfRingStorage {
+public:
+  HeapPerfRingStorage(u32 n_bytes)
+  {
+    page_size_ = getpagesize();
+    n_data_pages_ = n_bytes / page_size_;
+    memory_ = std::make_unique<u64[]>((page_size_ * (1 + n_data_pages_)) / sizeof(u64));
+    data_ = reinterpret_cast<char *>(memory_.get());
+  }
+
+  void set_callback(uv_loop_t &loop, void *ctx, CALLBACK cb) override {}
+
+private:
+  std::unique_ptr<u64[]> memory_;
+};
+
+// Upstream buffer that discards its contents instead of sending them.
+class DiscardingBufferedWriter : public IBufferedWriter {
+public:
+  DiscardingBufferedWriter() : buf_(UPSTREAM_BUFFER_SIZE) {}
+
+  Expected<u8 *, std::error_code> start_write(u32 length) override
+  {
+    if (UPSTREAM_BUFFER_SIZE - offset_ < length) {
+      offset_ = 0;
+    }
+    length_ = length;
+    return &buf_[offset_];
+  }
+
+  void finish_write() override
+  {
+    offset_ += length_;
+    bytes_written_ += length_;
+  }
+
+  std::error_code flush() override
+  {
+    offset_ = 0;
+    return {};
+  }
+
+  u32 buf_size() const override { return UPSTREAM_BUFFER_SIZE; }
+
+  bool is_writable() const override { return true; }
+
+  u64 bytes_written() const { return bytes_written_; }
+
+private:
+  std::vector<u8> buf_;
+  u32 offset_ = 0;
+  u32 length_ = 0;
+  u64 bytes_written_ = 0;
+};
+
+// Builds an event the way the generated perf_submit_* helpers lay it out:
+// u32 (size or unused), u32 unpadded size, u64 timestamp, wire message.
+template <typename Message> std::string make_event(u64 timestamp, Message const &msg)
+{
+  u32 const unpadded = sizeof(u64) + IngestPassthrough<Message>::size;
+  std::string event(sizeof(u64) + unpadded, '\0');
+  memcpy(&event[sizeof(u32)], &unpadded, sizeof(unpadded));
+  memcpy(&event[sizeof(u64)], &timestamp, sizeof(timestamp));
+  memcpy(&event[2 * sizeof(u64)], &msg, IngestPassthrough<Message>::size);
+  return event;
+}
+
+std::string make_event(u64 timestamp, size_t i)
+{
+  u64 const sk = 0xffff888000000000ull + (i % 4096) * 2048;
+  switch (i % 4) {
+  case 0:
+  case 1: {
+    jb_agent_internal__set_state_ipv4 msg = {};
+    msg._rpc_id = jb_agent_internal__set_state_ipv4__rpc_id;
+    msg.dest = 0x0100000a;
+    msg.src = 0x0200000a;
+    msg.dport = 443;
+    msg.sport = static_cast<u16>(32768 + i % 16384);
+    msg.sk = sk;
+    msg.tx_rx = 1;
+    return make_event(timestamp, msg);
+  }
+  case 2: {
+    jb_agent_internal__tcp_reset msg = {};
+    msg._rpc_id = jb_agent_internal__tcp_reset__rpc_id;
+    msg.sk = sk;
+    msg.is_rx = 1;
+    return make_event(timestamp, msg);
+  }
+  default: {
+    jb_agent_internal__http_response msg = {};
+    msg._rpc_id = jb_agent_internal__http_response__rpc_id;
+    msg.sk = sk;
+    msg.pid = 1234;
+    msg.code = 200;
+    msg.latency_ns = 250000;
+    msg.client_server = 0;
+    return make_event(timestamp, msg);
+  }
+  }
+}
+
+template <typename Message> void forward_direct(PerfReader &reader, IBufferedWriter &upstream, u16 length)
+{
+  auto allocated = upstream.start_write(length);
+  encode_passthrough_sample<Message>(*allocated, reader.peek_message());
+  upstream.finish_write();
+  reader.pop();
+}
+
+template <typename Message> Message pop_message(PerfReader &reader, u64 &timestamp)
+{
+  struct {
+    u64 timestamp;
+    Message msg;
+  } in;
+  reader.pop_and_copy_to(reinterpret_cast<char *>(&in));
+  timestamp = in.timestamp;
+  return in.msg;
+}
+
+// Drains all events from the container, the way BufferedPoller does.
+void drain(PerfContainer &container, Mode mode, IBufferedWriter &upstream, ebpf_net::ingest::Writer &writer)
+{
+  PerfReader reader(container, ~0ull);
+  while (!reader.empty()) {
+    u16 const length = reader.peek_unpadded_length();
+    u16 const rpc_id = reader.peek_rpc_id();
+    u64 timestamp;
+
+    switch (rpc_id) {
+    case jb_agent_internal__set_state_ipv4__rpc_id:
+      if (mode == Mode::direct) {
+        forward_direct<jb_agent_internal__set_state_ipv4>(reader, upstream, length);
+      } else {
+        auto const msg = pop_message<jb_agent_internal__set_state_ipv4>(reader, timestamp);
+        writer.set_state_ipv4_tstamp(timestamp, msg.dest, msg.src, msg.dport, msg.sport, msg.sk, msg.tx_rx);
+      }
+      break;
+
+    case jb_agent_internal__tcp_reset__rpc_id:
+      if (mode == Mode::direct) {
+        forward_direct<jb_agent_internal__tcp_reset>(reader, upstream, length);
+      } else {
+        auto const msg = pop_message<jb_agent_internal__tcp_reset>(reader, timestamp);
+        writer.tcp_reset_tstamp(timestamp, msg.sk, msg.is_rx);
+      }
+      break;
+
+    case jb_agent_internal__http_response__rpc_id:
+      if (mode == Mode::direct) {
+        forward_direct<jb_agent_internal__http_response>(reader, upstream, length);
+      } else {
+        auto const msg = pop_message<jb_agent_internal__http_response>(reader, timestamp);
+        writer.http_response_tstamp(timestamp, msg.sk, msg.pid, msg.code, msg.latency_ns, msg.client_server);
+      }
+      break;
+
+    default:
+      std::cerr << "unexpected rpc id " << rpc_id << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+}
+
+double run(Mode mode, std::chrono::milliseconds duration)
+{
+  PerfContainer container;
+  std::vector<PerfRing> rings;
+  for (size_t cpu = 0; cpu < NUM_CPUS; ++cpu) {
+    PerfRing ring(std::make_shared<HeapPerfRingStorage>(PERF_RING_N_BYTES));
+    container.add_ring(ring);
+    rings.push_back(ring);
+  }
+
+  DiscardingBufferedWriter upstream;
+  ebpf_net::ingest::Writer writer(upstream, [] { return 0ull; });
+
+  std::chrono::steady_clock::duration elapsed{};
+  u64 timestamp = 0;
+  while (elapsed < duration) {
+    // rounds don't fill the rings exactly, so samples end up wrapping around
+    for (auto &ring : rings) {
+      ring.start_write_batch();
+    }
+    for (size_t i = 0; i < EVENTS_PER_ROUND; ++i) {
+      rings[i % NUM_CPUS].write(make_event(timestamp + i, i), PERF_RECORD_SAMPLE);
+    }
+    for (auto &ring : rings) {
+      ring.finish_write_batch();
+    }
+    timestamp += EVENTS_PER_ROUND;
+
+    auto const start = std::chrono::steady_clock::now();
+    drain(container, mode, upstream, writer);
+    elapsed += std::chrono::steady_clock::now() - start;
+  }
+
+  return upstream.bytes_written() / std::chrono::duration<double>(elapsed).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  std::chrono::milliseconds duration{2000};
+
+  if (argc > 2) {
+    std::cerr << "usage: passthrough_encode_bench [duration_ms]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (argc == 2) {
+    duration = std::chrono::milliseconds{std::atoi(argv[1])};
+  }
+
+  for (Mode mode : {Mode::encoder, Mode::direct}) {
+    double const rate = run(mode, duration);
+    std::cout << (mode == Mode::encoder ? "encoder" : "direct") << ": " << static_cast<u64>(rate / (1024 * 1024)) << " MiB/sec"
+              << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,224 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Kernel collector event transport micro-benchmark
+ *
+ * Measures how fast `PerfReader` consumes events, in events per second, from
+ * per-CPU perf rings (merged by timestamp) and from a single BPF ring buffer
+ * (read in order), the two transports between the kernel collector's eBPF
+ * code and `BufferedPoller`.
+ *
+ * Rings live in process memory and are filled with synthetic events shaped
+ * like small agent_internal messages, with timestamps interleaved across
+ * CPUs. Only reading is timed; the cost of producing events in the kernel
+ * has to be measured on a live host.
+ */
+
+#include <collector/kernel/perf_reader.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Size of each event's message: timestamp followed by the wire message.
+constexpr u32 MESSAGE_SIZE = 48;
+
+// Per-CPU perf ring size, as in the kernel collector.
+constexpr u32 PERF_RING_N_BYTES = 1024 * 4096;
+
+// Number of CPUs to simulate in perf ring mode.
+constexpr size_t CPU_COUNTS[] = {1, 8, 64};
+
+// Events written, then read, per round; fits in a single perf ring.
+constexpr size_t EVENTS_PER_ROUND = 32 * 1024;
+
+// Builds an event the way the generated perf_submit_* helpers lay it out:
+// u32 (size or unused), u32 unpadded size, u64 timestamp, wire message.
+std::string make_event(u64 timestamp)
+{
+  std::string event(sizeof(u64) + MESSAGE_SIZE, '\0');
+  u32 const unpadded = MESSAGE_SIZE;
+  memcpy(&event[sizeof(u32)], &unpadded, sizeof(unpadded));
+  memcpy(&event[sizeof(u64)], &timestamp, sizeof(timestamp));
+  return event;
+}
+
+// Perf ring storage in process memory.
+class HeapPerfRingStorage : public PerfRingStorage {
+public:
+  HeapPerfRingStorage(u32 n_bytes)
+  {
+    page_size_ = getpagesize();
+    n_data_pages_ = n_bytes / page_size_;
+    memory_ = std::make_unique<u64[]>((page_size_ * (1 + n_data_pages_)) / sizeof(u64));
+    data_ = reinterpret_cast<char *>(memory_.get());
+  }
+
+  void set_callback(uv_loop_t &loop, void *ctx, CALLBACK cb) override {}
+
+private:
+  std::unique_ptr<u64[]> memory_;
+};
+
+// Producer and consumer positions, initialized before BpfRingBuffer reads them.
+struct RingBufferPositions {
+  unsigned long consumer_ = 0;
+  unsigned long producer_ = 0;
+};
+
+// BPF ring buffer in process memory, with the data area mapped twice like
+// the kernel does.
+class MemoryRingBuffer : private RingBufferPositions, public BpfRingBuffer {
+public:
+  static std::unique_ptr<MemoryRingBuffer> create()
+  {
+    int fd = memfd_create("perf_reader_bench", 0);
+    if (fd < 0 || ftruncate(fd, EVENTS_RINGBUF_N_BYTES) != 0) {
+      std::cerr << "memfd_create failed: " << strerror(errno) << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+
+    char *data = static_cast<char *>(mmap(NULL, 2 * EVENTS_RINGBUF_N_BYTES, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (data == MAP_FAILED ||
+        mmap(data, EVENTS_RINGBUF_N_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap(data + EVENTS_RINGBUF_N_BYTES, EVENTS_RINGBUF_N_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) ==
+            MAP_FAILED) {
+      std::cerr << "mmap failed: " << strerror(errno) << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    close(fd);
+
+    return std::unique_ptr<MemoryRingBuffer>(new MemoryRingBuffer(data));
+  }
+
+  // Writes a committed record, like bpf_ringbuf_submit.
+  void write(std::string_view payload)
+  {
+    char *record = &memory_[producer_ & (EVENTS_RINGBUF_N_BYTES - 1)];
+    memcpy(record + BPF_RINGBUF_HDR_SZ, payload.data(), payload.size());
+    u32 const len = payload.size();
+    memcpy(record, &len, sizeof(len));
+    producer_ += (len + BPF_RINGBUF_HDR_SZ + 7) & ~7u;
+  }
+
+private:
+  MemoryRingBuffer(char *data) : BpfRingBuffer(&consumer_, &producer_, data, EVENTS_RINGBUF_N_BYTES), memory_(data) {}
+
+  char *memory_;
+};
+
+// Drains all events from the container, the way BufferedPoller does.
+u64 drain(PerfContainer &container)
+{
+  u64 count = 0;
+  PerfReader reader(container, ~0ull);
+  char buf[sizeof(u64) + MESSAGE_SIZE];
+  while (!reader.empty()) {
+    reader.pop_and_copy_to(buf);
+    ++count;
+  }
+  return count;
+}
+
+template <typename Fill> double run(PerfContainer &container, Fill &&fill, std::chrono::milliseconds duration)
+{
+  u64 events = 0;
+  std::chrono::steady_clock::duration elapsed{};
+  u64 timestamp = 0;
+
+  while (elapsed < duration) {
+    fill(timestamp);
+    timestamp += EVENTS_PER_ROUND;
+
+    auto const start = std::chrono::steady_clock::now();
+    u64 const count = drain(container);
+    elapsed += std::chrono::steady_clock::now() - start;
+
+    if (count != EVENTS_PER_ROUND) {
+      std::cerr << "read " << count << " events, expected " << EVENTS_PER_ROUND << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    events += count;
+  }
+
+  return events / std::chrono::duration<double>(elapsed).count();
+}
+
+double run_perf_rings(size_t num_cpus, std::chrono::milliseconds duration)
+{
+  PerfContainer container;
+  std::vector<PerfRing> writers;
+  for (size_t cpu = 0; cpu < num_cpus; ++cpu) {
+    PerfRing ring(std::make_shared<HeapPerfRingStorage>(PERF_RING_N_BYTES));
+    container.add_ring(ring);
+    writers.push_back(ring);
+  }
+
+  auto fill = [&](u64 timestamp) {
+    for (auto &writer : writers) {
+      writer.start_write_batch();
+    }
+    // consecutive events land on different CPUs, so the reader has to merge
+    for (size_t i = 0; i < EVENTS_PER_ROUND; ++i) {
+      writers[i % num_cpus].write(make_event(timestamp + i), PERF_RECORD_SAMPLE);
+    }
+    for (auto &writer : writers) {
+      writer.finish_write_batch();
+    }
+  };
+
+  return run(container, fill, duration);
+}
+
+double run_ring_buffer(std::chrono::milliseconds duration)
+{
+  static u64 const lost_count = 0;
+
+  PerfContainer container;
+  auto ring = MemoryRingBuffer::create();
+  auto &writer = *ring;
+  container.set_ring_buffer(std::move(ring), &lost_count);
+
+  auto fill = [&](u64 timestamp) {
+    for (size_t i = 0; i < EVENTS_PER_ROUND; ++i) {
+      writer.write(make_event(timestamp + i));
+    }
+  };
+
+  return run(container, fill, duration);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  std::chrono::milliseconds duration{2000};
+
+  if (argc > 2) {
+    std::cerr << "usage: perf_reader_bench [duration_ms]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (argc == 2) {
+    duration = std::chrono::milliseconds{std::atoi(argv[1])};
+  }
+
+  for (size_t num_cpus : CPU_COUNTS) {
+    double const rate = run_perf_rings(num_cpus, duration);
+    std::cout << "perf rings, " << num_cpus << " cpus: " << static_cast<u64>(rate) << " events/sec" << std::endl;
+  }
+
+  double const rate = run_ring_buffer(duration);
+  std::cout << "ring buffer: " << static_cast<u64>(rate) << " events/sec" << std::endl;
+
+  return EXIT_SUCCESS;
+}
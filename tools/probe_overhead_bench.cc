@@ -0,0 +1,257 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Kernel collector per-probe overhead benchmark
+ *
+ * Measures what the kernel collector's hot TCP receive probes
+ * (tcp_rcv_established, tcp_event_data_recv, tcp_rtt_estimator) add to a
+ * loopback TCP ping-pong, in nanoseconds per round trip, when attached as
+ * kprobes and as fentry programs (BPF trampolines), compared to running with
+ * no probes attached.
+ *
+ * The benchmark's sockets are not tracked in tcp_open_sockets, so probes
+ * return after the map lookup: this measures the probe entry cost, which is
+ * what differs between the two modes, and not the work shared by both.
+ *
+ * Loads the kernel collector's eBPF object, so it must run as root on the
+ * host being measured.
+ */
+
+#include <platform/platform.h>
+
+#include <bpf/btf.h>
+#include <bpf/libbpf.h>
+
+extern "C" {
+#include "generated/render_bpf.skel.h"
+}
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+enum class Mode { none, kprobe, fentry };
+
+char const *mode_name(Mode mode)
+{
+  switch (mode) {
+  case Mode::none:
+    return "no probes";
+  case Mode::kprobe:
+    return "kprobe";
+  case Mode::fentry:
+    return "fentry";
+  }
+  return "";
+}
+
+// Kprobe programs and the kernel function each one is attached to; fentry
+// flavours are named with a "__fentry" suffix and trace the same function.
+struct Probe {
+  char const *func_name;
+  char const *k_func_name;
+};
+
+constexpr Probe PROBES[] = {
+    {"on_tcp_rcv_established", "tcp_rcv_established"},
+    {"on_tcp_event_data_recv", "tcp_event_data_recv"},
+    {"on_tcp_rtt_estimator", "tcp_rtt_estimator"},
+};
+
+[[noreturn]] void fail(std::string const &what)
+{
+  std::cerr << what << ": " << strerror(errno) << std::endl;
+  std::exit(EXIT_FAILURE);
+}
+
+// Loads the eBPF object with only the programs under test, and attaches them.
+class ProbeSet {
+public:
+  ProbeSet(Mode mode, btf const *vmlinux_btf)
+  {
+    if (mode == Mode::none) {
+      return;
+    }
+
+    skel_ = render_bpf_bpf__open();
+    if (!skel_) {
+      fail("cannot open BPF skeleton");
+    }
+    bpf_map__set_autocreate(skel_->maps.events_ringbuf, false);
+
+    std::vector<std::pair<bpf_program *, char const *>> programs;
+    bpf_program *prog;
+    bpf_object__for_each_program(prog, skel_->obj)
+    {
+      bpf_program__set_autoload(prog, false);
+    }
+    for (auto const &probe : PROBES) {
+      std::string name = probe.func_name;
+      if (mode == Mode::fentry) {
+        if (btf__find_by_name_kind(vmlinux_btf, probe.k_func_name, BTF_KIND_FUNC) < 0) {
+          std::cout << "  " << probe.k_func_name << " is not in kernel BTF, skipped" << std::endl;
+          continue;
+        }
+        name += "__fentry";
+      }
+      prog = bpf_object__find_program_by_name(skel_->obj, name.c_str());
+      if (!prog) {
+        std::cerr << "cannot find program " << name << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      bpf_program__set_autoload(prog, true);
+      programs.emplace_back(prog, probe.k_func_name);
+    }
+
+    if (render_bpf_bpf__load(skel_) != 0) {
+      fail("cannot load BPF skeleton");
+    }
+
+    for (auto [program, k_func_name] : programs) {
+      bpf_link *link =
+          (mode == Mode::fentry) ? bpf_program__attach_trace(program) : bpf_program__attach_kprobe(program, false, k_func_name);
+      if (!link) {
+        std::cout << "  cannot attach " << bpf_program__name(program) << ", skipped" << std::endl;
+        continue;
+      }
+      links_.push_back(link);
+    }
+  }
+
+  ~ProbeSet()
+  {
+    for (auto link : links_) {
+      bpf_link__destroy(link);
+    }
+    if (skel_) {
+      render_bpf_bpf__destroy(skel_);
+    }
+  }
+
+  ProbeSet(ProbeSet const &) = delete;
+  ProbeSet &operator=(ProbeSet const &) = delete;
+
+private:
+  render_bpf_bpf *skel_ = nullptr;
+  std::vector<bpf_link *> links_;
+};
+
+// Returns a connected pair of loopback TCP sockets.
+std::pair<int, int> connected_pair()
+{
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof(addr);
+  if (listener < 0 || bind(listener, (sockaddr *)&addr, sizeof(addr)) != 0 || listen(listener, 1) != 0 ||
+      getsockname(listener, (sockaddr *)&addr, &addr_len) != 0) {
+    fail("cannot listen on loopback");
+  }
+
+  int client = socket(AF_INET, SOCK_STREAM, 0);
+  if (client < 0 || connect(client, (sockaddr *)&addr, sizeof(addr)) != 0) {
+    fail("cannot connect on loopback");
+  }
+  int server = accept(listener, nullptr, nullptr);
+  if (server < 0) {
+    fail("cannot accept on loopback");
+  }
+  close(listener);
+
+  int one = 1;
+  setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  setsockopt(server, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  return {client, server};
+}
+
+// Bounces one byte between two threads over loopback TCP, returning the mean
+// round trip time in nanoseconds.
+double ping_pong(std::chrono::milliseconds duration)
+{
+  auto [client, server] = connected_pair();
+
+  std::thread echo([server = server] {
+    char byte;
+    while (read(server, &byte, 1) == 1) {
+      if (write(server, &byte, 1) != 1) {
+        break;
+      }
+    }
+  });
+
+  u64 round_trips = 0;
+  char byte = 0;
+  auto const start = std::chrono::steady_clock::now();
+  auto const end = start + duration;
+  auto now = start;
+  while (now < end) {
+    // check the clock every batch of round trips, not after each one
+    for (int i = 0; i < 256; ++i) {
+      if (write(client, &byte, 1) != 1 || read(client, &byte, 1) != 1) {
+        fail("ping-pong failed");
+      }
+    }
+    round_trips += 256;
+    now = std::chrono::steady_clock::now();
+  }
+
+  shutdown(client, SHUT_WR);
+  echo.join();
+  close(client);
+  close(server);
+
+  return std::chrono::duration<double, std::nano>(now - start).count() / round_trips;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  std::chrono::milliseconds duration{5000};
+
+  if (argc > 2) {
+    std::cerr << "usage: probe_overhead_bench [duration_ms]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (argc == 2) {
+    duration = std::chrono::milliseconds{std::atoi(argv[1])};
+  }
+
+  btf *vmlinux_btf = btf__load_vmlinux_btf();
+  if (!vmlinux_btf) {
+    std::cout << "kernel BTF not available, fentry mode will be skipped" << std::endl;
+  }
+
+  double baseline = 0;
+  for (Mode mode : {Mode::none, Mode::kprobe, Mode::fentry}) {
+    if (mode == Mode::fentry && !vmlinux_btf) {
+      continue;
+    }
+
+    std::cout << mode_name(mode) << ":" << std::endl;
+    ProbeSet probes(mode, vmlinux_btf);
+    double const rtt_ns = ping_pong(duration);
+    if (mode == Mode::none) {
+      baseline = rtt_ns;
+    }
+    std::cout << "  " << static_cast<u64>(rtt_ns) << " ns/round trip, overhead "
+              << static_cast<s64>(rtt_ns - baseline) << " ns" << std::endl;
+  }
+
+  btf__free(vmlinux_btf);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,260 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Reducer reconnect storm simulation
+ *
+ * Simulates N kernel collectors reconnecting to a restarted reducer, and
+ * measures how long each takes to reach steady state, i.e. for the reducer to
+ * have handled the whole initial dump of its state, and how many bytes pile up
+ * in the reducer waiting to be handled.
+ *
+ *  - unlimited: every connection is admitted, and dumps at full speed
+ *  - admission: connections go through the reducer's AdmissionControl; deferred
+ *    collectors retry after their reconnect backoff, paced ones dump slower
+ *
+ * Collectors and the reducer are modelled, not run: collectors reconnect after
+ * the kernel collector's backoff and probe hold-off, dump a random amount of
+ * state at a fixed rate, with at most a socket buffer's worth of data unread
+ * per connection, and the reducer handles a fixed number of bytes per second,
+ * shared evenly among connections.
+ */
+
+#include <reducer/admission_control.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using reducer::AdmissionControl;
+
+constexpr std::size_t DEFAULT_COLLECTORS[] = {1000, 5000, 10000};
+
+constexpr u64 NS_PER_SEC = 1'000'000'000;
+constexpr u64 TICK_NS = 10'000'000;
+constexpr double TICK_SEC = static_cast<double>(TICK_NS) / NS_PER_SEC;
+
+// Collector reconnect backoff: 5s plus up to 10s of jitter.
+constexpr u64 RECONNECT_NS = 5 * NS_PER_SEC;
+constexpr u64 RECONNECT_JITTER_NS = 10 * NS_PER_SEC;
+// Time between a collector connecting and starting its dump.
+constexpr u64 PROBE_HOLDOFF_NS = 2 * NS_PER_SEC;
+
+// Size of a collector's initial dump, and how fast it is sent.
+constexpr double MIN_DUMP_BYTES = 256 * 1024;
+constexpr double MAX_DUMP_BYTES = 2 * 1024 * 1024;
+constexpr double DUMP_BYTES_PER_SEC = 16 * 1024 * 1024;
+// Paced dumps work 10ms out of every 40ms (see BPFHandler).
+constexpr double PACED_DUMP_BYTES_PER_SEC = DUMP_BYTES_PER_SEC / 4;
+// Telemetry sent once in steady state.
+constexpr double STEADY_BYTES_PER_SEC = 2 * 1024;
+// Bytes sent but not handled by the reducer, per connection.
+constexpr double SOCKET_BUFFER_BYTES = 256 * 1024;
+
+// Bytes the reducer handles per second, across all connections.
+constexpr double REDUCER_BYTES_PER_SEC = 100 * 1024 * 1024;
+
+// Admission limits of the `admission` mode.
+constexpr AdmissionControl::Config ADMISSION_CONFIG{
+    .connection_rate = 80,
+    .byte_rate = REDUCER_BYTES_PER_SEC * 0.8,
+};
+
+enum class Mode { unlimited, admission };
+
+enum class State { waiting, holdoff, dumping, steady };
+
+struct Collector {
+  State state = State::waiting;
+  // Time of the next connection attempt, or when the dump starts.
+  u64 next_ns = 0;
+  u64 connected_ns = 0;
+  bool paced = false;
+  // Dump bytes left to send, and bytes sent but not handled yet.
+  double to_send = 0;
+  double unhandled = 0;
+};
+
+struct Result {
+  u64 deferred = 0;
+  u64 paced = 0;
+  double peak_unhandled = 0;
+  // Since the reducer restarted, and since the connection was admitted.
+  std::vector<u64> since_restart_ns;
+  std::vector<u64> since_connect_ns;
+};
+
+u64 jitter(std::mt19937_64 &rng)
+{
+  return std::uniform_int_distribution<u64>(0, RECONNECT_JITTER_NS)(rng);
+}
+
+// Shares `budget` bytes evenly among the connections with unhandled bytes.
+// Returns the bytes handled.
+double handle(std::vector<Collector *> &pending, double budget)
+{
+  double handled = 0;
+  while (!pending.empty() && budget - handled > 1) {
+    double const share = (budget - handled) / pending.size();
+    for (auto *collector : pending) {
+      double const bytes = std::min(share, collector->unhandled);
+      collector->unhandled -= bytes;
+      handled += bytes;
+    }
+    pending.erase(
+        std::remove_if(pending.begin(), pending.end(), [](Collector *collector) { return collector->unhandled <= 0; }),
+        pending.end());
+  }
+  return handled;
+}
+
+Result run(Mode mode, std::size_t count)
+{
+  std::mt19937_64 rng(count);
+  std::uniform_real_distribution<double> dump_size(MIN_DUMP_BYTES, MAX_DUMP_BYTES);
+
+  std::vector<Collector> collectors(count);
+  for (auto &collector : collectors) {
+    collector.next_ns = RECONNECT_NS + jitter(rng);
+    collector.to_send = dump_size(rng);
+  }
+
+  AdmissionControl admission;
+  if (mode == Mode::admission) {
+    admission = AdmissionControl(ADMISSION_CONFIG, 0);
+  }
+
+  Result result;
+  std::size_t steady = 0;
+  std::vector<Collector *> pending;
+
+  for (u64 now = 0; steady < count; now += TICK_NS) {
+    pending.clear();
+    double unhandled = 0;
+
+    for (auto &collector : collectors) {
+      switch (collector.state) {
+      case State::waiting:
+        if (collector.next_ns > now) {
+          break;
+        }
+        switch (admission.on_new_connection(now)) {
+        case AdmissionControl::Decision::defer:
+          ++result.deferred;
+          collector.next_ns = now + RECONNECT_NS + jitter(rng);
+          break;
+        case AdmissionControl::Decision::pace:
+          ++result.paced;
+          collector.paced = true;
+          [[fallthrough]];
+        case AdmissionControl::Decision::admit:
+          collector.state = State::holdoff;
+          collector.connected_ns = now;
+          collector.next_ns = now + PROBE_HOLDOFF_NS;
+          break;
+        }
+        break;
+
+      case State::holdoff:
+        if (collector.next_ns <= now) {
+          collector.state = State::dumping;
+        }
+        break;
+
+      case State::dumping: {
+        double const rate = collector.paced ? PACED_DUMP_BYTES_PER_SEC : DUMP_BYTES_PER_SEC;
+        double const bytes = std::min({rate * TICK_SEC, collector.to_send, SOCKET_BUFFER_BYTES - collector.unhandled});
+        collector.to_send -= bytes;
+        collector.unhandled += bytes;
+        break;
+      }
+
+      case State::steady:
+        collector.unhandled += STEADY_BYTES_PER_SEC * TICK_SEC;
+        break;
+      }
+
+      if (collector.unhandled > 0) {
+        pending.push_back(&collector);
+        unhandled += collector.unhandled;
+      }
+    }
+
+    result.peak_unhandled = std::max(result.peak_unhandled, unhandled);
+    admission.on_bytes_received(static_cast<u64>(handle(pending, REDUCER_BYTES_PER_SEC * TICK_SEC)), now);
+
+    for (auto &collector : collectors) {
+      if (collector.state == State::dumping && collector.to_send <= 0 && collector.unhandled <= 0) {
+        collector.state = State::steady;
+        result.since_restart_ns.push_back(now);
+        result.since_connect_ns.push_back(now - collector.connected_ns);
+        ++steady;
+      }
+    }
+  }
+
+  return result;
+}
+
+std::string seconds(u64 ns)
+{
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1) << static_cast<double>(ns) / NS_PER_SEC << "s";
+  return out.str();
+}
+
+void report_times(char const *label, std::vector<u64> &times)
+{
+  std::sort(times.begin(), times.end());
+
+  u64 total = 0;
+  for (auto const time : times) {
+    total += time;
+  }
+
+  std::cout << "  time to steady state " << label << ": mean " << seconds(total / times.size()) << ", p50 "
+            << seconds(times[times.size() / 2]) << ", p99 " << seconds(times[(times.size() * 99) / 100]) << ", max "
+            << seconds(times.back()) << std::endl;
+}
+
+void report(char const *label, std::size_t count, Result &result)
+{
+  std::cout << label << ", " << count << " collectors: " << result.deferred << " connections deferred, " << result.paced
+            << " paced, peak unhandled " << static_cast<u64>(result.peak_unhandled / (1024 * 1024)) << "MiB" << std::endl;
+  report_times("since restart", result.since_restart_ns);
+  report_times("since connect", result.since_connect_ns);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  std::vector<std::size_t> counts(std::begin(DEFAULT_COLLECTORS), std::end(DEFAULT_COLLECTORS));
+
+  if (argc > 1) {
+    counts.clear();
+    for (int i = 1; i < argc; ++i) {
+      counts.push_back(std::strtoull(argv[i], nullptr, 10));
+      if (counts.back() == 0) {
+        std::cerr << "usage: reconnect_storm_bench [collectors...]" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  for (auto const count : counts) {
+    for (Mode mode : {Mode::unlimited, Mode::admission}) {
+      auto result = run(mode, count);
+      report(mode == Mode::unlimited ? "unlimited" : "admission", count, result);
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * RPC queue micro-benchmark
+ *
+ * Measures the throughput, in messages per second, of the element queues
+ * used for message-passing between reducer cores, for a few sender/receiver
+ * matrix shapes (1:1 and N:M).
+ *
+ * Each sender thread writes small fixed-size messages round-robin to every
+ * receiver, and each receiver thread drains all of its queues in batches,
+ * the same way reducer cores do.
+ */
+
+#include <reducer/rpc_queue_matrix.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Size of each message, roughly that of a small render message.
+constexpr u32 MESSAGE_SIZE = 64;
+
+// Queue dimensions; smaller than the reducer's defaults to keep the
+// benchmark's memory footprint modest for larger matrices.
+constexpr u32 QUEUE_N_ELEMS = (1 << 16);
+constexpr u32 QUEUE_BUF_LEN = (1 << 22);
+
+struct MatrixShape {
+  size_t num_senders;
+  size_t num_receivers;
+};
+
+constexpr MatrixShape SHAPES[] = {
+    {1, 1},
+    {2, 2},
+    {4, 4},
+    {8, 4},
+};
+
+double run(MatrixShape shape, std::chrono::milliseconds duration)
+{
+  reducer::RpcQueueMatrix queues(shape.num_senders, shape.num_receivers, QUEUE_N_ELEMS, QUEUE_BUF_LEN);
+
+  std::atomic<bool> senders_done{false};
+  std::atomic<bool> receivers_done{false};
+  std::atomic<bool> start{false};
+  std::atomic<u64> received{0};
+
+  std::vector<std::thread> receivers;
+  for (size_t r = 0; r < shape.num_receivers; ++r) {
+    receivers.emplace_back([&, readers = queues.make_readers(r)]() mutable {
+      u64 count = 0;
+      bool done = false;
+      while (!done) {
+        // read the flag before draining, so nothing written before it was set
+        // is left behind
+        done = receivers_done.load(std::memory_order_acquire);
+        for (auto &reader : readers) {
+          reader.start_read_batch();
+          char *data;
+          while (reader.read(data) > 0) {
+            ++count;
+          }
+          reader.finish_read_batch();
+        }
+      }
+      received += count;
+    });
+  }
+
+  std::vector<std::thread> senders;
+  for (size_t s = 0; s < shape.num_senders; ++s) {
+    senders.emplace_back([&, writers = queues.make_writers<std::reference_wrapper<ElementQueueWriter>>(s)]() {
+      while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      u64 seq = 0;
+      while (!senders_done.load(std::memory_order_relaxed)) {
+        for (ElementQueueWriter &writer : writers) {
+          auto buf = writer.start_write(MESSAGE_SIZE);
+          if (!buf) {
+            std::cerr << "write failed: " << buf.error().message() << std::endl;
+            std::exit(EXIT_FAILURE);
+          }
+          std::memcpy(*buf, &seq, sizeof(seq));
+          writer.finish_write();
+          ++seq;
+        }
+      }
+    });
+  }
+
+  auto const start_time = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  std::this_thread::sleep_for(duration);
+
+  senders_done = true;
+  for (auto &sender : senders) {
+    sender.join();
+  }
+
+  receivers_done.store(true, std::memory_order_release);
+  for (auto &receiver : receivers) {
+    receiver.join();
+  }
+  auto const elapsed = std::chrono::steady_clock::now() - start_time;
+
+  return received / std::chrono::duration<double>(elapsed).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  std::chrono::milliseconds duration{2000};
+
+  if (argc > 2) {
+    std::cerr << "usage: rpc_queue_bench [duration_ms]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (argc == 2) {
+    duration = std::chrono::milliseconds{std::atoi(argv[1])};
+  }
+
+  for (auto const &shape : SHAPES) {
+    double const rate = run(shape, duration);
+    std::cout << shape.num_senders << ":" << shape.num_receivers << " " << static_cast<u64>(rate) << " msgs/sec"
+              << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Span pool memory benchmark
+ *
+ * Compares the memory footprint of fixed-size span pools (Pool) against
+ * growable ones (ChunkedPool), for a pool sized like the reducer's largest
+ * spans, populated as for a small cluster and for a large one.
+ *
+ * Each scenario runs in its own child process and reports the virtual memory
+ * size and resident set size of that process after populating the pool.
+ */
+
+#include <util/chunked_pool.h>
+#include <util/pool.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+// Pool dimensions, matching e.g. the `flow` span in render/ebpf_net.render.
+constexpr std::size_t POOL_SIZE = 4200000;
+constexpr std::size_t POOL_CHUNK_SIZE = 65536;
+
+// Number of live spans for each cluster size.
+constexpr std::size_t SMALL_CLUSTER_SPANS = 10000;
+constexpr std::size_t LARGE_CLUSTER_SPANS = 4000000;
+
+// Stand-in for a generated span, roughly the size of a flow span.
+struct span_t {
+  u64 fields[24];
+  u32 __refcount;
+};
+
+// Prints the VmSize and VmRSS lines of /proc/self/status.
+void print_memory_usage(std::string_view label)
+{
+  std::ifstream status("/proc/self/status");
+  std::string vm_size, vm_rss;
+  for (std::string line; std::getline(status, line);) {
+    if (line.rfind("VmSize:", 0) == 0) {
+      vm_size = line.substr(7);
+    } else if (line.rfind("VmRSS:", 0) == 0) {
+      vm_rss = line.substr(6);
+    }
+  }
+
+  auto trim = [](std::string const &s) { return s.substr(s.find_first_not_of(" \t")); };
+  std::cout << label << ": virtual " << trim(vm_size) << ", resident " << trim(vm_rss) << std::endl;
+}
+
+template <typename PoolType> void populate(std::string_view label, std::size_t num_spans)
+{
+  auto pool = std::make_unique<PoolType>();
+  for (std::size_t i = 0; i < num_spans; ++i) {
+    if (pool->emplace().index == PoolType::invalid) {
+      std::cerr << label << ": pool full after " << i << " spans" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  print_memory_usage(label);
+}
+
+// Runs `fn` in a child process so each scenario starts from a clean slate.
+template <typename Fn> void run_isolated(Fn &&fn)
+{
+  pid_t pid = fork();
+  if (pid < 0) {
+    std::perror("fork");
+    std::exit(EXIT_FAILURE);
+  }
+  if (pid == 0) {
+    fn();
+    std::exit(EXIT_SUCCESS);
+  }
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+}
+
+} // namespace
+
+int main()
+{
+  using fixed_pool = Pool<span_t, POOL_SIZE>;
+  using chunked_pool = ChunkedPool<span_t, POOL_SIZE, POOL_CHUNK_SIZE>;
+
+  run_isolated([] { print_memory_usage("baseline"); });
+
+  run_isolated([] { populate<fixed_pool>("fixed, small cluster", SMALL_CLUSTER_SPANS); });
+  run_isolated([] { populate<chunked_pool>("chunked, small cluster", SMALL_CLUSTER_SPANS); });
+
+  run_isolated([] { populate<fixed_pool>("fixed, large cluster", LARGE_CLUSTER_SPANS); });
+  run_isolated([] { populate<chunked_pool>("chunked, large cluster", LARGE_CLUSTER_SPANS); });
+
+  return EXIT_SUCCESS;
+}
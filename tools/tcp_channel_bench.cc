@@ -0,0 +1,300 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * TCPChannel loopback throughput benchmark
+ *
+ * Sends messages of a few sizes over a loopback TCP connection, on a single
+ * libuv loop, and reports the throughput.
+ *
+ *  - per-send: each send is copied into its own malloc-ed buffer and written
+ *    with its own uv_write, the way TCPChannel used to send
+ *  - tcp_channel: sends go through TCPChannel, which copies them into pooled
+ *    buffers and writes those queued behind a write in flight together
+ *
+ * Either way, data is received by a TCPChannel which handles whole messages,
+ * leaving partial ones in its receive buffer, as protocol handlers do. The
+ * sender keeps at most MAX_PENDING_BYTES sent but not written to the socket.
+ */
+
+#include <channel/callbacks.h>
+#include <channel/tcp_channel.h>
+#include <util/uv_helpers.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <uv.h>
+
+namespace {
+
+using channel::TCPChannel;
+
+constexpr u32 DEFAULT_MESSAGE_SIZES[] = {64, 1024, 16 * 1024};
+constexpr u64 DEFAULT_TOTAL_BYTES = 256 * 1024 * 1024;
+constexpr u64 MAX_PENDING_BYTES = 1024 * 1024;
+
+enum class Mode { per_send, tcp_channel };
+
+// Handles whole messages, leaving partial ones in the receive buffer.
+class Receiver : public channel::Callbacks {
+public:
+  Receiver(u32 message_size, u64 total_bytes, std::function<void()> on_done)
+      : message_size_(message_size), total_bytes_(total_bytes), on_done_(std::move(on_done))
+  {}
+
+  u32 received_data(u8 const *data, int length) override
+  {
+    u32 const handled = length - length % message_size_;
+    received_ += handled;
+    if (received_ == total_bytes_) {
+      on_done_();
+    }
+    return handled;
+  }
+
+  void on_error(int error) override
+  {
+    if (received_ < total_bytes_) {
+      std::cerr << "receive error: " << uv_error_t{error} << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  }
+
+private:
+  u32 const message_size_;
+  u64 const total_bytes_;
+  std::function<void()> on_done_;
+  u64 received_ = 0;
+};
+
+class Sender {
+public:
+  virtual ~Sender() = default;
+
+  // Connects to `port` on localhost, calling `on_connect` once connected.
+  virtual void connect(u16 port, std::function<void()> on_connect) = 0;
+
+  virtual void send(u8 const *data, u32 len) = 0;
+
+  // Bytes sent but not written to the socket.
+  virtual u64 pending_bytes() const = 0;
+
+  virtual void close() = 0;
+};
+
+// Sends through a TCPChannel.
+class ChannelSender : public Sender, private channel::Callbacks {
+public:
+  explicit ChannelSender(uv_loop_t &loop) : loop_(loop) {}
+
+  void connect(u16 port, std::function<void()> on_connect) override
+  {
+    on_connect_ = std::move(on_connect);
+    channel_ = std::make_unique<TCPChannel>(loop_, "127.0.0.1", std::to_string(port));
+    channel_->connect(*this);
+  }
+
+  void send(u8 const *data, u32 len) override { channel_->send(data, len); }
+
+  u64 pending_bytes() const override { return channel_->pending_send_bytes(); }
+
+  void close() override { channel_->close_permanently(); }
+
+private:
+  void on_connect() override { on_connect_(); }
+
+  void on_error(int error) override
+  {
+    std::cerr << "send error: " << uv_error_t{error} << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  uv_loop_t &loop_;
+  std::function<void()> on_connect_;
+  std::unique_ptr<TCPChannel> channel_;
+};
+
+// Sends each message with its own malloc-ed buffer and uv_write.
+class PerSendSender : public Sender {
+public:
+  explicit PerSendSender(uv_loop_t &loop)
+  {
+    CHECK_UV(uv_tcp_init(&loop, &conn_));
+    conn_.data = this;
+  }
+
+  void connect(u16 port, std::function<void()> on_connect) override
+  {
+    on_connect_ = std::move(on_connect);
+
+    struct sockaddr_in addr;
+    CHECK_UV(uv_ip4_addr("127.0.0.1", port, &addr));
+    CHECK_UV(uv_tcp_connect(&connect_req_, &conn_, reinterpret_cast<sockaddr const *>(&addr), &connect_cb));
+  }
+
+  void send(u8 const *data, u32 len) override
+  {
+    auto *buffer = static_cast<send_buffer_t *>(malloc(sizeof(send_buffer_t) + len));
+    memset(buffer, 0, sizeof(send_buffer_t) + len);
+    memcpy(buffer->data, data, len);
+    buffer->len = len;
+
+    uv_buf_t uv_buf = uv_buf_init(reinterpret_cast<char *>(buffer->data), len);
+    CHECK_UV(uv_write(&buffer->req, reinterpret_cast<uv_stream_t *>(&conn_), &uv_buf, 1, &write_cb));
+    pending_bytes_ += len;
+  }
+
+  u64 pending_bytes() const override { return pending_bytes_; }
+
+  void close() override { uv_close(reinterpret_cast<uv_handle_t *>(&conn_), nullptr); }
+
+private:
+  struct send_buffer_t {
+    uv_write_t req; /* must be first */
+    u32 len;
+    u64 data[0];
+  };
+
+  static void connect_cb(uv_connect_t *req, int status)
+  {
+    CHECK_UV(status);
+    auto *sender = static_cast<PerSendSender *>(req->handle->data);
+    CHECK_UV(uv_tcp_nodelay(&sender->conn_, true));
+    sender->on_connect_();
+  }
+
+  static void write_cb(uv_write_t *req, int status)
+  {
+    auto *buffer = reinterpret_cast<send_buffer_t *>(req);
+    static_cast<PerSendSender *>(req->handle->data)->pending_bytes_ -= buffer->len;
+    free(buffer);
+  }
+
+  uv_tcp_t conn_;
+  uv_connect_t connect_req_;
+  std::function<void()> on_connect_;
+  u64 pending_bytes_ = 0;
+};
+
+struct Run {
+  uv_loop_t loop;
+  uv_tcp_t listener;
+  uv_idle_t idle;
+
+  std::unique_ptr<Sender> sender;
+  std::unique_ptr<TCPChannel> server;
+  std::unique_ptr<Receiver> receiver;
+
+  std::vector<u8> message;
+  u64 total_bytes = 0;
+  u64 sent_bytes = 0;
+
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+};
+
+void send_cb(uv_idle_t *idle)
+{
+  auto &run = *static_cast<Run *>(idle->data);
+
+  while (run.sent_bytes < run.total_bytes && run.sender->pending_bytes() < MAX_PENDING_BYTES) {
+    run.sender->send(run.message.data(), run.message.size());
+    run.sent_bytes += run.message.size();
+  }
+
+  if (run.sent_bytes == run.total_bytes) {
+    uv_idle_stop(idle);
+  }
+}
+
+void accept_cb(uv_stream_t *listener, int status)
+{
+  CHECK_UV(status);
+  auto &run = *static_cast<Run *>(listener->data);
+  run.server->accept(*run.receiver, reinterpret_cast<uv_tcp_t *>(listener));
+}
+
+// Returns the throughput in bytes per second.
+double measure(Mode mode, u32 message_size, u64 total_bytes)
+{
+  Run run;
+  CHECK_UV(uv_loop_init(&run.loop));
+
+  run.message.resize(message_size);
+  for (u32 i = 0; i < message_size; ++i) {
+    run.message[i] = static_cast<u8>(i);
+  }
+  run.total_bytes = total_bytes - total_bytes % message_size;
+
+  run.receiver = std::make_unique<Receiver>(message_size, run.total_bytes, [&run] {
+    run.end = std::chrono::steady_clock::now();
+    run.sender->close();
+    run.server->close_permanently();
+    uv_close(reinterpret_cast<uv_handle_t *>(&run.listener), nullptr);
+    uv_close(reinterpret_cast<uv_handle_t *>(&run.idle), nullptr);
+  });
+  run.server = std::make_unique<TCPChannel>(run.loop);
+
+  struct sockaddr_in addr;
+  CHECK_UV(uv_ip4_addr("127.0.0.1", 0, &addr));
+  CHECK_UV(uv_tcp_init(&run.loop, &run.listener));
+  run.listener.data = &run;
+  CHECK_UV(uv_tcp_bind(&run.listener, reinterpret_cast<sockaddr const *>(&addr), 0));
+  CHECK_UV(uv_listen(reinterpret_cast<uv_stream_t *>(&run.listener), 1, &accept_cb));
+
+  int addr_len = sizeof(addr);
+  CHECK_UV(uv_tcp_getsockname(&run.listener, reinterpret_cast<sockaddr *>(&addr), &addr_len));
+
+  CHECK_UV(uv_idle_init(&run.loop, &run.idle));
+  run.idle.data = &run;
+
+  if (mode == Mode::per_send) {
+    run.sender = std::make_unique<PerSendSender>(run.loop);
+  } else {
+    run.sender = std::make_unique<ChannelSender>(run.loop);
+  }
+  run.sender->connect(ntohs(addr.sin_port), [&run] {
+    run.start = std::chrono::steady_clock::now();
+    CHECK_UV(uv_idle_start(&run.idle, &send_cb));
+  });
+
+  CHECK_UV(uv_run(&run.loop, UV_RUN_DEFAULT));
+  CHECK_UV(uv_loop_close(&run.loop));
+
+  std::chrono::duration<double> const elapsed = run.end - run.start;
+  return run.total_bytes / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  u64 total_bytes = DEFAULT_TOTAL_BYTES;
+
+  if (argc > 1) {
+    total_bytes = std::strtoull(argv[1], nullptr, 10) * 1024 * 1024;
+    if (total_bytes == 0) {
+      std::cerr << "usage: tcp_channel_bench [MiB per run]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  for (auto const message_size : DEFAULT_MESSAGE_SIZES) {
+    for (Mode mode : {Mode::per_send, Mode::tcp_channel}) {
+      double const bytes_per_sec = measure(mode, message_size, total_bytes);
+      std::cout << (mode == Mode::per_send ? "per-send" : "tcp_channel") << ", " << message_size
+                << "B messages: " << std::fixed << std::setprecision(1) << bytes_per_sec / (1024 * 1024) << "MiB/s, "
+                << bytes_per_sec / message_size / 1e3 << "k sends/s" << std::endl;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
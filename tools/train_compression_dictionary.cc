@@ -0,0 +1,96 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Ingest compression dictionary trainer
+ *
+ * Trains the zstd dictionary that collectors compress their ingest stream
+ * with, when the reducer offers it (see util/compression_dictionary.h), and
+ * writes it to the given file.
+ *
+ * Samples are cut from ingest streams recorded from kernel collectors (see
+ * EBPF_NET_RECORD_INTAKE_OUTPUT_PATH), given after the output file, in chunks
+ * the size of the collector's write buffer, which is what the collector
+ * compresses at a time. Without recorded streams, synthetic ones are used.
+ *
+ * The build trains the dictionary on synthetic streams unless it is given one
+ * with the EBPF_NET_COMPRESSION_DICTIONARY CMake variable, which can be
+ * trained with this tool on streams recorded from a real cluster.
+ */
+
+#include <collector/constants.h>
+#include <reducer/bench/synthetic_stream.h>
+#include <util/file_ops.h>
+
+#include <zdict.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t DICTIONARY_SIZE = 64 * 1024;
+
+// Synthetic cluster, large enough for every message type to show up with a
+// variety of field values.
+constexpr reducer::bench::SyntheticStreamConfig SYNTHETIC_CLUSTER{
+    .num_hosts = 64,
+    .processes_per_host = 10,
+    .sockets_per_host = 200,
+    .stats_rounds = 4,
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  if (argc < 2) {
+    std::cerr << "usage: train_compression_dictionary <output> [recorded streams...]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::string> streams;
+  if (argc == 2) {
+    streams = reducer::bench::make_synthetic_streams(SYNTHETIC_CLUSTER);
+  }
+  for (int i = 2; i < argc; ++i) {
+    auto stream = read_file_as_string(argv[i]);
+    if (!stream) {
+      std::cerr << "failed to read '" << argv[i] << "': " << stream.error() << std::endl;
+      return EXIT_FAILURE;
+    }
+    streams.push_back(std::move(*stream));
+  }
+
+  std::string samples;
+  std::vector<std::size_t> sample_sizes;
+  for (auto const &stream : streams) {
+    for (std::size_t offset = 0; offset < stream.size(); offset += WRITE_BUFFER_SIZE) {
+      auto const size = std::min<std::size_t>(WRITE_BUFFER_SIZE, stream.size() - offset);
+      samples.append(stream, offset, size);
+      sample_sizes.push_back(size);
+    }
+  }
+
+  std::string dictionary(DICTIONARY_SIZE, '\0');
+  auto const size = ZDICT_trainFromBuffer(
+      dictionary.data(), dictionary.size(), samples.data(), sample_sizes.data(), static_cast<unsigned>(sample_sizes.size()));
+  if (ZDICT_isError(size)) {
+    std::cerr << "failed to train dictionary on " << sample_sizes.size() << " samples: " << ZDICT_getErrorName(size)
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  dictionary.resize(size);
+
+  if (auto const error = write_file(argv[1], dictionary)) {
+    std::cerr << "failed to write '" << argv[1] << "': " << error << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "trained a " << size << " bytes dictionary on " << sample_sizes.size() << " samples from " << streams.size()
+            << " streams" << std::endl;
+  return EXIT_SUCCESS;
+}
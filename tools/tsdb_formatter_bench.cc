@@ -0,0 +1,159 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * TSDB formatter micro-benchmark
+ *
+ * Measures how many time-series per second TsdbFormatter produces for each
+ * output format, with labels assigned per flow the way they used to be (a
+ * label map built for every flow) and as prebuilt label sets that are reused
+ * from one write round to the next.
+ *
+ * Prometheus and JSON output is handed to a writer that discards it. OTLP
+ * output goes through an OTLP publisher writer, and is only measured if an
+ * endpoint is given on the command line; data points that can't be sent are
+ * dropped by the export queue, so the endpoint doesn't need to be reachable.
+ */
+
+#include <reducer/label_set.h>
+#include <reducer/otlp_grpc_publisher.h>
+#include <reducer/tsdb_formatter.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+
+using reducer::LabelSet;
+using reducer::Publisher;
+using reducer::TsdbFormat;
+using reducer::TsdbFormatter;
+
+// Number of distinct flows, each with its own labels.
+constexpr size_t NUM_FLOWS = 10000;
+// Number of time-series written for each flow, e.g. tcp.bytes, tcp.rtt.*, ...
+constexpr size_t METRICS_PER_FLOW = 8;
+// Number of times all the flows are written.
+constexpr size_t NUM_ROUNDS = 10;
+
+constexpr std::string_view METRIC_NAMES[METRICS_PER_FLOW] = {
+    "tcp.bytes",
+    "tcp.rtt.num_measurements",
+    "tcp.active",
+    "tcp.rtt.average",
+    "tcp.packets",
+    "tcp.retrans",
+    "tcp.syn_timeouts",
+    "tcp.resets",
+};
+
+// Writer that discards its input.
+class DiscardingWriter : public Publisher::Writer {
+public:
+  void write(std::string_view prefix, std::string_view labels, std::string_view suffix) override
+  {
+    bytes_ += prefix.size() + labels.size() + suffix.size();
+  }
+
+  void flush() override {}
+
+  u64 bytes_written() const override { return bytes_; }
+
+private:
+  u64 bytes_ = 0;
+};
+
+// Labels of a flow, similar in shape to az_az time-series labels.
+TsdbFormatter::labels_t flow_labels(size_t flow)
+{
+  auto const side = [flow](std::string_view side, size_t n) {
+    return std::string(side) + "-" + std::to_string((flow * 31 + n) % 997);
+  };
+
+  return {
+      {"aggregation", "az_az"},
+      {"source.az", side("az", 1)},
+      {"source.role", side("role", 2)},
+      {"source.env", "production"},
+      {"source.ns", side("ns", 3)},
+      {"dest.az", side("az", 4)},
+      {"dest.role", side("role", 5)},
+      {"dest.env", "production"},
+      {"dest.ns", side("ns", 6)},
+      {"sf_product", "network-explorer"},
+  };
+}
+
+// Writes all the flows NUM_ROUNDS times and returns the number of
+// time-series written per second.
+template <typename AssignLabels>
+double run(TsdbFormat format, Publisher::WriterPtr &writer, AssignLabels &&assign_labels)
+{
+  auto formatter = TsdbFormatter::make(format, writer);
+
+  auto const start_time = std::chrono::steady_clock::now();
+
+  for (size_t round = 0; round < NUM_ROUNDS; ++round) {
+    formatter->set_timestamp(std::chrono::seconds(1'700'000'000 + round * 30));
+    for (size_t flow = 0; flow < NUM_FLOWS; ++flow) {
+      assign_labels(*formatter, flow);
+      for (size_t metric = 0; metric < METRICS_PER_FLOW; ++metric) {
+        formatter->write(METRIC_NAMES[metric], u64(flow + metric), writer);
+      }
+    }
+    formatter->flush();
+  }
+
+  auto const elapsed = std::chrono::steady_clock::now() - start_time;
+
+  return (NUM_ROUNDS * NUM_FLOWS * METRICS_PER_FLOW) / std::chrono::duration<double>(elapsed).count();
+}
+
+void run_format(std::string_view name, TsdbFormat format, Publisher::WriterPtr &writer)
+{
+  std::vector<TsdbFormatter::labels_t> label_maps;
+  std::vector<LabelSet::Ptr> label_sets;
+  for (size_t flow = 0; flow < NUM_FLOWS; ++flow) {
+    label_maps.push_back(flow_labels(flow));
+    label_sets.push_back(LabelSet::make(flow_labels(flow)));
+  }
+
+  double const map_rate =
+      run(format, writer, [&](TsdbFormatter &formatter, size_t flow) { formatter.set_labels(label_maps[flow]); });
+  std::cout << name << " label map: " << static_cast<u64>(map_rate) << " series/sec" << std::endl;
+
+  double const set_rate =
+      run(format, writer, [&](TsdbFormatter &formatter, size_t flow) { formatter.set_labels(label_sets[flow]); });
+  std::cout << name << " label set: " << static_cast<u64>(set_rate) << " series/sec" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  std::optional<std::string> otlp_endpoint;
+
+  if (argc > 2) {
+    std::cerr << "usage: tsdb_formatter_bench [otlp_endpoint]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (argc == 2) {
+    otlp_endpoint = argv[1];
+  }
+
+  Publisher::WriterPtr discarding_writer = std::make_unique<DiscardingWriter>();
+  run_format("prometheus", TsdbFormat::prometheus, discarding_writer);
+  run_format("json", TsdbFormat::json, discarding_writer);
+
+  if (otlp_endpoint) {
+    reducer::OtlpGrpcPublisher publisher(1, *otlp_endpoint);
+    auto otlp_writer = publisher.make_writer(0);
+    run_format("otlp_grpc", TsdbFormat::otlp_grpc, otlp_writer);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/bpf_ring_buffer.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <stdexcept>
+
+BpfRingBuffer::BpfRingBuffer(int map_fd, u32 n_bytes) : fd_(map_fd)
+{
+  if ((n_bytes == 0) || (n_bytes & (n_bytes - 1))) {
+    throw std::invalid_argument("BPF ring buffer size must be a power of 2");
+  }
+
+  size_t const page_size = getpagesize();
+
+  /* consumer page: read-write */
+  consumer_mmap_ = mmap(NULL, page_size, PROT_READ | PROT_WRITE, MAP_SHARED, map_fd, 0);
+  if (consumer_mmap_ == MAP_FAILED) {
+    std::stringstream msg;
+    msg << "mmap of ring buffer consumer page failed with errno " << errno << ", error: '" << strerror(errno) << "'";
+    throw std::runtime_error(msg.str());
+  }
+
+  /* producer page followed by the data area mapped twice: read-only */
+  producer_mmap_size_ = page_size + 2 * static_cast<size_t>(n_bytes);
+  producer_mmap_ = mmap(NULL, producer_mmap_size_, PROT_READ, MAP_SHARED, map_fd, page_size);
+  if (producer_mmap_ == MAP_FAILED) {
+    munmap(consumer_mmap_, page_size);
+
+    std::stringstream msg;
+    msg << "mmap of ring buffer data failed with errno " << errno << ", error: '" << strerror(errno) << "'";
+    throw std::runtime_error(msg.str());
+  }
+
+  consumer_pos_ptr_ = static_cast<unsigned long *>(consumer_mmap_);
+  producer_pos_ptr_ = static_cast<unsigned long const *>(producer_mmap_);
+  data_ = static_cast<char const *>(producer_mmap_) + page_size;
+  mask_ = n_bytes - 1;
+
+  consumer_pos_ = __atomic_load_n(consumer_pos_ptr_, __ATOMIC_ACQUIRE);
+  producer_pos_ = consumer_pos_;
+}
+
+BpfRingBuffer::BpfRingBuffer(unsigned long *consumer, unsigned long *producer, char *data, u32 n_bytes)
+    : consumer_pos_ptr_(consumer),
+      producer_pos_ptr_(producer),
+      data_(data),
+      mask_(n_bytes - 1),
+      consumer_pos_(*consumer),
+      producer_pos_(*consumer)
+{}
+
+BpfRingBuffer::~BpfRingBuffer()
+{
+  if (callback_) {
+    uv_poll_stop(&poll_);
+  }
+  if (producer_mmap_) {
+    munmap(producer_mmap_, producer_mmap_size_);
+  }
+  if (consumer_mmap_) {
+    munmap(consumer_mmap_, getpagesize());
+  }
+}
+
+void BpfRingBuffer::set_callback(uv_loop_t &loop, void *ctx, CALLBACK cb)
+{
+  if (fd_ < 0) {
+    throw std::logic_error("BpfRingBuffer: cannot set callback on a ring buffer without a map");
+  }
+
+  callback_ = cb;
+  callback_ctx_ = ctx;
+
+  int res = uv_poll_init(&loop, &poll_, fd_);
+  if (res != 0) {
+    throw std::runtime_error("Could not init ring buffer poll");
+  }
+
+  uv_handle_set_data((uv_handle_t *)&poll_, this);
+
+  res = uv_poll_start(&poll_, UV_READABLE, [](uv_poll_t *handle, int status, int events) {
+    BpfRingBuffer *obj = (BpfRingBuffer *)uv_handle_get_data((uv_handle_t *)handle);
+    (obj->callback_)(obj->callback_ctx_);
+  });
+  if (res != 0) {
+    throw std::runtime_error("Could not start watching ring buffer poll");
+  }
+}
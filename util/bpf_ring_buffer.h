@@ -0,0 +1,212 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/platform.h>
+
+#include <linux/bpf.h>
+#include <uv.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+/**
+ * Consumer side of a BPF_MAP_TYPE_RINGBUF map.
+ *
+ * Unlike per-CPU perf rings, a BPF ring buffer is shared by all CPUs, and
+ * records come out in the order they were reserved by the producers.
+ *
+ * The kernel maps the data area twice, back to back, so a record is always
+ * contiguous in memory even when it wraps around the end of the ring.
+ *
+ * Format of records in the ring:
+ *  BEGIN bpf_ringbuf_hdr
+ *  - u32: length, with BPF_RINGBUF_BUSY_BIT and BPF_RINGBUF_DISCARD_BIT
+ *  - u32: page offset (kernel use only)
+ *  END bpf_ringbuf_hdr
+ *  - u8[length]: record payload, padded to 8 bytes
+ *
+ * The reading interface mirrors `PerfRing`: offsets given to the `peek_*`
+ * methods are relative to the start of the payload, which takes the place of
+ * the data following `perf_event_header` in perf rings.
+ */
+class BpfRingBuffer {
+public:
+  /**
+   * Maps the ring buffer of the given BPF_MAP_TYPE_RINGBUF map.
+   *
+   * @param map_fd: file descriptor of the ring buffer map
+   * @param n_bytes: size of the data area, i.e. the map's max_entries
+   *
+   * Throws std::runtime_error if mapping fails.
+   */
+  BpfRingBuffer(int map_fd, u32 n_bytes);
+
+  virtual ~BpfRingBuffer();
+
+  /* disallow copy and assignment */
+  BpfRingBuffer(BpfRingBuffer const &) = delete;
+  BpfRingBuffer &operator=(BpfRingBuffer const &) = delete;
+
+  /**
+   * Starts a read batch: reads the producer position, making records
+   * committed until now visible to the `peek_*` methods.
+   */
+  void start_read_batch()
+  {
+    producer_pos_ = __atomic_load_n(producer_pos_ptr_, __ATOMIC_ACQUIRE);
+    skip_discarded();
+  }
+
+  /**
+   * Returns the size of the next record's payload, or -ENOENT if there are no
+   * more committed records in this batch.
+   */
+  int peek_size() const
+  {
+    if (consumer_pos_ == producer_pos_) {
+      return -ENOENT;
+    }
+    u32 const len = header_len();
+    if (len & BPF_RINGBUF_BUSY_BIT) {
+      // reserved but not yet committed: records behind it must wait
+      return -ENOENT;
+    }
+    return len;
+  }
+
+  /* Reads an aligned value from the payload of the next record. */
+  u64 peek_aligned_u64(u16 offset) const { return peek_aligned<u64>(offset); }
+  u32 peek_aligned_u32(u16 offset) const { return peek_aligned<u32>(offset); }
+  u16 peek_aligned_u16(u16 offset) const { return peek_aligned<u16>(offset); }
+
+  /**
+   * Copies @len bytes from the payload of the next record, starting at
+   * @offset, to @buf.
+   */
+  void peek_copy(char *buf, u16 offset, u16 len) const
+  {
+    assert(peek_size() >= (int)offset + len);
+    memcpy(buf, payload() + offset, len);
+  }
+
+  /**
+   * Returns a view of the next record's message, with the same layout as
+   * `PerfRing::peek()`: the payload is expected to start with
+   * [ u32 + u32 unpadded_size + u64 timestamp ] and the view covers
+   * `unpadded_size` bytes starting at the timestamp.
+   *
+   * Records never wrap around, so the second view is always empty.
+   */
+  std::pair<std::string_view, std::string_view> peek() const
+  {
+    u32 const unpadded_len = peek_aligned_u32(sizeof(u32));
+    assert(peek_size() >= (int)(sizeof(u64) + unpadded_len));
+    return {std::string_view(payload() + sizeof(u64), unpadded_len), std::string_view()};
+  }
+
+  /**
+   * Discards the next record.
+   *
+   * Assumes the ring is not empty (i.e. peek_size() >= 0).
+   */
+  void pop()
+  {
+    assert(peek_size() >= 0);
+    consumer_pos_ += record_size(header_len());
+    skip_discarded();
+  }
+
+  /**
+   * Finishes the read batch, releasing the space of popped records to the
+   * producers.
+   */
+  void finish_read_batch() { __atomic_store_n(consumer_pos_ptr_, consumer_pos_, __ATOMIC_RELEASE); }
+
+  /**
+   * Returns the number of bytes left to read, and optionally the total size
+   * of the ring.
+   */
+  u32 bytes_remaining(u32 *total_bytes) const
+  {
+    if (total_bytes) {
+      *total_bytes = mask_ + 1;
+    }
+    return producer_pos_ - consumer_pos_;
+  }
+
+  /**
+   * Sets a callback to execute when the kernel signals that records are
+   * available.
+   */
+  typedef void CALLBACK(void *ctx);
+  void set_callback(uv_loop_t &loop, void *ctx, CALLBACK cb);
+
+protected:
+  /**
+   * Reads from an already mapped ring buffer, used by tests.
+   *
+   * @param consumer: the consumer page, starting with the consumer position
+   * @param producer: the producer page, starting with the producer position
+   * @param data: the data area, mapped twice back to back
+   * @param n_bytes: size of the data area, a power of 2
+   */
+  BpfRingBuffer(unsigned long *consumer, unsigned long *producer, char *data, u32 n_bytes);
+
+private:
+  static constexpr u32 record_size(u32 len)
+  {
+    return ((len & ~(BPF_RINGBUF_BUSY_BIT | BPF_RINGBUF_DISCARD_BIT)) + BPF_RINGBUF_HDR_SZ + 7) & ~7u;
+  }
+
+  u32 header_len() const
+  {
+    return __atomic_load_n(reinterpret_cast<u32 const *>(&data_[consumer_pos_ & mask_]), __ATOMIC_ACQUIRE);
+  }
+
+  char const *payload() const { return &data_[(consumer_pos_ & mask_) + BPF_RINGBUF_HDR_SZ]; }
+
+  template <typename T> T peek_aligned(u16 offset) const
+  {
+    assert(peek_size() >= (int)(offset + sizeof(T)));
+    assert((offset % sizeof(T)) == 0);
+    T value;
+    memcpy(&value, payload() + offset, sizeof(T));
+    return value;
+  }
+
+  // skips records that producers discarded instead of committing
+  void skip_discarded()
+  {
+    while (consumer_pos_ != producer_pos_) {
+      u32 const len = header_len();
+      if ((len & BPF_RINGBUF_BUSY_BIT) || !(len & BPF_RINGBUF_DISCARD_BIT)) {
+        break;
+      }
+      consumer_pos_ += record_size(len);
+    }
+  }
+
+  int fd_ = -1;
+  void *consumer_mmap_ = nullptr;
+  void *producer_mmap_ = nullptr;
+  size_t producer_mmap_size_ = 0;
+
+  unsigned long *consumer_pos_ptr_;
+  unsigned long const *producer_pos_ptr_;
+  char const *data_;
+  u64 mask_;
+
+  unsigned long consumer_pos_;
+  unsigned long producer_pos_;
+
+  uv_poll_t poll_;
+  void *callback_ctx_ = nullptr;
+  CALLBACK *callback_ = nullptr;
+};
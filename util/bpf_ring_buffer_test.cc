@@ -0,0 +1,201 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/bpf_ring_buffer.h>
+
+#include <gtest/gtest.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <string>
+
+namespace {
+
+constexpr u32 RING_BYTES = 4096;
+
+// Emulates the kernel side of a BPF ring buffer in process memory, with the
+// data area mapped twice back to back like the kernel does.
+class FakeRingBuffer {
+public:
+  FakeRingBuffer()
+  {
+    fd_ = memfd_create("bpf_ring_buffer_test", 0);
+    EXPECT_GE(fd_, 0);
+    EXPECT_EQ(0, ftruncate(fd_, RING_BYTES));
+
+    // reserve space for both copies, then map the same pages over each half
+    data_ = static_cast<char *>(mmap(NULL, 2 * RING_BYTES, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    EXPECT_NE(MAP_FAILED, data_);
+    EXPECT_NE(MAP_FAILED, mmap(data_, RING_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_, 0));
+    EXPECT_NE(MAP_FAILED, mmap(data_ + RING_BYTES, RING_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_, 0));
+  }
+
+  ~FakeRingBuffer()
+  {
+    munmap(data_, 2 * RING_BYTES);
+    close(fd_);
+  }
+
+  // Reserves a record and returns its position; the record stays busy until
+  // committed.
+  unsigned long reserve(u32 len)
+  {
+    unsigned long const pos = producer_;
+    set_header(pos, len | BPF_RINGBUF_BUSY_BIT);
+    producer_ += (len + BPF_RINGBUF_HDR_SZ + 7) & ~7u;
+    return pos;
+  }
+
+  void commit(unsigned long pos, std::string_view payload)
+  {
+    memcpy(&data_[(pos & (RING_BYTES - 1)) + BPF_RINGBUF_HDR_SZ], payload.data(), payload.size());
+    set_header(pos, payload.size());
+  }
+
+  void discard(unsigned long pos, u32 len) { set_header(pos, len | BPF_RINGBUF_DISCARD_BIT); }
+
+  void write(std::string_view payload) { commit(reserve(payload.size()), payload); }
+
+  unsigned long consumer_ = 0;
+  unsigned long producer_ = 0;
+  char *data_;
+
+private:
+  void set_header(unsigned long pos, u32 len) { memcpy(&data_[pos & (RING_BYTES - 1)], &len, sizeof(len)); }
+
+  int fd_;
+};
+
+class TestRingBuffer : public BpfRingBuffer {
+public:
+  TestRingBuffer(FakeRingBuffer &fake) : BpfRingBuffer(&fake.consumer_, &fake.producer_, fake.data_, RING_BYTES) {}
+};
+
+std::string read(BpfRingBuffer &ring)
+{
+  int const size = ring.peek_size();
+  EXPECT_GE(size, 0);
+  std::string result(size, '\0');
+  ring.peek_copy(result.data(), 0, size);
+  ring.pop();
+  return result;
+}
+
+} // namespace
+
+TEST(bpf_ring_buffer, empty)
+{
+  FakeRingBuffer fake;
+  TestRingBuffer ring(fake);
+
+  ring.start_read_batch();
+  EXPECT_EQ(-ENOENT, ring.peek_size());
+  ring.finish_read_batch();
+}
+
+TEST(bpf_ring_buffer, records_in_order)
+{
+  FakeRingBuffer fake;
+  TestRingBuffer ring(fake);
+
+  fake.write("first");
+  fake.write("second record");
+
+  ring.start_read_batch();
+  EXPECT_EQ("first", read(ring));
+  EXPECT_EQ("second record", read(ring));
+  EXPECT_EQ(-ENOENT, ring.peek_size());
+  ring.finish_read_batch();
+
+  // both records are 8-byte aligned, including the header
+  EXPECT_EQ(16u + 24u, fake.consumer_);
+}
+
+TEST(bpf_ring_buffer, records_only_visible_after_start_read_batch)
+{
+  FakeRingBuffer fake;
+  TestRingBuffer ring(fake);
+
+  ring.start_read_batch();
+  fake.write("late");
+  EXPECT_EQ(-ENOENT, ring.peek_size());
+  ring.finish_read_batch();
+
+  ring.start_read_batch();
+  EXPECT_EQ("late", read(ring));
+  ring.finish_read_batch();
+}
+
+TEST(bpf_ring_buffer, busy_record_blocks_later_records)
+{
+  FakeRingBuffer fake;
+  TestRingBuffer ring(fake);
+
+  auto const busy = fake.reserve(8);
+  fake.write("committed");
+
+  ring.start_read_batch();
+  EXPECT_EQ(-ENOENT, ring.peek_size());
+  ring.finish_read_batch();
+  EXPECT_EQ(0u, fake.consumer_);
+
+  fake.commit(busy, "reserved");
+
+  ring.start_read_batch();
+  EXPECT_EQ("reserved", read(ring));
+  EXPECT_EQ("committed", read(ring));
+  ring.finish_read_batch();
+}
+
+TEST(bpf_ring_buffer, discarded_records_are_skipped)
+{
+  FakeRingBuffer fake;
+  TestRingBuffer ring(fake);
+
+  fake.discard(fake.reserve(16), 16);
+  fake.write("kept");
+  fake.discard(fake.reserve(4), 4);
+
+  ring.start_read_batch();
+  EXPECT_EQ("kept", read(ring));
+  EXPECT_EQ(-ENOENT, ring.peek_size());
+  ring.finish_read_batch();
+
+  EXPECT_EQ(fake.producer_, fake.consumer_);
+}
+
+TEST(bpf_ring_buffer, wrapped_record_is_contiguous)
+{
+  FakeRingBuffer fake;
+  TestRingBuffer ring(fake);
+
+  // fill most of the ring and consume it, so the next record wraps around
+  std::string const filler(RING_BYTES - 32, 'x');
+  fake.write(filler);
+  ring.start_read_batch();
+  EXPECT_EQ(filler, read(ring));
+  ring.finish_read_batch();
+
+  // u32 dummy, u32 unpadded size, u64 timestamp, then the message body
+  std::string payload(16, '\0');
+  u32 const unpadded = 8 + 40;
+  u64 const timestamp = 12345;
+  memcpy(&payload[4], &unpadded, sizeof(unpadded));
+  memcpy(&payload[8], &timestamp, sizeof(timestamp));
+  payload += std::string(40, 'y');
+  fake.write(payload);
+
+  ring.start_read_batch();
+  EXPECT_EQ(unpadded, ring.peek_aligned_u32(4));
+  EXPECT_EQ(timestamp, ring.peek_aligned_u64(8));
+
+  auto const view = ring.peek();
+  EXPECT_EQ(unpadded, view.first.size());
+  EXPECT_TRUE(view.second.empty());
+  EXPECT_EQ(std::string_view(payload).substr(8), view.first);
+
+  ring.pop();
+  ring.finish_read_batch();
+  EXPECT_EQ(fake.producer_, fake.consumer_);
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/platform.h>
+#include <util/iterable_bitmap.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * A pool of elements that grows in chunks of CHUNK_SIZE elements, up to a
+ * runtime capacity that is at most SIZE.
+ *
+ * Drop-in replacement for Pool<T, SIZE>: indices are stable for the lifetime
+ * of an element (chunks are never moved or released while the pool lives),
+ * so indices can be used as handles and weak references just the same.
+ * Unlike Pool, memory is only reserved once elements are actually needed.
+ */
+template <class T, std::size_t SIZE, std::size_t CHUNK_SIZE, class Allocator = std::allocator<T>> class ChunkedPool {
+public:
+  using index_type = typename std::conditional<(SIZE >= (1 << 16) - 1), u32, u16>::type;
+  using element_type = T;
+  using size_type = std::size_t;
+  using bitmap_type = IterableBitmap<SIZE>;
+
+  static constexpr size_type pool_size = SIZE;
+  static constexpr size_type chunk_size = CHUNK_SIZE;
+  static constexpr size_type max_chunks = (SIZE + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  static constexpr index_type invalid = std::numeric_limits<index_type>::max();
+
+private:
+  /* force the used storage to at least hold a u32, for the free list */
+  union poolable_type {
+    element_type t;
+    u32 next_free;
+  };
+
+  /* POD type suitable for use as uninitialized storage */
+  using storage_type = typename std::aligned_storage<sizeof(poolable_type), alignof(poolable_type)>::type;
+
+  /* allocator traits rebound to the storage type */
+  using allocator_traits = typename std::allocator_traits<Allocator>::template rebind_traits<storage_type>;
+
+  static constexpr u32 null_index = std::numeric_limits<u32>::max();
+
+public:
+  using allocator_type = typename allocator_traits::allocator_type;
+
+  struct position {
+    index_type index;
+    element_type *entry;
+  };
+
+  ChunkedPool()
+  {
+    static_assert(pool_size > 0, "pool size must be larger than 0");
+    static_assert(chunk_size > 0 && (chunk_size & (chunk_size - 1)) == 0, "chunk size must be a power of 2");
+    static_assert(pool_size <= invalid, "pool size must leave room for the invalid index");
+
+    chunks_.reserve(max_chunks);
+  }
+
+  ~ChunkedPool()
+  {
+    for (auto i : allocated_) {
+      destroy(i);
+    }
+
+    for (auto chunk : chunks_) {
+      allocator_traits::deallocate(allocator_, chunk, chunk_size);
+    }
+  }
+
+  ChunkedPool(ChunkedPool const &) = delete;
+  ChunkedPool &operator=(ChunkedPool const &) = delete;
+
+  bool empty() const { return size() == 0; }
+
+  bool full() const { return size() >= capacity(); }
+
+  size_type size() const { return elem_count_; }
+
+  size_type max_size() const { return max_elem_count_; }
+
+  /**
+   * Maximum number of elements the pool will grow to.
+   */
+  size_type capacity() const { return capacity_; }
+
+  /**
+   * Number of elements for which memory is currently reserved.
+   */
+  size_type reserved() const { return std::min(chunks_.size() * chunk_size, pool_size); }
+
+  /**
+   * Sets the maximum number of elements the pool will grow to, clamped to
+   * SIZE. Lowering it below the current size makes the pool full until
+   * enough elements are removed; memory already reserved is kept.
+   */
+  void set_capacity(size_type capacity) { capacity_ = std::min(capacity, pool_size); }
+
+  const bitmap_type &allocated() const { return allocated_; }
+
+  element_type &operator[](index_type index)
+  {
+    assert(index < reserved());
+    assert(allocated_.get(index));
+    return *reinterpret_cast<element_type *>(slot(index));
+  }
+
+  element_type const &operator[](index_type index) const
+  {
+    assert(index < reserved());
+    assert(allocated_.get(index));
+    return *reinterpret_cast<element_type const *>(slot(index));
+  }
+
+  /**
+   * Emplaces an element into the pool, reserving a new chunk if needed.
+   * @returns position of the new value, or {invalid,nullptr} if the container
+   *   is full or a new chunk could not be allocated.
+   */
+  template <typename... Args> position emplace(Args &&... args)
+  {
+    if (full())
+      return {invalid, nullptr};
+
+    u32 index = free_list_;
+    if (index != null_index) {
+      free_list_ = slot(index)->next_free;
+    } else {
+      if (alloc_end_ >= reserved() && !grow())
+        return {invalid, nullptr};
+      index = alloc_end_++;
+    }
+
+    bool disarm = false;
+    DisarmGuard pool_guard(disarm, [index, this] { release(index); });
+
+    /* zero memory before constructing, like the fixed-size Pool */
+    auto *entry = reinterpret_cast<element_type *>(slot(index));
+    memset(static_cast<void *>(entry), 0, sizeof(storage_type));
+
+    /* construct the object, might throw! */
+    allocator_traits::construct(allocator_, entry, std::forward<Args>(args)...);
+
+    /* okay, we're good! */
+    elem_count_++;
+    allocated_.set(index);
+    disarm = true; /* don't want to deallocate */
+
+    max_elem_count_ = std::max(max_elem_count_, elem_count_);
+
+    return {(index_type)index, entry};
+  }
+
+  /**
+   * Removes the element at the given index
+   */
+  void remove(index_type index)
+  {
+    assert(index < reserved());
+    assert(allocated_.get(index));
+
+    destroy(index);
+    release(index);
+
+    elem_count_--;
+    allocated_.clear(index);
+  }
+
+private:
+  struct DisarmGuard {
+    template <typename F> DisarmGuard(bool &disarm_b, F fn) : fn_(fn), disarm_(disarm_b) {}
+    ~DisarmGuard()
+    {
+      if (!disarm_)
+        fn_();
+    }
+
+  private:
+    std::function<void(void)> fn_;
+    bool &disarm_;
+  };
+
+  allocator_type allocator_;
+
+  /* chunks of chunk_size elements; index i lives in chunks_[i / chunk_size] */
+  std::vector<storage_type *> chunks_;
+
+  bitmap_type allocated_;
+
+  /* head of the list of removed elements, linked through next_free */
+  u32 free_list_{null_index};
+  /* elements at or past this index were never allocated */
+  u32 alloc_end_{0};
+
+  size_type capacity_{pool_size};
+
+  size_type elem_count_{0};
+  size_type max_elem_count_{0};
+
+  poolable_type *slot(u32 index) const
+  {
+    return reinterpret_cast<poolable_type *>(&chunks_[index / chunk_size][index % chunk_size]);
+  }
+
+  /**
+   * Reserves memory for another chunk of elements.
+   * @returns false if the pool can't grow.
+   */
+  bool grow()
+  {
+    if (chunks_.size() >= max_chunks)
+      return false;
+
+    try {
+      chunks_.push_back(allocator_traits::allocate(allocator_, chunk_size));
+    } catch (std::bad_alloc const &) {
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Returns the element at @index to the free list.
+   */
+  void release(u32 index)
+  {
+    slot(index)->next_free = free_list_;
+    free_list_ = index;
+  }
+
+  /**
+   * Destroys the element at @index.
+   */
+  void destroy(index_type index) { allocator_traits::destroy(allocator_, reinterpret_cast<element_type *>(slot(index))); }
+};
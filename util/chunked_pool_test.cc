@@ -0,0 +1,91 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/chunked_pool.h>
+#include <util/fixed_hash.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(chunked_pool, grows_in_chunks)
+{
+  ChunkedPool<u64, 100, 8> pool;
+  EXPECT_EQ(0u, pool.reserved());
+  EXPECT_EQ(100u, pool.capacity());
+
+  std::vector<ChunkedPool<u64, 100, 8>::position> positions;
+  for (u64 i = 0; i < 20; ++i) {
+    auto pos = pool.emplace(i);
+    ASSERT_NE(pool.invalid, pos.index);
+    positions.push_back(pos);
+  }
+
+  EXPECT_EQ(20u, pool.size());
+  EXPECT_EQ(24u, pool.reserved());
+
+  // growing doesn't move existing elements
+  for (u64 i = 0; i < positions.size(); ++i) {
+    EXPECT_EQ(i, pool[positions[i].index]);
+    EXPECT_EQ(positions[i].entry, &pool[positions[i].index]);
+  }
+}
+
+TEST(chunked_pool, reuses_removed_indices)
+{
+  ChunkedPool<u64, 100, 8> pool;
+
+  auto a = pool.emplace(1u);
+  auto b = pool.emplace(2u);
+  pool.remove(a.index);
+  EXPECT_EQ(1u, pool.size());
+  EXPECT_EQ(2u, pool.max_size());
+
+  auto c = pool.emplace(3u);
+  EXPECT_EQ(a.index, c.index);
+  EXPECT_EQ(2u, pool[b.index]);
+  EXPECT_EQ(3u, pool[c.index]);
+  EXPECT_EQ(8u, pool.reserved());
+}
+
+TEST(chunked_pool, capacity_limit)
+{
+  ChunkedPool<u64, 100, 8> pool;
+  pool.set_capacity(10);
+
+  for (u64 i = 0; i < 10; ++i) {
+    ASSERT_NE(pool.invalid, pool.emplace(i).index);
+  }
+  EXPECT_TRUE(pool.full());
+  EXPECT_EQ(pool.invalid, pool.emplace(10u).index);
+  EXPECT_EQ(16u, pool.reserved());
+
+  // capped at the compile-time size
+  pool.set_capacity(1000);
+  EXPECT_EQ(100u, pool.capacity());
+
+  for (u64 i = 10; i < 100; ++i) {
+    ASSERT_NE(pool.invalid, pool.emplace(i).index);
+  }
+  EXPECT_EQ(pool.invalid, pool.emplace(100u).index);
+  EXPECT_EQ(100u, pool.size());
+}
+
+TEST(chunked_pool, fixed_hash)
+{
+  FixedHash<int, int, 100, std::hash<int>, std::equal_to<int>, std::allocator<int>, ChunkedPool<int, 100, 4>> hash;
+  hash.set_capacity(6);
+
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_NE(hash.invalid, hash.insert(i, i * 10).index);
+  }
+  EXPECT_EQ(hash.invalid, hash.insert(6, 60).index);
+
+  EXPECT_TRUE(hash.erase(2));
+  ASSERT_NE(hash.invalid, hash.insert(6, 60).index);
+
+  auto pos = hash.find(6);
+  ASSERT_NE(hash.invalid, pos.index);
+  EXPECT_EQ(60, *pos.entry);
+  EXPECT_EQ(6u, hash.max_size());
+}
@@ -0,0 +1,23 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/compression_dictionary.h>
+
+#include <zstd.h>
+
+namespace {
+
+#include <generated/compression_dictionary.zdict.xxd>
+
+} // namespace
+
+std::string_view compression_dictionary()
+{
+  return {reinterpret_cast<char const *>(compression_dictionary_zdict), compression_dictionary_zdict_len};
+}
+
+u32 compression_dictionary_id()
+{
+  static u32 const id = ZSTD_getDictID_fromDict(compression_dictionary_zdict, compression_dictionary_zdict_len);
+  return id;
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/types.h>
+
+#include <string_view>
+
+// zstd dictionary used to compress ingest streams, when the reducer offers it
+// (see ServerCommand::COMPRESSION_DICTIONARY).
+//
+// It is trained on ingest messages at build time (see
+// tools/train_compression_dictionary.cc), so collectors and the reducer built
+// together share it. Frames compressed with it carry its ID, which the reducer
+// sends along with its offer.
+std::string_view compression_dictionary();
+
+u32 compression_dictionary_id();
+
+// Log2 of the window size of compressed ingest streams, which bounds the
+// memory the reducer needs to decompress each of them.
+constexpr int COMPRESSION_WINDOW_LOG = 17;
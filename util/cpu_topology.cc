@@ -0,0 +1,168 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/cpu_topology.h>
+
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+constexpr std::string_view SYSFS_NODE_DIR = "/sys/devices/system/node";
+
+std::optional<int> parse_id(std::string_view str)
+{
+  int value = 0;
+  auto const [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+  if (ec != std::errc{} || ptr != str.data() + str.size() || value < 0) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// CPUs this process is allowed to run on, in ascending order.
+std::vector<int> allowed_cpus()
+{
+  std::vector<int> cpus;
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+
+  if (cpus.empty()) {
+    // shouldn't happen, but don't leave the caller without CPUs
+    long const count = ::sysconf(_SC_NPROCESSORS_ONLN);
+    for (int cpu = 0; cpu < std::max(count, 1L); ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+
+  return cpus;
+}
+
+} // namespace
+
+std::size_t CpuTopology::num_cpus() const
+{
+  std::size_t count = 0;
+  for (auto const &node : nodes) {
+    count += node.cpus.size();
+  }
+  return count;
+}
+
+std::optional<std::vector<int>> parse_cpu_list(std::string_view list)
+{
+  std::vector<int> ids;
+
+  while (!list.empty() && (list.back() == '\n' || list.back() == ' ')) {
+    list.remove_suffix(1);
+  }
+
+  while (!list.empty()) {
+    auto const comma = list.find(',');
+    auto const range = list.substr(0, comma);
+    list = (comma == std::string_view::npos) ? std::string_view{} : list.substr(comma + 1);
+
+    auto const dash = range.find('-');
+    auto const first = parse_id(range.substr(0, dash));
+    auto const last = (dash == std::string_view::npos) ? first : parse_id(range.substr(dash + 1));
+    if (!first || !last || *last < *first) {
+      return std::nullopt;
+    }
+
+    for (int id = *first; id <= *last; ++id) {
+      ids.push_back(id);
+    }
+  }
+
+  return ids;
+}
+
+CpuTopology detect_cpu_topology()
+{
+  auto const allowed = allowed_cpus();
+  CpuTopology topology;
+
+  std::error_code ec;
+  for (auto const &entry : std::filesystem::directory_iterator(SYSFS_NODE_DIR, ec)) {
+    auto const name = entry.path().filename().string();
+    if (name.rfind("node", 0) != 0) {
+      continue;
+    }
+
+    auto const id = parse_id(std::string_view(name).substr(4));
+    if (!id) {
+      continue;
+    }
+
+    std::ifstream file(entry.path() / "cpulist");
+    std::string line;
+    if (!std::getline(file, line)) {
+      continue;
+    }
+
+    auto cpus = parse_cpu_list(line);
+    if (!cpus) {
+      continue;
+    }
+
+    CpuTopology::Node node{.id = *id, .cpus = {}};
+    for (int cpu : *cpus) {
+      if (std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+        node.cpus.push_back(cpu);
+      }
+    }
+
+    // memory-only nodes and nodes we can't run on are of no use for placement
+    if (!node.cpus.empty()) {
+      std::sort(node.cpus.begin(), node.cpus.end());
+      topology.nodes.push_back(std::move(node));
+    }
+  }
+
+  if (topology.nodes.empty()) {
+    topology.nodes.push_back({.id = 0, .cpus = allowed});
+  }
+
+  std::sort(topology.nodes.begin(), topology.nodes.end(), [](auto const &a, auto const &b) { return a.id < b.id; });
+
+  return topology;
+}
+
+Expected<bool, std::error_code> prefer_numa_node(void *addr, std::size_t len, int node)
+{
+  constexpr std::size_t BITS_PER_WORD = sizeof(unsigned long) * CHAR_BIT;
+
+  if (node < 0) {
+    return {unexpected, std::make_error_code(std::errc::invalid_argument)};
+  }
+
+  std::vector<unsigned long> node_mask(node / BITS_PER_WORD + 1, 0);
+  node_mask[node / BITS_PER_WORD] |= 1UL << (node % BITS_PER_WORD);
+
+  // the kernel expects one more than the number of bits in the mask
+  unsigned long const max_node = node_mask.size() * BITS_PER_WORD + 1;
+
+  if (::syscall(SYS_mbind, addr, len, MPOL_PREFERRED, node_mask.data(), max_node, 0) != 0) {
+    return {unexpected, std::error_code{errno, std::generic_category()}};
+  }
+
+  return true;
+}
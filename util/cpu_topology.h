@@ -0,0 +1,57 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+// This file contains helpers for discovering the CPUs and NUMA nodes of the
+// host, and for placing memory on a given NUMA node.
+
+#include <util/expected.h>
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// CPUs this process is allowed to run on, grouped by NUMA node.
+//
+struct CpuTopology {
+  struct Node {
+    // NUMA node id, as used by the kernel.
+    int id;
+    // CPUs of this node, in ascending order.
+    std::vector<int> cpus;
+  };
+
+  // Nodes that have at least one CPU, in ascending order of id.
+  std::vector<Node> nodes;
+
+  // Total number of CPUs across all nodes.
+  std::size_t num_cpus() const;
+};
+
+// Parses a list of CPUs (or NUMA nodes) in the format used by the kernel,
+// e.g. "0-3,8,10-11".
+//
+// Returns the ids in the order they appear in the list, or nothing if the list
+// is malformed.
+std::optional<std::vector<int>> parse_cpu_list(std::string_view list);
+
+// Detects the NUMA topology of this host from sysfs, keeping only the CPUs
+// this process is allowed to run on.
+//
+// If NUMA information is not available, all the allowed CPUs are reported as
+// belonging to node 0.
+CpuTopology detect_cpu_topology();
+
+// Asks the kernel to allocate the pages of the given memory range from the
+// given NUMA node, falling back to other nodes if that one is out of memory.
+//
+// Only affects pages that weren't touched yet, so this should be called right
+// after the range is allocated. `addr` must be aligned to the page size.
+//
+// On failure the error information is returned.
+Expected<bool, std::error_code> prefer_numa_node(void *addr, std::size_t len, int node);
@@ -0,0 +1,59 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/cpu_topology.h>
+
+#include <gtest/gtest.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+TEST(cpu_topology, parse_cpu_list)
+{
+  EXPECT_EQ(std::vector<int>({0}), parse_cpu_list("0"));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), parse_cpu_list("0-3"));
+  EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}), parse_cpu_list("0-3,8,10-11\n"));
+  EXPECT_EQ(std::vector<int>({}), parse_cpu_list(""));
+  EXPECT_EQ(std::vector<int>({}), parse_cpu_list("\n"));
+
+  EXPECT_FALSE(parse_cpu_list("a"));
+  EXPECT_FALSE(parse_cpu_list("3-1"));
+  EXPECT_FALSE(parse_cpu_list("1-"));
+  EXPECT_FALSE(parse_cpu_list("1,,2"));
+  EXPECT_FALSE(parse_cpu_list("-1"));
+}
+
+TEST(cpu_topology, detect)
+{
+  auto const topology = detect_cpu_topology();
+
+  ASSERT_FALSE(topology.nodes.empty());
+  EXPECT_GT(topology.num_cpus(), 0u);
+
+  for (std::size_t i = 0; i < topology.nodes.size(); ++i) {
+    EXPECT_FALSE(topology.nodes[i].cpus.empty());
+    if (i > 0) {
+      EXPECT_LT(topology.nodes[i - 1].id, topology.nodes[i].id);
+    }
+  }
+}
+
+TEST(cpu_topology, prefer_numa_node)
+{
+  auto const page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  auto const topology = detect_cpu_topology();
+
+  void *const addr = ::mmap(nullptr, page_size * 4, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(MAP_FAILED, addr);
+
+  auto const result = prefer_numa_node(addr, page_size * 4, topology.nodes.front().id);
+  // mbind is not allowed in some sandboxes, but must not fail otherwise
+  if (!result) {
+    EXPECT_TRUE(result.error() == std::errc::operation_not_permitted || result.error() == std::errc::function_not_supported)
+        << result.error().message();
+  }
+
+  EXPECT_FALSE(prefer_numa_node(addr, page_size * 4, -1));
+
+  ::munmap(addr, page_size * 4);
+}
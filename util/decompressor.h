@@ -0,0 +1,33 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/platform.h>
+
+#include <cstddef>
+#include <string_view>
+
+// Streaming decompressor, which keeps decompressed data in its output buffer
+// until the caller discards it.
+class Decompressor {
+public:
+  virtual ~Decompressor() {}
+
+  virtual const u8 *output_buf() const = 0;
+  virtual size_t output_buf_size() const = 0;
+
+  // Decompresses |data| of size |data_len|.
+  // The # of bytes that have been decompressed is stored in |consumed_len|.
+  //
+  // Returns an error code (see error_name()) if an error happened, 0 otherwise.
+  virtual size_t process(const u8 *data, size_t data_len, size_t *consumed_len) = 0;
+
+  // Discards |len| bytes of data in output_buf.
+  virtual void discard(size_t len) = 0;
+
+  // Describes an error code returned by process().
+  virtual std::string_view error_name(size_t error) const = 0;
+};
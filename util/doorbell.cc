@@ -0,0 +1,70 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "doorbell.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+
+static_assert(std::atomic<u32>::is_always_lock_free);
+
+Doorbell::Doorbell() : fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+  if (fd_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "Doorbell couldn't create eventfd");
+  }
+}
+
+Doorbell::~Doorbell()
+{
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+void Doorbell::ring()
+{
+  // pairs with the fence in park(): either we see the parked flag, or the
+  // consumer's re-check sees the data published before this call
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (!parked_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  // only one of several concurrent producers gets to write the eventfd
+  if (parked_.exchange(0, std::memory_order_acq_rel)) {
+    u64 const one = 1;
+    ssize_t res;
+    do {
+      res = ::write(fd_, &one, sizeof(one));
+    } while (res < 0 && errno == EINTR);
+
+    num_signals_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Doorbell::park()
+{
+  parked_.store(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+bool Doorbell::unpark()
+{
+  return parked_.exchange(0, std::memory_order_acq_rel) != 0;
+}
+
+void Doorbell::drain()
+{
+  u64 count;
+  ssize_t res;
+  do {
+    res = ::read(fd_, &count, sizeof(count));
+  } while (res < 0 && errno == EINTR);
+
+  parked_.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/types.h>
+
+#include <atomic>
+
+// Wakes up a consumer thread that parked itself waiting for producers.
+//
+// The consumer owns the doorbell and registers `fd()` with its event loop.
+// Producers call `ring()` after publishing new data; the underlying eventfd is
+// only written to while the consumer is parked, so producers writing into a
+// busy consumer pay just for a fence and a load.
+//
+// Protocol on the consumer side:
+//   1. `park()`
+//   2. re-check all inputs; if anything is pending, `unpark()` and go on
+//   3. otherwise wait for `fd()` to become readable, then `drain()`
+//
+class Doorbell {
+public:
+  // Creates the underlying eventfd. Throws std::system_error on failure.
+  Doorbell();
+  ~Doorbell();
+
+  Doorbell(Doorbell const &) = delete;
+  Doorbell &operator=(Doorbell const &) = delete;
+
+  // File descriptor that becomes readable when the doorbell is rung.
+  int fd() const { return fd_; }
+
+  // Producer side: signals the consumer if, and only if, it is parked.
+  void ring();
+
+  // Consumer side: announces that the consumer is about to go to sleep.
+  // Must be followed by a re-check of the inputs.
+  void park();
+
+  // Consumer side: cancels a previous `park()`.
+  // Returns whether the consumer was still flagged as parked.
+  bool unpark();
+
+  // Consumer side: clears the pending notification and the parked flag.
+  void drain();
+
+  // Number of times a producer actually signalled the consumer.
+  u64 num_signals() const { return num_signals_.load(std::memory_order_relaxed); }
+
+  // Address of the parked flag, for consumers not written in C++.
+  std::atomic<u32> *parked_flag() { return &parked_; }
+
+private:
+  int fd_{-1};
+  std::atomic<u32> parked_{0};
+  std::atomic<u64> num_signals_{0};
+};
@@ -0,0 +1,73 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/doorbell.h>
+
+#include <gtest/gtest.h>
+
+#include <poll.h>
+
+#include <thread>
+
+namespace {
+
+bool is_readable(Doorbell const &doorbell)
+{
+  struct pollfd pfd = {.fd = doorbell.fd(), .events = POLLIN, .revents = 0};
+  return ::poll(&pfd, 1, 0) == 1;
+}
+
+} // namespace
+
+TEST(doorbell, ring_without_parked_consumer_is_silent)
+{
+  Doorbell doorbell;
+
+  doorbell.ring();
+  doorbell.ring();
+
+  EXPECT_FALSE(is_readable(doorbell));
+  EXPECT_EQ(0u, doorbell.num_signals());
+}
+
+TEST(doorbell, ring_wakes_parked_consumer_once)
+{
+  Doorbell doorbell;
+
+  doorbell.park();
+  doorbell.ring();
+  doorbell.ring();
+
+  EXPECT_TRUE(is_readable(doorbell));
+  EXPECT_EQ(1u, doorbell.num_signals());
+
+  doorbell.drain();
+  EXPECT_FALSE(is_readable(doorbell));
+}
+
+TEST(doorbell, unpark_cancels_park)
+{
+  Doorbell doorbell;
+
+  doorbell.park();
+  EXPECT_TRUE(doorbell.unpark());
+  EXPECT_FALSE(doorbell.unpark());
+
+  doorbell.ring();
+  EXPECT_FALSE(is_readable(doorbell));
+}
+
+TEST(doorbell, cross_thread_wakeup)
+{
+  Doorbell doorbell;
+  doorbell.park();
+
+  std::thread producer([&] { doorbell.ring(); });
+
+  struct pollfd pfd = {.fd = doorbell.fd(), .events = POLLIN, .revents = 0};
+  EXPECT_EQ(1, ::poll(&pfd, 1, 5000));
+
+  producer.join();
+  doorbell.drain();
+  EXPECT_EQ(1u, doorbell.num_signals());
+}
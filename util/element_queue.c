@@ -20,10 +20,7 @@ static inline u32 __eq_next_offset_by_len(u32 buf_offset, u32 buf_mask, u32 len)
 
 void eq_init_shared(struct element_queue_shared *shared)
 {
-  shared->elem_head = 0;
-  shared->elem_tail = 0;
-  shared->buf_head = 0;
-  shared->buf_tail = 0;
+  memset(shared, 0, sizeof(*shared));
 }
 
 int eq_init_contig(struct element_queue *eq, u32 n_elems, u32 buf_len, void *data)
@@ -42,10 +39,10 @@ int eq_init_contig(struct element_queue *eq, u32 n_elems, u32 buf_len, void *dat
   eq->elem_mask = n_elems - 1;
   eq->buf_mask = buf_len - 1;
 
-  eq->elem_head = eq->shared->elem_head;
-  eq->elem_tail = eq->shared->elem_tail;
-  eq->buf_head = eq->shared->buf_head;
-  eq->buf_tail = eq->shared->buf_tail;
+  eq->elem_head = EQ_LOAD_RELAXED(eq->shared->elem_head);
+  eq->elem_tail = EQ_LOAD_RELAXED(eq->shared->elem_tail);
+  eq->buf_head = EQ_LOAD_RELAXED(eq->shared->buf_head);
+  eq->buf_tail = EQ_LOAD_RELAXED(eq->shared->buf_tail);
 
   return 0;
 }
@@ -70,16 +67,18 @@ int eq_write(struct element_queue *eq, u32 len)
   if (aligned_len > eq->buf_mask)
     return -EINVAL;
 
-  /* is the element queue full? */
-  if (eq->elem_tail - eq->elem_head >= eq->elem_mask + 1)
-    return -ENOSPC;
-
   buf_mask = eq->buf_mask;
   buf_tail = __eq_next_offset_by_len(eq->buf_tail, buf_mask, aligned_len);
 
-  /* is there enough space in the eq? */
-  if (buf_tail + aligned_len - eq->buf_head > buf_mask + 1)
-    return -ENOSPC;
+  /* is the element queue full? if so, see if the consumer made progress */
+  if ((eq->elem_tail - eq->elem_head >= eq->elem_mask + 1) || (buf_tail + aligned_len - eq->buf_head > buf_mask + 1)) {
+    eq_refresh_heads(eq);
+
+    if (eq->elem_tail - eq->elem_head >= eq->elem_mask + 1)
+      return -ENOSPC;
+    if (buf_tail + aligned_len - eq->buf_head > buf_mask + 1)
+      return -ENOSPC;
+  }
 
   /* okay we're good to go */
   eq->buf_tail = buf_tail + aligned_len;
@@ -12,13 +12,42 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/* size of a cache line, used to keep producer and consumer state apart */
+#define EQ_CACHE_LINE_SIZE 64
+
+/**
+ * Indices shared between the producer and the consumer of a queue (layout v2).
+ *
+ * The heads are only written by the consumer and the tails only by the
+ * producer. Each pair lives on its own cache line so that publishing one side
+ * does not invalidate the line the other side keeps writing to.
+ *
+ * The layout is mirrored by `ElementQueueShared` in crates/element-queue.
+ */
 struct element_queue_shared {
+  /* written by the consumer */
   u32 elem_head;
   u32 buf_head;
+  u8 __pad_head[EQ_CACHE_LINE_SIZE - 2 * sizeof(u32)];
+
+  /* written by the producer */
   u32 elem_tail;
   u32 buf_tail;
+  u8 __pad_tail[EQ_CACHE_LINE_SIZE - 2 * sizeof(u32)];
 };
 
+#ifdef __cplusplus
+static_assert(sizeof(struct element_queue_shared) == 2 * EQ_CACHE_LINE_SIZE, "element_queue_shared layout");
+#else
+_Static_assert(sizeof(struct element_queue_shared) == 2 * EQ_CACHE_LINE_SIZE, "element_queue_shared layout");
+#endif
+
+/* accessors for the indices in element_queue_shared */
+#define EQ_LOAD_ACQUIRE(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define EQ_LOAD_RELAXED(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define EQ_STORE_RELEASE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#define EQ_STORE_RELAXED(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+
 /**
  * A queue structure conveying discrete elements of variable length.
  *
@@ -29,6 +58,10 @@ struct element_queue_shared {
  *  - all reads must be surrounded by start_read_batch and finish_read_batch
  *  - all writes must be surrounded by start_write_batch and finish_read_batch
  *
+ * The indices of the other side are cached: a producer only reloads the
+ * consumer's heads when the queue looks full, and a consumer only reloads the
+ * producer's tails when the queue looks empty.
+ *
  * @param buf_head: index of the next unread char in the eq
  * @param buf_tail: index following the eq's last written char
  */
@@ -60,7 +93,7 @@ void eq_init_shared(struct element_queue_shared *shared);
  * @param data: shared memory area
  *
  * Memory layout of eq data:
- *   element_queue_shared
+ *   element_queue_shared (two cache lines)
  *   u32 elem[n_elems]
  *   char buf[buf_len]
  *
@@ -70,7 +103,8 @@ void eq_init_shared(struct element_queue_shared *shared);
 int eq_init_contig(struct element_queue *eq, u32 n_elems, u32 buf_len, void *data);
 
 /**
- * Returns the size, in bytes, of a contiguous element queue
+ * Returns the size, in bytes, of a contiguous element queue.
+ * The memory area should be aligned to EQ_CACHE_LINE_SIZE.
  */
 u32 eq_contig_size(u32 n_elems, u32 buf_len);
 
@@ -83,13 +117,24 @@ u32 eq_contig_size(u32 n_elems, u32 buf_len);
  */
 static inline void eq_start_write_batch(struct element_queue *eq)
 {
-  eq->elem_head = ACCESS_ONCE(eq->shared->elem_head);
-  eq->buf_head = ACCESS_ONCE(eq->shared->buf_head);
-
+  /* the consumer's heads are reloaded lazily, see eq_refresh_heads */
   assert((int)eq->buf_tail - eq->buf_head >= 0);
   assert((int)eq->elem_tail - eq->elem_head >= 0);
 }
 
+/**
+ * Reloads the heads published by the consumer into the producer's cache
+ * @param eq: the eq to write to
+ */
+static inline void eq_refresh_heads(struct element_queue *eq)
+{
+  /* buf_head can be newer than elem_head, from a read batch that finished
+   * after elem_head was loaded: it needs its own acquire so the space it
+   * frees isn't reused before the consumer is done reading it */
+  eq->elem_head = EQ_LOAD_ACQUIRE(eq->shared->elem_head);
+  eq->buf_head = EQ_LOAD_ACQUIRE(eq->shared->buf_head);
+}
+
 /**
  * Get a buffer where data can be written to the eq
  * @param eq: the eq to write to
@@ -97,7 +142,7 @@ static inline void eq_start_write_batch(struct element_queue *eq)
  *
  * @return: offset in eq where data should be written
  *   -EINVAL if trying to write more than the eq size or passed NULL pointer
- *   -ENOSPC if eq too full
+ *   -ENOSPC if eq too full, even after reloading the consumer's heads
  */
 int eq_write(struct element_queue *eq, u32 len);
 
@@ -109,14 +154,12 @@ int eq_write(struct element_queue *eq, u32 len);
  */
 static inline void eq_finish_write_batch(struct element_queue *eq)
 {
-  /* make sure items have been committed before writing the tails */
-  smp_wmb();
-
   assert((int)eq->buf_tail - eq->buf_head >= 0);
   assert((int)eq->elem_tail - eq->elem_head >= 0);
 
-  eq->shared->buf_tail = eq->buf_tail;
-  eq->shared->elem_tail = eq->elem_tail;
+  /* the release store makes items visible no later than the tails */
+  EQ_STORE_RELAXED(eq->shared->buf_tail, eq->buf_tail);
+  EQ_STORE_RELEASE(eq->shared->elem_tail, eq->elem_tail);
 }
 
 /**
@@ -130,8 +173,11 @@ static inline void eq_start_read_batch(struct element_queue *eq)
   /* we don't need to read buf_tail because we trust that the sizes in the
    * element-size array do not overflow the element_queue */
 
-  eq->elem_tail = ACCESS_ONCE(eq->shared->elem_tail);
-  smp_rmb();
+  /* elements we already know about can be read without touching the
+   * producer's cache line */
+  if (eq->elem_tail == eq->elem_head) {
+    eq->elem_tail = EQ_LOAD_ACQUIRE(eq->shared->elem_tail);
+  }
 
   assert((int)eq->elem_tail - eq->elem_head >= 0);
 }
@@ -164,10 +210,9 @@ int eq_read(struct element_queue *eq, u32 *lenp);
  */
 static inline void eq_finish_read_batch(struct element_queue *eq)
 {
-  smp_mb();
-
-  eq->shared->buf_head = eq->buf_head;
-  eq->shared->elem_head = eq->elem_head;
+  /* the release stores keep reads of the items before freeing their space */
+  EQ_STORE_RELEASE(eq->shared->buf_head, eq->buf_head);
+  EQ_STORE_RELEASE(eq->shared->elem_head, eq->elem_head);
 
   assert((int)eq->elem_tail - eq->elem_head >= 0);
 }
@@ -204,6 +249,24 @@ static inline u32 eq_buf_capacity(const struct element_queue *eq)
   return eq->buf_mask + 1;
 }
 
+/**
+ * Number of elements in the queue as seen by the producer, using the heads
+ * most recently published by the consumer rather than the cached ones.
+ */
+static inline u32 eq_writer_elem_count(const struct element_queue *eq)
+{
+  return eq->elem_tail - EQ_LOAD_ACQUIRE(eq->shared->elem_head);
+}
+
+/**
+ * Bytes used in the buffer as seen by the producer, using the heads most
+ * recently published by the consumer rather than the cached ones.
+ */
+static inline u32 eq_writer_buf_used(const struct element_queue *eq)
+{
+  return eq->buf_tail - EQ_LOAD_ACQUIRE(eq->shared->buf_head);
+}
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
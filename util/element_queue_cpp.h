@@ -151,6 +151,18 @@ public:
    */
   u32 buf_capacity() const;
 
+  /**
+   * Gets the number of elements in the queue, from the producer's side.
+   * @see eq_writer_elem_count
+   */
+  u32 writer_elem_count() const;
+
+  /**
+   * Gets the number of bytes used in the buffer, from the producer's side.
+   * @see eq_writer_buf_used
+   */
+  u32 writer_buf_used() const;
+
 protected:
   /* the underlying storage backing the element queue */
   ElementQueueStoragePtr storage_;
@@ -164,8 +176,9 @@ inline MemElementQueueStorage::MemElementQueueStorage(u32 n_elems, u32 buf_len)
 {
   u32 size = eq_contig_size(n_elems, buf_len);
 
-  /* allocate contig memory */
-  data_ = (char *)malloc(size);
+  /* allocate contig memory, keeping the shared indices on their own cache lines */
+  size = (size + EQ_CACHE_LINE_SIZE - 1) & ~(EQ_CACHE_LINE_SIZE - 1);
+  data_ = (char *)aligned_alloc(EQ_CACHE_LINE_SIZE, size);
   if (data_ == NULL)
     throw std::runtime_error("Unable to allocate memory for element queue");
 
@@ -321,4 +334,14 @@ inline u32 ElementQueue::buf_capacity() const
   return eq_buf_capacity(this);
 }
 
+inline u32 ElementQueue::writer_elem_count() const
+{
+  return eq_writer_elem_count(this);
+}
+
+inline u32 ElementQueue::writer_buf_used() const
+{
+  return eq_writer_buf_used(this);
+}
+
 #endif /* INCLUDE_FASTPASS_UTIL_ELEMENT_QUEUE_CPP_H_ */
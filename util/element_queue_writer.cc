@@ -3,6 +3,7 @@
 
 #include "element_queue_writer.h"
 
+#include <util/doorbell.h>
 #include <util/log.h>
 
 #include <unistd.h>
@@ -15,7 +16,7 @@ static constexpr useconds_t RETRY_INTERVAL = 1000; // in microseconds
 
 } // namespace
 
-ElementQueueWriter::ElementQueueWriter(ElementQueue &queue) : queue_(queue) {}
+ElementQueueWriter::ElementQueueWriter(ElementQueue &queue, Doorbell *doorbell) : queue_(queue), doorbell_(doorbell) {}
 
 ElementQueueWriter::~ElementQueueWriter() {}
 
@@ -58,6 +59,10 @@ Expected<u8 *, std::error_code> ElementQueueWriter::start_write(u32 length)
 void ElementQueueWriter::finish_write()
 {
   queue_.finish_write_batch();
+
+  if (doorbell_) {
+    doorbell_->ring();
+  }
 }
 
 std::error_code ElementQueueWriter::flush()
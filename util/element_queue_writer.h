@@ -9,12 +9,16 @@
 #include <platform/platform.h>
 #include <util/element_queue_cpp.h>
 
+class Doorbell;
+
 // Adapter class for writing to ElementQueues through the
 // IBufferedWriter interface.
 //
 class ElementQueueWriter : public IBufferedWriter {
 public:
-  ElementQueueWriter(ElementQueue &queue);
+  // If `doorbell` is given, it is rung every time a write is published, so a
+  // parked reader gets woken up.
+  ElementQueueWriter(ElementQueue &queue, Doorbell *doorbell = nullptr);
   virtual ~ElementQueueWriter();
 
   // Starts a write operation of size \p length.
@@ -42,5 +46,6 @@ public:
 
 private:
   ElementQueue &queue_;
+  Doorbell *doorbell_;
   u64 num_write_stalls_{0};
 };
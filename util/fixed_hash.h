@@ -28,12 +28,13 @@ template <
     std::size_t ELEM_POOL_SZ,
     class Hash,
     class KeyEqual = std::equal_to<Key>,
-    class Allocator = std::allocator<T>>
+    class Allocator = std::allocator<T>,
+    class PoolType = Pool<T, ELEM_POOL_SZ, Allocator>>
 class FixedHash {
 public:
   using key_type = Key;
   using value_type = T;
-  using pool_type = Pool<value_type, ELEM_POOL_SZ, Allocator>;
+  using pool_type = PoolType;
   using index_type = typename pool_type::index_type;
   using size_type = std::size_t;
   // Use default allocator for the map to avoid allocator rebind issues with Abseil.
@@ -56,6 +57,8 @@ public:
   size_type size() const { return pool_.size(); }
   size_type max_size() const { return pool_.max_size(); }
   size_type capacity() const { return pool_.capacity(); }
+  /* only available with growable pools, see ChunkedPool */
+  void set_capacity(size_type capacity) { pool_.set_capacity(capacity); }
   value_type const &operator[](index_type index) const { return pool_[index]; }
   value_type &operator[](index_type index) { return pool_[index]; }
   bitmap_type allocated() const { return pool_.allocated(); }
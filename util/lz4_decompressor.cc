@@ -43,8 +43,13 @@ size_t Lz4Decompressor::process(const u8 *data, size_t data_len, size_t *consume
     data += src_size;
     data_len -= src_size;
 
-    // continue to decompress while LZ4 is making progress
-  } while ((!LZ4F_isError(res)) && (src_size > 0));
+    // LZ4F_decompress returns 0 once a frame is fully decoded
+    if (res == 0 || src_size > 0) {
+      at_frame_boundary_ = (res == 0);
+    }
+
+    // continue to decompress while LZ4 is making progress, within the frame
+  } while ((!LZ4F_isError(res)) && (src_size > 0) && !at_frame_boundary_);
 
   return LZ4F_isError(res) ? res : 0;
 }
@@ -59,6 +64,11 @@ size_t Lz4Decompressor::output_buf_size() const
   return tail_loc_;
 }
 
+std::string_view Lz4Decompressor::error_name(size_t error) const
+{
+  return LZ4F_getErrorName(error);
+}
+
 void Lz4Decompressor::discard(size_t len)
 {
   assert(tail_loc_ >= len);
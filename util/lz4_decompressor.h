@@ -6,32 +6,39 @@
 #pragma once
 
 #include <platform/platform.h>
+#include <util/decompressor.h>
 
 #include <lz4frame.h>
 
 #include <cstdint>
 #include <tuple>
 
-class Lz4Decompressor {
+class Lz4Decompressor : public Decompressor {
 public:
   explicit Lz4Decompressor(size_t buf_capacity);
-  ~Lz4Decompressor();
+  ~Lz4Decompressor() override;
 
-  const u8 *output_buf() const;
-  size_t output_buf_size() const;
+  const u8 *output_buf() const override;
+  size_t output_buf_size() const override;
 
-  // Decompresses |data| of size |data_len|.
+  // Decompresses |data| of size |data_len|, stopping at the end of a frame.
   // The # of bytes that have been decompressed is stored in |consumed_len|.
   //
   // Returns LZ4 error, if an error happened, 0 otherwise.
-  size_t process(const u8 *data, size_t data_len, size_t *consumed_len);
+  size_t process(const u8 *data, size_t data_len, size_t *consumed_len) override;
 
   // Discards |len| bytes of data in output_buf.
-  void discard(size_t len);
+  void discard(size_t len) override;
+
+  std::string_view error_name(size_t error) const override;
+
+  // Whether the next byte to decompress starts a new frame.
+  bool at_frame_boundary() const { return at_frame_boundary_; }
 
 private:
   const size_t output_buf_capacity_;
   size_t tail_loc_;
+  bool at_frame_boundary_ = true;
 
   LZ4F_dctx *ctx_;
   u8 *output_buf_;
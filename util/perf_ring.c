@@ -216,12 +216,7 @@ u32 pr_bytes_remaining(const struct perf_ring *eq, u32 *total_size)
   if (total_size) {
     *total_size = buf_size;
   }
-  u32 begin = eq->buf_head & eq->buf_mask;
-  u32 end = eq->buf_tail & eq->buf_mask;
 
-  if (end < begin) {
-    return (buf_size - begin) + end;
-  }
-
-  return (end - begin);
+  /* positions are free-running, so this also holds when the ring is full */
+  return eq->buf_tail - eq->buf_head;
 }
@@ -0,0 +1,180 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/platform.h>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+class StringInterner;
+
+/**
+ * A reference-counted handle to a string held by a StringInterner.
+ *
+ * Handles are the size of a pointer and cheap to copy. Two handles obtained
+ * from the same interner compare equal if and only if they refer to the same
+ * string, so equality is a pointer comparison.
+ *
+ * The default-constructed handle refers to the empty string.
+ *
+ * Not thread-safe: handles from an interner must only be copied and released
+ * on one thread at a time.
+ */
+class InternedString {
+public:
+  InternedString() = default;
+
+  InternedString(InternedString const &other) : entry_(other.entry_) { acquire(); }
+
+  InternedString(InternedString &&other) noexcept : entry_(std::exchange(other.entry_, nullptr)) {}
+
+  ~InternedString() { release(); }
+
+  InternedString &operator=(InternedString const &other)
+  {
+    if (entry_ != other.entry_) {
+      release();
+      entry_ = other.entry_;
+      acquire();
+    }
+    return *this;
+  }
+
+  InternedString &operator=(InternedString &&other) noexcept
+  {
+    if (this != &other) {
+      release();
+      entry_ = std::exchange(other.entry_, nullptr);
+    }
+    return *this;
+  }
+
+  std::string_view view() const { return entry_ ? std::string_view(entry_->value) : std::string_view(); }
+
+  operator std::string_view() const { return view(); }
+
+  bool empty() const { return entry_ == nullptr; }
+
+  std::size_t size() const { return view().size(); }
+
+  // Compares by identity. Both handles must come from the same interner.
+  friend bool operator==(InternedString const &lhs, InternedString const &rhs) { return lhs.entry_ == rhs.entry_; }
+  friend bool operator!=(InternedString const &lhs, InternedString const &rhs) { return lhs.entry_ != rhs.entry_; }
+
+  // Compares by content.
+  friend bool operator==(InternedString const &lhs, std::string_view rhs) { return lhs.view() == rhs; }
+  friend bool operator!=(InternedString const &lhs, std::string_view rhs) { return lhs.view() != rhs; }
+
+private:
+  friend class StringInterner;
+
+  struct Entry {
+    u32 refcount;
+    // interner holding this entry, or nullptr if it was already destroyed
+    StringInterner *owner;
+    std::string value;
+  };
+
+  explicit InternedString(Entry *entry) : entry_(entry) { acquire(); }
+
+  void acquire()
+  {
+    if (entry_) {
+      ++entry_->refcount;
+    }
+  }
+
+  inline void release();
+
+  Entry *entry_ = nullptr;
+};
+
+// fmt customization point, so handles can be logged directly.
+inline std::string_view format_as(InternedString const &s)
+{
+  return s.view();
+}
+
+/**
+ * A table of unique strings, handing out InternedString handles.
+ *
+ * Each distinct string is stored once, for as long as there are handles
+ * referring to it. Handles can outlive the interner that created them.
+ *
+ * Not thread-safe: meant to be owned by a single core (shard).
+ */
+class StringInterner {
+public:
+  StringInterner() = default;
+
+  StringInterner(StringInterner const &) = delete;
+  StringInterner &operator=(StringInterner const &) = delete;
+
+  ~StringInterner()
+  {
+    // entries still referenced by handles are freed when their last handle is
+    for (auto &[value, entry] : table_) {
+      entry->owner = nullptr;
+    }
+  }
+
+  /**
+   * Returns a handle to the unique copy of `value`, adding it to the table if
+   * it is not there yet.
+   */
+  InternedString intern(std::string_view value)
+  {
+    if (value.empty()) {
+      return {};
+    }
+
+    if (auto found = table_.find(value); found != table_.end()) {
+      return InternedString(found->second);
+    }
+
+    auto entry = new InternedString::Entry{.refcount = 0, .owner = this, .value = std::string(value)};
+    table_.emplace(std::string_view(entry->value), entry);
+    bytes_ += entry->value.size();
+
+    return InternedString(entry);
+  }
+
+  // Number of distinct strings currently held.
+  std::size_t size() const { return table_.size(); }
+
+  // Total length of the distinct strings currently held.
+  std::size_t bytes() const { return bytes_; }
+
+private:
+  friend class InternedString;
+
+  void erase(InternedString::Entry *entry)
+  {
+    bytes_ -= entry->value.size();
+    table_.erase(std::string_view(entry->value));
+  }
+
+  // keys are views into the entries' values
+  absl::flat_hash_map<std::string_view, InternedString::Entry *> table_;
+  std::size_t bytes_ = 0;
+};
+
+inline void InternedString::release()
+{
+  if (entry_ && --entry_->refcount == 0) {
+    if (entry_->owner) {
+      entry_->owner->erase(entry_);
+    }
+    delete entry_;
+  }
+  entry_ = nullptr;
+}
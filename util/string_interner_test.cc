@@ -0,0 +1,95 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include <util/string_interner.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+TEST(string_interner, empty_string)
+{
+  StringInterner interner;
+
+  auto s = interner.intern("");
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(InternedString(), s);
+  EXPECT_EQ("", s.view());
+  EXPECT_EQ(0u, interner.size());
+}
+
+TEST(string_interner, equal_strings_share_storage)
+{
+  StringInterner interner;
+
+  std::string value = "us-west-2a";
+  auto a = interner.intern(value);
+  auto b = interner.intern(std::string_view(value));
+  auto c = interner.intern("us-east-1b");
+
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(a.view().data(), b.view().data());
+  EXPECT_EQ("us-west-2a", a);
+  EXPECT_EQ("us-east-1b", c);
+
+  EXPECT_EQ(2u, interner.size());
+  EXPECT_EQ(value.size() + c.size(), interner.bytes());
+}
+
+TEST(string_interner, released_when_unreferenced)
+{
+  StringInterner interner;
+
+  {
+    auto a = interner.intern("kube-system");
+    auto copy = a;
+    EXPECT_EQ(1u, interner.size());
+
+    a = InternedString();
+    EXPECT_EQ(1u, interner.size());
+    EXPECT_EQ("kube-system", copy);
+  }
+
+  EXPECT_EQ(0u, interner.size());
+  EXPECT_EQ(0u, interner.bytes());
+}
+
+TEST(string_interner, copy_and_move)
+{
+  StringInterner interner;
+
+  auto a = interner.intern("nginx");
+  InternedString b = a;
+  InternedString c = std::move(b);
+
+  EXPECT_TRUE(b.empty());
+  EXPECT_EQ(a, c);
+
+  c = interner.intern("redis");
+  EXPECT_EQ(2u, interner.size());
+
+  a = c;
+  EXPECT_EQ(1u, interner.size());
+  EXPECT_EQ("redis", a);
+
+  // through an alias, so the self-move doesn't trip -Wself-move
+  auto &self = a;
+  a = std::move(self);
+  EXPECT_EQ("redis", a);
+}
+
+TEST(string_interner, handles_outlive_interner)
+{
+  auto interner = std::make_unique<StringInterner>();
+
+  auto a = interner->intern("default");
+  interner.reset();
+
+  EXPECT_EQ("default", a);
+
+  auto b = a;
+  a = InternedString();
+  EXPECT_EQ("default", b);
+}
@@ -0,0 +1,103 @@
+// Copyright The OpenTelemetry Authors
+// SPDX-License-Identifier: Apache-2.0
+
+#include "zstd_decompressor.h"
+
+#include <util/compression_dictionary.h>
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include <endian.h>
+
+namespace {
+
+// Digested once, and shared by the decompressors of all threads.
+ZSTD_DDict const *shared_dictionary()
+{
+  static ZSTD_DDict *const ddict = [] {
+    auto const dictionary = compression_dictionary();
+    return ZSTD_createDDict(dictionary.data(), dictionary.size());
+  }();
+  return ddict;
+}
+
+} // namespace
+
+ZstdDecompressor::ZstdDecompressor(size_t capacity) : output_buf_capacity_(capacity), tail_loc_(0)
+{
+  output_buf_ = (u8 *)malloc(capacity * sizeof(u8));
+  if (output_buf_ == NULL) {
+    throw std::runtime_error("ZstdDecompressor: failed to allocate memory.");
+  }
+
+  ctx_ = ZSTD_createDCtx();
+  if (ctx_ == NULL) {
+    free(output_buf_);
+    throw std::runtime_error("ZstdDecompressor: failed to create a CTX object.");
+  }
+
+  auto const *const ddict = shared_dictionary();
+  if (ddict == NULL || ZSTD_isError(ZSTD_DCtx_refDDict(ctx_, ddict)) ||
+      ZSTD_isError(ZSTD_DCtx_setParameter(ctx_, ZSTD_d_windowLogMax, COMPRESSION_WINDOW_LOG))) {
+    free(output_buf_);
+    ZSTD_freeDCtx(ctx_);
+    throw std::runtime_error("ZstdDecompressor: failed to set up the CTX object.");
+  }
+}
+
+ZstdDecompressor::~ZstdDecompressor()
+{
+  free(output_buf_);
+  ZSTD_freeDCtx(ctx_);
+}
+
+size_t ZstdDecompressor::process(const u8 *data, size_t data_len, size_t *consumed_len)
+{
+  ZSTD_inBuffer input = {.src = data, .size = data_len, .pos = 0};
+  ZSTD_outBuffer output = {.dst = output_buf_ + tail_loc_, .size = output_buf_capacity_ - tail_loc_, .pos = 0};
+
+  // decompresses as much as the input and output buffers allow
+  size_t const res = ZSTD_decompressStream(ctx_, &output, &input);
+
+  *consumed_len = input.pos;
+  tail_loc_ += output.pos;
+
+  return ZSTD_isError(res) ? res : 0;
+}
+
+const u8 *ZstdDecompressor::output_buf() const
+{
+  return output_buf_;
+}
+
+size_t ZstdDecompressor::output_buf_size() const
+{
+  return tail_loc_;
+}
+
+std::string_view ZstdDecompressor::error_name(size_t error) const
+{
+  return ZSTD_getErrorName(error);
+}
+
+void ZstdDecompressor::discard(size_t len)
+{
+  assert(tail_loc_ >= len);
+
+  if (tail_loc_ == len) {
+    tail_loc_ = 0;
+    return;
+  }
+
+  memmove((void *)output_buf_, (const void *)(output_buf_ + len), tail_loc_ - len);
+  tail_loc_ -= len;
+}
+
+bool ZstdDecompressor::is_frame_start(const u8 *data)
+{
+  u32 magic;
+  memcpy(&magic, data, sizeof(magic));
+  return le32toh(magic) == ZSTD_MAGICNUMBER;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright The OpenTelemetry Authors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <platform/platform.h>
+#include <util/decompressor.h>
+
+#include <zstd.h>
+
+// Decompresses a zstd stream compressed with the ingest compression dictionary
+// (see util/compression_dictionary.h).
+class ZstdDecompressor : public Decompressor {
+public:
+  // Number of bytes needed to tell whether data starts a zstd frame.
+  static constexpr size_t MAGIC_SIZE = 4;
+
+  explicit ZstdDecompressor(size_t buf_capacity);
+  ~ZstdDecompressor() override;
+
+  const u8 *output_buf() const override;
+  size_t output_buf_size() const override;
+
+  // Decompresses |data| of size |data_len|.
+  // The # of bytes that have been decompressed is stored in |consumed_len|.
+  //
+  // Returns zstd error, if an error happened, 0 otherwise.
+  size_t process(const u8 *data, size_t data_len, size_t *consumed_len) override;
+
+  // Discards |len| bytes of data in output_buf.
+  void discard(size_t len) override;
+
+  std::string_view error_name(size_t error) const override;
+
+  // Whether |data|, of at least MAGIC_SIZE bytes, starts a zstd frame.
+  static bool is_frame_start(const u8 *data);
+
+private:
+  const size_t output_buf_capacity_;
+  size_t tail_loc_;
+
+  ZSTD_DCtx *ctx_;
+  u8 *output_buf_;
+};